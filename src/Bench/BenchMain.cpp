@@ -0,0 +1,380 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include <Utils/File/Logfile.hpp>
+#include <Utils/File/FileUtils.hpp>
+
+#include "Utils/InternalState.hpp"
+#include "Mesh/BaseComplex/global_types.h"
+#include "Mesh/HexMesh/HexMesh.hpp"
+#include "Mesh/HexMesh/Loaders/VtkLoader.hpp"
+#include "Mesh/HexMesh/Loaders/VtuLoader.hpp"
+#include "Mesh/HexMesh/Loaders/MeshLoader.hpp"
+#include "Mesh/HexMesh/Loaders/DatLoader.hpp"
+#include "Mesh/HexMesh/Loaders/DegStressLoader.hpp"
+#include "Mesh/HexMesh/Loaders/SyntheticMeshGenerator.hpp"
+#include "Mesh/HexMesh/Renderers/LOD/LodSheetGeneration.hpp"
+#include "Mesh/HexMesh/Renderers/Tubes/Tubes.hpp"
+#include "Mesh/Filters/PlaneFilter.hpp"
+#include "Mesh/Filters/PeelingFilter.hpp"
+#include "Mesh/Filters/QualityFilter.hpp"
+#include "BenchmarkRunner.hpp"
+
+/**
+ * Headless benchmark of the CPU stages of HexVolumeRenderer (loading, connectivity computation, quality measures,
+ * filters, render data extraction, LOD generation, CPU tube generation and base-complex frame extraction). No window
+ * or GPU is needed.
+ *
+ * Usage: HexVolumeRendererBench [options] <mesh file | synthetic:key=value,...>...
+ * For the keys of synthetic meshes, see @see parseSyntheticMeshSpecification.
+ * --repetitions <n>    How often each repeatable stage is run (the minimum and mean time are reported).
+ * --output <file.csv>  The CSV file to write the results to (default: HexVolumeRendererBench.csv). "-" writes the
+ *                      results to the standard output after all stages have finished.
+ * --skip-lod           Skips the sheet LOD generation (which can be slow for meshes with many sheets).
+ * --skip-tubes         Skips the CPU tube generation.
+ */
+
+static void printUsage() {
+    std::cerr << "Usage: HexVolumeRendererBench [--repetitions <n>] [--output <file.csv>] [--skip-lod] "
+            "[--skip-tubes] <mesh file | synthetic:key=value,...>..." << std::endl;
+}
+
+static void benchmarkMesh(
+        BenchmarkRunner& runner, const std::string& meshName,
+        std::map<std::string, HexahedralMeshLoader*>& meshLoaderMap, bool skipLod, bool skipTubes) {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> cellIndices;
+    std::vector<glm::vec3> deformations;
+    std::vector<float> attributeList;
+    bool isPerVertexData = true;
+
+    // Stage 1: Load or generate the mesh.
+    SyntheticMeshSettings syntheticMeshSettings;
+    bool loadingSuccessful = false;
+    if (meshName.compare(0, 10, "synthetic:") == 0) {
+        if (!parseSyntheticMeshSpecification(meshName, syntheticMeshSettings)) {
+            return;
+        }
+        runner.runStage(meshName, "generate", getSyntheticMeshNumCells(syntheticMeshSettings), [&]() {
+            loadingSuccessful = generateSyntheticHexMesh(
+                    syntheticMeshSettings, vertices, cellIndices, attributeList, isPerVertexData);
+        }, false);
+    } else {
+        size_t extensionPos = meshName.find_last_of('.');
+        std::string extension = extensionPos == std::string::npos ? "" : meshName.substr(extensionPos + 1);
+        auto it = meshLoaderMap.find(extension);
+        if (it == meshLoaderMap.end()) {
+            sgl::Logfile::get()->writeError("Error: Unknown mesh file extension: " + meshName);
+            return;
+        }
+        runner.runStage(meshName, "load", 0, [&]() {
+            loadingSuccessful = it->second->loadHexahedralMeshFromFile(
+                    meshName, vertices, cellIndices, deformations, attributeList, isPerVertexData);
+        }, false);
+    }
+    if (!loadingSuccessful) {
+        sgl::Logfile::get()->writeError("Error: Couldn't load the mesh " + meshName);
+        return;
+    }
+    size_t numCells = cellIndices.size() / 8;
+
+    // Stage 2: Connectivity and singularity structure.
+    HexMeshPtr hexMesh(new HexMesh);
+    runner.runStage(meshName, "setHexMeshData", numCells, [&]() {
+        hexMesh->setHexMeshData(vertices, cellIndices);
+    }, false);
+    if (!hexMesh->isBaseComplexMeshLoaded()) {
+        sgl::Logfile::get()->writeError("Error: The connectivity of the mesh " + meshName + " couldn't be computed.");
+        return;
+    }
+
+    // Stage 3: Quality measure and attributes.
+    runner.runStage(meshName, "setQualityMeasure", numCells, [&]() {
+        hexMesh->setQualityMeasure(QUALITY_MEASURE_SCALED_JACOBIAN);
+    });
+    runner.runStage(meshName, "precomputeAllQualityMeasures", numCells, [&]() {
+        hexMesh->setPrecomputeAllQualityMeasures(false);
+        hexMesh->setPrecomputeAllQualityMeasures(true);
+        hexMesh->setQualityMeasure(QUALITY_MEASURE_SCALED_JACOBIAN);
+    });
+    runner.runStage(meshName, "setQualityMeasure (precomputed)", numCells, [&]() {
+        hexMesh->setQualityMeasure(QUALITY_MEASURE_EDGE_RATIO);
+    });
+    hexMesh->setPrecomputeAllQualityMeasures(false);
+    hexMesh->setQualityMeasure(QUALITY_MEASURE_SCALED_JACOBIAN);
+    if (!attributeList.empty()) {
+        runner.runStage(meshName, isPerVertexData ? "addManualVertexAttribute" : "addManualCellAttribute", numCells,
+                [&]() {
+            if (isPerVertexData) {
+                hexMesh->addManualVertexAttribute(attributeList, "Attribute");
+            } else {
+                hexMesh->addManualCellAttribute(attributeList, "Attribute");
+            }
+        }, false);
+    }
+
+    // Stage 4: Filters. Each filter is measured on its own, then the filter chain is applied as in the application.
+    PlaneFilter planeFilter;
+    PeelingFilter peelingFilter;
+    QualityFilter qualityFilter;
+    SettingsMap planeFilterSettings;
+    planeFilterSettings.addKeyValue("filter_ratio", "0.5");
+    planeFilter.setNewSettings(planeFilterSettings);
+    SettingsMap peelingFilterSettings;
+    peelingFilterSettings.addKeyValue("peeling_depth", "1");
+    SettingsMap qualityFilterSettings;
+    qualityFilterSettings.addKeyValue("filter_ratio", "0.2");
+    qualityFilter.setNewSettings(qualityFilterSettings);
+    std::vector<HexahedralMeshFilter*> meshFilters = { &planeFilter, &peelingFilter, &qualityFilter };
+
+    runner.runStage(meshName, "PeelingFilter::onMeshLoaded", numCells, [&]() {
+        peelingFilter.onMeshLoaded(hexMesh);
+    });
+    peelingFilter.setNewSettings(peelingFilterSettings);
+    runner.runStage(meshName, "PlaneFilter", numCells, [&]() {
+        planeFilter.onInputMeshChanged(hexMesh);
+        planeFilter.filterMesh(hexMesh);
+    });
+    runner.runStage(meshName, "PeelingFilter", numCells, [&]() {
+        peelingFilter.filterMesh(hexMesh);
+    });
+    runner.runStage(meshName, "QualityFilter", numCells, [&]() {
+        qualityFilter.filterMesh(hexMesh);
+    });
+    HexMeshPtr filteredMesh = hexMesh;
+    runner.runStage(meshName, "filterChain", numCells, [&]() {
+        // Like MainApp::getFilteredMesh after the input mesh changed, i.e., no cached filter mask is reused.
+        filteredMesh = hexMesh;
+        std::vector<const CellMask*> filterMasks;
+        for (HexahedralMeshFilter* meshFilter : meshFilters) {
+            meshFilter->onInputMeshChanged(filteredMesh);
+            meshFilter->filterMesh(filteredMesh);
+            filteredMesh = meshFilter->getOutput();
+            filterMasks.push_back(&meshFilter->getFilterMask());
+        }
+        filteredMesh->setCellFilteringMasks(filterMasks);
+    });
+
+    // Stage 5: Render data extraction.
+    runner.runStage(meshName, "getSurfaceData", numCells, [&]() {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<glm::vec3> vertexPositions;
+        std::vector<glm::vec3> vertexNormals;
+        std::vector<float> vertexAttributes;
+        filteredMesh->getSurfaceData(triangleIndices, vertexPositions, vertexNormals, vertexAttributes);
+    });
+    // A small plane filter slider step followed by the incremental update of the filtered surface.
+    FilteredSurfaceData filteredSurfaceData;
+    filteredMesh->updateFilteredSurfaceData(filteredSurfaceData);
+    bool isSliderStepForward = true;
+    runner.runStage(meshName, "updateFilteredSurfaceData (slider step)", numCells, [&]() {
+        planeFilterSettings.addKeyValue("filter_ratio", isSliderStepForward ? "0.52" : "0.5");
+        isSliderStepForward = !isSliderStepForward;
+        planeFilter.setNewSettings(planeFilterSettings);
+        planeFilter.filterMesh(filteredMesh);
+        std::vector<const CellMask*> filterMasks;
+        for (HexahedralMeshFilter* meshFilter : meshFilters) {
+            filterMasks.push_back(&meshFilter->getFilterMask());
+        }
+        filteredMesh->setCellFilteringMasks(filterMasks);
+        filteredMesh->updateFilteredSurfaceData(filteredSurfaceData);
+    });
+    runner.runStage(meshName, "getWireframeData", numCells, [&]() {
+        std::vector<glm::vec3> lineVertices;
+        std::vector<glm::vec4> lineColors;
+        filteredMesh->getWireframeData(lineVertices, lineColors);
+    });
+    runner.runStage(meshName, "getVolumeData_Faces", numCells, [&]() {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<glm::vec3> vertexPositions;
+        std::vector<glm::vec3> vertexNormals;
+        std::vector<float> vertexAttributes;
+        filteredMesh->getVolumeData_Faces(triangleIndices, vertexPositions, vertexNormals, vertexAttributes);
+    });
+    runner.runStage(meshName, "getVolumeData_Volume", numCells, [&]() {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<glm::vec3> vertexPositions;
+        std::vector<float> vertexAttributes;
+        filteredMesh->getVolumeData_Volume(triangleIndices, vertexPositions, vertexAttributes);
+    });
+    runner.runStage(meshName, "getVolumeData_FacesShared", numCells, [&]() {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<glm::vec3> vertexPositions;
+        std::vector<float> vertexAttributes;
+        filteredMesh->getVolumeData_FacesShared(triangleIndices, vertexPositions, vertexAttributes);
+    });
+    runner.runStage(meshName, "getSingularityData", numCells, [&]() {
+        std::vector<glm::vec3> lineVertices;
+        std::vector<glm::vec4> lineColors;
+        std::vector<glm::vec3> pointVertices;
+        std::vector<glm::vec4> pointColors;
+        filteredMesh->getSingularityData(lineVertices, lineColors, pointVertices, pointColors);
+    });
+    runner.runStage(meshName, "getCompleteWireframeData", numCells, [&]() {
+        std::vector<glm::vec3> lineVertices;
+        std::vector<glm::vec4> lineColors;
+        filteredMesh->getCompleteWireframeData(lineVertices, lineColors);
+    });
+
+    // Stage 6: Sheet-based LOD structure. This also runs as part of the unified face extraction below.
+    if (!skipLod) {
+        runner.runStage(meshName, "generateSheetLevelOfDetailEdgeStructure", numCells, [&]() {
+            std::vector<float> edgeLodValues;
+            int maxValueInt = 0;
+            generateSheetLevelOfDetailEdgeStructure(filteredMesh.get(), edgeLodValues, &maxValueInt, LodSettings());
+        });
+        runner.runStage(meshName, "getSurfaceDataWireframeFacesUnified_AttributePerVertex", numCells, [&]() {
+            std::vector<uint32_t> triangleIndices;
+            std::vector<HexahedralCellFaceUnified> hexahedralCellFaces;
+            std::vector<HexahedralCellVertexUnified> hexahedralCellVertices;
+            std::vector<HexahedralCellEdgeUnified> hexahedralCellEdges;
+            std::vector<glm::uvec2> hexahedralCellFacesCellLinks;
+            std::vector<float> hexahedralCells;
+            int maxLodValue = 0;
+            filteredMesh->getSurfaceDataWireframeFacesUnified_AttributePerVertex(
+                    triangleIndices, hexahedralCellFaces, hexahedralCellVertices, hexahedralCellEdges,
+                    hexahedralCellFacesCellLinks, hexahedralCells, true, maxLodValue);
+        });
+    }
+
+    // Stage 7: CPU tube generation for the complete wireframe.
+    if (!skipTubes) {
+        std::vector<std::vector<glm::vec3>> lineCentersList;
+        std::vector<std::vector<glm::vec4>> lineColorsList;
+        runner.runStage(meshName, "getCompleteWireframeTubeData", numCells, [&]() {
+            lineCentersList.clear();
+            lineColorsList.clear();
+            filteredMesh->getCompleteWireframeTubeData(lineCentersList, lineColorsList);
+        });
+        const float tubeRadius = 0.001f;
+        const int numCircleSubdivisions = 8;
+        runner.runStage(meshName, "createTriangleTubesRenderDataCPU", numCells, [&]() {
+            std::vector<uint32_t> triangleIndices;
+            std::vector<glm::vec3> vertexPositions;
+            std::vector<glm::vec3> vertexNormals;
+            std::vector<glm::vec3> vertexTangents;
+            std::vector<glm::vec4> vertexColors;
+            createTriangleTubesRenderDataCPU(
+                    lineCentersList, lineColorsList, tubeRadius, numCircleSubdivisions,
+                    triangleIndices, vertexPositions, vertexNormals, vertexTangents, vertexColors);
+        });
+        runner.runStage(meshName, "createCappedTriangleTubesRenderDataCPU", numCells, [&]() {
+            std::vector<uint32_t> triangleIndices;
+            std::vector<glm::vec3> vertexPositions;
+            std::vector<glm::vec3> vertexNormals;
+            std::vector<glm::vec3> vertexTangents;
+            std::vector<glm::vec4> vertexColors;
+            createCappedTriangleTubesRenderDataCPU(
+                    lineCentersList, lineColorsList, tubeRadius, false, numCircleSubdivisions,
+                    triangleIndices, vertexPositions, vertexNormals, vertexTangents, vertexColors);
+        });
+    }
+
+    // Stage 8: Base-complex frame extraction. The frame is computed lazily only once, so the stage isn't repeated.
+    runner.runStage(meshName, "computeBaseComplexMeshFrame", numCells, [&]() {
+        hexMesh->getBaseComplexMeshFrame();
+    }, false);
+    const BaseComplexFrameTimings& frameTimings = hexMesh->getBaseComplexMeshFrameTimings();
+    runner.addStageResult(meshName, "baseComplexNodeEdgeExtraction", numCells, frameTimings.nodeEdgeExtractionMs);
+    runner.addStageResult(meshName, "baseComplexFaceExtraction", numCells, frameTimings.faceExtractionMs);
+    runner.addStageResult(meshName, "baseComplexCuboidExtraction", numCells, frameTimings.cuboidExtractionMs);
+    runner.addStageResult(meshName, "baseComplexSingularityAndColor", numCells, frameTimings.singularityAndColorMs);
+
+    for (HexahedralMeshFilter* meshFilter : meshFilters) {
+        meshFilter->removeOldMesh();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    sgl::FileUtils::get()->initialize("HexVolumeRendererBench", argc, argv);
+
+    int numRepetitions = 1;
+    std::string outputFilename = "HexVolumeRendererBench.csv";
+    bool skipLod = false;
+    bool skipTubes = false;
+    std::vector<std::string> meshNames;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--repetitions" && i + 1 < argc) {
+            numRepetitions = std::max(std::atoi(argv[++i]), 1);
+        } else if (argument == "--output" && i + 1 < argc) {
+            outputFilename = argv[++i];
+        } else if (argument == "--skip-lod") {
+            skipLod = true;
+        } else if (argument == "--skip-tubes") {
+            skipTubes = true;
+        } else if (argument == "--help" || argument == "-h") {
+            printUsage();
+            return 0;
+        } else if (argument.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown option: " << argument << std::endl;
+            printUsage();
+            return 1;
+        } else {
+            meshNames.push_back(argument);
+        }
+    }
+    if (meshNames.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::map<std::string, HexahedralMeshLoader*> meshLoaderMap;
+    meshLoaderMap.insert(std::make_pair("vtk", new VtkLoader));
+    meshLoaderMap.insert(std::make_pair("vtu", new VtuLoader));
+    meshLoaderMap.insert(std::make_pair("mesh", new MeshLoader));
+    meshLoaderMap.insert(std::make_pair("dat", new DatCartesianGridLoader));
+    meshLoaderMap.insert(std::make_pair("degStress", new DegStressLoader));
+
+    BenchmarkRunner runner(numRepetitions);
+    for (const std::string& meshName : meshNames) {
+        benchmarkMesh(runner, meshName, meshLoaderMap, skipLod, skipTubes);
+    }
+
+    for (auto& it : meshLoaderMap) {
+        delete it.second;
+    }
+    meshLoaderMap.clear();
+
+    if (outputFilename == "-") {
+        runner.writeCsv(std::cout);
+    } else if (!runner.writeCsv(outputFilename)) {
+        return 1;
+    }
+    return 0;
+}
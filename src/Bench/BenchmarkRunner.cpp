@@ -0,0 +1,161 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#include <Utils/File/Logfile.hpp>
+
+#include "BenchmarkRunner.hpp"
+
+void BenchmarkRunner::runStage(
+        const std::string& meshName, const std::string& stageName, size_t numCells,
+        std::function<void()> stageFunction, bool repeatable) {
+    int numRuns = repeatable ? std::max(numRepetitions, 1) : 1;
+    bool peakRssReset = resetPeakResidentSetSize();
+
+    double minTimeMs = std::numeric_limits<double>::max();
+    double sumTimeMs = 0.0;
+    for (int run = 0; run < numRuns; run++) {
+        auto startTime = std::chrono::steady_clock::now();
+        stageFunction();
+        auto endTime = std::chrono::steady_clock::now();
+        double timeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        minTimeMs = std::min(minTimeMs, timeMs);
+        sumTimeMs += timeMs;
+    }
+
+    BenchmarkStageResult result;
+    result.meshName = meshName;
+    result.stageName = stageName;
+    result.numCells = numCells;
+    result.numRepetitions = numRuns;
+    result.minTimeMs = minTimeMs;
+    result.meanTimeMs = sumTimeMs / double(numRuns);
+    result.cellsPerSecond = minTimeMs > 0.0 ? double(numCells) / (minTimeMs * 1e-3) : 0.0;
+    result.peakRssBytes = getPeakResidentSetSizeBytes();
+    results.push_back(result);
+
+    sgl::Logfile::get()->writeInfo(
+            std::string() + "Stage '" + stageName + "' (" + meshName + "): " + std::to_string(minTimeMs) + "ms, "
+            + std::to_string(result.peakRssBytes / (1024 * 1024)) + "MiB peak RSS"
+            + (peakRssReset ? "" : " (since program start)"));
+}
+
+void BenchmarkRunner::addStageResult(
+        const std::string& meshName, const std::string& stageName, size_t numCells, double timeMs) {
+    BenchmarkStageResult result;
+    result.meshName = meshName;
+    result.stageName = stageName;
+    result.numCells = numCells;
+    result.numRepetitions = 1;
+    result.minTimeMs = timeMs;
+    result.meanTimeMs = timeMs;
+    result.cellsPerSecond = timeMs > 0.0 ? double(numCells) / (timeMs * 1e-3) : 0.0;
+    results.push_back(result);
+
+    sgl::Logfile::get()->writeInfo(
+            std::string() + "Stage '" + stageName + "' (" + meshName + "): " + std::to_string(timeMs) + "ms");
+}
+
+bool BenchmarkRunner::writeCsv(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        sgl::Logfile::get()->writeError(
+                std::string() + "Error in BenchmarkRunner::writeCsv: Couldn't open file \"" + filename + "\".");
+        return false;
+    }
+    writeCsv(file);
+    return file.good();
+}
+
+void BenchmarkRunner::writeCsv(std::ostream& stream) const {
+    stream << "mesh,stage,num_cells,repetitions,min_time_ms,mean_time_ms,cells_per_second,peak_rss_bytes\n";
+    stream << std::setprecision(10);
+    for (const BenchmarkStageResult& result : results) {
+        stream << result.meshName << ',' << result.stageName << ',' << result.numCells << ','
+               << result.numRepetitions << ',' << result.minTimeMs << ',' << result.meanTimeMs << ','
+               << result.cellsPerSecond << ',' << result.peakRssBytes << '\n';
+    }
+    stream.flush();
+}
+
+uint64_t BenchmarkRunner::getPeakResidentSetSizeBytes() {
+#if defined(__linux__)
+    // VmHWM is the peak resident set size, which can be reset (in contrast to ru_maxrss).
+    std::ifstream statusFile("/proc/self/status");
+    std::string line;
+    while (std::getline(statusFile, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return uint64_t(std::stoull(line.substr(6))) * 1024ull;
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return uint64_t(usage.ru_maxrss);
+#else
+        return uint64_t(usage.ru_maxrss) * 1024ull;
+#endif
+    }
+#endif
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memoryCounters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters))) {
+        return uint64_t(memoryCounters.PeakWorkingSetSize);
+    }
+#endif
+    return 0;
+}
+
+bool BenchmarkRunner::resetPeakResidentSetSize() {
+#if defined(__linux__)
+    // Writing "5" to clear_refs resets the peak resident set size (Linux 4.0 and newer).
+    std::ofstream clearRefsFile("/proc/self/clear_refs");
+    if (clearRefsFile.is_open()) {
+        clearRefsFile << "5";
+        clearRefsFile.close();
+        return !clearRefsFile.fail();
+    }
+#endif
+    return false;
+}
@@ -0,0 +1,107 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_BENCHMARKRUNNER_HPP
+#define HEXVOLUMERENDERER_BENCHMARKRUNNER_HPP
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * The measured data of one benchmark stage.
+ */
+struct BenchmarkStageResult {
+    std::string meshName;
+    std::string stageName;
+    size_t numCells = 0;
+    int numRepetitions = 0;
+    double minTimeMs = 0.0;
+    double meanTimeMs = 0.0;
+    /// Throughput based on the minimum time.
+    double cellsPerSecond = 0.0;
+    /// Peak resident set size during the stage (or since program start if it can't be reset, see below).
+    uint64_t peakRssBytes = 0;
+};
+
+/**
+ * Runs the CPU stages of the hexahedral mesh processing pipeline and records their wall time, throughput and peak
+ * resident set size. The results are written as comma-separated values.
+ *
+ * On Linux, the peak resident set size is reset before each stage using /proc/self/clear_refs, so the value is the
+ * peak of the stage. On other systems, the peak since program start is reported.
+ */
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(int numRepetitions = 1) : numRepetitions(numRepetitions) {}
+
+    /**
+     * Runs a stage and stores its measurements.
+     * @param meshName The name of the mesh the stage is run on.
+     * @param stageName The name of the stage.
+     * @param numCells The number of cells of the mesh (used for computing the throughput).
+     * @param stageFunction The stage to run.
+     * @param repeatable Whether the stage may be run multiple times. Stages changing the state of the following stages
+     * (e.g., loading the mesh) should be run only once.
+     */
+    void runStage(
+            const std::string& meshName, const std::string& stageName, size_t numCells,
+            std::function<void()> stageFunction, bool repeatable = true);
+
+    /**
+     * Stores the time of a stage measured elsewhere (e.g., a sub-stage of a stage run with @see runStage).
+     * The peak resident set size of the stage is unknown and stored as zero.
+     */
+    void addStageResult(const std::string& meshName, const std::string& stageName, size_t numCells, double timeMs);
+
+    inline const std::vector<BenchmarkStageResult>& getResults() const { return results; }
+
+    /**
+     * Writes all results to a CSV file.
+     * @param filename The name of the CSV file.
+     * @return Whether the file could be written.
+     */
+    bool writeCsv(const std::string& filename) const;
+
+    /// Writes all results in CSV format to the passed stream.
+    void writeCsv(std::ostream& stream) const;
+
+    /// Returns the current peak resident set size of the process.
+    static uint64_t getPeakResidentSetSizeBytes();
+    /// Resets the peak resident set size of the process if the operating system supports it.
+    static bool resetPeakResidentSetSize();
+
+private:
+    int numRepetitions;
+    std::vector<BenchmarkStageResult> results;
+};
+
+#endif //HEXVOLUMERENDERER_BENCHMARKRUNNER_HPP
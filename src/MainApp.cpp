@@ -55,10 +55,12 @@
 #include "Widgets/DataView.hpp"
 
 #include "Mesh/HexMesh/Loaders/VtkLoader.hpp"
+#include "Mesh/HexMesh/Loaders/VtuLoader.hpp"
 #include "Mesh/HexMesh/Loaders/MeshLoader.hpp"
 #include "Mesh/HexMesh/Loaders/DatLoader.hpp"
 #include "Mesh/HexMesh/Loaders/HexaLabDatasets.hpp"
 #include "Mesh/HexMesh/Loaders/DegStressLoader.hpp"
+#include "Mesh/HexMesh/Loaders/BinaryMeshCache.hpp"
 #include "Mesh/Filters/PlaneFilter.hpp"
 #include "Mesh/Filters/PeelingFilter.hpp"
 #include "Mesh/Filters/QualityFilter.hpp"
@@ -102,7 +104,7 @@ MainApp::MainApp()
 #endif
           sceneData(
                   &sceneFramebuffer, &sceneTexture, &sceneDepthRBO, camera, clearColor, performanceMeasurer,
-                  recording, useCameraFlight, *rayMeshIntersection)
+                  recording, useCameraFlight, *rayMeshIntersection, visualizationMappingCache)
 #ifdef USE_PYTHON
         , replayWidget(sceneData, transferFunctionWindow, checkpointWindow)
 #endif
@@ -233,12 +235,14 @@ MainApp::MainApp()
     changeQualityMeasureType();
 
     meshLoaderMap.insert(std::make_pair("vtk", new VtkLoader));
+    meshLoaderMap.insert(std::make_pair("vtu", new VtuLoader));
     meshLoaderMap.insert(std::make_pair("mesh", new MeshLoader));
     meshLoaderMap.insert(std::make_pair("dat", new DatCartesianGridLoader));
     meshLoaderMap.insert(std::make_pair("degStress", new DegStressLoader));
     meshFilters.push_back(new PlaneFilter);
     meshFilters.push_back(new PeelingFilter);
     meshFilters.push_back(new QualityFilter);
+    meshCacheDirectory = sgl::AppSettings::get()->getDataDirectory() + "MeshCache/";
 
     if (usePerformanceMeasurementMode) {
         useCameraFlight = true;
@@ -879,6 +883,8 @@ void MainApp::renderFileSelectionSettingsGui() {
         }
     }
 
+    ImGui::Checkbox("Use Binary Mesh Cache", &useBinaryMeshCache);
+
     // Assume deformed meshes only in source at index 2 for now (don't clutter the UI for other sources).
     if (getFileSourceContainsDeformationMeshes()) {
         if (ImGui::SliderFloat("deformationFactor", &deformationFactor, 0.0f, 1.0f)) {
@@ -937,6 +943,9 @@ void MainApp::renderSceneSettingsGui() {
         setRenderers();
         reRender = true;
     }
+    if (ImGui::SliderInt("Mapping Cache (MiB)", &visualizationMappingCacheBudgetMiB, 0, 4096)) {
+        visualizationMappingCache.setMemoryBudget(size_t(visualizationMappingCacheBudgetMiB) << 20u);
+    }
 
     // Switch importance criterion
     if (ImGui::Combo(
@@ -945,6 +954,17 @@ void MainApp::renderSceneSettingsGui() {
         changeQualityMeasureType();
         reRender = true;
     }
+    if (ImGui::Checkbox("Precompute All Quality Measures", &precomputeAllQualityMeasures)) {
+        if (inputData) {
+            inputData->setPrecomputeAllQualityMeasures(precomputeAllQualityMeasures);
+        }
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip(
+                "Stores the normalized qualities of all measures as half floats for switching without recomputation.\n"
+                "The values are quantized (steps of about 5e-4 close to 1), so the cells kept by the quality\n"
+                "filter at a given threshold may differ slightly.");
+    }
 
     SciVisApp::renderSceneSettingsGuiPost();
 }
@@ -1049,6 +1069,7 @@ void MainApp::update(float dt) {
 
 bool MainApp::checkHasValidExtension(const std::string& filenameLower) {
     if (sgl::endsWith(filenameLower, ".vtk")
+            || sgl::endsWith(filenameLower, ".vtu")
             || sgl::endsWith(filenameLower, ".mesh")
             || sgl::endsWith(filenameLower, ".dat")
             || sgl::endsWith(filenameLower, ".degStress")) {
@@ -1168,8 +1189,24 @@ void MainApp::loadHexahedralMesh(const std::string &fileName) {
     hexMeshCellIndices.clear();
     hexMeshDeformations.clear();
     hexMeshAttributeList.clear();
+    // The cached visualization mappings can't be reused for the new mesh.
+    visualizationMappingCache.clear();
     bool isPerVertexData = true;
-    bool loadingSuccessful = it->second->loadHexahedralMeshFromFile(
+
+    // Try to skip parsing and the connectivity computation by using the binary mesh cache.
+    BinaryMeshCache meshCache;
+    HexBinSourceKey meshSourceKey;
+    std::string meshCacheFilename;
+    bool loadedFromMeshCache = false;
+    if (useBinaryMeshCache && BinaryMeshCache::computeSourceKey(fileName, meshSourceKey)) {
+        meshCacheFilename = BinaryMeshCache::getCacheFilename(fileName, meshCacheDirectory);
+        if (meshCache.open(meshCacheFilename, meshSourceKey)) {
+            loadedFromMeshCache = meshCache.readMeshData(
+                    hexMeshVertices, hexMeshCellIndices, hexMeshDeformations, hexMeshAttributeList, isPerVertexData);
+        }
+    }
+
+    bool loadingSuccessful = loadedFromMeshCache || it->second->loadHexahedralMeshFromFile(
             fileName, hexMeshVertices, hexMeshCellIndices, hexMeshDeformations,
             hexMeshAttributeList, isPerVertexData);
     if (loadingSuccessful) {
@@ -1203,10 +1240,29 @@ void MainApp::loadHexahedralMesh(const std::string &fileName) {
         }
 
         inputData = HexMeshPtr(new HexMesh(transferFunctionWindow, *rayMeshIntersection));
+        if (useBinaryMeshCache) {
+            inputData->setBaseComplexCacheDirectory(meshCacheDirectory);
+        }
         bool loadMeshRepresentation =
                 renderingMode != RENDERING_MODE_PSEUDO_VOLUME && renderingMode != RENDERING_MODE_DEPTH_COMPLEXITY;
-        inputData->setHexMeshData(vertices, hexMeshCellIndices, loadMeshRepresentation);
+        inputData->setHexMeshData(
+                vertices, hexMeshCellIndices, loadMeshRepresentation, loadedFromMeshCache ? &meshCache : nullptr);
+        inputData->setPrecomputeAllQualityMeasures(precomputeAllQualityMeasures);
         inputData->setQualityMeasure(selectedQualityMeasure);
+
+        // (Re-)write the cache if it is missing, outdated or lacks the connectivity data.
+        bool hasMeshConnectivity = inputData->isBaseComplexMeshLoaded();
+        if (!meshCacheFilename.empty()
+                && (!loadedFromMeshCache || (hasMeshConnectivity && !meshCache.getHasConnectivity()))) {
+            meshCache.close();
+            sgl::FileUtils::get()->ensureDirectoryExists(meshCacheDirectory);
+            BinaryMeshCache::save(
+                    meshCacheFilename, meshSourceKey, hexMeshVertices, hexMeshCellIndices, hexMeshDeformations,
+                    hexMeshAttributeList, isPerVertexData,
+                    hasMeshConnectivity ? &inputData->getBaseComplexMesh() : nullptr,
+                    hasMeshConnectivity ? &inputData->getBaseComplexMeshSingularity() : nullptr);
+        }
+        meshCache.close();
         MeshSourceDescription sourceDescription;
         std::vector<std::string> dataAdditionalFiles;
         if (selectedMeshIndex != 0) {
@@ -1352,6 +1408,10 @@ void MainApp::prepareVisualizationPipeline() {
 
 HexMeshPtr MainApp::getFilteredMesh(bool& isDirty) {
     HexMeshPtr filteredMesh = inputData;
+    // The dirty flag of the input mesh is also set by filter mask changes, so use the data generation instead.
+    bool isInputDirty = inputData->getMeshDataGeneration() != filterInputMeshDataGeneration;
+    filterInputMeshDataGeneration = inputData->getMeshDataGeneration();
+    isDirty = isDirty || isInputDirty;
 
     // Test if we need to re-run the filters.
     for (HexahedralMeshFilter* meshFilter : meshFilters) {
@@ -1365,15 +1425,23 @@ HexMeshPtr MainApp::getFilteredMesh(bool& isDirty) {
     }
 
     if (isDirty) {
-        filteredMesh->unmark();
-        // Pass the output of each filter to the next filter.
+        // Only the dirty filters need to update their cached masks (or all filters if the input mesh changed).
+        std::vector<const CellMask*> filterMasks;
         for (HexahedralMeshFilter* meshFilter : meshFilters) {
             if (!meshFilter->isEnabled()) {
                 continue;
             }
-            meshFilter->filterMesh(filteredMesh);
-            filteredMesh = meshFilter->getOutput();
+            if (isInputDirty) {
+                meshFilter->onInputMeshChanged(filteredMesh);
+            }
+            if (isInputDirty || meshFilter->isDirty()
+                    || meshFilter->getFilterMask().size() != filteredMesh->getNumCells()) {
+                meshFilter->filterMesh(filteredMesh);
+                filteredMesh = meshFilter->getOutput();
+            }
+            filterMasks.push_back(&meshFilter->getFilterMask());
         }
+        filteredMesh->setCellFilteringMasks(filterMasks);
     }
 
     return filteredMesh;
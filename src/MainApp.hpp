@@ -47,6 +47,7 @@
 #include "Mesh/Filters/HexahedralMeshFilter.hpp"
 #include "Mesh/HexMesh/Renderers/SceneData.hpp"
 #include "Mesh/HexMesh/Renderers/HexahedralMeshRenderer.hpp"
+#include "Mesh/HexMesh/Renderers/Helpers/VisualizationMappingCache.hpp"
 #include "Utils/AutomaticPerformanceMeasurer.hpp"
 
 #ifdef USE_PYTHON
@@ -107,6 +108,8 @@ private:
 
     /// Scene data (e.g., camera, main framebuffer, ...).
     RayMeshIntersection* rayMeshIntersection;
+    VisualizationMappingCache visualizationMappingCache;
+    int visualizationMappingCacheBudgetMiB = int(VisualizationMappingCache::DEFAULT_MEMORY_BUDGET >> 20u);
     SceneData sceneData;
 
     // This setting lets all data views use the same viewport resolution.
@@ -134,9 +137,14 @@ private:
     std::string loadedMeshFilename;
     std::string customMeshFileName;
     float deformationFactor = 0.0f;
+    /// Loaded meshes are cached in a binary format (.hexbin) including their connectivity (see BinaryMeshCache.hpp).
+    bool useBinaryMeshCache = true;
+    std::string meshCacheDirectory;
 
     // Coloring & filtering dependent on importance criteria.
     QualityMeasure selectedQualityMeasure;
+    /// Computes all quality measures at once when loading a mesh for switching between them without recomputation.
+    bool precomputeAllQualityMeasures = false;
     sgl::TransferFunctionWindow transferFunctionWindow;
 
     // Color legend widgets for different attributes.
@@ -201,6 +209,8 @@ private:
 
     /// A list of filters that are applied sequentially on the data.
     std::vector<HexahedralMeshFilter*> meshFilters;
+    /// The data generation of the input mesh the filters were last run on (see HexMesh::getMeshDataGeneration).
+    uint64_t filterInputMeshDataGeneration = 0;
     /// A list of rendering methods that use the output of the concatenation of all mesh filters for rendering.
     std::vector<HexahedralMeshRenderer*> meshRenderers;
 
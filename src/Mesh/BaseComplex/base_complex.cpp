@@ -10,118 +10,174 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <atomic>
+#include <chrono>
 #include "base_complex.h"
 
 
+namespace {
+const uint32_t REGULAR_E = (uint32_t)-1;
+//lock-free union-find. Roots are always linked below smaller roots, so the root of a set is its smallest element.
+uint32_t find_set_root(vector<std::atomic<uint32_t>> &parents, uint32_t e) {
+	while (true) {
+		uint32_t p = parents[e].load();
+		if (p == e) return e;
+		uint32_t gp = parents[p].load();
+		if (p != gp) parents[e].compare_exchange_weak(p, gp);//path halving
+		e = gp;
+	}
+}
+void unite_sets(vector<std::atomic<uint32_t>> &parents, uint32_t e0, uint32_t e1) {
+	while (true) {
+		e0 = find_set_root(parents, e0); e1 = find_set_root(parents, e1);
+		if (e0 == e1) return;
+		if (e0 < e1) std::swap(e0, e1);
+		uint32_t expected = e0;
+		if (parents[e0].compare_exchange_strong(expected, e1)) return;
+	}
+}
+//the other singular edge of a vertex a singular edge chain passes through.
+uint32_t next_singular_edge(const Mesh &mesh, const vector<uint32_t> &e_types, uint32_t vid, uint32_t eid) {
+	const Adjacency_List &nes = mesh.Vs[vid].neighbor_es;
+	for (uint32_t j = 0; j < nes.size(); j++) if (nes[j] != eid && e_types[nes[j]] != REGULAR_E) return nes[j];
+	return eid;
+}
+//singular edge chain traced from its smallest edge id, before the singular vertices are assigned.
+struct Singular_Chain {
+	Singular_E se;
+	uint32_t v_left, v_right;
+	bool is_circle;
+};
+//returns the milliseconds since start and restarts the measurement.
+double lap_time_ms(std::chrono::steady_clock::time_point &start) {
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	double time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+	start = end;
+	return time_ms;
+}
+}
 void base_complex::singularity_structure(Singularity &si, Mesh &mesh){
 	si.SVs.clear(); si.SEs.clear();
 
 	uint32_t INVALID_V = (uint32_t)-1;
-	uint32_t INVALID_E = (uint32_t)-1;
-	std::vector<uint32_t> V_flag(mesh.Vs.size(), INVALID_V), E_flag(mesh.Es.size(),false);
+	int32_t V_num = int32_t(mesh.Vs.size()), E_num = int32_t(mesh.Es.size());
+	std::vector<uint32_t> V_flag(mesh.Vs.size(), INVALID_V);
 
 	for (auto &v : mesh.Vs) { v.fvid = -1; v.svid = -1; }
-	
-	uint32_t SV_count = 0, SE_count = 0;
-	vector<Singular_E> circle_ses;//circular singular edges
-
-	for (int i = 0; i < mesh.Es.size(); i++) {
-		if (E_flag[i]) continue;
-
-		if ((!mesh.Es[i].boundary && mesh.Es[i].neighbor_hs.size() == Interior_RegularE) ||
-			(mesh.Es[i].boundary && mesh.Es[i].neighbor_hs.size() == Boundary_RegularE))
-			continue;//non-singular e-->continue;
-		
-		std::function<bool(uint32_t, uint32_t, uint32_t &)> singular_proceed = [&](uint32_t vid, uint32_t eid, uint32_t &neid)->bool {
-			uint32_t num1 = 0, num2 = 0;
-			for (uint32_t j = 0; j<mesh.Vs[vid].neighbor_es.size(); j++){
-				uint32_t cur_e = mesh.Vs[vid].neighbor_es[j];
-				if (cur_e == eid) continue;
-				if ((!mesh.Es[cur_e].boundary && mesh.Es[cur_e].neighbor_hs.size() != Interior_RegularE) ||
-					(mesh.Es[cur_e].boundary && mesh.Es[cur_e].neighbor_hs.size() != Boundary_RegularE))
-					num1++;
-
-				if (mesh.Es[cur_e].boundary == mesh.Es[eid].boundary&&mesh.Es[cur_e].neighbor_hs.size() == mesh.Es[eid].neighbor_hs.size()){
-					num2++; neid = cur_e;
-				}
-			}
-			if (num1 == 1 && num2 == 1)
-				return true;
-			return false;
-		};
+
+	//classify the edges: the type of a singular edge is its valence and boundary flag, regular edges get REGULAR_E.
+	vector<uint32_t> e_types(mesh.Es.size());
+	vector<std::atomic<uint32_t>> parents(mesh.Es.size());
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(mesh, e_types, parents, E_num)
+#endif
+	for (int32_t i = 0; i < E_num; i++) {
+		const Hybrid_E &e = mesh.Es[i];
+		bool regular = (!e.boundary && e.neighbor_hs.size() == Interior_RegularE) ||
+			(e.boundary && e.neighbor_hs.size() == Boundary_RegularE);
+		e_types[i] = regular ? REGULAR_E : (uint32_t(e.neighbor_hs.size()) << 1u) | uint32_t(e.boundary);
+		parents[i].store(uint32_t(i));
+	}
+
+	//a chain passes through a vertex iff it has exactly two singular edges and both are of the same type.
+	//The two edges of every such vertex belong to the same chain.
+	vector<char> v_pass(mesh.Vs.size(), 0);
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(mesh, e_types, parents, v_pass, V_num)
+#endif
+	for (int32_t i = 0; i < V_num; i++) {
+		const Adjacency_List &nes = mesh.Vs[i].neighbor_es;
+		uint32_t ses[2], num_ses = 0;
+		for (uint32_t j = 0; j < nes.size(); j++) {
+			if (e_types[nes[j]] == REGULAR_E) continue;
+			if (num_ses < 2) ses[num_ses] = nes[j];
+			num_ses++;
+		}
+		if (num_ses != 2 || e_types[ses[0]] != e_types[ses[1]]) continue;
+		v_pass[i] = 1;
+		unite_sets(parents, ses[0], ses[1]);
+	}
+
+	//the roots are the smallest edge ids of the chains, i.e., the edges the chains are traced from.
+	vector<uint32_t> seeds;
+	for (uint32_t i = 0; i < mesh.Es.size(); i++) if (e_types[i] != REGULAR_E && parents[i].load() == i) seeds.push_back(i);
+
+	int32_t seeds_num = int32_t(seeds.size());
+	vector<Singular_Chain> chains(seeds.size());
+#if _OPENMP >= 201107
+	#pragma omp parallel for schedule(dynamic, 16) default(none) shared(mesh, e_types, v_pass, seeds, chains, seeds_num)
+#endif
+	for (int32_t c = 0; c < seeds_num; c++) {
+		uint32_t i = seeds[c];
+		Singular_Chain &chain = chains[c];
+		Singular_E &se = chain.se;
 		uint32_t v_left = mesh.Es[i].vs[0], v_right = mesh.Es[i].vs[1];
-		uint32_t sv_left, sv_right;
-		std::vector<uint32_t> vs_left, vs_right, es_left, es_right;
-		
-		bool is_circle = false;
-		//left 
-		es_left.push_back(i); vs_left.push_back(v_left);
-		uint32_t cur_e = i, next_e = INVALID_E;
-		while (singular_proceed(v_left, cur_e, next_e)) {
-			cur_e = next_e;
-			if (cur_e == i){ is_circle = true; break; }
-			es_left.push_back(next_e);
+		std::vector<uint32_t> vs_right, es_right;
+
+		chain.is_circle = false;
+		//left
+		se.es_link.push_back(i); se.vs_link.push_back(v_left);
+		uint32_t cur_e = i;
+		while (v_pass[v_left]) {
+			cur_e = next_singular_edge(mesh, e_types, v_left, cur_e);
+			if (cur_e == i){ chain.is_circle = true; break; }
+			se.es_link.push_back(cur_e);
 			if (mesh.Es[cur_e].vs[0] == v_left) v_left = mesh.Es[cur_e].vs[1]; else v_left = mesh.Es[cur_e].vs[0];
-			vs_left.push_back(v_left);
+			se.vs_link.push_back(v_left);
 		}
-
-		if (is_circle){
-			Singular_E se; se.id = si.SEs.size();
+		se.boundary = mesh.Es[i].boundary;
+		chain.v_left = v_left;
+		if (chain.is_circle) {
 			se.circle = true;
-			se.es_link = es_left; se.vs_link = vs_left;
-			for(uint32_t j=0;j<se.es_link.size();j++) E_flag[se.es_link[j]] = true;
-			se.boundary = mesh.Es[i].boundary;
-			si.SEs.push_back(se);
-			circle_ses.push_back(se);
 			continue;
 		}
-
-		sv_left = V_flag[v_left];
-		if (V_flag[v_left] == INVALID_V) {
-			sv_left = si.SVs.size(); V_flag[v_left] = sv_left;
-			Singular_V sv; sv.fake = false;
-			sv.id = sv_left;
-			sv.hid = v_left;
-			sv.boundary = mesh.Vs[v_left].boundary;
-			si.SVs.push_back(sv);
-		}
 		//right
 		vs_right.push_back(v_right);
-		cur_e = i, next_e = INVALID_E;
-		while (singular_proceed(v_right, cur_e, next_e)) {
-			cur_e = next_e;
+		cur_e = i;
+		while (v_pass[v_right]) {
+			cur_e = next_singular_edge(mesh, e_types, v_right, cur_e);
 			if (mesh.Es[cur_e].vs[0] == v_right) v_right = mesh.Es[cur_e].vs[1]; else v_right = mesh.Es[cur_e].vs[0];
 			vs_right.push_back(v_right);
-			es_right.push_back(next_e);
+			es_right.push_back(cur_e);
 		}
-		sv_right = V_flag[v_right];
-		if (V_flag[v_right] == INVALID_V) {
-			sv_right = si.SVs.size(); V_flag[v_right] = sv_right;
-			Singular_V sv; sv.fake = false;
-			sv.id = sv_right;
-			sv.hid = v_right;
-			sv.boundary = mesh.Vs[v_right].boundary;
-			si.SVs.push_back(sv);
+		chain.v_right = v_right;
+		se.circle = false;
+		std::reverse(se.vs_link.begin(), se.vs_link.end());
+		se.vs_link.insert(se.vs_link.end(), vs_right.begin(), vs_right.end());
+		std::reverse(se.es_link.begin(), se.es_link.end());
+		se.es_link.insert(se.es_link.end(), es_right.begin(), es_right.end());
+	}
+
+	//assign the singular vertices in the order of the chains (left end before right end).
+	si.SEs.resize(chains.size());
+	for (uint32_t c = 0; c < chains.size(); c++) {
+		Singular_Chain &chain = chains[c];
+		Singular_E &se = si.SEs[c];
+		se = std::move(chain.se);
+		se.id = c;
+		if (chain.is_circle) continue;
+
+		uint32_t sv_ends[2];
+		uint32_t v_ends[2] = { chain.v_left, chain.v_right };
+		for (int j = 0; j < 2; j++) {
+			sv_ends[j] = V_flag[v_ends[j]];
+			if (V_flag[v_ends[j]] == INVALID_V) {
+				sv_ends[j] = si.SVs.size(); V_flag[v_ends[j]] = sv_ends[j];
+				Singular_V sv; sv.fake = false;
+				sv.id = sv_ends[j];
+				sv.hid = v_ends[j];
+				sv.boundary = mesh.Vs[v_ends[j]].boundary;
+				si.SVs.push_back(sv);
+			}
 		}
-		//se
-		Singular_E se; se.id = si.SEs.size(); se.circle = false;
-		std::reverse(vs_left.begin(), vs_left.end());
-		se.vs_link = vs_left; se.vs_link.insert(se.vs_link.end(), vs_right.begin(), vs_right.end());
-		std::reverse(es_left.begin(), es_left.end());
-		se.es_link = es_left; se.es_link.insert(se.es_link.end(), es_right.begin(), es_right.end());
-		for (uint32_t j = 0; j<se.es_link.size(); j++) E_flag[se.es_link[j]] = true;
-		se.boundary = mesh.Es[i].boundary;
-		
-		if (sv_left == sv_right) {
-			se.vs.resize(1); se.vs[0] = sv_left;
+		if (sv_ends[0] == sv_ends[1]) {
+			se.vs.resize(1); se.vs[0] = sv_ends[0];
 			se.vs_link.erase(se.vs_link.begin() + se.vs_link.size() - 1);
 			se.circle = true;
-			circle_ses.push_back(se);
 		}
 		else {
-			se.vs.resize(2); se.vs[0] = sv_left; se.vs[1] = sv_right;
+			se.vs.resize(2); se.vs[0] = sv_ends[0]; se.vs[1] = sv_ends[1];
 		}
-		si.SEs.push_back(se);
 	}
 
 	for (auto sv : si.SVs) mesh.Vs[sv.hid].svid = sv.id;
@@ -129,12 +185,18 @@ void base_complex::singularity_structure(Singularity &si, Mesh &mesh){
 bool base_complex::base_complex_extraction(Singularity &si, Frame &frame, Mesh &mesh) {
 	frame.FVs.clear(); frame.FEs.clear(); frame.FFs.clear(); frame.FHs.clear();
 
+	timings = Base_Complex_Timings();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 	base_complex_node_edge_extraction(si, frame,mesh);
+	timings.node_edge_ms = lap_time_ms(start);
 	if(!base_complex_face_extraction(si, frame, mesh)) return false;
+	timings.face_ms = lap_time_ms(start);
 	base_complex_cuboid_extraction(si, frame, mesh);
+	timings.cuboid_ms = lap_time_ms(start);
 
 	singularity_base_complex(si, frame, mesh);
 	assign_color(frame);
+	timings.singularity_color_ms = lap_time_ms(start);
 
 	return true;
 }
@@ -483,67 +545,116 @@ void base_complex::node_on_circular_singularity(Singularity &si, Frame &frame, M
 	std::sort(Nodes.begin(), Nodes.end());
 	Nodes.erase(std::unique(Nodes.begin(), Nodes.end()), Nodes.end());
 }
+namespace {
+//flood fills the face patch of the frame edge fe_id from the mesh face fid. Faces with f_flag != INVALID_F belong to
+//patches found before, the faces of the current patch are marked in in_patch (one bit per mesh face). Only the faces
+//in ff.ffs_net are marked, so they are unmarked again at the end instead of clearing the whole array.
+void trace_frame_face(const Mesh &mesh, const vector<uint32_t> &e_tag, const vector<uint32_t> &f_flag,
+	vector<bool> &in_patch, uint32_t INVALID_E, uint32_t fe_id, uint32_t fid, Frame_F &ff)
+{
+	uint32_t INVALID_F = mesh.Fs.size();
+	if (in_patch.size() != mesh.Fs.size()) in_patch.assign(mesh.Fs.size(), false);
+	ff.boundary = mesh.Fs[fid].boundary;
+	ff.es.push_back(fe_id);
+
+	std::queue<uint32_t> f_pool; f_pool.push(fid);
+	while (!f_pool.empty()) {
+		fid = f_pool.front(); f_pool.pop();
+		if (f_flag[fid] != INVALID_F || in_patch[fid]) continue;
+		in_patch[fid] = true;
+		ff.ffs_net.push_back(fid);
+
+		for (uint32_t k = 0; k < 4; k++) {
+			uint32_t feid = mesh.Fs[fid].es[k];
+			if (e_tag[feid] != INVALID_E) {
+				if (std::find(ff.es.begin(), ff.es.end(), e_tag[feid]) == ff.es.end()) ff.es.push_back(e_tag[feid]);
+				continue;
+			}
+			for (uint32_t m = 0; m < mesh.Es[feid].neighbor_fs.size(); m++) {
+				uint32_t enfid = mesh.Es[feid].neighbor_fs[m];
+				if (in_patch[enfid] || f_flag[enfid] != INVALID_F) continue;
+				bool pass = true;
+				for (uint32_t n = 0; n < mesh.Fs[enfid].neighbor_hs.size(); n++) {
+					uint32_t fnhid = mesh.Fs[enfid].neighbor_hs[n];
+					for (uint32_t p = 0; p < 6; p++) {
+						uint32_t cur_fid = mesh.Hs[fnhid].fs[p];
+						if (in_patch[cur_fid]) { pass = false; break; }
+					}
+					if (!pass) break;
+				}
+				if (pass) f_pool.push(enfid);
+			}
+		}
+	}
+	for (uint32_t f : ff.ffs_net) in_patch[f] = false;
+}
+}
 bool base_complex::base_complex_face_extraction(Singularity &si, Frame &frame, Mesh &mesh)
 {
 	frame.FFs.clear();
-	uint32_t INVALID_E = frame.FEs.size(), INVALID_F = mesh.Fs.size();
+	uint32_t INVALID_E = frame.FEs.size(), INVALID_F = mesh.Fs.size(), INVALID_S = (uint32_t)-1;
 	std::vector<uint32_t> e_tag(mesh.Es.size(), INVALID_E);
 	for (uint32_t i = 0; i < frame.FEs.size(); i++) 
 		for (uint32_t j = 0; j < frame.FEs[i].es_link.size(); j++) e_tag[frame.FEs[i].es_link[j]] = i;
 	std::vector<uint32_t> f_flag(mesh.Fs.size(), INVALID_F);
-	std::vector<bool> fe_flag(frame.FEs.size(), false);
-	
+
+	//the patches are flood filled from the faces around the first mesh edge of every frame edge.
+	std::vector<std::pair<uint32_t, uint32_t>> seeds;
 	for (uint32_t i = 0; i < frame.FEs.size(); i++) {
 		uint32_t eid = frame.FEs[i].es_link[0];
-		for (uint32_t j = 0; j < mesh.Es[eid].neighbor_fs.size(); j++) {
-			uint32_t fid = mesh.Es[eid].neighbor_fs[j];
-			if (f_flag[fid] != INVALID_F) continue;
-
-			Frame_F ff; ff.id = frame.FFs.size();
-			ff.boundary = mesh.Fs[fid].boundary;
-			ff.es.push_back(i); fe_flag[i] = true;
-
-			std::queue<uint32_t> f_pool; f_pool.push(fid);
-			while (!f_pool.empty()) {
-				fid = f_pool.front(); f_pool.pop();
-				if (f_flag[fid] != INVALID_F) continue;
-				f_flag[fid] = ff.id;
-				ff.ffs_net.push_back(fid);
-
-				for (uint32_t k = 0; k < 4; k++) {
-					uint32_t feid = mesh.Fs[fid].es[k];
-					if (e_tag[feid] != INVALID_E) { 
-						if (!fe_flag[e_tag[feid]]) {
-							fe_flag[e_tag[feid]] = true;
-							ff.es.push_back(e_tag[feid]);
-						}
-						continue; 
-					}
-					for (uint32_t m = 0; m < mesh.Es[feid].neighbor_fs.size(); m++) {
-						uint32_t enfid = mesh.Es[feid].neighbor_fs[m];
-						if (f_flag[enfid] != INVALID_F) continue;
-						bool pass = true;
-						for (uint32_t n = 0; n < mesh.Fs[enfid].neighbor_hs.size(); n++) {
-							uint32_t fnhid = mesh.Fs[enfid].neighbor_hs[n];
-							for (uint32_t p = 0; p < 6; p++) {
-								uint32_t cur_fid = mesh.Hs[fnhid].fs[p];
-								if (f_flag[cur_fid] == ff.id) { pass = false; break; }
-							}
-							if (!pass) break;
-						}
-						if (pass) f_pool.push(enfid);
-					}
-				}
+		for (uint32_t j = 0; j < mesh.Es[eid].neighbor_fs.size(); j++) seeds.push_back(std::make_pair(i, mesh.Es[eid].neighbor_fs[j]));
+	}
+
+	//the patches of all seeds are flood filled in parallel, assuming that they don't overlap with the patches of the
+	//seeds before them. A seed is skipped if its face is already part of the patch of a smaller seed.
+	int32_t seeds_num = int32_t(seeds.size());
+	std::vector<Frame_F> seed_ffs(seeds.size());
+	std::vector<char> seed_traced(seeds.size(), 0);
+	std::vector<std::atomic<uint32_t>> f_claims(mesh.Fs.size());
+	for (auto &claim : f_claims) claim.store(INVALID_S, std::memory_order_relaxed);
+#if _OPENMP >= 201107
+	#pragma omp parallel default(none) shared(mesh, e_tag, f_flag, seeds, seed_ffs, seed_traced, f_claims, seeds_num, INVALID_E)
+#endif
+	{
+		vector<bool> in_patch;//allocated on the first patch of the thread
+#if _OPENMP >= 201107
+		#pragma omp for schedule(dynamic, 4)
+#endif
+		for (int32_t s = 0; s < seeds_num; s++) {
+			if (f_claims[seeds[s].second].load(std::memory_order_relaxed) < uint32_t(s)) continue;
+			trace_frame_face(mesh, e_tag, f_flag, in_patch, INVALID_E, seeds[s].first, seeds[s].second, seed_ffs[s]);
+			seed_traced[s] = 1;
+			for (uint32_t fid : seed_ffs[s].ffs_net) {
+				uint32_t claim = f_claims[fid].load(std::memory_order_relaxed);
+				while (uint32_t(s) < claim && !f_claims[fid].compare_exchange_weak(claim, uint32_t(s), std::memory_order_relaxed));
 			}
-			frame.FFs.push_back(ff);
-			for (uint32_t k = 0; k < ff.es.size(); k++) fe_flag[ff.es[k]] = false;
 		}
 	}
-	//re-order es
-	for (uint32_t i = 0; i < frame.FFs.size(); i++) {
-
-		if (frame.FFs[i].es.size() != 4) return false;
 
+	//the patches are accepted in the order of the seeds. Patches overlapping with an accepted patch (or not traced
+	//above) are flood filled again, so the result is the same as with a sequential flood fill.
+	vector<bool> in_patch;
+	for (uint32_t s = 0; s < seeds.size(); s++) {
+		if (f_flag[seeds[s].second] != INVALID_F) continue;
+		Frame_F &ff = seed_ffs[s];
+		bool overlaps = !seed_traced[s];
+		for (uint32_t k = 0; k < ff.ffs_net.size() && !overlaps; k++) if (f_flag[ff.ffs_net[k]] != INVALID_F) overlaps = true;
+		if (overlaps) {
+			ff = Frame_F();
+			trace_frame_face(mesh, e_tag, f_flag, in_patch, INVALID_E, seeds[s].first, seeds[s].second, ff);
+		}
+		ff.id = frame.FFs.size();
+		for (uint32_t fid : ff.ffs_net) f_flag[fid] = ff.id;
+		frame.FFs.push_back(std::move(ff));
+	}
+	seed_ffs.clear();
+	//re-order es. Frame faces before the first one that isn't a quad are re-ordered.
+	int32_t ffs_num = 0;
+	while (ffs_num < int32_t(frame.FFs.size()) && frame.FFs[ffs_num].es.size() == 4) ffs_num++;
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(frame, ffs_num)
+#endif
+	for (int32_t i = 0; i < ffs_num; i++) {
 		uint32_t e0 = frame.FFs[i].es[0], e1 = -1, e2 = -1, e3 = -1;
 		uint32_t v0 = frame.FEs[e0].vs[0], v1 = frame.FEs[e0].vs[1], v2 = -1, v3 = -1;
 		//e1, v2
@@ -572,16 +683,17 @@ bool base_complex::base_complex_face_extraction(Singularity &si, Frame &frame, M
 		frame.FFs[i].es[2] = e2;
 		frame.FFs[i].es[3] = e3;
 
-		for (uint32_t j = 0; j < 4; j++) frame.FEs[frame.FFs[i].es[j]].neighbor_ffs.push_back(i);
-
 		frame.FFs[i].vs.resize(4);
 		frame.FFs[i].vs[0] = v0;
 		frame.FFs[i].vs[1] = v1;
 		frame.FFs[i].vs[2] = v2;
 		frame.FFs[i].vs[3] = v3;
-
+	}
+	for (int32_t i = 0; i < ffs_num; i++) {
+		for (uint32_t j = 0; j < 4; j++) frame.FEs[frame.FFs[i].es[j]].neighbor_ffs.push_back(i);
 		for (uint32_t j = 0; j < 4; j++) frame.FVs[frame.FFs[i].vs[j]].neighbor_ffs.push_back(i);
 	}
+	if (ffs_num != int32_t(frame.FFs.size())) return false;
 
 	return true;
 }
@@ -591,16 +703,37 @@ void base_complex::base_complex_cuboid_extraction(Singularity &si, Frame &frame,
 
 	uint32_t INVALID_F = mesh.Fs.size(), INVALID_H=mesh.Hs.size();
 	std::vector<uint32_t> f_flag(mesh.Fs.size(), INVALID_F), h_flag(mesh.Hs.size(), INVALID_H);
-	std::vector<bool> ff_flag(frame.FFs.size(),false);
 
 	for (uint32_t i = 0; i < frame.FFs.size(); i++) for (uint32_t j = 0; j < frame.FFs[i].ffs_net.size(); j++)
 		f_flag[frame.FFs[i].ffs_net[j]] = i;
 
-	while (true) {
-		Frame_H fh; fh.id = frame.FHs.size(); fh.Color_ID = -1;
-		uint32_t start_h = INVALID_H;
-		for (uint32_t i = 0; i < h_flag.size(); i++) if (h_flag[i] == INVALID_H) {start_h = i; break;}
-		if (start_h == INVALID_H) break;
+	//the cuboids are the components of hexes connected by faces not on a frame face. The root of a component is its
+	//smallest hex, i.e., the hex a sequential flood fill would start from.
+	int32_t F_num = int32_t(mesh.Fs.size()), H_num = int32_t(mesh.Hs.size());
+	std::vector<std::atomic<uint32_t>> parents(mesh.Hs.size());
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(parents, H_num)
+#endif
+	for (int32_t i = 0; i < H_num; i++) parents[i].store(uint32_t(i));
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(mesh, f_flag, parents, F_num, INVALID_F)
+#endif
+	for (int32_t i = 0; i < F_num; i++) {
+		if (f_flag[i] != INVALID_F || mesh.Fs[i].neighbor_hs.size() < 2) continue;
+		unite_sets(parents, mesh.Fs[i].neighbor_hs[0], mesh.Fs[i].neighbor_hs[1]);
+	}
+	std::vector<uint32_t> start_hs;
+	for (uint32_t i = 0; i < mesh.Hs.size(); i++) if (parents[i].load() == i) start_hs.push_back(i);
+
+	//the components are disjoint, so they can be flood filled in parallel.
+	int32_t FH_num = int32_t(start_hs.size());
+	frame.FHs.resize(start_hs.size());
+#if _OPENMP >= 201107
+	#pragma omp parallel for schedule(dynamic, 4) default(none) shared(mesh, frame, f_flag, h_flag, start_hs, FH_num, INVALID_F, INVALID_H)
+#endif
+	for (int32_t c = 0; c < FH_num; c++) {
+		Frame_H &fh = frame.FHs[c]; fh.id = c; fh.Color_ID = -1;
+		uint32_t start_h = start_hs[c];
 
 		std::queue<uint32_t> h_pool; h_pool.push(start_h);
 		while (!h_pool.empty()) {
@@ -611,10 +744,7 @@ void base_complex::base_complex_cuboid_extraction(Singularity &si, Frame &frame,
 			for (uint32_t i = 0; i < 6; i++) {
 				uint32_t fid = mesh.Hs[start_h].fs[i];
 				if (f_flag[fid] != INVALID_F) {
-					if (!ff_flag[f_flag[fid]]) {
-						ff_flag[f_flag[fid]] = true;
-						fh.fs.push_back(f_flag[fid]);
-					}
+					if (std::find(fh.fs.begin(), fh.fs.end(), f_flag[fid]) == fh.fs.end()) fh.fs.push_back(f_flag[fid]);
 					continue;
 				}
 				for (uint32_t j = 0; j < mesh.Fs[fid].neighbor_hs.size(); j++) {
@@ -624,11 +754,12 @@ void base_complex::base_complex_cuboid_extraction(Singularity &si, Frame &frame,
 				}
 			}
 		}
-		frame.FHs.push_back(fh);
-		for (uint32_t k = 0; k < fh.fs.size(); k++) ff_flag[fh.fs[k]] = false;
 	}
 
-	for (uint32_t i = 0; i < frame.FHs.size(); i++) {
+#if _OPENMP >= 201107
+	#pragma omp parallel for schedule(dynamic, 16) default(none) shared(frame, FH_num)
+#endif
+	for (int32_t i = 0; i < FH_num; i++) {
 		frame.FHs[i].es.reserve(12);
 		for (uint32_t j = 0; j < frame.FHs[i].fs.size(); j++) {
 			uint32_t fid = frame.FHs[i].fs[j];
@@ -649,13 +780,14 @@ void base_complex::base_complex_cuboid_extraction(Singularity &si, Frame &frame,
 		}
 		vs = frame.FFs[frame.FHs[i].fs[cors_f]].vs;
 		for (uint32_t j = 0; j < 4; j++) {
-			std::vector<uint32_t> nvs = frame.FVs[frame.FHs[i].vs[j]].neighbor_fvs;
+			const std::vector<uint32_t> &nvs = frame.FVs[frame.FHs[i].vs[j]].neighbor_fvs;
 			for (uint32_t k = 0; k < nvs.size(); k++)
 				if (std::find(vs.begin(), vs.end(), nvs[k]) != vs.end()){
 					frame.FHs[i].vs.push_back(nvs[k]); break;
 				}
 		}
-
+	}
+	for (uint32_t i = 0; i < frame.FHs.size(); i++) {
 		for (uint32_t j = 0; j < 8; j++)frame.FVs[frame.FHs[i].vs[j]].neighbor_fhs.push_back(i);
 		for (uint32_t j = 0; j < 12; j++)frame.FEs[frame.FHs[i].es[j]].neighbor_fhs.push_back(i);
 		for (uint32_t j = 0; j < 6; j++)frame.FFs[frame.FHs[i].fs[j]].neighbor_fhs.push_back(i);
@@ -14,6 +14,15 @@
 #include "global_types.h"
 #include "global_functions.h"
 
+//wall time of the stages of base_complex::base_complex_extraction in milliseconds.
+struct Base_Complex_Timings
+{
+	double node_edge_ms = 0.0;
+	double face_ms = 0.0;
+	double cuboid_ms = 0.0;
+	double singularity_color_ms = 0.0;
+};
+
 class base_complex
 {
 public:
@@ -29,5 +38,8 @@ public:
 
 	void assign_color(Frame &frame);
 	~base_complex() {};
+
+	//filled by base_complex_extraction.
+	Base_Complex_Timings timings;
 };
 
@@ -12,8 +12,180 @@
 
 #include "global_functions.h"
 #include "global_types.h"
+#include "Utils/ParallelRadixSort.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 //#include "igl/bounding_box_diagonal.h"
 //===================================mesh connectivities===================================
+namespace {
+struct Hex_Edge_Record {
+	uint64_t key;//(v0 << bits) | v1, v0 < v1
+	uint32_t id;//12 * hid + local edge
+};
+struct Hex_Face_Record {
+	uint64_t key[2];//sorted face vertices packed into 128 bits, key[1] holds the high bits
+	uint32_t id;//6 * hid + local face
+};
+inline void append_key_bits(uint64_t key[2], uint64_t value, uint32_t bits) {
+	key[1] = (key[1] << bits) | (key[0] >> (64 - bits));
+	key[0] = (key[0] << bits) | value;
+}
+//stores the start index of every run of equal records in a sorted array, followed by the number of records.
+template<class Record, class Equal>
+void find_sorted_runs(const vector<Record> &records, Equal equal, vector<uint32_t> &run_starts) {
+	int64_t num_records = int64_t(records.size());
+	int32_t num_blocks = 1;
+#ifdef _OPENMP
+	num_blocks = omp_get_max_threads();
+#endif
+	vector<uint32_t> block_runs(num_blocks + 1, 0);
+#if _OPENMP >= 201107
+	#pragma omp parallel for num_threads(num_blocks) default(none) shared(records, equal, block_runs, num_records, num_blocks)
+#endif
+	for (int32_t b = 0; b < num_blocks; b++) {
+		int64_t begin = num_records * b / num_blocks, end = num_records * (b + 1) / num_blocks;
+		for (int64_t i = begin; i < end; i++) if (i == 0 || !equal(records[i - 1], records[i])) block_runs[b + 1]++;
+	}
+	for (int32_t b = 0; b < num_blocks; b++) block_runs[b + 1] += block_runs[b];
+	run_starts.resize(block_runs[num_blocks] + 1);
+	run_starts.back() = uint32_t(num_records);
+#if _OPENMP >= 201107
+	#pragma omp parallel for num_threads(num_blocks) default(none) shared(records, equal, block_runs, run_starts, num_records, num_blocks)
+#endif
+	for (int32_t b = 0; b < num_blocks; b++) {
+		int64_t begin = num_records * b / num_blocks, end = num_records * (b + 1) / num_blocks;
+		uint32_t run = block_runs[b];
+		for (int64_t i = begin; i < end; i++) if (i == 0 || !equal(records[i - 1], records[i])) run_starts[run++] = uint32_t(i);
+	}
+}
+}
+//builds Es, Fs, h_es, h_fs, f_nhs and e_nhs of a hex mesh from packed vertex keys sorted with a parallel radix sort.
+//Element ids and list orders are the same as those of the tuple-sorting construction used for tet meshes.
+void build_hex_elements(Mesh &hmi) {
+	int32_t H_num = int32_t(hmi.Hs.size());
+	uint32_t bits = 1;
+	while (bits < 32 && (uint64_t(1) << bits) < hmi.Vs.size()) bits++;
+
+	//local copies of the tables for the OpenMP data-sharing clauses, and the local edge ids of the face edges (fvs[j], fvs[j + 1])
+	int edge_table[12][2], face_table[6][4], face_edges[6][4];
+	std::copy(&hex_edge_table[0][0], &hex_edge_table[0][0] + 24, &edge_table[0][0]);
+	std::copy(&hex_face_table[0][0], &hex_face_table[0][0] + 24, &face_table[0][0]);
+	for (int j = 0; j < 6; j++) for (int k = 0; k < 4; k++) {
+		int v0 = hex_face_table[j][k], v1 = hex_face_table[j][(k + 1) % 4];
+		for (int l = 0; l < 12; l++)
+			if ((hex_edge_table[l][0] == v0 && hex_edge_table[l][1] == v1) || (hex_edge_table[l][0] == v1 && hex_edge_table[l][1] == v0))
+				face_edges[j][k] = l;
+	}
+
+	//Es, h_es, e_nhs
+	vector<Hex_Edge_Record> edge_records(size_t(H_num) * 12);
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(hmi, edge_records, edge_table, H_num, bits)
+#endif
+	for (int32_t i = 0; i < H_num; i++) {
+		Hybrid &h = hmi.Hs[i];
+		h.es.resize(12); h.fs.resize(6);
+		for (uint32_t j = 0; j < 12; j++) {
+			uint64_t v0 = h.vs[edge_table[j][0]], v1 = h.vs[edge_table[j][1]];
+			if (v0 > v1) std::swap(v0, v1);
+			edge_records[12 * i + j].key = (v0 << bits) | v1;
+			edge_records[12 * i + j].id = 12 * uint32_t(i) + j;
+		}
+	}
+	parallelRadixSort(edge_records, 2 * bits, [](const Hex_Edge_Record &r, uint32_t pass) {
+		return uint32_t(r.key >> (8 * pass)) & 255u;
+	});
+	vector<uint32_t> edge_starts;
+	find_sorted_runs(edge_records, [](const Hex_Edge_Record &a, const Hex_Edge_Record &b) { return a.key == b.key; }, edge_starts);
+
+	int32_t E_num = int32_t(edge_starts.size() - 1);
+	uint64_t vertex_mask = (uint64_t(1) << bits) - 1;
+	Hybrid_E e; e.boundary = false;
+	hmi.Es.resize(E_num, e);
+	vector<uint32_t> e_nhs_offsets(E_num + 1, 0);
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(hmi, edge_records, edge_starts, e_nhs_offsets, E_num, bits, vertex_mask)
+#endif
+	for (int32_t i = 0; i < E_num; i++) {
+		Hybrid_E &e = hmi.Es[i];
+		e.id = uint32_t(i);
+		e.vs.resize(2);
+		e.vs[0] = uint32_t(edge_records[edge_starts[i]].key >> bits);
+		e.vs[1] = uint32_t(edge_records[edge_starts[i]].key & vertex_mask);
+		uint32_t num_hs = 0, last_hid = uint32_t(-1);
+		for (uint32_t j = edge_starts[i]; j < edge_starts[i + 1]; j++) {
+			uint32_t hid = edge_records[j].id / 12;
+			hmi.Hs[hid].es[edge_records[j].id % 12] = uint32_t(i);
+			if (hid != last_hid) { num_hs++; last_hid = hid; }
+		}
+		e_nhs_offsets[i + 1] = num_hs;
+	}
+	for (int32_t i = 0; i < E_num; i++) e_nhs_offsets[i + 1] += e_nhs_offsets[i];
+	vector<uint32_t> e_nhs(e_nhs_offsets.back());
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(edge_records, edge_starts, e_nhs_offsets, e_nhs, E_num)
+#endif
+	for (int32_t i = 0; i < E_num; i++) {
+		uint32_t pos = e_nhs_offsets[i], last_hid = uint32_t(-1);
+		for (uint32_t j = edge_starts[i]; j < edge_starts[i + 1]; j++) {
+			uint32_t hid = edge_records[j].id / 12;
+			if (hid != last_hid) { e_nhs[pos++] = hid; last_hid = hid; }
+		}
+	}
+	vector<Hex_Edge_Record>().swap(edge_records);
+	vector<uint32_t>().swap(edge_starts);
+
+	//Fs, h_fs, f_nhs
+	vector<Hex_Face_Record> face_records(size_t(H_num) * 6);
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(hmi, face_records, face_table, H_num, bits)
+#endif
+	for (int32_t i = 0; i < H_num; i++) {
+		for (uint32_t j = 0; j < 6; j++) {
+			uint32_t vs[4];
+			for (short k = 0; k < 4; k++) vs[k] = hmi.Hs[i].vs[face_table[j][k]];
+			std::sort(vs, vs + 4);
+			Hex_Face_Record &r = face_records[6 * i + j];
+			r.key[0] = r.key[1] = 0;
+			for (short k = 0; k < 4; k++) append_key_bits(r.key, vs[k], bits);
+			r.id = 6 * uint32_t(i) + j;
+		}
+	}
+	parallelRadixSort(face_records, 4 * bits, [](const Hex_Face_Record &r, uint32_t pass) {
+		return pass < 8 ? uint32_t(r.key[0] >> (8 * pass)) & 255u : uint32_t(r.key[1] >> (8 * (pass - 8))) & 255u;
+	});
+	vector<uint32_t> face_starts;
+	find_sorted_runs(face_records, [](const Hex_Face_Record &a, const Hex_Face_Record &b) {
+		return a.key[0] == b.key[0] && a.key[1] == b.key[1];
+	}, face_starts);
+
+	int32_t F_num = int32_t(face_starts.size() - 1);
+	hmi.Fs.resize(F_num);
+	//the runs of equal face keys are the CSR rows of f_nhs (non-manifold faces simply have longer rows)
+	vector<uint32_t> f_nhs(face_records.size());
+#if _OPENMP >= 201107
+	#pragma omp parallel for default(none) shared(hmi, face_records, face_starts, f_nhs, face_table, face_edges, F_num)
+#endif
+	for (int32_t i = 0; i < F_num; i++) {
+		Hybrid_F &f = hmi.Fs[i];
+		uint32_t hid = face_records[face_starts[i]].id / 6, j = face_records[face_starts[i]].id % 6;
+		f.id = uint32_t(i);
+		f.vs.resize(4); f.es.resize(4);
+		for (short k = 0; k < 4; k++) {
+			f.vs[k] = hmi.Hs[hid].vs[face_table[j][k]];
+			f.es[k] = hmi.Hs[hid].es[face_edges[j][k]];
+		}
+		f.boundary = face_starts[i + 1] - face_starts[i] == 1;
+		for (uint32_t k = face_starts[i]; k < face_starts[i + 1]; k++) {
+			hmi.Hs[face_records[k].id / 6].fs[face_records[k].id % 6] = uint32_t(i);
+			f_nhs[k] = face_records[k].id / 6;
+		}
+	}
+	vector<Hex_Face_Record>().swap(face_records);
+	hmi.set_adjacency(E_NHS, e_nhs_offsets, e_nhs);
+	hmi.set_adjacency(F_NHS, face_starts, f_nhs);
+}
 void build_connectivity(Mesh &hmi) {
 	hmi.Es.clear(); if (hmi.Hs.size()) hmi.Fs.clear();
 	//either hex or tri
@@ -119,98 +291,101 @@ void build_connectivity(Mesh &hmi) {
 			}
 	}
 	else if(hmi.type == Mesh_type::Hex) {
-
-		std::vector<std::vector<uint32_t>> total_fs(hmi.Hs.size() * 6);
-		std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>> tempF(hmi.Hs.size() * 6);
-		std::vector<uint32_t> vs(4);
-		for (uint32_t i = 0; i < hmi.Hs.size(); ++i) {
-			for (short j = 0; j < 6; j++){
-				for (short k = 0; k < 4; k++) vs[k] = hmi.Hs[i].vs[hex_face_table[j][k]];
-				uint32_t id = 6 * i + j;
-				total_fs[id] = vs;
-				std::sort(vs.begin(), vs.end());
-				tempF[id] = std::make_tuple(vs[0], vs[1], vs[2], vs[3], id, i, j);
-			}
-			hmi.Hs[i].fs.resize(6);
-		}
-		std::sort(tempF.begin(), tempF.end());
-		hmi.Fs.reserve(tempF.size() / 3);
-		Hybrid_F f; f.boundary = true;
-		uint32_t F_num = 0;
-		for (uint32_t i = 0; i < tempF.size(); ++i) {
-			if (i == 0 || (i != 0 &&
-				(std::get<0>(tempF[i]) != std::get<0>(tempF[i - 1]) || std::get<1>(tempF[i]) != std::get<1>(tempF[i - 1]) ||
-					std::get<2>(tempF[i]) != std::get<2>(tempF[i - 1]) || std::get<3>(tempF[i]) != std::get<3>(tempF[i - 1])))) {
-				f.id = F_num; F_num++;
-				f.vs = total_fs[std::get<4>(tempF[i])];
-				hmi.Fs.push_back(f);
-			}
-			else if (i != 0 && (std::get<0>(tempF[i]) == std::get<0>(tempF[i - 1]) && std::get<1>(tempF[i]) == std::get<1>(tempF[i - 1]) &&
-				std::get<2>(tempF[i]) == std::get<2>(tempF[i - 1]) && std::get<3>(tempF[i]) == std::get<3>(tempF[i - 1])))
-				hmi.Fs[F_num - 1].boundary = false;
-
-			hmi.Hs[std::get<5>(tempF[i])].fs[std::get<6>(tempF[i])] = F_num - 1;
-		}
-
-		std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> temp(hmi.Fs.size() * 4);
-		for (uint32_t i = 0; i < hmi.Fs.size(); ++i) {
-			for (uint32_t j = 0; j < 4; ++j) {
-				uint32_t v0 = hmi.Fs[i].vs[j], v1 = hmi.Fs[i].vs[(j + 1) % 4];
-				if (v0 > v1) std::swap(v0, v1);
-				temp[4 * i + j] = std::make_tuple(v0, v1, i, j);
-			}
-			hmi.Fs[i].es.resize(4);
-		}
-		std::sort(temp.begin(), temp.end());
-		hmi.Es.reserve(temp.size() / 2);
-		uint32_t E_num = 0;
-		Hybrid_E e; e.boundary = false; e.vs.resize(2);
-		for (uint32_t i = 0; i < temp.size(); ++i) {
-			if (i == 0 || (i != 0 && (std::get<0>(temp[i]) != std::get<0>(temp[i - 1]) ||
-				std::get<1>(temp[i]) != std::get<1>(temp[i - 1])))) {
-				e.id = E_num; E_num++;
-				e.vs[0] = std::get<0>(temp[i]);
-				e.vs[1] = std::get<1>(temp[i]);
-				hmi.Es.push_back(e);
-			}
-			hmi.Fs[std::get<2>(temp[i])].es[std::get<3>(temp[i])] = E_num - 1;
-		}
-		//boundary
-		for (auto &v : hmi.Vs) v.boundary = false;
-		for (uint32_t i = 0; i < hmi.Fs.size(); ++i)
-			if (hmi.Fs[i].boundary) for (uint32_t j = 0; j < 4; ++j) {
-				uint32_t eid = hmi.Fs[i].es[j];
-				hmi.Es[eid].boundary = true;
-				hmi.Vs[hmi.Es[eid].vs[0]].boundary = hmi.Vs[hmi.Es[eid].vs[1]].boundary = true;
-			}
-	}
-	//f_nhs;
-	for (uint32_t i = 0; i < hmi.Hs.size(); i++) {
-		for (uint32_t j = 0; j < hmi.Hs[i].fs.size(); j++) hmi.Fs[hmi.Hs[i].fs[j]].neighbor_hs.push_back(i);
-	}
+		build_hex_elements(hmi);
+	}
+	//f_nhs; (hex meshes get f_nhs, e_nhs and h_es directly from build_hex_elements)
+	if (hmi.type != Mesh_type::Hex) {
+		std::vector<uint32_t> f_nhs_offsets(hmi.Fs.size() + 1, 0);
+		for (uint32_t i = 0; i < hmi.Hs.size(); i++)
+			for (uint32_t j = 0; j < hmi.Hs[i].fs.size(); j++) f_nhs_offsets[hmi.Hs[i].fs[j] + 1]++;
+		for (uint32_t i = 0; i < hmi.Fs.size(); i++) f_nhs_offsets[i + 1] += f_nhs_offsets[i];
+		std::vector<uint32_t> f_nhs(f_nhs_offsets.back());
+		std::vector<uint32_t> f_pos(f_nhs_offsets.begin(), f_nhs_offsets.end() - 1);
+		for (uint32_t i = 0; i < hmi.Hs.size(); i++)
+			for (uint32_t j = 0; j < hmi.Hs[i].fs.size(); j++) f_nhs[f_pos[hmi.Hs[i].fs[j]]++] = i;
+		hmi.set_adjacency(F_NHS, f_nhs_offsets, f_nhs);
+	}
+	//v_nhs
+	build_vertex_neighbor_hs(hmi);
 	//e_nfs, v_nfs
+	std::vector<uint32_t> e_nfs_offsets(hmi.Es.size() + 1, 0), v_nfs_offsets(hmi.Vs.size() + 1, 0);
+	for (uint32_t i = 0; i < hmi.Fs.size(); i++) {
+		for (uint32_t j = 0; j < hmi.Fs[i].es.size(); j++) e_nfs_offsets[hmi.Fs[i].es[j] + 1]++;
+		for (uint32_t j = 0; j < hmi.Fs[i].vs.size(); j++) v_nfs_offsets[hmi.Fs[i].vs[j] + 1]++;
+	}
+	for (uint32_t i = 0; i < hmi.Es.size(); i++) e_nfs_offsets[i + 1] += e_nfs_offsets[i];
+	for (uint32_t i = 0; i < hmi.Vs.size(); i++) v_nfs_offsets[i + 1] += v_nfs_offsets[i];
+	std::vector<uint32_t> e_nfs(e_nfs_offsets.back()), v_nfs(v_nfs_offsets.back());
+	std::vector<uint32_t> e_pos(e_nfs_offsets.begin(), e_nfs_offsets.end() - 1);
+	std::vector<uint32_t> v_pos(v_nfs_offsets.begin(), v_nfs_offsets.end() - 1);
 	for (uint32_t i = 0; i < hmi.Fs.size(); i++) {
-		for (uint32_t j = 0; j < hmi.Fs[i].es.size(); j++) hmi.Es[hmi.Fs[i].es[j]].neighbor_fs.push_back(i);
-		for (uint32_t j = 0; j < hmi.Fs[i].vs.size(); j++) hmi.Vs[hmi.Fs[i].vs[j]].neighbor_fs.push_back(i);
+		for (uint32_t j = 0; j < hmi.Fs[i].es.size(); j++) e_nfs[e_pos[hmi.Fs[i].es[j]]++] = i;
+		for (uint32_t j = 0; j < hmi.Fs[i].vs.size(); j++) v_nfs[v_pos[hmi.Fs[i].vs[j]]++] = i;
 	}
+	hmi.set_adjacency(E_NFS, e_nfs_offsets, e_nfs);
+	hmi.set_adjacency(V_NFS, v_nfs_offsets, v_nfs);
 	//v_nes, v_nvs
+	std::vector<uint32_t> v_nes_offsets(hmi.Vs.size() + 1, 0);
+	for (uint32_t i = 0; i < hmi.Es.size(); i++) {
+		v_nes_offsets[hmi.Es[i].vs[0] + 1]++;
+		v_nes_offsets[hmi.Es[i].vs[1] + 1]++;
+	}
+	for (uint32_t i = 0; i < hmi.Vs.size(); i++) v_nes_offsets[i + 1] += v_nes_offsets[i];
+	std::vector<uint32_t> v_nvs_offsets(v_nes_offsets);
+	std::vector<uint32_t> v_nes(v_nes_offsets.back()), v_nvs(v_nes_offsets.back());
+	v_pos.assign(v_nes_offsets.begin(), v_nes_offsets.end() - 1);
 	for (uint32_t i = 0; i < hmi.Es.size(); i++) {
 		uint32_t v0 = hmi.Es[i].vs[0], v1 = hmi.Es[i].vs[1];
-		hmi.Vs[v0].neighbor_es.push_back(i);
-		hmi.Vs[v1].neighbor_es.push_back(i);
-		hmi.Vs[v0].neighbor_vs.push_back(v1);
-		hmi.Vs[v1].neighbor_vs.push_back(v0);
+		v_nes[v_pos[v0]] = i; v_nvs[v_pos[v0]++] = v1;
+		v_nes[v_pos[v1]] = i; v_nvs[v_pos[v1]++] = v0;
+	}
+	hmi.set_adjacency(V_NES, v_nes_offsets, v_nes);
+	hmi.set_adjacency(V_NVS, v_nvs_offsets, v_nvs);
+	if (hmi.type == Mesh_type::Hex) {
+		//boundary
+		int32_t E_num = int32_t(hmi.Es.size()), V_num = int32_t(hmi.Vs.size());
+#if _OPENMP >= 201107
+		#pragma omp parallel for default(none) shared(hmi, E_num)
+#endif
+		for (int32_t i = 0; i < E_num; i++) {
+			Hybrid_E &e = hmi.Es[i];
+			e.boundary = false;
+			for (uint32_t j = 0; j < e.neighbor_fs.size(); j++) if (hmi.Fs[e.neighbor_fs[j]].boundary) e.boundary = true;
+		}
+#if _OPENMP >= 201107
+		#pragma omp parallel for default(none) shared(hmi, V_num)
+#endif
+		for (int32_t i = 0; i < V_num; i++) {
+			Hybrid_V &v = hmi.Vs[i];
+			v.boundary = false;
+			for (uint32_t j = 0; j < v.neighbor_es.size(); j++) if (hmi.Es[v.neighbor_es[j]].boundary) v.boundary = true;
+		}
+		return;
 	}
 	//e_nhs
+	std::vector<uint32_t> e_nhs_offsets(hmi.Es.size() + 1, 0), e_nhs;
+	e_nhs.reserve(hmi.Es.size() * 4);
 	for (uint32_t i = 0; i < hmi.Es.size(); i++) {
-		std::vector<uint32_t> nhs;
+		size_t start = e_nhs.size();
 		for (uint32_t j = 0; j < hmi.Es[i].neighbor_fs.size(); j++) {
 			uint32_t nfid = hmi.Es[i].neighbor_fs[j];
-			nhs.insert(nhs.end(), hmi.Fs[nfid].neighbor_hs.begin(), hmi.Fs[nfid].neighbor_hs.end());
+			e_nhs.insert(e_nhs.end(), hmi.Fs[nfid].neighbor_hs.begin(), hmi.Fs[nfid].neighbor_hs.end());
 		}
-		std::sort(nhs.begin(), nhs.end()); nhs.erase(std::unique(nhs.begin(), nhs.end()), nhs.end());
-		hmi.Es[i].neighbor_hs = nhs;
+		std::sort(e_nhs.begin() + start, e_nhs.end()); e_nhs.erase(std::unique(e_nhs.begin() + start, e_nhs.end()), e_nhs.end());
+		e_nhs_offsets[i + 1] = uint32_t(e_nhs.size());
 	}
+	hmi.set_adjacency(E_NHS, e_nhs_offsets, e_nhs);
+}
+void build_vertex_neighbor_hs(Mesh &hmi) {
+	std::vector<uint32_t> v_nhs_offsets(hmi.Vs.size() + 1, 0);
+	for (uint32_t i = 0; i < hmi.Hs.size(); i++)
+		for (uint32_t j = 0; j < hmi.Hs[i].vs.size(); j++) v_nhs_offsets[hmi.Hs[i].vs[j] + 1]++;
+	for (uint32_t i = 0; i < hmi.Vs.size(); i++) v_nhs_offsets[i + 1] += v_nhs_offsets[i];
+	std::vector<uint32_t> v_nhs(v_nhs_offsets.back());
+	std::vector<uint32_t> v_pos(v_nhs_offsets.begin(), v_nhs_offsets.end() - 1);
+	for (uint32_t i = 0; i < hmi.Hs.size(); i++)
+		for (uint32_t j = 0; j < hmi.Hs[i].vs.size(); j++) v_nhs[v_pos[hmi.Hs[i].vs[j]]++] = i;
+	hmi.set_adjacency(V_NHS, v_nhs_offsets, v_nhs);
 }
 void topology_info(Mesh &mesh, Frame &frame, Mesh_Topology & mt) {
 
@@ -460,8 +635,8 @@ bool redundentV_check(Mesh &meshI, Mesh &meshO) {
 
 	for (auto &h:meshO.Hs) {
 		for (uint32_t j = 0; j < h.vs.size(); j++) h.vs[j] = V_tag[h.vs[j]];
-		for (uint32_t i = 0; i < h.vs.size(); i++) meshO.Vs[h.vs[i]].neighbor_hs.push_back(h.id);
 	}
+	build_vertex_neighbor_hs(meshO);
 	return redundentV;
 }
 double average_edge_length(Mesh &mesh) {
@@ -496,7 +671,6 @@ void re_indexing_connectivity(Mesh &hmi, MatrixXi &H){
 	for (uint32_t i = 0; i < H.cols(); i++) {
 		for (uint32_t j = 0; j < H.rows(); j++) h.vs[j] = H(j, i);
 		h.id = i; hmi.Hs[h.id] = h;
-		for (uint32_t i = 0; i < h.vs.size(); i++) hmi.Vs[h.vs[i]].neighbor_hs.push_back(h.id);
 	}
 //Es, Fs, and their connectivities
 	build_connectivity(hmi);
@@ -1653,7 +1827,7 @@ bool phong_projection(vector<uint32_t> &tids, uint32_t Loop, uint32_t &tid, Vect
 	vector<uint32_t> tids_;
 	for (uint32_t Iter = 0; Iter < Loop; Iter++) {
 		for (uint32_t j = 0; j < tids.size(); j++) {
-			vector<uint32_t> &vs = mf.tri.Fs[tids[j]].vs;
+			Fixed_List<4> &vs = mf.tri.Fs[tids[j]].vs;
 			for (uint32_t k = 0; k < 3; k++) {
 				for (auto ntid : mf.tri.Vs[vs[k]].neighbor_fs) {
 					if (t_flag[ntid]) continue; t_flag[ntid] = true;
@@ -1674,7 +1848,7 @@ bool phong_projection(vector<uint32_t> &tids, uint32_t Loop, uint32_t &tid, Vect
 		vector<Vector2d> uvs; vector<pair<double, uint32_t>> dis_ids;
 		for (uint32_t j = 0; j < ts.size(); j++) {
 			vector<Vector3d> tri_vs(3), vs_normals(3);
-			vector<uint32_t> &vs = mf.tri.Fs[ts[j]].vs;
+			Fixed_List<4> &vs = mf.tri.Fs[ts[j]].vs;
 			for (uint32_t k = 0; k < 3; k++) {
 				tri_vs[k] = mf.tri.V.col(vs[k]);
 				vs_normals[k] = mf.normal_V.col(vs[k]);
@@ -1705,7 +1879,7 @@ bool phong_projection(vector<uint32_t> &tids, uint32_t Loop, uint32_t &tid, Vect
 
 		vector<uint32_t> ts_;
 		for (uint32_t j = 0; j < ts.size(); j++) {
-			vector<uint32_t> &vs = mf.tri.Fs[ts[j]].vs;
+			Fixed_List<4> &vs = mf.tri.Fs[ts[j]].vs;
 			for (uint32_t k = 0; k < 3; k++) {
 				for (auto ntid : mf.tri.Vs[vs[k]].neighbor_fs) {
 					if (t_flag[ntid]) continue;
@@ -1842,7 +2016,8 @@ void compute_referenceMesh(MatrixXd &V, vector<Hybrid> &H, vector<uint32_t> &Hs,
 
 	for (auto hid : Hs) {
 		vector<MatrixXd> vout;
-		hex2cuboid(V, H[hid].vs, vout);
+		vector<uint32_t> vs = H[hid].vs;
+		hex2cuboid(V, vs, vout);
 		Vout.insert(Vout.end(),vout.begin(), vout.end());
 	}
 }
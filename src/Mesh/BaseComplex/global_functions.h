@@ -30,6 +30,8 @@ using namespace std;
 
 //===================================mesh connectivities===================================
 void build_connectivity(Mesh &hmi);
+void build_hex_elements(Mesh &hmi);
+void build_vertex_neighbor_hs(Mesh &hmi);
 void topology_info(Mesh &mesh, Frame &frame, Mesh_Topology & mt);
 bool disk_polygon(Mesh &mesh, Frame &frame, vector<vector<uint32_t>> &fes, vector<short> &E_flag, vector<short> &V_flag, const bool &Ismesh);
 bool sphere_polyhedral(Mesh &mesh, Frame &frame, vector<vector<uint32_t>> &F_nvs, vector<vector<uint32_t>> &pfs, vector<bool> &F_flag, vector<short> &E_flag, vector<short> &V_flag, const bool &Ismesh);
@@ -58,4 +58,45 @@ int32_t GRAIN_SIZE;
 double diagonal_len;
 
 Mesh mesh_sheet, mesh_sheetS;
-bool HEXAHEDRAL_COLLASPE = false;
\ No newline at end of file
+bool HEXAHEDRAL_COLLASPE = false;
+//===================================mesh adjacency===================================
+Mesh &Mesh::operator=(const Mesh &mesh) {
+	if (this == &mesh) return *this;
+	type = mesh.type;
+	V = mesh.V;
+	Vs = mesh.Vs; Es = mesh.Es; Fs = mesh.Fs; Hs = mesh.Hs;
+	for (int t = 0; t < Adjacency_Type_Count; t++) {
+		adjacency_offsets[t] = mesh.adjacency_offsets[t];
+		adjacency_indices[t] = mesh.adjacency_indices[t];
+		//the copied lists still point into the CSR arrays of the source mesh
+		update_adjacency_lists(Adjacency_Type(t));
+	}
+	return *this;
+}
+void Mesh::set_adjacency(Adjacency_Type type, vector<uint32_t> &offsets, vector<uint32_t> &indices) {
+	adjacency_offsets[type].swap(offsets);
+	adjacency_indices[type].swap(indices);
+	update_adjacency_lists(type);
+}
+void Mesh::update_adjacency_lists(Adjacency_Type type) {
+	const vector<uint32_t> &offsets = adjacency_offsets[type];
+	uint32_t *indices = adjacency_indices[type].data();
+	size_t num_lists = offsets.empty() ? 0 : offsets.size() - 1;
+
+	Adjacency_List empty_list;
+	auto list = [&](size_t i) -> Adjacency_List {
+		if (i >= num_lists) return empty_list;
+		Adjacency_List l; l.elements = indices + offsets[i]; l.n = offsets[i + 1] - offsets[i];
+		return l;
+	};
+	switch (type) {
+	case V_NVS: for (size_t i = 0; i < Vs.size(); i++) Vs[i].neighbor_vs = list(i); break;
+	case V_NES: for (size_t i = 0; i < Vs.size(); i++) Vs[i].neighbor_es = list(i); break;
+	case V_NFS: for (size_t i = 0; i < Vs.size(); i++) Vs[i].neighbor_fs = list(i); break;
+	case V_NHS: for (size_t i = 0; i < Vs.size(); i++) Vs[i].neighbor_hs = list(i); break;
+	case E_NFS: for (size_t i = 0; i < Es.size(); i++) Es[i].neighbor_fs = list(i); break;
+	case E_NHS: for (size_t i = 0; i < Es.size(); i++) Es[i].neighbor_hs = list(i); break;
+	case F_NHS: for (size_t i = 0; i < Fs.size(); i++) Fs[i].neighbor_hs = list(i); break;
+	default: break;
+	}
+}
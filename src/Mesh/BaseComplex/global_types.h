@@ -15,6 +15,8 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <cassert>
+#include <stdexcept>
 #include "Eigen/Dense"
 using namespace Eigen;
 using namespace std;
@@ -87,6 +89,30 @@ const int hex_face_table[6][4] =
     { 3,2,6,7 },
     { 1,5,6,2 },*/
 };
+// Local vertex indices of the 12 edges of a hexahedron, in the order used for Hybrid::es.
+// Every four consecutive edges are parallel to each other.
+//
+//      3 +----------------+ 2
+//       /|       1       /|
+//   11 / |           10 / |
+//     /  |             /  |
+//    /   | 4          /   | 7
+// 7 +----------------+ 6  |
+//   |    |   2       |    |
+//   |    |           |    |
+//   |    |      0    |    |
+//   |  0 +-----------|----+ 1
+// 5 |   /          6 |   /
+//   |  / 8           |  / 9
+//   | /              | /
+//   |/      3        |/
+// 4 +----------------+ 5
+const int hex_edge_table[12][2] =
+{
+	{ 0,1 },{ 2,3 },{ 6,7 },{ 4,5 },
+	{ 0,3 },{ 4,7 },{ 5,6 },{ 1,2 },
+	{ 0,4 },{ 1,5 },{ 2,6 },{ 3,7 },
+};
 const int hex_tetra_table[8][4] =
 {
 	{ 0,3,4,1 },
@@ -100,23 +126,98 @@ const int hex_tetra_table[8][4] =
 };
 //-------------------------------------------------------------------
 //---For Hybrid mesh-------------------------------------------------
+//fixed-capacity list stored inline in the element (cell/face/edge vertices, edges and faces).
+//It mirrors the parts of the std::vector interface used by the algorithms.
+template<uint32_t N>
+struct Fixed_List
+{
+	uint32_t elements[N];
+	uint32_t n = 0;
+
+	Fixed_List() {}
+	Fixed_List(const vector<uint32_t> &list) { assign(list.begin(), list.end()); }
+	Fixed_List &operator=(const vector<uint32_t> &list) { assign(list.begin(), list.end()); return *this; }
+	operator vector<uint32_t>() const { return vector<uint32_t>(begin(), end()); }
+
+	template<class Iterator>
+	void assign(Iterator first, Iterator last) {
+		n = 0;
+		for (; first != last; ++first) push_back(*first);
+	}
+	//exceeding the capacity means the topology is not supported (e.g., a non-manifold face), which must not silently
+	//truncate the lists in release builds.
+	void push_back(uint32_t value) {
+		if (n >= N) throw std::length_error("Fixed_List::push_back: Capacity exceeded");
+		elements[n++] = value;
+	}
+	void pop_back() { assert(n > 0); n--; }
+	void clear() { n = 0; }
+	void resize(size_t size, uint32_t value = 0) {
+		if (size > N) throw std::length_error("Fixed_List::resize: Capacity exceeded");
+		for (uint32_t i = n; i < size; i++) elements[i] = value;
+		n = uint32_t(size);
+	}
+	void reserve(size_t) {}
+
+	size_t size() const { return n; }
+	bool empty() const { return n == 0; }
+	uint32_t &operator[](size_t i) { return elements[i]; }
+	const uint32_t &operator[](size_t i) const { return elements[i]; }
+	uint32_t &at(size_t i) { if (i >= n) throw std::out_of_range("Fixed_List::at"); return elements[i]; }
+	const uint32_t &at(size_t i) const { if (i >= n) throw std::out_of_range("Fixed_List::at"); return elements[i]; }
+	uint32_t &front() { return elements[0]; }
+	const uint32_t &front() const { return elements[0]; }
+	uint32_t &back() { return elements[n - 1]; }
+	const uint32_t &back() const { return elements[n - 1]; }
+	uint32_t *data() { return elements; }
+	const uint32_t *data() const { return elements; }
+	uint32_t *begin() { return elements; }
+	const uint32_t *begin() const { return elements; }
+	uint32_t *end() { return elements + n; }
+	const uint32_t *end() const { return elements + n; }
+};
+//row of a CSR adjacency array owned by Mesh (see Mesh::set_adjacency).
+//The row may be reordered in place, but its length is fixed once the connectivity is built.
+struct Adjacency_List
+{
+	uint32_t *elements = nullptr;
+	uint32_t n = 0;
+
+	operator vector<uint32_t>() const { return vector<uint32_t>(begin(), end()); }
+
+	size_t size() const { return n; }
+	bool empty() const { return n == 0; }
+	uint32_t &operator[](size_t i) { return elements[i]; }
+	const uint32_t &operator[](size_t i) const { return elements[i]; }
+	uint32_t &at(size_t i) { if (i >= n) throw std::out_of_range("Adjacency_List::at"); return elements[i]; }
+	const uint32_t &at(size_t i) const { if (i >= n) throw std::out_of_range("Adjacency_List::at"); return elements[i]; }
+	uint32_t &front() { return elements[0]; }
+	const uint32_t &front() const { return elements[0]; }
+	uint32_t &back() { return elements[n - 1]; }
+	const uint32_t &back() const { return elements[n - 1]; }
+	uint32_t *data() { return elements; }
+	const uint32_t *data() const { return elements; }
+	uint32_t *begin() { return elements; }
+	const uint32_t *begin() const { return elements; }
+	uint32_t *end() { return elements + n; }
+	const uint32_t *end() const { return elements + n; }
+};
 struct Hybrid_V
 {
 	uint32_t id, svid, fvid;
-	vector<Float> v;
-	vector<uint32_t> neighbor_vs;
-	vector<uint32_t> neighbor_es;
-	vector<uint32_t> neighbor_fs;
-	vector<uint32_t> neighbor_hs;
+	Adjacency_List neighbor_vs;
+	Adjacency_List neighbor_es;
+	Adjacency_List neighbor_fs;
+	Adjacency_List neighbor_hs;
 
 	bool boundary;
 };
 struct Hybrid_E
 {
 	uint32_t id;
-	vector<uint32_t> vs;
-	vector<uint32_t> neighbor_fs;
-	vector<uint32_t> neighbor_hs;
+	Fixed_List<2> vs;
+	Adjacency_List neighbor_fs;
+	Adjacency_List neighbor_hs;
 	
 	bool boundary;
 
@@ -125,18 +226,18 @@ struct Hybrid_E
 struct Hybrid_F
 {
 	uint32_t id;
-	vector<uint32_t> vs;
-	vector<uint32_t> es;
-	vector<uint32_t> neighbor_hs;
+	Fixed_List<4> vs;
+	Fixed_List<4> es;
+	Adjacency_List neighbor_hs;
 	bool boundary;
 };
 
 struct Hybrid
 {
 	uint32_t id;
-	vector<uint32_t> vs;
-	vector<uint32_t> es;
-	vector<uint32_t> fs;
+	Fixed_List<8> vs;
+	Fixed_List<12> es;
+	Fixed_List<6> fs;
 	bool boundary;
 };
 //-------------------------------------------------------------------
@@ -332,6 +433,16 @@ struct Mesh_Quality
 
 	double timings = -1;
 };
+enum Adjacency_Type {
+	V_NVS = 0,
+	V_NES,
+	V_NFS,
+	V_NHS,
+	E_NFS,
+	E_NHS,
+	F_NHS,
+	Adjacency_Type_Count
+};
 struct Mesh
 {
 	short type;
@@ -340,6 +451,20 @@ struct Mesh
 	vector<Hybrid_E> Es;
 	vector<Hybrid_F> Fs;
 	vector<Hybrid> Hs;
+
+	//variable-valence adjacency in CSR form; the neighbor lists of Vs, Es and Fs point into these arrays.
+	vector<uint32_t> adjacency_offsets[Adjacency_Type_Count];
+	vector<uint32_t> adjacency_indices[Adjacency_Type_Count];
+
+	Mesh() {}
+	Mesh(const Mesh &mesh) { *this = mesh; }
+	Mesh(Mesh &&mesh) = default;
+	Mesh &operator=(const Mesh &mesh);
+	Mesh &operator=(Mesh &&mesh) = default;
+
+	//takes over the CSR arrays (offsets has one entry more than the number of elements) and updates the element lists.
+	void set_adjacency(Adjacency_Type type, vector<uint32_t> &offsets, vector<uint32_t> &indices);
+	void update_adjacency_lists(Adjacency_Type type);
 };
 struct Mesh_Feature
 {//ground-truth feature
@@ -45,10 +45,14 @@ public:
 
     // Called when a new mesh is loaded from a file.
     virtual void onMeshLoaded(HexMeshPtr meshIn) {}
+    // Called when the data of the input mesh changed (e.g., the vertex positions or the cell attributes).
+    virtual void onInputMeshChanged(HexMeshPtr meshIn) {}
 
     // Gets a copy of mesh from parent if parent has multiple children, i.e., operations must use different meshes.
+    // The cells filtered out are stored in the filter mask, which is cached until the filter gets dirty again.
     virtual void filterMesh(HexMeshPtr meshIn)=0;
     inline HexMeshPtr getOutput() { return output; }
+    inline const CellMask& getFilterMask() const { return filterMask; }
     inline void removeOldMesh() { output = HexMeshPtr(); }
 
     // Renders the GUI. The "dirty" flag might be set depending on the user's actions.
@@ -60,6 +64,7 @@ public:
 
 protected:
     HexMeshPtr output;
+    CellMask filterMask;
     bool enabled = true;
     bool dirty = true;
     bool showFilterWindow = true;
@@ -27,11 +27,12 @@
  */
 
 #include <unordered_set>
+#include <algorithm>
 #include <limits>
-#include <Utils/CircularQueue.hpp>
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Mesh/BaseComplex/global_types.h"
+#include "Utils/InternalState.hpp"
 #include "PeelingFilter.hpp"
 
 void PeelingFilter::onMeshLoaded(HexMeshPtr meshIn) {
@@ -43,38 +44,113 @@ void PeelingFilter::onMeshLoaded(HexMeshPtr meshIn) {
     peelingDepth = 0;
     maxPeelingDepth = 0;
 
-    CircularQueue<uint32_t> openList(32);
-
     Mesh& mesh = meshIn->getBaseComplexMesh();
-    cellDepths.resize(mesh.Hs.size(), std::numeric_limits<int>::max());
-    for (Hybrid& h : mesh.Hs) {
-        if (std::any_of(h.fs.begin(), h.fs.end(), [this, &mesh](uint32_t f_id) {
-            return mesh.Fs.at(f_id).boundary;
-        })) {
-            cellDepths.at(h.id) = 0;
-            openList.push_back(h.id);
+    size_t numCells = mesh.Hs.size();
+    cellDepths.resize(numCells, std::numeric_limits<int>::max());
+    int* depths = cellDepths.data();
+    int unvisitedDepth = std::numeric_limits<int>::max();
+
+    // The cells at the boundary form the first frontier.
+    std::vector<uint32_t> frontier;
+#if _OPENMP >= 201107
+    #pragma omp parallel default(none) shared(mesh, frontier, depths, numCells)
+#endif
+    {
+        std::vector<uint32_t> localFrontier;
+#if _OPENMP >= 201107
+        #pragma omp for nowait
+#endif
+        for (size_t h_id = 0; h_id < numCells; h_id++) {
+            Hybrid& h = mesh.Hs.at(h_id);
+            if (std::any_of(h.fs.begin(), h.fs.end(), [&mesh](uint32_t f_id) {
+                return mesh.Fs.at(f_id).boundary;
+            })) {
+                depths[h_id] = 0;
+                localFrontier.push_back(uint32_t(h_id));
+            }
         }
+#if _OPENMP >= 201107
+        #pragma omp critical
+#endif
+        frontier.insert(frontier.end(), localFrontier.begin(), localFrontier.end());
     }
 
-    while (!openList.is_empty()) {
-        uint32_t h_id = openList.pop_front();
-        Hybrid& h = mesh.Hs.at(h_id);
-        int cellDepth = cellDepths.at(h_id);
-        for (uint32_t f_id : h.fs) {
-            Hybrid_F& f = mesh.Fs.at(f_id);
-            if (!f.boundary) {
-                uint32_t neighbor_h_id = f.neighbor_hs.at(0) == h_id ? f.neighbor_hs.at(1) : f.neighbor_hs.at(0);
-                int neighborDepth = cellDepths.at(neighbor_h_id);
-                if (neighborDepth > cellDepth + 1) {
-                    openList.push_back(neighbor_h_id);
-                    cellDepths.at(neighbor_h_id) = cellDepth + 1;
-                    maxPeelingDepth = std::max(maxPeelingDepth, cellDepth + 1);
+    // Level-synchronous breadth-first search. The cells of the next level are claimed with an atomic exchange, as the
+    // cells of all previous levels already have their final depth and only this level writes the depth cellDepth + 1.
+    int cellDepth = 0;
+    std::vector<uint32_t> nextFrontier;
+    while (!frontier.empty()) {
+        nextFrontier.clear();
+        int neighborDepthNew = cellDepth + 1;
+#if _OPENMP >= 201107
+        #pragma omp parallel default(none) shared(mesh, frontier, nextFrontier, depths, unvisitedDepth, neighborDepthNew)
+#endif
+        {
+            std::vector<uint32_t> localFrontier;
+#if _OPENMP >= 201107
+            #pragma omp for schedule(dynamic, 256) nowait
+#endif
+            for (size_t i = 0; i < frontier.size(); i++) {
+                uint32_t h_id = frontier[i];
+                Hybrid& h = mesh.Hs.at(h_id);
+                for (uint32_t f_id : h.fs) {
+                    Hybrid_F& f = mesh.Fs.at(f_id);
+                    if (f.boundary) {
+                        continue;
+                    }
+                    uint32_t neighbor_h_id = f.neighbor_hs.at(0) == h_id ? f.neighbor_hs.at(1) : f.neighbor_hs.at(0);
+                    int neighborDepth;
+#if _OPENMP >= 201107
+                    #pragma omp atomic read
+#endif
+                    neighborDepth = depths[neighbor_h_id];
+                    if (neighborDepth != unvisitedDepth) {
+                        continue;
+                    }
+#if _OPENMP >= 201107
+                    #pragma omp atomic capture
+#endif
+                    { neighborDepth = depths[neighbor_h_id]; depths[neighbor_h_id] = neighborDepthNew; }
+                    if (neighborDepth == unvisitedDepth) {
+                        localFrontier.push_back(neighbor_h_id);
+                    }
                 }
             }
+#if _OPENMP >= 201107
+            #pragma omp critical
+#endif
+            nextFrontier.insert(nextFrontier.end(), localFrontier.begin(), localFrontier.end());
+        }
+        frontier.swap(nextFrontier);
+        if (!frontier.empty()) {
+            cellDepth++;
         }
     }
+    maxPeelingDepth = cellDepth;
+
+    // Counting sort of the cells by their depth. The cells filtered for a peeling depth d are the prefix of length
+    // depthOffsets[d]. Cells not reachable from the boundary come last and are never filtered.
+    depthOffsets.assign(size_t(maxPeelingDepth) + 2, 0);
+    for (size_t h_id = 0; h_id < numCells; h_id++) {
+        int depth = std::min(cellDepths[h_id], maxPeelingDepth + 1);
+        depthOffsets[depth]++;
+    }
+    size_t offset = 0;
+    for (size_t depth = 0; depth < depthOffsets.size(); depth++) {
+        size_t count = depthOffsets[depth];
+        depthOffsets[depth] = offset;
+        offset += count;
+    }
+    std::vector<size_t> depthWriteOffsets(depthOffsets);
+    sortedCellIds.resize(numCells);
+    for (size_t h_id = 0; h_id < numCells; h_id++) {
+        int depth = std::min(cellDepths[h_id], maxPeelingDepth + 1);
+        sortedCellIds[depthWriteOffsets[depth]++] = uint32_t(h_id);
+    }
 
     cellDepths.shrink_to_fit();
+    filterMask.resize(numCells);
+    numFilteredCells = 0;
 }
 
 void PeelingFilter::filterMesh(HexMeshPtr meshIn) {
@@ -82,13 +158,16 @@ void PeelingFilter::filterMesh(HexMeshPtr meshIn) {
         onMeshLoaded(meshIn);
     }
 
+    // Changing the peeling depth only toggles the cells with a depth between the old and the new peeling depth.
     output = meshIn;
-    Mesh& mesh = meshIn->getBaseComplexMesh();
-    for (Hybrid& h : mesh.Hs) {
-        if (cellDepths.at(h.id) < peelingDepth) {
-            meshIn->markCell(h.id);
-        }
+    size_t numFilteredCellsNew = depthOffsets.at(size_t(std::max(std::min(peelingDepth, maxPeelingDepth + 1), 0)));
+    for (size_t i = numFilteredCells; i < numFilteredCellsNew; i++) {
+        filterMask.set(sortedCellIds[i]);
+    }
+    for (size_t i = numFilteredCellsNew; i < numFilteredCells; i++) {
+        filterMask.reset(sortedCellIds[i]);
     }
+    numFilteredCells = numFilteredCellsNew;
     dirty = false;
 }
 
@@ -101,3 +180,10 @@ void PeelingFilter::renderGui() {
     }
     ImGui::End();
 }
+
+void PeelingFilter::setNewSettings(const SettingsMap& settings) {
+    if (settings.getValueOpt("peeling_depth", peelingDepth)) {
+        peelingDepth = std::max(std::min(peelingDepth, maxPeelingDepth), 0);
+        dirty = true;
+    }
+}
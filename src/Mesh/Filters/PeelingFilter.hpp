@@ -29,6 +29,7 @@
 #ifndef HEXVOLUMERENDERER_PEELINGFILTER_HPP
 #define HEXVOLUMERENDERER_PEELINGFILTER_HPP
 
+#include <vector>
 #include <glm/vec3.hpp>
 #include "HexahedralMeshFilter.hpp"
 
@@ -40,10 +41,18 @@ public:
     // Renders the GUI. The "dirty" flag might be set depending on the user's actions.
     virtual void renderGui() override;
 
+    virtual void setNewSettings(const SettingsMap& settings) override;
+
 protected:
     int peelingDepth = 0;
     int maxPeelingDepth = 0;
     std::vector<int> cellDepths;
+
+    // Cells sorted by their depth, and the offset of the first cell of each depth in sortedCellIds.
+    std::vector<uint32_t> sortedCellIds;
+    std::vector<size_t> depthOffsets;
+    // Length of the prefix of sortedCellIds currently set in the filter mask.
+    size_t numFilteredCells = 0;
 };
 
 #endif //HEXVOLUMERENDERER_PEELINGFILTER_HPP
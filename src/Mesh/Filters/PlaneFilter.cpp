@@ -26,35 +26,92 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <numeric>
+#include <limits>
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Mesh/BaseComplex/global_types.h"
+#include "Utils/InternalState.hpp"
 #include "PlaneFilter.hpp"
 
-void PlaneFilter::filterMesh(HexMeshPtr meshIn) {
-    output = meshIn;
+void PlaneFilter::onMeshLoaded(HexMeshPtr meshIn) {
+    sortedCellIds.clear();
+    sortedCellProjections.clear();
+    numFilteredCells = 0;
+}
+
+void PlaneFilter::onInputMeshChanged(HexMeshPtr meshIn) {
+    // The vertex positions might have changed, so the cells need to be sorted again.
+    onMeshLoaded(meshIn);
+}
+
+void PlaneFilter::updateSortedCells(HexMeshPtr meshIn) {
     Mesh& mesh = meshIn->getBaseComplexMesh();
     glm::vec3 normalizedDirection = glm::normalize(direction);
 
+    std::vector<float> vertexProjections(mesh.Vs.size());
     float minOffset = std::numeric_limits<float>::max();
     float maxOffset = std::numeric_limits<float>::lowest();
-    for (Hybrid_V& v : mesh.Vs) {
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) reduction(min: minOffset) reduction(max: maxOffset) \
+    shared(mesh, vertexProjections, normalizedDirection)
+#endif
+    for (size_t v_id = 0; v_id < mesh.Vs.size(); v_id++) {
         float offset = glm::dot(normalizedDirection,
-                glm::vec3(mesh.V(0, v.id), mesh.V(1, v.id), mesh.V(2, v.id)));
+                glm::vec3(mesh.V(0, v_id), mesh.V(1, v_id), mesh.V(2, v_id)));
+        vertexProjections.at(v_id) = offset;
         minOffset = std::min(minOffset, offset);
         maxOffset = std::max(maxOffset, offset);
     }
-    float offset = minOffset + (maxOffset - minOffset) * filterRatio;
+    minProjection = minOffset;
+    maxProjection = maxOffset;
 
-    for (Hybrid& h : mesh.Hs) {
-        for (uint32_t v_id : h.vs) {
-            if (glm::dot(normalizedDirection,
-                    glm::vec3(mesh.V(0, v_id), mesh.V(1, v_id), mesh.V(2, v_id))) < offset) {
-                meshIn->markCell(h.id);
-                break;
-            }
+    std::vector<float> cellProjections(mesh.Hs.size());
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(mesh, vertexProjections, cellProjections)
+#endif
+    for (size_t h_id = 0; h_id < mesh.Hs.size(); h_id++) {
+        float cellProjection = std::numeric_limits<float>::max();
+        for (uint32_t v_id : mesh.Hs.at(h_id).vs) {
+            cellProjection = std::min(cellProjection, vertexProjections.at(v_id));
         }
+        cellProjections.at(h_id) = cellProjection;
     }
+
+    sortedCellIds.resize(mesh.Hs.size());
+    std::iota(sortedCellIds.begin(), sortedCellIds.end(), 0);
+    std::sort(sortedCellIds.begin(), sortedCellIds.end(), [&cellProjections](uint32_t h0, uint32_t h1) {
+        return cellProjections[h0] < cellProjections[h1];
+    });
+    sortedCellProjections.resize(mesh.Hs.size());
+    for (size_t i = 0; i < sortedCellIds.size(); i++) {
+        sortedCellProjections.at(i) = cellProjections.at(sortedCellIds.at(i));
+    }
+
+    sortedCellsDirection = direction;
+    filterMask.resize(mesh.Hs.size());
+    numFilteredCells = 0;
+}
+
+void PlaneFilter::filterMesh(HexMeshPtr meshIn) {
+    output = meshIn;
+    if (sortedCellIds.size() != meshIn->getBaseComplexMesh().Hs.size() || sortedCellsDirection != direction) {
+        updateSortedCells(meshIn);
+    }
+
+    // Slider drags only move the end of the filtered prefix. Thus, only the cells between the old and the new end
+    // need to be marked or unmarked.
+    float offset = minProjection + (maxProjection - minProjection) * filterRatio;
+    size_t numFilteredCellsNew = size_t(std::lower_bound(
+            sortedCellProjections.begin(), sortedCellProjections.end(), offset) - sortedCellProjections.begin());
+    for (size_t i = numFilteredCells; i < numFilteredCellsNew; i++) {
+        filterMask.set(sortedCellIds[i]);
+    }
+    for (size_t i = numFilteredCellsNew; i < numFilteredCells; i++) {
+        filterMask.reset(sortedCellIds[i]);
+    }
+    numFilteredCells = numFilteredCellsNew;
     dirty = false;
 }
 
@@ -70,3 +127,12 @@ void PlaneFilter::renderGui() {
     }
     ImGui::End();
 }
+
+void PlaneFilter::setNewSettings(const SettingsMap& settings) {
+    if (settings.getValueOpt("filter_ratio", filterRatio)) {
+        dirty = true;
+    }
+    if (settings.getValueOpt("direction", direction)) {
+        dirty = true;
+    }
+}
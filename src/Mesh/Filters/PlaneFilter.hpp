@@ -29,19 +29,39 @@
 #ifndef FILTERS_PLANEFILTER_HPP
 #define FILTERS_PLANEFILTER_HPP
 
+#include <vector>
 #include <glm/vec3.hpp>
 #include "HexahedralMeshFilter.hpp"
 
 class PlaneFilter : public HexahedralMeshFilter {
 public:
+    virtual void onMeshLoaded(HexMeshPtr meshIn);
+    virtual void onInputMeshChanged(HexMeshPtr meshIn);
     virtual void filterMesh(HexMeshPtr meshIn);
 
     // Renders the GUI. The "dirty" flag might be set depending on the user's actions.
     virtual void renderGui();
 
+    virtual void setNewSettings(const SettingsMap& settings);
+
 protected:
+    /**
+     * Sorts the cells by the minimum projection of their vertices onto the normalized plane direction.
+     * A cell is filtered iff this minimum lies below the plane offset, i.e., the filtered cells are always a prefix of
+     * the sorted order. Only needs to be called when the mesh or the direction changes.
+     */
+    void updateSortedCells(HexMeshPtr meshIn);
+
     float filterRatio = 0.0f;
     glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    // Cells sorted by their minimum projection (and the sorted projections for binary search).
+    std::vector<uint32_t> sortedCellIds;
+    std::vector<float> sortedCellProjections;
+    glm::vec3 sortedCellsDirection = glm::vec3(0.0f);
+    float minProjection = 0.0f, maxProjection = 0.0f;
+    // Length of the prefix of sortedCellIds currently set in the filter mask.
+    size_t numFilteredCells = 0;
 };
 
 #endif // FILTERS_PLANEFILTER_HPP
\ No newline at end of file
@@ -26,23 +26,107 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <cmath>
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Mesh/BaseComplex/global_types.h"
+#include "Utils/InternalState.hpp"
+#include "Utils/ParallelRadixSort.hpp"
 #include "QualityFilter.hpp"
 
+namespace {
+struct CellAttributeRecord {
+    uint32_t key;
+    uint32_t h_id;
+};
+
+/// Maps a float to an unsigned integer key with the same order. NaN is mapped to the largest key, -0 to +0.
+inline uint32_t getOrderedFloatKey(float value) {
+    if (std::isnan(value)) {
+        return 0xFFFFFFFFu;
+    }
+    if (value == 0.0f) {
+        value = 0.0f;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(uint32_t));
+    return (bits & 0x80000000u) != 0u ? ~bits : bits | 0x80000000u;
+}
+}
+
+void QualityFilter::onMeshLoaded(HexMeshPtr meshIn) {
+    sortedCellIds.clear();
+    sortedCellAttributes.clear();
+    numFilteredCells = 0;
+}
+
+void QualityFilter::onInputMeshChanged(HexMeshPtr meshIn) {
+    // The cell attributes might have changed (e.g., a different quality measure), so the cells need to be sorted again.
+    onMeshLoaded(meshIn);
+}
+
+void QualityFilter::updateSortedCells(HexMeshPtr meshIn) {
+    size_t numCells = meshIn->getBaseComplexMesh().Hs.size();
+    HexMesh* hexMesh = meshIn.get();
+
+    std::vector<CellAttributeRecord> records(numCells);
+#if _OPENMP >= 200805
+    #pragma omp parallel for default(none) shared(records, hexMesh, numCells)
+#endif
+    for (size_t h_id = 0; h_id < numCells; h_id++) {
+        records[h_id].key = getOrderedFloatKey(hexMesh->getCellAttribute(uint32_t(h_id)));
+        records[h_id].h_id = uint32_t(h_id);
+    }
+    parallelRadixSort(records, 32, [](const CellAttributeRecord& record, uint32_t pass) {
+        return (record.key >> (pass * 8u)) & 0xFFu;
+    });
+
+    sortedCellIds.resize(numCells);
+    sortedCellAttributes.resize(numCells);
+#if _OPENMP >= 200805
+    #pragma omp parallel for default(none) shared(records, hexMesh, numCells)
+#endif
+    for (size_t i = 0; i < numCells; i++) {
+        sortedCellIds[i] = records[i].h_id;
+        sortedCellAttributes[i] = hexMesh->getCellAttribute(records[i].h_id);
+    }
+
+    filterMask.resize(numCells);
+    numFilteredCells = 0;
+}
+
 void QualityFilter::filterMesh(HexMeshPtr meshIn) {
     output = meshIn;
-    Mesh& mesh = meshIn->getBaseComplexMesh();
+    if (sortedCellIds.size() != meshIn->getBaseComplexMesh().Hs.size()) {
+        updateSortedCells(meshIn);
+    }
 
-    for (Hybrid& h : mesh.Hs) {
-        if (meshIn->getCellAttribute(h.id) < filterRatio) {
-            meshIn->markCell(h.id);
-        }
+    // Threshold changes only move the end of the filtered prefix, so only the cells in between need to be updated.
+    size_t numFilteredCellsNew = getNumCellsBelow(filterRatio);
+    for (size_t i = numFilteredCells; i < numFilteredCellsNew; i++) {
+        filterMask.set(sortedCellIds[i]);
+    }
+    for (size_t i = numFilteredCellsNew; i < numFilteredCells; i++) {
+        filterMask.reset(sortedCellIds[i]);
     }
+    numFilteredCells = numFilteredCellsNew;
     dirty = false;
 }
 
+size_t QualityFilter::getNumCellsBelow(float threshold) const {
+    // NaN attributes are stored at the end and never compare less than the threshold, like in the unsorted case.
+    return size_t(std::lower_bound(sortedCellAttributes.begin(), sortedCellAttributes.end(), threshold)
+            - sortedCellAttributes.begin());
+}
+
+size_t QualityFilter::getNumCellsInRange(float lower, float upper) const {
+    size_t numCellsBelowLower = getNumCellsBelow(lower);
+    size_t numCellsBelowUpper = getNumCellsBelow(upper);
+    return numCellsBelowUpper > numCellsBelowLower ? numCellsBelowUpper - numCellsBelowLower : 0;
+}
+
 void QualityFilter::renderGui() {
     sgl::ImGuiWrapper::get()->setNextWindowStandardPosSize(3025, 1395, 800, 110);
     if (ImGui::Begin("Quality Filter", &showFilterWindow)) {
@@ -52,3 +136,9 @@ void QualityFilter::renderGui() {
     }
     ImGui::End();
 }
+
+void QualityFilter::setNewSettings(const SettingsMap& settings) {
+    if (settings.getValueOpt("filter_ratio", filterRatio)) {
+        dirty = true;
+    }
+}
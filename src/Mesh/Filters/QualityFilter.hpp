@@ -29,18 +29,50 @@
 #ifndef HEXVOLUMERENDERER_QUALITYFILTER_HPP
 #define HEXVOLUMERENDERER_QUALITYFILTER_HPP
 
+#include <vector>
 #include <glm/vec3.hpp>
 #include "HexahedralMeshFilter.hpp"
 
 class QualityFilter : public HexahedralMeshFilter {
 public:
+    virtual void onMeshLoaded(HexMeshPtr meshIn);
+    virtual void onInputMeshChanged(HexMeshPtr meshIn);
     virtual void filterMesh(HexMeshPtr meshIn);
 
     // Renders the GUI. The "dirty" flag might be set depending on the user's actions.
     virtual void renderGui();
 
+    virtual void setNewSettings(const SettingsMap& settings);
+
+    /*
+     * Range queries on the cell attribute in O(log n). They are valid after the filter was applied to the mesh, i.e.,
+     * they can be used, e.g., for computing visible cell counts or histogram bins for any threshold.
+     */
+    /// Returns the number of cells with an attribute below the passed threshold (i.e., filtered for this threshold).
+    size_t getNumCellsBelow(float threshold) const;
+    /// Returns the number of cells not filtered for the passed threshold.
+    inline size_t getNumVisibleCells(float threshold) const {
+        return sortedCellIds.size() - getNumCellsBelow(threshold);
+    }
+    /// Returns the number of cells with an attribute in the range [lower, upper).
+    size_t getNumCellsInRange(float lower, float upper) const;
+    /// The cell IDs sorted by their attribute in ascending order (NaN attributes come last).
+    inline const std::vector<uint32_t>& getSortedCellIds() const { return sortedCellIds; }
+
 protected:
+    /**
+     * Sorts the cells by their attribute. The cells filtered for a threshold are always a prefix of the sorted order.
+     * Only needs to be called when the mesh or its attribute changes.
+     */
+    void updateSortedCells(HexMeshPtr meshIn);
+
     float filterRatio = 0.0f;
+
+    // Cells sorted by their attribute (and the sorted attributes for binary search).
+    std::vector<uint32_t> sortedCellIds;
+    std::vector<float> sortedCellAttributes;
+    // Length of the prefix of sortedCellIds currently set in the filter mask.
+    size_t numFilteredCells = 0;
 };
 
 #endif //HEXVOLUMERENDERER_QUALITYFILTER_HPP
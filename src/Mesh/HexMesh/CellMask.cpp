@@ -0,0 +1,103 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CellMask.hpp"
+
+void CellMask::resize(size_t numCellsNew) {
+    numCells = numCellsNew;
+    numSetBits = 0;
+    size_t numBlocks = (numCells + CELLS_PER_BLOCK - 1) / CELLS_PER_BLOCK;
+    // The words are padded to full blocks; the padding bits are never set.
+    words.assign(numBlocks * WORDS_PER_BLOCK, 0ull);
+    blockCounts.assign(numBlocks, 0);
+    blockGenerations.assign(numBlocks, generation);
+    version++;
+}
+
+void CellMask::clear() {
+    for (size_t blockIdx = 0; blockIdx < blockCounts.size(); blockIdx++) {
+        if (blockCounts[blockIdx] != 0) {
+            std::fill(
+                    words.begin() + blockIdx * WORDS_PER_BLOCK, words.begin() + (blockIdx + 1) * WORDS_PER_BLOCK, 0ull);
+            blockCounts[blockIdx] = 0;
+            blockGenerations[blockIdx] = generation;
+            version++;
+        }
+    }
+    numSetBits = 0;
+}
+
+void CellMask::getBlocksChangedSince(uint64_t syncedGeneration, std::vector<uint32_t>& blockIndices) const {
+    for (size_t blockIdx = 0; blockIdx < blockGenerations.size(); blockIdx++) {
+        if (blockGenerations[blockIdx] > syncedGeneration) {
+            blockIndices.push_back(uint32_t(blockIdx));
+        }
+    }
+}
+
+void CellMask::setToUnion(const std::vector<const CellMask*>& masks) {
+    size_t numMasks = masks.size();
+    size_t numBlocks = blockCounts.size();
+    uint64_t* wordsOut = words.data();
+    uint32_t* blockCountsOut = blockCounts.data();
+    uint64_t* blockGenerationsOut = blockGenerations.data();
+    uint64_t currentGeneration = generation;
+    std::vector<const uint64_t*> maskWords(numMasks);
+    for (size_t maskIdx = 0; maskIdx < numMasks; maskIdx++) {
+        maskWords.at(maskIdx) = masks.at(maskIdx)->getWords();
+    }
+
+    // Each block is processed by exactly one thread, so its count and generation can be updated without atomics.
+    size_t numSetBitsNew = 0;
+    size_t numChangedBlocks = 0;
+#if _OPENMP >= 200805
+    #pragma omp parallel for default(none) reduction(+: numSetBitsNew, numChangedBlocks) \
+    shared(maskWords, wordsOut, blockCountsOut, blockGenerationsOut, currentGeneration, numMasks, numBlocks)
+#endif
+    for (size_t blockIdx = 0; blockIdx < numBlocks; blockIdx++) {
+        bool blockChanged = false;
+        uint32_t blockCount = 0;
+        for (size_t wordIdx = blockIdx * WORDS_PER_BLOCK; wordIdx < (blockIdx + 1) * WORDS_PER_BLOCK; wordIdx++) {
+            uint64_t word = 0ull;
+            for (size_t maskIdx = 0; maskIdx < numMasks; maskIdx++) {
+                word |= maskWords[maskIdx][wordIdx];
+            }
+            blockChanged = blockChanged || word != wordsOut[wordIdx];
+            blockCount += popcount(word);
+            wordsOut[wordIdx] = word;
+        }
+        if (blockChanged) {
+            blockCountsOut[blockIdx] = blockCount;
+            blockGenerationsOut[blockIdx] = currentGeneration;
+            numChangedBlocks++;
+        }
+        numSetBitsNew += blockCount;
+    }
+    numSetBits = numSetBitsNew;
+    version += numChangedBlocks;
+}
@@ -0,0 +1,151 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXMESH_CELLMASK_HPP
+#define HEXMESH_CELLMASK_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * A bit set storing one flag per cell (e.g., whether the cell was filtered).
+ * The bits are packed into 64-bit words so that multiple masks can be combined word by word.
+ *
+ * The words are grouped into blocks of CELLS_PER_BLOCK cells. For each block, the number of set bits and the
+ * generation of the last change are stored. This way, consumers of the mask (e.g., the render data extractors) can
+ * skip blocks with all bits set, and only revisit the blocks changed since they last synchronized with the mask:
+ *
+ * uint64_t syncedGeneration = mask.synchronize();
+ * ... (the mask is changed)
+ * for (size_t blockIdx = 0; blockIdx < mask.getNumBlocks(); blockIdx++) {
+ *     if (mask.isBlockChangedSince(blockIdx, syncedGeneration)) { ... }
+ * }
+ */
+class CellMask {
+public:
+    static const size_t BITS_PER_WORD = 64;
+    static const size_t WORDS_PER_BLOCK = 8;
+    static const size_t CELLS_PER_BLOCK = BITS_PER_WORD * WORDS_PER_BLOCK;
+
+    /// Resizes the mask to the passed number of cells. All bits are cleared and all blocks count as changed.
+    void resize(size_t numCellsNew);
+    /// Clears all bits.
+    void clear();
+
+    inline size_t size() const { return numCells; }
+    inline size_t getNumWords() const { return words.size(); }
+    inline const uint64_t* getWords() const { return words.data(); }
+    /// Returns the total number of set bits.
+    inline size_t count() const { return numSetBits; }
+
+    inline void set(uint32_t h_id) {
+        uint64_t& word = words[h_id / BITS_PER_WORD];
+        uint64_t bit = 1ull << (h_id % BITS_PER_WORD);
+        if ((word & bit) == 0ull) {
+            word |= bit;
+            onBitChanged(h_id / CELLS_PER_BLOCK, 1);
+        }
+    }
+    inline void reset(uint32_t h_id) {
+        uint64_t& word = words[h_id / BITS_PER_WORD];
+        uint64_t bit = 1ull << (h_id % BITS_PER_WORD);
+        if ((word & bit) != 0ull) {
+            word &= ~bit;
+            onBitChanged(h_id / CELLS_PER_BLOCK, -1);
+        }
+    }
+    inline bool test(uint32_t h_id) const { return (words[h_id / BITS_PER_WORD] >> (h_id % BITS_PER_WORD)) & 1ull; }
+
+    // Block queries.
+    inline size_t getNumBlocks() const { return blockCounts.size(); }
+    inline size_t getBlockBegin(size_t blockIdx) const { return blockIdx * CELLS_PER_BLOCK; }
+    inline size_t getBlockEnd(size_t blockIdx) const { return std::min((blockIdx + 1) * CELLS_PER_BLOCK, numCells); }
+    /// Returns the number of set bits in the block.
+    inline uint32_t getBlockCount(size_t blockIdx) const { return blockCounts[blockIdx]; }
+    inline bool isBlockEmpty(size_t blockIdx) const { return blockCounts[blockIdx] == 0; }
+    inline bool isBlockFull(size_t blockIdx) const {
+        return blockCounts[blockIdx] == getBlockEnd(blockIdx) - getBlockBegin(blockIdx);
+    }
+
+    // Change tracking.
+    /**
+     * Starts a new generation of changes.
+     * @return The generation to pass to @see isBlockChangedSince for querying the blocks changed after this call.
+     */
+    inline uint64_t synchronize() { return generation++; }
+    inline bool isBlockChangedSince(size_t blockIdx, uint64_t syncedGeneration) const {
+        return blockGenerations[blockIdx] > syncedGeneration;
+    }
+    /// Appends the indices of all blocks changed after the passed generation to blockIndices.
+    void getBlocksChangedSince(uint64_t syncedGeneration, std::vector<uint32_t>& blockIndices) const;
+    /**
+     * Returns a counter that is incremented by every change of the mask (and by resize). In contrast to the
+     * generations, it doesn't need synchronization, so it can be stored as part of a cache key.
+     */
+    inline uint64_t getVersion() const { return version; }
+
+    /**
+     * Sets this mask to the union of the passed masks, i.e., a bit is set iff it is set in any of the masks.
+     * The blocks are combined in parallel. All masks need to have the same size as this mask.
+     * @param masks The masks to combine. If the list is empty, all bits are cleared.
+     */
+    void setToUnion(const std::vector<const CellMask*>& masks);
+
+    static inline uint32_t popcount(uint64_t word) {
+#ifdef _MSC_VER
+        return uint32_t(__popcnt64(word));
+#else
+        return uint32_t(__builtin_popcountll(word));
+#endif
+    }
+
+private:
+    inline void onBitChanged(size_t blockIdx, int delta) {
+        blockCounts[blockIdx] += delta;
+        numSetBits += delta;
+        blockGenerations[blockIdx] = generation;
+        version++;
+    }
+
+    size_t numCells = 0;
+    size_t numSetBits = 0;
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> blockCounts;
+    std::vector<uint64_t> blockGenerations;
+    // Generation 0 is reserved for consumers that never synchronized with the mask.
+    uint64_t generation = 1;
+    uint64_t version = 0;
+};
+
+#endif //HEXMESH_CELLMASK_HPP
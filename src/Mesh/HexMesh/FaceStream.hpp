@@ -0,0 +1,116 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXMESH_FACESTREAM_HPP
+#define HEXMESH_FACESTREAM_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class HexMesh;
+
+/**
+ * A structure-of-arrays view of all faces and edges of a hexahedral mesh that the face-based render data extractors
+ * of @see HexMesh derive their output from, instead of each traversing the base-complex mesh and testing the
+ * filtering state of the neighboring cells on their own. The data is kept up to date by @see HexMesh::getFaceStream.
+ *
+ * The stream consists of two parts:
+ * - The static part (vertex, edge and cell IDs, cell attributes and edge singularity information), which is only
+ *   regenerated when the mesh data changes.
+ * - The visibility part (the filtering flags of the faces and edges and the lists of visible faces and edges), which is
+ *   regenerated when the cell filtering mask changed since the last update.
+ * Both parts are generated in parallel. The lists of visible faces and edges are sorted by ID, so extractors iterating
+ * over them produce the same output as a serial loop over all faces (or edges) skipping the filtered ones.
+ */
+class FaceStream {
+    friend class HexMesh;
+public:
+    static const uint32_t INVALID_CELL = 0xFFFFFFFFu;
+
+    // Face flags.
+    enum FaceFlag : uint8_t {
+        FACE_BOUNDARY = 1u, ///< The face lies on the boundary of the mesh.
+        FACE_FRONT_CELL_FILTERED = 2u, ///< The first cell of the face is filtered.
+        FACE_BACK_CELL_FILTERED = 4u, ///< The face has a second cell, which is filtered.
+        FACE_VISIBLE = 8u, ///< Not all cells of the face are filtered.
+        /// The face is a boundary face or a face between a filtered and another cell (cf. HexMesh::getSurfaceData).
+        FACE_ON_FILTERED_SURFACE = 16u
+    };
+
+    inline size_t getNumFaces() const { return faceFlags.size(); }
+    inline size_t getNumEdges() const { return edgeSingularityInformation.size(); }
+
+    /// The four vertex IDs of a face.
+    inline const uint32_t* getFaceVertexIds(size_t f_id) const { return &faceVertexIds[f_id * 4]; }
+    /// The four edge IDs of a face.
+    inline const uint32_t* getFaceEdgeIds(size_t f_id) const { return &faceEdgeIds[f_id * 4]; }
+    /// The cell on the passed side (0 or 1) of a face, or INVALID_CELL for the outer side of a boundary face.
+    inline uint32_t getFaceCellId(size_t f_id, size_t side) const { return faceCellIds[f_id * 2 + side]; }
+    /// The attribute (cf. HexMesh::getCellAttribute) of the cell on the passed side of a face, or zero.
+    inline float getFaceCellAttribute(size_t f_id, size_t side) const { return faceCellAttributes[f_id * 2 + side]; }
+
+    inline uint8_t getFaceFlags(size_t f_id) const { return faceFlags[f_id]; }
+    inline bool getIsFaceBoundary(size_t f_id) const { return (faceFlags[f_id] & FACE_BOUNDARY) != 0; }
+    inline bool getIsFaceVisible(size_t f_id) const { return (faceFlags[f_id] & FACE_VISIBLE) != 0; }
+    inline bool getIsFaceOnFilteredSurface(size_t f_id) const {
+        return (faceFlags[f_id] & FACE_ON_FILTERED_SURFACE) != 0;
+    }
+
+    /// The packed singularity information of an edge (cf. HexMesh::packEdgeSingularityInformation).
+    inline uint32_t getEdgeSingularityInformation(size_t e_id) const { return edgeSingularityInformation[e_id]; }
+    inline bool getIsEdgeSingular(size_t e_id) const { return (edgeSingularityInformation[e_id] & 1u) != 0u; }
+    inline bool getIsEdgeBoundary(size_t e_id) const { return (edgeSingularityInformation[e_id] & 2u) != 0u; }
+    inline int getEdgeValence(size_t e_id) const { return int(edgeSingularityInformation[e_id] >> 2u); }
+    /// Whether not all cells of the edge are filtered.
+    inline bool getIsEdgeVisible(size_t e_id) const { return edgeVisibility[e_id] != 0; }
+
+    /// The IDs of all visible faces and edges in ascending order.
+    inline const std::vector<uint32_t>& getVisibleFaceIds() const { return visibleFaceIds; }
+    inline const std::vector<uint32_t>& getVisibleEdgeIds() const { return visibleEdgeIds; }
+
+private:
+    // Static part.
+    std::vector<uint32_t> faceVertexIds;
+    std::vector<uint32_t> faceEdgeIds;
+    std::vector<uint32_t> faceCellIds;
+    std::vector<float> faceCellAttributes;
+    std::vector<uint32_t> edgeSingularityInformation;
+
+    // Visibility part. FACE_BOUNDARY is part of the static data.
+    std::vector<uint8_t> faceFlags;
+    std::vector<uint8_t> edgeVisibility;
+    std::vector<uint32_t> visibleFaceIds;
+    std::vector<uint32_t> visibleEdgeIds;
+
+    // The state of the mesh the data was generated for.
+    uint64_t meshDataGeneration = 0;
+    uint64_t cellMaskGeneration = 0;
+};
+
+#endif //HEXMESH_FACESTREAM_HPP
@@ -0,0 +1,89 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXMESH_FILTEREDSURFACEDATA_HPP
+#define HEXMESH_FILTEREDSURFACEDATA_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/vec3.hpp>
+
+class HexMesh;
+
+/**
+ * The triangle data of the boundary surface of the filtered hexahedral mesh, i.e., the same data as returned by
+ * @see HexMesh::getSurfaceData. The data is kept up to date by @see HexMesh::updateFilteredSurfaceData.
+ *
+ * Each visible face side (i.e., the side of a face belonging to an unfiltered cell where the face is either a boundary
+ * face or its other cell is filtered) occupies one slot of four vertices and six triangle indices. After a filter
+ * change, only the slots of the faces adjacent to changed cells are added or removed (by moving the last slot into the
+ * removed one). Thus, the order of the faces may differ from the one of @see HexMesh::getSurfaceData.
+ */
+class FilteredSurfaceData {
+    friend class HexMesh;
+public:
+    // Renderer-facing data. It may be uploaded directly, but must not be changed outside of HexMesh.
+    std::vector<uint32_t> triangleIndices;
+    std::vector<glm::vec3> vertexPositions;
+    std::vector<glm::vec3> vertexNormals;
+    std::vector<float> vertexAttributes;
+
+    /// The number of slots (i.e., visible face sides).
+    inline size_t getNumFaces() const { return slotFaceSides.size(); }
+    /// The face ID of the passed slot.
+    inline uint32_t getFaceId(size_t slot) const { return slotFaceSides[slot] / 2u; }
+    /// Whether the passed slot belongs to the second cell of its face (i.e., the winding order is inverted).
+    inline bool getIsFaceSideInverted(size_t slot) const { return (slotFaceSides[slot] & 1u) != 0u; }
+
+    /// Whether the last update regenerated all data (e.g., for a new mesh) or only patched the changed slots.
+    inline bool getWasRebuilt() const { return wasRebuilt; }
+    /**
+     * All slots starting at this index were changed by the last update (or are new), i.e., the vertices starting at
+     * 4 * getFirstChangedFace() and the indices starting at 6 * getFirstChangedFace() need to be uploaded again.
+     */
+    inline size_t getFirstChangedFace() const { return firstChangedFace; }
+
+private:
+    static const uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    // Slot -> face side (2 * f_id + side) and face side -> slot.
+    std::vector<uint32_t> slotFaceSides;
+    std::vector<uint32_t> faceSideSlots;
+
+    // The state of the mesh the data was generated for.
+    const HexMesh* hexMesh = nullptr;
+    uint64_t meshDataGeneration = 0;
+    uint64_t cellMaskGeneration = 0;
+    std::vector<uint64_t> cellMaskWords;
+
+    bool wasRebuilt = false;
+    size_t firstChangedFace = 0;
+};
+
+#endif //HEXMESH_FILTEREDSURFACEDATA_HPP
@@ -59,6 +59,7 @@
 #include <algorithm>
 #include <functional>
 #include <unordered_map>
+#include <chrono>
 
 #include <glm/detail/setup.hpp>
 #if GLM_VERSION_MAJOR == 1 && GLM_VERSION_MINOR == 0 && GLM_VERSION_PATCH == 0
@@ -68,18 +69,22 @@ template<class T> T epsilon() { return std::numeric_limits<T>::epsilon(); }
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/color_space.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include <Utils/File/Logfile.hpp>
+#include <Utils/File/FileUtils.hpp>
 #include <Utils/Random/Xorshift.hpp>
 
 #include "QualityMeasure/hex_quality.h"
 #include "QualityMeasure/hex_quality_color_maps.h"
+#include "QualityMeasure/hex_quality_batch.h"
 
 #include "Renderers/Helpers/HexahedronVolume.hpp"
 #include "Renderers/LOD/LodSheetGeneration.hpp"
+#include "Loaders/BinaryMeshCache.hpp"
 #include "../BaseComplex/base_complex.h"
+#include "Utils/ParallelCompaction.hpp"
 
-#include "EdgeKey.hpp"
 #include "HexMesh.hpp"
 
 const glm::vec4 HexMesh::glowColorRegular = glm::vec4(0.0f, 0.5f, 0.2f, 1.0f);
@@ -110,7 +115,10 @@ size_t getUsedSystemMemoryBytes()
 #endif
 
 HexMesh::HexMesh(sgl::TransferFunctionWindow &transferFunctionWindow, RayMeshIntersection& rayMeshIntersection)
-        : transferFunctionWindow(transferFunctionWindow), rayMeshIntersection(rayMeshIntersection) {
+        : transferFunctionWindow(&transferFunctionWindow), rayMeshIntersection(&rayMeshIntersection) {
+}
+
+HexMesh::HexMesh() {
 }
 
 HexMesh::~HexMesh() {
@@ -125,7 +133,8 @@ HexMesh::~HexMesh() {
 }
 
 void HexMesh::setHexMeshData(
-        const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices, bool loadMeshRepresentation) {
+        const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices, bool loadMeshRepresentation,
+        const BinaryMeshCache* meshCache) {
     if (mesh != nullptr) {
         delete mesh;
         mesh = nullptr;
@@ -141,13 +150,14 @@ void HexMesh::setHexMeshData(
 
     this->vertices = vertices;
     this->cellIndices = cellIndices;
+    precomputedQualityMeasures.clear();
     meshNumCells = cellIndices.size() / 8ull;
     meshNumVertices = vertices.size();
-    cellFilteringList.resize(meshNumCells);
+    cellFilteringMask.resize(meshNumCells);
     cellQualityMeasureList.resize(meshNumCells);
 
     if (loadMeshRepresentation) {
-        computeBaseComplexMesh(vertices, cellIndices);
+        computeBaseComplexMesh(vertices, cellIndices, meshCache);
     }
 
     cellVolumes.clear();
@@ -163,6 +173,7 @@ void HexMesh::setHexMeshData(
         sgl::Logfile::get()->writeInfo(std::string() + "Number of mesh cells: " + std::to_string(cellIndices.size()/8ull));
     }
 
+    onMeshDataChanged();
     dirty = true;
 }
 
@@ -187,6 +198,7 @@ void HexMesh::addManualVertexAttribute(const std::vector<float>& vertexAttribute
     manualVertexAttributes = &manualVertexAttributesList.at(manualVertexAttributeIdx);
 
     recomputeHistogram();
+    onMeshDataChanged();
 }
 
 void HexMesh::addManualCellAttribute(const std::vector<float>& cellAttributes, const std::string& attributeName) {
@@ -212,55 +224,12 @@ void HexMesh::addManualCellAttribute(const std::vector<float>& cellAttributes, c
     cellQualityMeasureList = cellAttributes;
 
     recomputeHistogram();
-}
-
-/**
- * Vertex and edge IDs:
- *
- *      3 +----------------+ 2
- *       /|       1       /|
- *   11 / |           10 / |
- *     /  |             /  |
- *    /   | 4          /   | 7
- * 7 +----------------+ 6  |
- *   |    |   2       |    |
- *   |    |           |    |
- *   |    |      0    |    |
- *   |  0 +-----------|----+ 1
- * 5 |   /          6 |   /
- *   |  / 8           |  / 9
- *   | /              | /
- *   |/      3        |/
- * 4 +----------------+ 5
- */
-void buildCellEdgeList(Mesh &mesh) {
-    EdgeMap edgeMap;
-    for (Hybrid_E& e : mesh.Es) {
-        edgeMap.insert(std::make_pair(EdgeKey(e.vs.at(0), e.vs.at(1)), e.id));
-    }
-
-    for (Hybrid& h : mesh.Hs) {
-        assert(h.es.empty());
-        h.es.resize(12);
-        h.es.at(0) = edgeMap.find(EdgeKey(h.vs.at(0), h.vs.at(1)))->second;
-        h.es.at(1) = edgeMap.find(EdgeKey(h.vs.at(2), h.vs.at(3)))->second;
-        h.es.at(2) = edgeMap.find(EdgeKey(h.vs.at(6), h.vs.at(7)))->second;
-        h.es.at(3) = edgeMap.find(EdgeKey(h.vs.at(4), h.vs.at(5)))->second;
-
-        h.es.at(4) = edgeMap.find(EdgeKey(h.vs.at(0), h.vs.at(3)))->second;
-        h.es.at(5) = edgeMap.find(EdgeKey(h.vs.at(4), h.vs.at(7)))->second;
-        h.es.at(6) = edgeMap.find(EdgeKey(h.vs.at(5), h.vs.at(6)))->second;
-        h.es.at(7) = edgeMap.find(EdgeKey(h.vs.at(1), h.vs.at(2)))->second;
-
-        h.es.at(8) = edgeMap.find(EdgeKey(h.vs.at(0), h.vs.at(4)))->second;
-        h.es.at(9) = edgeMap.find(EdgeKey(h.vs.at(1), h.vs.at(5)))->second;
-        h.es.at(10) = edgeMap.find(EdgeKey(h.vs.at(2), h.vs.at(6)))->second;
-        h.es.at(11) = edgeMap.find(EdgeKey(h.vs.at(3), h.vs.at(7)))->second;
-    }
+    onMeshDataChanged();
 }
 
 void HexMesh::computeBaseComplexMesh(
-        const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices) {
+        const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices,
+        const BinaryMeshCache* meshCache) {
     const uint32_t numVertices = vertices.size();
     const uint32_t numCells = cellIndices.size() / 8;
 
@@ -270,37 +239,54 @@ void HexMesh::computeBaseComplexMesh(
     mesh->type = Mesh_type::Hex;
     mesh->V.resize(3, numVertices);
     mesh->V.setZero();
-    mesh->Vs.resize(numVertices);
-
     for (uint32_t i = 0; i < numVertices; i++) {
         const glm::vec3 &vertexPosition = vertices.at(i);
         mesh->V(0, i) = vertexPosition.x;
         mesh->V(1, i) = vertexPosition.y;
         mesh->V(2, i) = vertexPosition.z;
-
-        Hybrid_V v;
-        v.id = i;
-        v.boundary = false;
-        mesh->Vs[i] = v;
     }
 
-    mesh->Hs.resize(numCells);
-    Hybrid h;
-    h.vs.resize(8);
-    for (uint32_t i = 0; i < numCells; i++) {
-        h.id = i;
-        for (int vertIdx = 0; vertIdx < 8; vertIdx++) {
-            uint32_t vertexIndex = cellIndices.at(i * 8 + vertIdx);
-            h.vs[vertIdx] = vertexIndex;
-            mesh->Vs[vertexIndex].neighbor_hs.push_back(h.id);
+    bool loadedFromCache = false;
+    if (meshCache != nullptr && meshCache->getHasConnectivity()) {
+        loadedFromCache = meshCache->readConnectivity(*mesh, *si);
+        if (loadedFromCache && (mesh->Vs.size() != numVertices || mesh->Hs.size() != numCells)) {
+            sgl::Logfile::get()->writeError(
+                    "Error in HexMesh::computeBaseComplexMesh: The mesh cache doesn't match the mesh data.");
+            mesh->Vs.clear();
+            mesh->Es.clear();
+            mesh->Fs.clear();
+            mesh->Hs.clear();
+            si->SVs.clear();
+            si->SEs.clear();
+            loadedFromCache = false;
         }
-        mesh->Hs[h.id] = h;
     }
 
-    build_connectivity(*mesh);
-    buildCellEdgeList(*mesh);
-    base_complex bc;
-    bc.singularity_structure(*si, *mesh);
+    if (!loadedFromCache) {
+        mesh->Vs.resize(numVertices);
+        for (uint32_t i = 0; i < numVertices; i++) {
+            Hybrid_V v;
+            v.id = i;
+            v.boundary = false;
+            mesh->Vs[i] = v;
+        }
+
+        mesh->Hs.resize(numCells);
+        Hybrid h;
+        h.vs.resize(8);
+        for (uint32_t i = 0; i < numCells; i++) {
+            h.id = i;
+            for (int vertIdx = 0; vertIdx < 8; vertIdx++) {
+                uint32_t vertexIndex = cellIndices.at(i * 8 + vertIdx);
+                h.vs[vertIdx] = vertexIndex;
+            }
+            mesh->Hs[h.id] = h;
+        }
+
+        build_connectivity(*mesh);
+        base_complex bc;
+        bc.singularity_structure(*si, *mesh);
+    }
 
     singularEdgeIds.clear();
     for (Singular_E& se : si->SEs) {
@@ -313,9 +299,28 @@ void HexMesh::computeBaseComplexMesh(
 void HexMesh::computeBaseComplexMeshFrame() {
     assert(frame == nullptr);
     frame = new Frame;
+    if (loadBaseComplexMeshFrameFromCache()) {
+        return;
+    }
+
     base_complex bc;
     bc.base_complex_extraction(*si, *frame, *mesh);
 
+    baseComplexFrameTimings = BaseComplexFrameTimings();
+    baseComplexFrameTimings.nodeEdgeExtractionMs = bc.timings.node_edge_ms;
+    baseComplexFrameTimings.faceExtractionMs = bc.timings.face_ms;
+    baseComplexFrameTimings.cuboidExtractionMs = bc.timings.cuboid_ms;
+    baseComplexFrameTimings.singularityAndColorMs = bc.timings.singularity_color_ms;
+    baseComplexFrameTimings.totalMs =
+            bc.timings.node_edge_ms + bc.timings.face_ms + bc.timings.cuboid_ms + bc.timings.singularity_color_ms;
+    sgl::Logfile::get()->writeInfo(
+            std::string() + "Base-complex frame extraction: " + std::to_string(baseComplexFrameTimings.totalMs)
+            + "ms (nodes and edges: " + std::to_string(baseComplexFrameTimings.nodeEdgeExtractionMs)
+            + "ms, faces: " + std::to_string(baseComplexFrameTimings.faceExtractionMs)
+            + "ms, cuboids: " + std::to_string(baseComplexFrameTimings.cuboidExtractionMs)
+            + "ms, singularity and colors: " + std::to_string(baseComplexFrameTimings.singularityAndColorMs)
+            + "ms)");
+
     // Set the singularity attribute on the frame vertices.
     std::unordered_set<uint32_t> singularVertexSet;
     for (size_t i = 0; i < si->SVs.size(); i++) {
@@ -326,6 +331,38 @@ void HexMesh::computeBaseComplexMeshFrame() {
     for (Frame_V &fv : frame->FVs) {
         fv.singular = (singularVertexSet.find(fv.hid) != singularVertexSet.end());
     }
+
+    if (!baseComplexCacheDirectory.empty()) {
+        HexBinSourceKey contentKey = BinaryMeshCache::computeContentKey(vertices.size(), cellIndices);
+        sgl::FileUtils::get()->ensureDirectoryExists(baseComplexCacheDirectory);
+        BinaryMeshCache::saveFrame(
+                BinaryMeshCache::getFrameCacheFilename(contentKey, baseComplexCacheDirectory),
+                contentKey, *si, *frame);
+    }
+}
+
+bool HexMesh::loadBaseComplexMeshFrameFromCache() {
+    if (baseComplexCacheDirectory.empty()) {
+        return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    HexBinSourceKey contentKey = BinaryMeshCache::computeContentKey(vertices.size(), cellIndices);
+    BinaryMeshCache frameCache;
+    if (!frameCache.open(BinaryMeshCache::getFrameCacheFilename(contentKey, baseComplexCacheDirectory), contentKey)
+            || !frameCache.readFrame(*mesh, *si, *frame)) {
+        return false;
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    // The singularity attribute of the frame vertices is stored in the cache.
+    baseComplexFrameTimings = BaseComplexFrameTimings();
+    baseComplexFrameTimings.totalMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    baseComplexFrameTimings.isLoadedFromCache = true;
+    sgl::Logfile::get()->writeInfo(
+            std::string() + "Base-complex frame loaded from cache: "
+            + std::to_string(baseComplexFrameTimings.totalMs) + "ms");
+    return true;
 }
 
 
@@ -346,6 +383,7 @@ void HexMesh::updateVertexPositions(const std::vector<glm::vec3>& vertices) {
         this->vertices.at(i) = vertices.at(i);
     }
 
+    precomputedQualityMeasures.clear();
     setQualityMeasure(qualityMeasure);
 
     dirty = true;
@@ -355,19 +393,214 @@ void HexMesh::onTransferFunctionMapRebuilt() {
     //dirty = true;
 }
 
-void HexMesh::markCell(uint32_t h_id) {
-    cellFilteringList.at(h_id) = true;
+void HexMesh::unmark() {
+    uint64_t cellMaskVersionOld = cellFilteringMask.getVersion();
+    cellFilteringMask.clear();
+    if (cellFilteringMask.getVersion() != cellMaskVersionOld) {
+        dirty = true;
+    }
 }
 
-bool HexMesh::isCellMarked(uint32_t h_id) {
-    return cellFilteringList.at(h_id);
+void HexMesh::setCellFilteringMasks(const std::vector<const CellMask*>& filterMasks) {
+    std::vector<const CellMask*> validFilterMasks;
+    validFilterMasks.reserve(filterMasks.size());
+    for (const CellMask* filterMask : filterMasks) {
+        if (filterMask->size() == cellFilteringMask.size()) {
+            validFilterMasks.push_back(filterMask);
+        } else {
+            sgl::Logfile::get()->writeError(
+                    "Error in HexMesh::setCellFilteringMasks: Filter mask size doesn't match the number of cells.");
+        }
+    }
+    // If the union didn't change, the renderers reuse their cached mappings and never reset the dirty flag.
+    uint64_t cellMaskVersionOld = cellFilteringMask.getVersion();
+    cellFilteringMask.setToUnion(validFilterMasks);
+    if (cellFilteringMask.getVersion() != cellMaskVersionOld) {
+        dirty = true;
+    }
 }
 
-void HexMesh::unmark() {
-    for (size_t i = 0; i < cellFilteringList.size(); i++) {
-        cellFilteringList.at(i) = false;
+/**
+ * Gathers the corners of the cells [cellOffset, cellOffset + numBatchCells) into lane-packed buffers. The batch is
+ * padded by repeating its last cell.
+ * @param getCellCorner A thread-safe functor (size_t h_id, int cornerIdx) -> glm::vec3 returning a cell corner.
+ */
+template<class CellCornerFunctor>
+static inline void gatherCellBatch(
+        CellCornerFunctor& getCellCorner, size_t cellOffset, size_t numBatchCells, HexaLab::HexCellBatch& cellBatch) {
+    for (size_t k = 0; k < HexaLab::QUALITY_MEASURE_BATCH_SIZE; k++) {
+        size_t h_id = cellOffset + std::min(k, numBatchCells - 1);
+        for (int j = 0; j < 8; j++) {
+            glm::vec3 corner = getCellCorner(h_id, j);
+            cellBatch.x[j][k] = corner.x;
+            cellBatch.y[j][k] = corner.y;
+            cellBatch.z[j][k] = corner.z;
+        }
+    }
+}
+
+/**
+ * Computes the quality of all cells with a batched quality measure kernel working on QUALITY_MEASURE_BATCH_SIZE cells
+ * at a time.
+ */
+template<class CellCornerFunctor>
+static void computeCellQualitiesBatched(
+        HexaLab::quality_measure_batch_fun* qualityBatchFunctor, const void* arg, size_t numCells,
+        CellCornerFunctor getCellCorner, std::vector<float>& cellQualityList, float& qualityMin, float& qualityMax) {
+    size_t batchSize = HexaLab::QUALITY_MEASURE_BATCH_SIZE;
+    size_t numBatches = (numCells + batchSize - 1) / batchSize;
+    float qualityMinLocal = qualityMin;
+    float qualityMaxLocal = qualityMax;
+
+#if _OPENMP >= 201107
+    #pragma omp parallel for reduction(min: qualityMinLocal) reduction(max: qualityMaxLocal) \
+            shared(qualityBatchFunctor, arg, numCells, getCellCorner, cellQualityList, batchSize, numBatches) \
+            default(none)
+#endif
+    for (size_t batchIdx = 0; batchIdx < numBatches; batchIdx++) {
+        size_t cellOffset = batchIdx * batchSize;
+        size_t numBatchCells = std::min(batchSize, numCells - cellOffset);
+        HexaLab::HexCellBatch cellBatch;
+        gatherCellBatch(getCellCorner, cellOffset, numBatchCells, cellBatch);
+
+        float qualities[HexaLab::QUALITY_MEASURE_BATCH_SIZE];
+        qualityBatchFunctor(cellBatch, arg, qualities);
+        for (size_t k = 0; k < numBatchCells; k++) {
+            qualityMinLocal = std::min(qualityMinLocal, qualities[k]);
+            qualityMaxLocal = std::max(qualityMaxLocal, qualities[k]);
+            cellQualityList[cellOffset + k] = qualities[k];
+        }
+    }
+
+    qualityMin = qualityMinLocal;
+    qualityMax = qualityMaxLocal;
+}
+
+/**
+ * Computes all quality measures of the cells [cellOffset, cellOffset + numCells) in one fused pass.
+ * @param cellQualityLists One list per measure (indexed by HexaLab::QualityMeasureEnum) of at least the size numCells.
+ * The quality of the cell cellOffset + i is stored at index i.
+ */
+template<class CellCornerFunctor>
+static void computeAllCellQualitiesBatched(
+        const void* arg, size_t cellOffset, size_t numCells, CellCornerFunctor getCellCorner,
+        std::vector<std::vector<float>>& cellQualityLists) {
+    size_t batchSize = HexaLab::QUALITY_MEASURE_BATCH_SIZE;
+    size_t numBatches = (numCells + batchSize - 1) / batchSize;
+    size_t numMeasures = HexaLab::NUM_QUALITY_MEASURES;
+
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) \
+            shared(arg, cellOffset, numCells, getCellCorner, cellQualityLists, batchSize, numBatches, numMeasures)
+#endif
+    for (size_t batchIdx = 0; batchIdx < numBatches; batchIdx++) {
+        size_t batchOffset = batchIdx * batchSize;
+        size_t numBatchCells = std::min(batchSize, numCells - batchOffset);
+        HexaLab::HexCellBatch cellBatch;
+        gatherCellBatch(getCellCorner, cellOffset + batchOffset, numBatchCells, cellBatch);
+
+        float qualities[HexaLab::NUM_QUALITY_MEASURES][HexaLab::QUALITY_MEASURE_BATCH_SIZE];
+        HexaLab::compute_all_quality_measures_batch(cellBatch, arg, qualities);
+        for (size_t measureIdx = 0; measureIdx < numMeasures; measureIdx++) {
+            std::vector<float>& cellQualityList = cellQualityLists[measureIdx];
+            for (size_t k = 0; k < numBatchCells; k++) {
+                cellQualityList[batchOffset + k] = qualities[measureIdx][k];
+            }
+        }
+    }
+}
+
+void HexMesh::setPrecomputeAllQualityMeasures(bool precompute) {
+    precomputeAllQualityMeasures = precompute;
+    if (!precompute) {
+        std::vector<PrecomputedQualityMeasure>().swap(precomputedQualityMeasures);
+    }
+}
+
+void HexMesh::precomputeQualityMeasures() {
+    // The raw qualities are only kept for one chunk of cells at a time. The first pass computes the range of each
+    // measure, and the second pass recomputes the qualities to normalize them with this range and store them as half
+    // floats. This keeps the peak memory close to the size of the half float storage.
+    const size_t chunkSize = size_t(1) << 16u;
+    float avgVolume = getAverageCellVolume();
+    std::vector<std::vector<float>> chunkQualityLists(
+            HexaLab::NUM_QUALITY_MEASURES, std::vector<float>(std::min(chunkSize, meshNumCells)));
+    auto computeChunkQualities = [&](size_t chunkOffset, size_t numChunkCells) {
+        if (mesh) {
+            computeAllCellQualitiesBatched(
+                    &avgVolume, chunkOffset, numChunkCells, [this](size_t h_id, int cornerIdx) {
+                        uint32_t v_id = mesh->Hs[h_id].vs[cornerIdx];
+                        return glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+                    }, chunkQualityLists);
+        } else {
+            computeAllCellQualitiesBatched(
+                    &avgVolume, chunkOffset, numChunkCells, [this](size_t h_id, int cornerIdx) {
+                        return vertices[cellIndices[h_id * 8 + cornerIdx]];
+                    }, chunkQualityLists);
+        }
+    };
+
+    precomputedQualityMeasures.resize(HexaLab::NUM_QUALITY_MEASURES);
+    for (PrecomputedQualityMeasure& precomputedQualityMeasure : precomputedQualityMeasures) {
+        precomputedQualityMeasure.normalizedQualities.resize(meshNumCells);
+        precomputedQualityMeasure.qualityMin = FLT_MAX;
+        precomputedQualityMeasure.qualityMax = -FLT_MAX;
+        precomputedQualityMeasure.qualityMinNormalized = FLT_MAX;
+        precomputedQualityMeasure.qualityMaxNormalized = -FLT_MAX;
+    }
+
+    // Pass 1: The range of the raw qualities of each measure.
+    for (size_t chunkOffset = 0; chunkOffset < meshNumCells; chunkOffset += chunkSize) {
+        size_t numChunkCells = std::min(chunkSize, meshNumCells - chunkOffset);
+        computeChunkQualities(chunkOffset, numChunkCells);
+        for (size_t measureIdx = 0; measureIdx < HexaLab::NUM_QUALITY_MEASURES; measureIdx++) {
+            const std::vector<float>& cellQualityList = chunkQualityLists.at(measureIdx);
+            PrecomputedQualityMeasure& precomputedQualityMeasure = precomputedQualityMeasures.at(measureIdx);
+            float measureMin = precomputedQualityMeasure.qualityMin;
+            float measureMax = precomputedQualityMeasure.qualityMax;
+#if _OPENMP >= 201107
+            #pragma omp parallel for reduction(min: measureMin) reduction(max: measureMax) \
+                    shared(cellQualityList, numChunkCells) default(none)
+#endif
+            for (size_t i = 0; i < numChunkCells; i++) {
+                measureMin = std::min(measureMin, cellQualityList[i]);
+                measureMax = std::max(measureMax, cellQualityList[i]);
+            }
+            precomputedQualityMeasure.qualityMin = measureMin;
+            precomputedQualityMeasure.qualityMax = measureMax;
+        }
+    }
+
+    // Pass 2: Normalize the qualities like setQualityMeasure and store them as half floats.
+    for (size_t chunkOffset = 0; chunkOffset < meshNumCells; chunkOffset += chunkSize) {
+        size_t numChunkCells = std::min(chunkSize, meshNumCells - chunkOffset);
+        computeChunkQualities(chunkOffset, numChunkCells);
+        for (size_t measureIdx = 0; measureIdx < HexaLab::NUM_QUALITY_MEASURES; measureIdx++) {
+            HexaLab::QualityMeasureEnum hexaLabQualityMeasure = HexaLab::QualityMeasureEnum(measureIdx);
+            const std::vector<float>& cellQualityList = chunkQualityLists.at(measureIdx);
+            PrecomputedQualityMeasure& precomputedQualityMeasure = precomputedQualityMeasures.at(measureIdx);
+            uint16_t* normalizedQualities = precomputedQualityMeasure.normalizedQualities.data() + chunkOffset;
+            float measureMin = precomputedQualityMeasure.qualityMin;
+            float measureMax = precomputedQualityMeasure.qualityMax;
+            float measureMinNormalized = precomputedQualityMeasure.qualityMinNormalized;
+            float measureMaxNormalized = precomputedQualityMeasure.qualityMaxNormalized;
+#if _OPENMP >= 201107
+            #pragma omp parallel for reduction(min: measureMinNormalized) reduction(max: measureMaxNormalized) \
+                    shared(cellQualityList, normalizedQualities, numChunkCells, hexaLabQualityMeasure) \
+                    shared(measureMin, measureMax) default(none)
+#endif
+            for (size_t i = 0; i < numChunkCells; i++) {
+                uint16_t normalizedQuality = glm::packHalf1x16(1.0f - HexaLab::normalize_quality_measure(
+                        hexaLabQualityMeasure, cellQualityList[i], measureMin, measureMax));
+                normalizedQualities[i] = normalizedQuality;
+                float normalizedQualityFloat = glm::unpackHalf1x16(normalizedQuality);
+                measureMinNormalized = std::min(measureMinNormalized, normalizedQualityFloat);
+                measureMaxNormalized = std::max(measureMaxNormalized, normalizedQualityFloat);
+            }
+            precomputedQualityMeasure.qualityMinNormalized = measureMinNormalized;
+            precomputedQualityMeasure.qualityMaxNormalized = measureMaxNormalized;
+        }
     }
-    dirty = true;
 }
 
 void HexMesh::setQualityMeasure(QualityMeasure qualityMeasure) {
@@ -433,66 +666,56 @@ void HexMesh::setQualityMeasure(QualityMeasure qualityMeasure) {
             break;
     }
 
-    HexaLab::quality_measure_fun* qualityFunctor = get_quality_measure_fun (hexaLabQualityMeasure);
-    void* arg = nullptr;
-    float avgVolume = 0.0f;
-    if (hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::RSS
-            || hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::SHAS
-            || hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::SHES) {
-        avgVolume = getAverageCellVolume();
-        arg = &avgVolume;
-    }
-
-    std::vector<float> cellQualityList;
-    cellQualityList.resize(meshNumCells);
-    qualityMin = FLT_MAX;
-    qualityMax = -FLT_MAX;
-    qualityMinNormalized = FLT_MAX;
-    qualityMaxNormalized = -FLT_MAX;
-    glm::vec3 v[8];
-
-    if (mesh) {
-#if _OPENMP >= 201107
-        #pragma omp parallel for reduction(min: qualityMin) reduction(max: qualityMax) private(v) \
-                shared(cellQualityList, qualityFunctor, arg) default(none)
-#endif
-        for (size_t i = 0; i < meshNumCells; i++) {
-            Hybrid& h = mesh->Hs.at(i);
-            assert(h.vs.size() == 8);
-            for (size_t j = 0; j < h.vs.size(); j++) {
-                uint32_t v_id = h.vs.at(j);
-                v[j] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-            }
-            float quality = qualityFunctor(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], arg);
-            qualityMin = std::min(qualityMin, quality);
-            qualityMax = std::max(qualityMax, quality);
-            cellQualityList.at(i) = quality;
+    if (precomputeAllQualityMeasures) {
+        // Switching between the precomputed measures only needs to decode the stored normalized qualities.
+        if (precomputedQualityMeasures.empty()) {
+            precomputeQualityMeasures();
         }
+        const PrecomputedQualityMeasure& precomputedQualityMeasure =
+                precomputedQualityMeasures.at(size_t(hexaLabQualityMeasure));
+        const std::vector<uint16_t>& normalizedQualities = precomputedQualityMeasure.normalizedQualities;
 #if _OPENMP >= 201107
-        #pragma omp parallel for reduction(min: qualityMinNormalized) reduction(max: qualityMaxNormalized) \
-                shared(cellQualityList, hexaLabQualityMeasure) default(none)
+        #pragma omp parallel for shared(normalizedQualities) default(none)
 #endif
         for (size_t i = 0; i < meshNumCells; i++) {
-            cellQualityMeasureList.at(i) = 1.0f - HexaLab::normalize_quality_measure(
-                    hexaLabQualityMeasure, cellQualityList.at(i), qualityMin, qualityMax);
-            qualityMinNormalized = std::min(qualityMinNormalized, cellQualityMeasureList.at(i));
-            qualityMaxNormalized = std::max(qualityMaxNormalized, cellQualityMeasureList.at(i));
+            cellQualityMeasureList[i] = glm::unpackHalf1x16(normalizedQualities[i]);
         }
+        qualityMin = precomputedQualityMeasure.qualityMin;
+        qualityMax = precomputedQualityMeasure.qualityMax;
+        qualityMinNormalized = precomputedQualityMeasure.qualityMinNormalized;
+        qualityMaxNormalized = precomputedQualityMeasure.qualityMaxNormalized;
     } else {
-#if _OPENMP >= 201107
-        #pragma omp parallel for reduction(min: qualityMin) reduction(max: qualityMax) private(v) \
-                shared(cellQualityList, qualityFunctor, arg) default(none)
-#endif
-        for (size_t i = 0; i < meshNumCells; i++) {
-            for (size_t j = 0; j < 8; j++) {
-                uint32_t v_id = cellIndices.at(i * 8 + j);
-                v[j] = glm::vec3(vertices.at(v_id));
-            }
-            float quality = qualityFunctor(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], arg);
-            qualityMin = std::min(qualityMin, quality);
-            qualityMax = std::max(qualityMax, quality);
-            cellQualityList.at(i) = quality;
+        HexaLab::quality_measure_batch_fun* qualityBatchFunctor =
+                HexaLab::get_quality_measure_batch_fun(hexaLabQualityMeasure);
+        void* arg = nullptr;
+        float avgVolume = 0.0f;
+        if (hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::RSS
+                || hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::SHAS
+                || hexaLabQualityMeasure == HexaLab::QualityMeasureEnum::SHES) {
+            avgVolume = getAverageCellVolume();
+            arg = &avgVolume;
+        }
+
+        std::vector<float> cellQualityList;
+        cellQualityList.resize(meshNumCells);
+        qualityMin = FLT_MAX;
+        qualityMax = -FLT_MAX;
+        qualityMinNormalized = FLT_MAX;
+        qualityMaxNormalized = -FLT_MAX;
+
+        if (mesh) {
+            computeCellQualitiesBatched(
+                    qualityBatchFunctor, arg, meshNumCells, [this](size_t h_id, int cornerIdx) {
+                        uint32_t v_id = mesh->Hs[h_id].vs[cornerIdx];
+                        return glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+                    }, cellQualityList, qualityMin, qualityMax);
+        } else {
+            computeCellQualitiesBatched(
+                    qualityBatchFunctor, arg, meshNumCells, [this](size_t h_id, int cornerIdx) {
+                        return vertices[cellIndices[h_id * 8 + cornerIdx]];
+                    }, cellQualityList, qualityMin, qualityMax);
         }
+
 #if _OPENMP >= 201107
         #pragma omp parallel for reduction(min: qualityMinNormalized) reduction(max: qualityMaxNormalized) \
                 shared(cellQualityList, hexaLabQualityMeasure) default(none)
@@ -509,17 +732,26 @@ void HexMesh::setQualityMeasure(QualityMeasure qualityMeasure) {
             << qualityMinNormalized << ", " << qualityMaxNormalized << "]" << std::endl;
 
     recomputeHistogram();
+    onMeshDataChanged();
     dirty = true;
 }
 
+void HexMesh::onMeshDataChanged() {
+    static uint64_t meshDataGenerationCounter = 0;
+    meshDataGeneration = ++meshDataGenerationCounter;
+}
+
 void HexMesh::recomputeHistogram() {
+    if (!transferFunctionWindow) {
+        return;
+    }
     if (useManualVertexAttribute) {
-        transferFunctionWindow.computeHistogram(*manualVertexAttributes, 0.0f, 1.0f);
+        transferFunctionWindow->computeHistogram(*manualVertexAttributes, 0.0f, 1.0f);
     } else if (useManualCellAttribute) {
-        transferFunctionWindow.computeHistogram(*manualCellAttributes, 0.0f, 1.0f);
+        transferFunctionWindow->computeHistogram(*manualCellAttributes, 0.0f, 1.0f);
     } else {
-        //transferFunctionWindow.computeHistogram(cellQualityMeasureList, qualityMinNormalized, qualityMaxNormalized);
-        transferFunctionWindow.computeHistogram(cellQualityMeasureList, 0.0f, 1.0f);
+        //transferFunctionWindow->computeHistogram(cellQualityMeasureList, qualityMinNormalized, qualityMaxNormalized);
+        transferFunctionWindow->computeHistogram(cellQualityMeasureList, 0.0f, 1.0f);
     }
 }
 
@@ -566,6 +798,10 @@ void HexMesh::rebuildInternalRepresentationIfNecessary() {
 }
 
 void HexMesh::updateMeshTriangleIntersectionDataStructure() {
+    if (!rayMeshIntersection) {
+        return;
+    }
+
     std::vector<uint32_t> triangleIndices;
     std::vector<glm::vec3> vertices;
 
@@ -601,7 +837,7 @@ void HexMesh::updateMeshTriangleIntersectionDataStructure() {
         triangleIndices.push_back(f.vs[3]);
     }
 
-    rayMeshIntersection.setMeshTriangleData(vertices, triangleIndices);
+    rayMeshIntersection->setMeshTriangleData(vertices, triangleIndices);
 }
 
 size_t HexMesh::getNumberOfSingularEdges() {
@@ -927,89 +1163,254 @@ glm::vec4 HexMesh::edgeColorMap(bool isSingular, bool isBoundary, int valence) {
     return glm::vec4(0.45f, 0.0f, 0.5f, 1.0f); // purple
 }
 
+/**
+ * Writes the indices of the two triangles of a quad face.
+ *
+ * vertex 1     edge 1    vertex 2
+ *          | - - - - - |
+ *          | \         |
+ *          |   \       |
+ *   edge 0 |     \     | edge 2
+ *          |       \   |
+ *          |         \ |
+ *          | - - - - - |
+ * vertex 0     edge 3    vertex 3
+ *
+ * @param triangleIndices The location of the six indices to write.
+ * @param indexOffset The index of vertex 0.
+ * @param invertWinding Whether to use the opposite winding order (e.g., for the backface).
+ */
+static inline void writeQuadTriangleIndices(
+        uint32_t* triangleIndices, uint32_t indexOffset, bool invertWinding = false) {
+    static const uint32_t quadTriangleOffsets[2][6] = { { 0, 3, 1, 2, 1, 3 }, { 1, 3, 0, 3, 1, 2 } };
+    for (size_t j = 0; j < 6; j++) {
+        triangleIndices[j] = indexOffset + quadTriangleOffsets[invertWinding ? 1 : 0][j];
+    }
+}
+
+/**
+ * Output count for parallelCountScanFill of extractors that write face entries and triangle indices at different rates.
+ */
+struct FaceIndexCount {
+    FaceIndexCount() : numFaces(0), numIndices(0) {}
+    FaceIndexCount& operator+=(const FaceIndexCount& other) {
+        numFaces += other.numFaces;
+        numIndices += other.numIndices;
+        return *this;
+    }
+    bool operator!=(const FaceIndexCount& other) const {
+        return numFaces != other.numFaces || numIndices != other.numIndices;
+    }
+    size_t numFaces;
+    size_t numIndices;
+};
+
+const FaceStream& HexMesh::getFaceStream() {
+    rebuildInternalRepresentationIfNecessary();
+
+    bool needsRebuild =
+            faceStream.meshDataGeneration != meshDataGeneration
+            || faceStream.getNumFaces() != mesh->Fs.size()
+            || faceStream.getNumEdges() != mesh->Es.size();
+    if (needsRebuild) {
+        updateFaceStreamStaticData();
+        faceStream.meshDataGeneration = meshDataGeneration;
+    }
+
+    // The visibility data only needs to be regenerated if any cell changed its filtering state since the last update.
+    bool isCellMaskChanged = needsRebuild;
+    for (size_t blockIdx = 0; !isCellMaskChanged && blockIdx < cellFilteringMask.getNumBlocks(); blockIdx++) {
+        isCellMaskChanged = cellFilteringMask.isBlockChangedSince(blockIdx, faceStream.cellMaskGeneration);
+    }
+    if (isCellMaskChanged) {
+        faceStream.cellMaskGeneration = cellFilteringMask.synchronize();
+        updateFaceStreamVisibility();
+    }
+
+    return faceStream;
+}
+
+void HexMesh::updateFaceStreamStaticData() {
+    const size_t numFaces = mesh->Fs.size();
+    const size_t numEdges = mesh->Es.size();
+    faceStream.faceVertexIds.resize(numFaces * 4);
+    faceStream.faceEdgeIds.resize(numFaces * 4);
+    faceStream.faceCellIds.resize(numFaces * 2);
+    faceStream.faceCellAttributes.resize(numFaces * 2);
+    faceStream.faceFlags.resize(numFaces);
+    parallelFor(numFaces, [&](size_t f_id) {
+        Hybrid_F& f = mesh->Fs.at(f_id);
+        assert(f.vs.size() == 4 && f.es.size() == 4);
+        assert(f.neighbor_hs.size() >= 1 && f.neighbor_hs.size() <= 2);
+        for (size_t j = 0; j < 4; j++) {
+            faceStream.faceVertexIds[f_id * 4 + j] = f.vs.at(j);
+            faceStream.faceEdgeIds[f_id * 4 + j] = f.es.at(j);
+        }
+        for (size_t side = 0; side < 2; side++) {
+            if (side < f.neighbor_hs.size()) {
+                faceStream.faceCellIds[f_id * 2 + side] = f.neighbor_hs.at(side);
+                faceStream.faceCellAttributes[f_id * 2 + side] = getCellAttribute(f.neighbor_hs.at(side));
+            } else {
+                faceStream.faceCellIds[f_id * 2 + side] = FaceStream::INVALID_CELL;
+                faceStream.faceCellAttributes[f_id * 2 + side] = 0.0f;
+            }
+        }
+        faceStream.faceFlags[f_id] = f.boundary ? uint8_t(FaceStream::FACE_BOUNDARY) : uint8_t(0);
+    });
+
+    faceStream.edgeSingularityInformation.resize(numEdges);
+    faceStream.edgeVisibility.resize(numEdges);
+    parallelFor(numEdges, [&](size_t e_id) {
+        faceStream.edgeSingularityInformation[e_id] = packEdgeSingularityInformation(uint32_t(e_id));
+    });
+}
+
+void HexMesh::updateFaceStreamVisibility() {
+    const uint32_t INVALID_CELL = FaceStream::INVALID_CELL;
+    parallelFor(faceStream.getNumFaces(), [&](size_t f_id) {
+        uint32_t frontCellId = faceStream.faceCellIds[f_id * 2];
+        uint32_t backCellId = faceStream.faceCellIds[f_id * 2 + 1];
+        bool isFrontCellFiltered = isCellMarked(frontCellId);
+        bool isBackCellFiltered = backCellId != INVALID_CELL && isCellMarked(backCellId);
+        bool isBackCellUnfiltered = backCellId != INVALID_CELL && !isCellMarked(backCellId);
+
+        uint8_t flags = faceStream.faceFlags[f_id] & uint8_t(FaceStream::FACE_BOUNDARY);
+        if (isFrontCellFiltered) {
+            flags |= FaceStream::FACE_FRONT_CELL_FILTERED;
+        }
+        if (isBackCellFiltered) {
+            flags |= FaceStream::FACE_BACK_CELL_FILTERED;
+        }
+        if (!isFrontCellFiltered || isBackCellUnfiltered) {
+            flags |= FaceStream::FACE_VISIBLE;
+        }
+        if ((flags & FaceStream::FACE_BOUNDARY) != 0 || isFrontCellFiltered || isBackCellFiltered) {
+            flags |= FaceStream::FACE_ON_FILTERED_SURFACE;
+        }
+        faceStream.faceFlags[f_id] = flags;
+    });
+
+    parallelFor(faceStream.getNumEdges(), [&](size_t e_id) {
+        Hybrid_E& e = mesh->Es.at(e_id);
+        bool isEdgeFiltered = std::all_of(e.neighbor_hs.begin(), e.neighbor_hs.end(), [this](uint32_t h_id) {
+            return isCellMarked(h_id);
+        });
+        faceStream.edgeVisibility[e_id] = isEdgeFiltered ? 0 : 1;
+    });
+
+    // Compact the IDs of the visible faces and edges (in ascending order).
+    parallelCountScanFill<size_t>(faceStream.getNumFaces(), [&](size_t f_id) -> size_t {
+        return faceStream.getIsFaceVisible(f_id) ? 1 : 0;
+    }, [&](size_t numVisibleFaces) {
+        faceStream.visibleFaceIds.resize(numVisibleFaces);
+    }, [&](size_t f_id, size_t offset) {
+        faceStream.visibleFaceIds[offset] = uint32_t(f_id);
+    });
+    parallelCountScanFill<size_t>(faceStream.getNumEdges(), [&](size_t e_id) -> size_t {
+        return faceStream.getIsEdgeVisible(e_id) ? 1 : 0;
+    }, [&](size_t numVisibleEdges) {
+        faceStream.visibleEdgeIds.resize(numVisibleEdges);
+    }, [&](size_t e_id, size_t offset) {
+        faceStream.visibleEdgeIds[offset] = uint32_t(e_id);
+    });
+}
+
 void HexMesh::getSurfaceData(
         std::vector<uint32_t>& triangleIndices,
         std::vector<glm::vec3>& vertexPositions,
         std::vector<glm::vec3>& vertexNormals,
         std::vector<float>& vertexAttributes,
         bool removeFilteredCells) {
-    rebuildInternalRepresentationIfNecessary();
-
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Hs.size(); i++) {
-        Hybrid& h = mesh->Hs.at(i);
-        float cellAttribute = getCellAttribute(h.id);
-        if (removeFilteredCells && isCellMarked(h.id)) {
-            continue;
-        }
-
-        for (size_t j = 0; j < h.fs.size(); j++) {
-            Hybrid_F& f = mesh->Fs.at(h.fs.at(j));
-            if ((!removeFilteredCells && !f.boundary) || (removeFilteredCells
-                    && !f.boundary && !std::any_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-                return isCellMarked(h_id);
-            }))) {
-                continue;
-            }
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    OutputBuffer<glm::vec3> vertexNormalBuffer(vertexNormals);
+    OutputBuffer<float> vertexAttributeBuffer(vertexAttributes);
+    getSurfaceData(
+            triangleIndexBuffer, vertexPositionBuffer, vertexNormalBuffer, vertexAttributeBuffer, removeFilteredCells);
+}
 
-            assert(f.neighbor_hs.size() >= 1 && f.neighbor_hs.size() <= 2);
-            bool invertWinding = f.neighbor_hs.at(0) != h.id;
+void HexMesh::getSurfaceData(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        OutputBuffer<glm::vec3>& vertexNormals,
+        OutputBuffer<float>& vertexAttributes,
+        bool removeFilteredCells) {
+    const FaceStream& stream = getFaceStream();
 
-            assert(f.vs.size() == 4);
-            for (size_t j = 0; j < 4; j++) {
-                uint32_t v_id = f.vs.at(j);
-                glm::vec3 vertexPosition(
-                        mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
-                if (!useManualVertexAttribute) {
-                    vertexAttributes.push_back(cellAttribute);
-                } else {
-                    // Use manually specified attributes.
-                    vertexAttributes.push_back(manualVertexAttributes->at(v_id));
-                }
-            }
+    auto isSurfaceFace = [&stream, removeFilteredCells](uint32_t f_id) -> bool {
+        return removeFilteredCells ? stream.getIsFaceOnFilteredSurface(f_id) : stream.getIsFaceBoundary(f_id);
+    };
 
-            size_t oldTriangleIndicesSize = triangleIndices.size();
-            if (!invertWinding) {
-                /**
-                 * vertex 1     edge 1    vertex 2
-                 *          | - - - - - |
-                 *          | \         |
-                 *          |   \       |
-                 *   edge 0 |     \     | edge 2
-                 *          |       \   |
-                 *          |         \ |
-                 *          | - - - - - |
-                 * vertex 0     edge 3    vertex 3
-                 */
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
-            }
-            if (invertWinding) {
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
+    size_t indexBase = triangleIndices.size();
+    size_t vertexBase = vertexPositions.size();
+    size_t normalBase = vertexNormals.size();
+    size_t attributeBase = vertexAttributes.size();
+    parallelCountScanFill<size_t>(mesh->Hs.size(), [&](size_t h_id) -> size_t {
+        size_t numFaces = 0;
+        if (removeFilteredCells && isCellMarked(uint32_t(h_id))) {
+            return numFaces;
+        }
+        for (uint32_t f_id : mesh->Hs.at(h_id).fs) {
+            if (isSurfaceFace(f_id)) {
+                numFaces++;
+            }
+        }
+        return numFaces;
+    }, [&](size_t numFaces) {
+        triangleIndices.resize(indexBase + numFaces * 6);
+        vertexPositions.resize(vertexBase + numFaces * 4);
+        vertexNormals.resize(normalBase + numFaces * 4);
+        vertexAttributes.resize(attributeBase + numFaces * 4);
+    }, [&](size_t h_id, size_t faceOffset) {
+        Hybrid& h = mesh->Hs.at(h_id);
+        float cellAttribute = getCellAttribute(h.id);
+        for (uint32_t f_id : h.fs) {
+            if (!isSurfaceFace(f_id)) {
+                continue;
             }
+            bool invertWinding = stream.getFaceCellId(f_id, 0) != h.id;
+            writeSurfaceQuad(
+                    mesh->Fs.at(f_id), invertWinding, cellAttribute, uint32_t(faceOffset * 4),
+                    &triangleIndices[indexBase + faceOffset * 6], &vertexPositions[vertexBase + faceOffset * 4],
+                    &vertexNormals[normalBase + faceOffset * 4], &vertexAttributes[attributeBase + faceOffset * 4]);
+            faceOffset++;
+        }
+    });
+}
+
+void HexMesh::writeSurfaceQuad(
+        Hybrid_F& f, bool invertWinding, float cellAttribute, uint32_t indexOffset, uint32_t* triangleIndices,
+        glm::vec3* vertexPositions, glm::vec3* vertexNormals, float* vertexAttributes) {
+    // The output is never read back, as it may be write-combined memory (e.g., a mapped GPU buffer).
+    assert(f.vs.size() == 4);
+    glm::vec3 quadVertices[4];
+    for (size_t j = 0; j < 4; j++) {
+        uint32_t v_id = f.vs.at(j);
+        quadVertices[j] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+        vertexPositions[j] = quadVertices[j];
+        if (!useManualVertexAttribute) {
+            vertexAttributes[j] = cellAttribute;
+        } else {
+            // Use manually specified attributes.
+            vertexAttributes[j] = manualVertexAttributes->at(v_id);
+        }
+    }
 
-            for (size_t j = 0; j < 2; j++) {
-                glm::vec3 v[3];
-                for (int k = 0; k < 3; k++) {
-                    v[k] = vertexPositions.at(triangleIndices.at(oldTriangleIndicesSize + j*3 + k));
-                }
-                glm::vec3 vertexNormal = glm::normalize(glm::cross(v[1] - v[0], v[2] - v[0]));
-                vertexNormals.push_back(vertexNormal);
-                vertexNormals.push_back(vertexNormal);
-            }
+    uint32_t quadIndices[6];
+    writeQuadTriangleIndices(quadIndices, 0, invertWinding);
+    for (size_t j = 0; j < 6; j++) {
+        triangleIndices[j] = indexOffset + quadIndices[j];
+    }
 
-            indexOffset += 4;
+    // The first two vertices get the normal of the first triangle, the last two the one of the second triangle.
+    for (size_t j = 0; j < 2; j++) {
+        glm::vec3 v[3];
+        for (int k = 0; k < 3; k++) {
+            v[k] = quadVertices[quadIndices[j * 3 + k]];
         }
+        glm::vec3 vertexNormal = glm::normalize(glm::cross(v[1] - v[0], v[2] - v[0]));
+        vertexNormals[j * 2] = vertexNormal;
+        vertexNormals[j * 2 + 1] = vertexNormal;
     }
 }
 
@@ -1017,66 +1418,190 @@ void HexMesh::getSurfaceData(
         std::vector<uint32_t>& triangleIndices,
         std::vector<glm::vec3>& vertexPositions,
         bool removeFilteredCells) {
-    rebuildInternalRepresentationIfNecessary();
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    getSurfaceData(triangleIndexBuffer, vertexPositionBuffer, removeFilteredCells);
+}
 
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Hs.size(); i++) {
-        Hybrid& h = mesh->Hs.at(i);
-        for (size_t j = 0; j < h.fs.size(); j++) {
-            Hybrid_F& f = mesh->Fs.at(h.fs.at(j));
-            if (!f.boundary && !std::any_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-                return isCellMarked(h_id);
-            })) {
-                continue;
-            }
-            if (removeFilteredCells && std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-                return isCellMarked(h_id);
-            })) {
+void HexMesh::getSurfaceData(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        bool removeFilteredCells) {
+    const FaceStream& stream = getFaceStream();
+
+    auto isSurfaceFace = [&stream, removeFilteredCells](uint32_t f_id) -> bool {
+        return stream.getIsFaceOnFilteredSurface(f_id) && (!removeFilteredCells || stream.getIsFaceVisible(f_id));
+    };
+
+    size_t indexBase = triangleIndices.size();
+    size_t vertexBase = vertexPositions.size();
+    parallelCountScanFill<size_t>(mesh->Hs.size(), [&](size_t h_id) -> size_t {
+        size_t numFaces = 0;
+        for (uint32_t f_id : mesh->Hs.at(h_id).fs) {
+            if (isSurfaceFace(f_id)) {
+                numFaces++;
+            }
+        }
+        return numFaces;
+    }, [&](size_t numFaces) {
+        triangleIndices.resize(indexBase + numFaces * 6);
+        vertexPositions.resize(vertexBase + numFaces * 4);
+    }, [&](size_t h_id, size_t faceOffset) {
+        Hybrid& h = mesh->Hs.at(h_id);
+        for (uint32_t f_id : h.fs) {
+            if (!isSurfaceFace(f_id)) {
                 continue;
             }
 
-            assert(f.neighbor_hs.size() >= 1 && f.neighbor_hs.size() <= 2);
-            bool invertWinding = f.neighbor_hs.at(0) != h.id;
+            bool invertWinding = stream.getFaceCellId(f_id, 0) != h.id;
 
-            assert(f.vs.size() == 4);
+            const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
             for (size_t j = 0; j < 4; j++) {
-                uint32_t v_id = f.vs.at(j);
-                glm::vec3 vertexPosition(
+                uint32_t v_id = faceVertexIds[j];
+                vertexPositions[vertexBase + faceOffset * 4 + j] = glm::vec3(
                         mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
             }
 
-            if (!invertWinding) {
-                /**
-                 * vertex 1     edge 1    vertex 2
-                 *          | - - - - - |
-                 *          | \         |
-                 *          |   \       |
-                 *   edge 0 |     \     | edge 2
-                 *          |       \   |
-                 *          |         \ |
-                 *          | - - - - - |
-                 * vertex 0     edge 3    vertex 3
-                 */
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
+            writeQuadTriangleIndices(
+                    &triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4), invertWinding);
+            faceOffset++;
+        }
+    });
+}
+
+void HexMesh::updateFilteredSurfaceData(FilteredSurfaceData& surfaceData) {
+    rebuildInternalRepresentationIfNecessary();
+
+    const uint32_t INVALID_SLOT = FilteredSurfaceData::INVALID_SLOT;
+    bool needsRebuild =
+            surfaceData.hexMesh != this || surfaceData.meshDataGeneration != meshDataGeneration
+            || surfaceData.faceSideSlots.size() != mesh->Fs.size() * 2
+            || surfaceData.cellMaskWords.size() != cellFilteringMask.getNumWords();
+    surfaceData.wasRebuilt = needsRebuild;
+
+    if (needsRebuild) {
+        surfaceData.triangleIndices.clear();
+        surfaceData.vertexPositions.clear();
+        surfaceData.vertexNormals.clear();
+        surfaceData.vertexAttributes.clear();
+        surfaceData.slotFaceSides.clear();
+        surfaceData.faceSideSlots.assign(mesh->Fs.size() * 2, INVALID_SLOT);
+        for (uint32_t faceSide = 0; faceSide < uint32_t(surfaceData.faceSideSlots.size()); faceSide++) {
+            if (getIsFaceSideVisible(faceSide)) {
+                addFilteredSurfaceFaceSide(surfaceData, faceSide);
+            }
+        }
+        surfaceData.hexMesh = this;
+        surfaceData.meshDataGeneration = meshDataGeneration;
+        surfaceData.cellMaskWords.assign(
+                cellFilteringMask.getWords(), cellFilteringMask.getWords() + cellFilteringMask.getNumWords());
+        surfaceData.cellMaskGeneration = cellFilteringMask.synchronize();
+        surfaceData.firstChangedFace = 0;
+        return;
+    }
+
+    // Get the cells whose filtering state changed from the blocks of the mask changed since the last update.
+    std::vector<uint32_t> changedBlocks;
+    cellFilteringMask.getBlocksChangedSince(surfaceData.cellMaskGeneration, changedBlocks);
+    surfaceData.cellMaskGeneration = cellFilteringMask.synchronize();
+    std::vector<uint32_t> changedFaceIds;
+    const uint64_t* maskWords = cellFilteringMask.getWords();
+    for (uint32_t blockIdx : changedBlocks) {
+        size_t wordBegin = size_t(blockIdx) * CellMask::WORDS_PER_BLOCK;
+        for (size_t wordIdx = wordBegin; wordIdx < wordBegin + CellMask::WORDS_PER_BLOCK; wordIdx++) {
+            uint64_t changedBits = maskWords[wordIdx] ^ surfaceData.cellMaskWords[wordIdx];
+            surfaceData.cellMaskWords[wordIdx] = maskWords[wordIdx];
+            for (size_t bitIdx = 0; changedBits != 0ull; bitIdx++, changedBits >>= 1u) {
+                if ((changedBits & 1ull) != 0ull) {
+                    Hybrid& h = mesh->Hs.at(wordIdx * CellMask::BITS_PER_WORD + bitIdx);
+                    changedFaceIds.insert(changedFaceIds.end(), h.fs.begin(), h.fs.end());
+                }
             }
-            if (invertWinding) {
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
+        }
+    }
+    std::sort(changedFaceIds.begin(), changedFaceIds.end());
+    changedFaceIds.erase(std::unique(changedFaceIds.begin(), changedFaceIds.end()), changedFaceIds.end());
+
+    // Removing a slot moves the last slot, so all slots from the smallest touched one to the end count as changed.
+    size_t numFacesOld = surfaceData.slotFaceSides.size();
+    size_t firstChangedFace = numFacesOld;
+    for (uint32_t f_id : changedFaceIds) {
+        for (uint32_t side = 0; side < 2; side++) {
+            uint32_t faceSide = f_id * 2u + side;
+            bool isVisible = getIsFaceSideVisible(faceSide);
+            uint32_t slot = surfaceData.faceSideSlots[faceSide];
+            if (isVisible && slot == INVALID_SLOT) {
+                addFilteredSurfaceFaceSide(surfaceData, faceSide);
+            } else if (!isVisible && slot != INVALID_SLOT) {
+                firstChangedFace = std::min(firstChangedFace, size_t(slot));
+                removeFilteredSurfaceFaceSide(surfaceData, faceSide);
             }
+        }
+    }
+    surfaceData.firstChangedFace = std::min(firstChangedFace, std::min(numFacesOld, surfaceData.slotFaceSides.size()));
+}
 
-            indexOffset += 4;
+bool HexMesh::getIsFaceSideVisible(uint32_t faceSide) {
+    Hybrid_F& f = mesh->Fs.at(faceSide / 2u);
+    uint32_t side = faceSide % 2u;
+    if (side >= f.neighbor_hs.size() || isCellMarked(f.neighbor_hs.at(side))) {
+        return false;
+    }
+    // Same criterion as in getSurfaceData: The face lies on the boundary of the filtered mesh.
+    return f.boundary || std::any_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
+        return isCellMarked(h_id);
+    });
+}
+
+void HexMesh::writeFilteredSurfaceSlot(FilteredSurfaceData& surfaceData, uint32_t slot) {
+    uint32_t faceSide = surfaceData.slotFaceSides.at(slot);
+    Hybrid_F& f = mesh->Fs.at(faceSide / 2u);
+    uint32_t h_id = f.neighbor_hs.at(faceSide % 2u);
+    bool invertWinding = f.neighbor_hs.at(0) != h_id;
+
+    // Same triangulation and normals as in getSurfaceData.
+    size_t indexOffset = size_t(slot) * 4;
+    writeSurfaceQuad(
+            f, invertWinding, getCellAttribute(h_id), uint32_t(indexOffset),
+            &surfaceData.triangleIndices.at(size_t(slot) * 6), &surfaceData.vertexPositions.at(indexOffset),
+            &surfaceData.vertexNormals.at(indexOffset), &surfaceData.vertexAttributes.at(indexOffset));
+}
+
+void HexMesh::addFilteredSurfaceFaceSide(FilteredSurfaceData& surfaceData, uint32_t faceSide) {
+    uint32_t slot = uint32_t(surfaceData.slotFaceSides.size());
+    surfaceData.slotFaceSides.push_back(faceSide);
+    surfaceData.faceSideSlots.at(faceSide) = slot;
+    surfaceData.triangleIndices.resize(surfaceData.triangleIndices.size() + 6);
+    surfaceData.vertexPositions.resize(surfaceData.vertexPositions.size() + 4);
+    surfaceData.vertexNormals.resize(surfaceData.vertexNormals.size() + 4);
+    surfaceData.vertexAttributes.resize(surfaceData.vertexAttributes.size() + 4);
+    writeFilteredSurfaceSlot(surfaceData, slot);
+}
+
+void HexMesh::removeFilteredSurfaceFaceSide(FilteredSurfaceData& surfaceData, uint32_t faceSide) {
+    uint32_t slot = surfaceData.faceSideSlots.at(faceSide);
+    uint32_t lastSlot = uint32_t(surfaceData.slotFaceSides.size() - 1);
+    surfaceData.faceSideSlots.at(faceSide) = FilteredSurfaceData::INVALID_SLOT;
+    if (slot != lastSlot) {
+        // Move the last slot to the free slot. The vertex data can be copied, but the indices need to be offset.
+        uint32_t lastFaceSide = surfaceData.slotFaceSides.at(lastSlot);
+        surfaceData.slotFaceSides.at(slot) = lastFaceSide;
+        surfaceData.faceSideSlots.at(lastFaceSide) = slot;
+        for (size_t j = 0; j < 4; j++) {
+            surfaceData.vertexPositions.at(slot * 4 + j) = surfaceData.vertexPositions.at(lastSlot * 4 + j);
+            surfaceData.vertexNormals.at(slot * 4 + j) = surfaceData.vertexNormals.at(lastSlot * 4 + j);
+            surfaceData.vertexAttributes.at(slot * 4 + j) = surfaceData.vertexAttributes.at(lastSlot * 4 + j);
+        }
+        for (size_t j = 0; j < 6; j++) {
+            surfaceData.triangleIndices.at(slot * 6 + j) =
+                    surfaceData.triangleIndices.at(lastSlot * 6 + j) - lastSlot * 4 + slot * 4;
         }
     }
+    surfaceData.slotFaceSides.pop_back();
+    surfaceData.triangleIndices.resize(surfaceData.triangleIndices.size() - 6);
+    surfaceData.vertexPositions.resize(surfaceData.vertexPositions.size() - 4);
+    surfaceData.vertexNormals.resize(surfaceData.vertexNormals.size() - 4);
+    surfaceData.vertexAttributes.resize(surfaceData.vertexAttributes.size() - 4);
 }
 
 void HexMesh::getWireframeData(
@@ -1085,28 +1610,32 @@ void HexMesh::getWireframeData(
     rebuildInternalRepresentationIfNecessary();
 
     // Add all hexahedral mesh vertices to the triangle mesh vertex data.
-    lineVertices.reserve(mesh->Vs.size());
-    for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-        glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-        lineVertices.push_back(vertexPosition);
-    }
+    size_t vertexBase = lineVertices.size();
+    lineVertices.resize(vertexBase + mesh->Vs.size());
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
+        lineVertices[vertexBase + v_id] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+    });
 
     // Add all triangle indices.
-    for (Hybrid_E& e : mesh->Es) {
-        if (std::all_of(e.neighbor_hs.begin(), e.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        glm::vec4 lineColor = singularEdgeIds.find(e.id) == singularEdgeIds.end()
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleEdgeIds = stream.getVisibleEdgeIds();
+    size_t edgeVertexBase = lineVertices.size();
+    size_t colorBase = lineColors.size();
+    lineVertices.resize(edgeVertexBase + visibleEdgeIds.size() * 2);
+    lineColors.resize(colorBase + visibleEdgeIds.size() * 2);
+    parallelFor(visibleEdgeIds.size(), [&](size_t edgeOffset) {
+        uint32_t e_id = visibleEdgeIds[edgeOffset];
+        Hybrid_E& e = mesh->Es.at(e_id);
+        glm::vec4 lineColor = !stream.getIsEdgeSingular(e_id)
                 ? glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) : glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
         assert(e.vs.size() == 2);
-        for (uint32_t v_id : e.vs) {
-            lineVertices.push_back(glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id)));
-            lineColors.push_back(lineColor);
+        for (size_t j = 0; j < 2; j++) {
+            uint32_t v_id = e.vs.at(j);
+            lineVertices[edgeVertexBase + edgeOffset * 2 + j] = glm::vec3(
+                    mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+            lineColors[colorBase + edgeOffset * 2 + j] = lineColor;
         }
-    }
+    });
 }
 
 void HexMesh::getVolumeData_Faces(
@@ -1114,140 +1643,159 @@ void HexMesh::getVolumeData_Faces(
         std::vector<glm::vec3>& vertexPositions,
         std::vector<glm::vec3>& vertexNormals,
         std::vector<float>& vertexAttributes) {
-    rebuildInternalRepresentationIfNecessary();
-
-    std::vector<glm::vec3> quadBuffer;
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        bool neighborIsMarked = std::any_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        });
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    OutputBuffer<glm::vec3> vertexNormalBuffer(vertexNormals);
+    OutputBuffer<float> vertexAttributeBuffer(vertexAttributes);
+    getVolumeData_Faces(triangleIndexBuffer, vertexPositionBuffer, vertexNormalBuffer, vertexAttributeBuffer);
+}
 
-        assert(f.vs.size() == 4);
+void HexMesh::getVolumeData_Faces(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        OutputBuffer<glm::vec3>& vertexNormals,
+        OutputBuffer<float>& vertexAttributes) {
+    const FaceStream& stream = getFaceStream();
+
+    // Every visible face adds a quad for the first cell if it is unfiltered, and one for the backside (i.e., the second
+    // cell or the outside) if the first cell is unfiltered or the face is a filtered front face of the second cell.
+    auto hasFrontQuad = [](uint8_t faceFlags) {
+        return (faceFlags & FaceStream::FACE_FRONT_CELL_FILTERED) == 0;
+    };
+    auto hasBackQuad = [](uint8_t faceFlags) {
+        return (faceFlags & FaceStream::FACE_FRONT_CELL_FILTERED) == 0
+                || (faceFlags & FaceStream::FACE_BACK_CELL_FILTERED) != 0;
+    };
 
-        for (uint32_t v_id : f.vs) {
-            glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-            quadBuffer.push_back(vertexPosition);
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    size_t vertexBase = vertexPositions.size();
+    size_t normalBase = vertexNormals.size();
+    size_t attributeBase = vertexAttributes.size();
+    parallelCountScanFill<size_t>(visibleFaceIds.size(), [&](size_t i) -> size_t {
+        uint8_t faceFlags = stream.getFaceFlags(visibleFaceIds[i]);
+        return (hasFrontQuad(faceFlags) ? 1 : 0) + (hasBackQuad(faceFlags) ? 1 : 0);
+    }, [&](size_t numQuads) {
+        triangleIndices.resize(indexBase + numQuads * 6);
+        vertexPositions.resize(vertexBase + numQuads * 4);
+        vertexNormals.resize(normalBase + numQuads * 4);
+        vertexAttributes.resize(attributeBase + numQuads * 4);
+    }, [&](size_t i, size_t quadOffset) {
+        uint32_t f_id = visibleFaceIds[i];
+        uint8_t faceFlags = stream.getFaceFlags(f_id);
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
+
+        glm::vec3 quadVertices[4];
+        for (size_t j = 0; j < 4; j++) {
+            uint32_t v_id = faceVertexIds[j];
+            quadVertices[j] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
         }
-        glm::vec3 v0 = quadBuffer.at(1) - quadBuffer.at(0);
-        glm::vec3 v1 = quadBuffer.at(2) - quadBuffer.at(0);
+        glm::vec3 v0 = quadVertices[1] - quadVertices[0];
+        glm::vec3 v1 = quadVertices[2] - quadVertices[0];
         glm::vec3 vertexNormal = glm::normalize(glm::cross(v0, v1));
-        quadBuffer.clear();
 
-        if (!isCellMarked(f.neighbor_hs.at(0))) {
-            size_t idxStart = vertexPositions.size();
+        auto writeQuad = [&](size_t side, bool isBackQuad) {
+            size_t idxStart = vertexBase + quadOffset * 4;
             float vertexAttribute;
             // Compute attribute data.
             if (!useManualVertexAttribute) {
-                vertexAttribute = getCellAttribute(f.neighbor_hs.at(0));
+                vertexAttribute = stream.getFaceCellAttribute(f_id, side);
             } else {
-                vertexAttribute = getCellAttributeManualVertexAttributes(f.neighbor_hs.at(0));
+                vertexAttribute = getCellAttributeManualVertexAttributes(stream.getFaceCellId(f_id, side));
             }
-            for (uint32_t v_id : f.vs) {
-                vertexAttributes.push_back(vertexAttribute);
-                glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
-                vertexNormals.push_back(vertexNormal);
+            for (size_t j = 0; j < 4; j++) {
+                vertexAttributes[attributeBase + quadOffset * 4 + j] = vertexAttribute;
+                vertexPositions[vertexBase + quadOffset * 4 + j] = quadVertices[j];
+                vertexNormals[normalBase + quadOffset * 4 + j] = isBackQuad ? -vertexNormal : vertexNormal;
             }
 
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+1);
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+3);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+0);
-        }
-
-        if (!isCellMarked(f.neighbor_hs.at(0)) || (!f.boundary && isCellMarked(f.neighbor_hs.at(1)))) {
-            size_t idxStart = vertexPositions.size();
-            float vertexAttribute;
-            // Compute attribute data.
-            if (!useManualVertexAttribute) {
-                vertexAttribute = getCellAttribute(f.neighbor_hs.at(f.boundary ? 0 : 1));
-            } else {
-                vertexAttribute = getCellAttributeManualVertexAttributes(f.neighbor_hs.at(f.boundary ? 0 : 1));
-            }
-            for (uint32_t v_id : f.vs) {
-                vertexAttributes.push_back(vertexAttribute);
-                glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
-                vertexNormals.push_back(-vertexNormal);
+            static const uint32_t quadTriangleOffsets[2][6] = { { 2, 1, 0, 3, 2, 0 }, { 0, 1, 2, 0, 2, 3 } };
+            for (size_t j = 0; j < 6; j++) {
+                triangleIndices[indexBase + quadOffset * 6 + j] =
+                        uint32_t(idxStart + quadTriangleOffsets[isBackQuad ? 1 : 0][j]);
             }
+            quadOffset++;
+        };
 
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+1);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+3);
+        if (hasFrontQuad(faceFlags)) {
+            writeQuad(0, false);
         }
-    }
+        if (hasBackQuad(faceFlags)) {
+            writeQuad((faceFlags & FaceStream::FACE_BOUNDARY) != 0 ? 0 : 1, true);
+        }
+    });
 }
 
 void HexMesh::getVolumeData_Volume(
         std::vector<uint32_t>& triangleIndices,
         std::vector<glm::vec3>& vertexPositions,
         std::vector<float>& vertexAttributes) {
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    OutputBuffer<float> vertexAttributeBuffer(vertexAttributes);
+    getVolumeData_Volume(triangleIndexBuffer, vertexPositionBuffer, vertexAttributeBuffer);
+}
 
-        assert(f.vs.size() == 4);
+void HexMesh::getVolumeData_Volume(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        OutputBuffer<float>& vertexAttributes) {
+    const FaceStream& stream = getFaceStream();
+
+    auto hasFrontQuad = [](uint8_t faceFlags) {
+        return (faceFlags & FaceStream::FACE_FRONT_CELL_FILTERED) == 0;
+    };
+    auto hasBackQuad = [](uint8_t faceFlags) {
+        return (faceFlags & FaceStream::FACE_BOUNDARY) == 0 && (faceFlags & FaceStream::FACE_BACK_CELL_FILTERED) == 0;
+    };
 
-        if (!isCellMarked(f.neighbor_hs.at(0))) {
-            size_t idxStart = vertexPositions.size();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    size_t vertexBase = vertexPositions.size();
+    size_t attributeBase = vertexAttributes.size();
+    parallelCountScanFill<size_t>(visibleFaceIds.size(), [&](size_t i) -> size_t {
+        uint8_t faceFlags = stream.getFaceFlags(visibleFaceIds[i]);
+        return (hasFrontQuad(faceFlags) ? 1 : 0) + (hasBackQuad(faceFlags) ? 1 : 0);
+    }, [&](size_t numQuads) {
+        triangleIndices.resize(indexBase + numQuads * 6);
+        vertexPositions.resize(vertexBase + numQuads * 4);
+        vertexAttributes.resize(attributeBase + numQuads * 4);
+    }, [&](size_t i, size_t quadOffset) {
+        uint32_t f_id = visibleFaceIds[i];
+        uint8_t faceFlags = stream.getFaceFlags(f_id);
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
+
+        auto writeQuad = [&](size_t side, bool isBackQuad) {
+            size_t idxStart = vertexBase + quadOffset * 4;
             float vertexAttribute;
             // Compute attribute data.
             if (!useManualVertexAttribute) {
-                vertexAttribute = getCellAttribute(f.neighbor_hs.at(0));
+                vertexAttribute = stream.getFaceCellAttribute(f_id, side);
             } else {
-                vertexAttribute = getCellAttributeManualVertexAttributes(f.neighbor_hs.at(0));
+                vertexAttribute = getCellAttributeManualVertexAttributes(stream.getFaceCellId(f_id, side));
             }
-            for (uint32_t v_id : f.vs) {
-                vertexAttributes.push_back(vertexAttribute);
-                glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
+            for (size_t j = 0; j < 4; j++) {
+                uint32_t v_id = faceVertexIds[j];
+                vertexAttributes[attributeBase + quadOffset * 4 + j] = vertexAttribute;
+                vertexPositions[vertexBase + quadOffset * 4 + j] = glm::vec3(
+                        mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
             }
 
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+1);
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+3);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+0);
-        }
-
-        if (!f.boundary && !isCellMarked(f.neighbor_hs.at(1))) {
-            size_t idxStart = vertexPositions.size();
-            float vertexAttribute;
-            // Compute attribute data.
-            if (!useManualVertexAttribute) {
-                vertexAttribute = getCellAttribute(f.neighbor_hs.at(1));
-            } else {
-                vertexAttribute = getCellAttributeManualVertexAttributes(f.neighbor_hs.at(1));
-            }
-            for (uint32_t v_id : f.vs) {
-                vertexAttributes.push_back(vertexAttribute);
-                glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-                vertexPositions.push_back(vertexPosition);
+            static const uint32_t quadTriangleOffsets[2][6] = { { 2, 1, 0, 3, 2, 0 }, { 0, 1, 2, 0, 2, 3 } };
+            for (size_t j = 0; j < 6; j++) {
+                triangleIndices[indexBase + quadOffset * 6 + j] =
+                        uint32_t(idxStart + quadTriangleOffsets[isBackQuad ? 1 : 0][j]);
             }
+            quadOffset++;
+        };
 
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+1);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+0);
-            triangleIndices.push_back(idxStart+2);
-            triangleIndices.push_back(idxStart+3);
+        if (hasFrontQuad(faceFlags)) {
+            writeQuad(0, false);
         }
-    }
+        if (hasBackQuad(faceFlags)) {
+            writeQuad(1, true);
+        }
+    });
 }
 
 void HexMesh::getVolumeData_FacesShared(
@@ -1255,6 +1803,17 @@ void HexMesh::getVolumeData_FacesShared(
         std::vector<glm::vec3>& vertexPositions,
         std::vector<float>& vertexAttributes,
         bool useVolumeWeighting) {
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    OutputBuffer<float> vertexAttributeBuffer(vertexAttributes);
+    getVolumeData_FacesShared(triangleIndexBuffer, vertexPositionBuffer, vertexAttributeBuffer, useVolumeWeighting);
+}
+
+void HexMesh::getVolumeData_FacesShared(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        OutputBuffer<float>& vertexAttributes,
+        bool useVolumeWeighting) {
     rebuildInternalRepresentationIfNecessary();
 
     // Compute all cell volumes.
@@ -1263,57 +1822,50 @@ void HexMesh::getVolumeData_FacesShared(
     }
 
     // Add all hexahedral mesh vertices to the triangle mesh vertex data.
-    for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-        glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-        vertexPositions.push_back(vertexPosition);
-    }
-    if (!useManualVertexAttribute) {
-        if (useVolumeWeighting) {
-            for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-                vertexAttributes.push_back(interpolateCellAttributePerVertex(v_id, cellVolumes));
-            }
+    size_t vertexBase = vertexPositions.size();
+    size_t attributeBase = vertexAttributes.size();
+    vertexPositions.resize(vertexBase + mesh->Vs.size());
+    vertexAttributes.resize(attributeBase + mesh->Vs.size());
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
+        vertexPositions[vertexBase + v_id] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+        if (useManualVertexAttribute) {
+            // Use manually specified attributes.
+            vertexAttributes[attributeBase + v_id] = this->manualVertexAttributes->at(v_id);
+        } else if (useVolumeWeighting) {
+            vertexAttributes[attributeBase + v_id] = interpolateCellAttributePerVertex(uint32_t(v_id), cellVolumes);
         } else {
-            for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-                vertexAttributes.push_back(maximumCellAttributePerVertex(v_id));
-            }
-        }
-    } else {
-        // Use manually specified attributes.
-        for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-            vertexAttributes.push_back(this->manualVertexAttributes->at(v_id));
-        }
-    }
-
-    // Add all triangle indices.
-    triangleIndices.reserve(mesh->Fs.size() * 12);
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        assert(f.vs.size() == 4);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[1]);
-        triangleIndices.push_back(f.vs[0]);
-        triangleIndices.push_back(f.vs[3]);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[0]);
-
-        triangleIndices.push_back(f.vs[0]);
-        triangleIndices.push_back(f.vs[1]);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[0]);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[3]);
-    }
+            vertexAttributes[attributeBase + v_id] = maximumCellAttributePerVertex(uint32_t(v_id));
+        }
+    });
+
+    // Add all triangle indices.
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    triangleIndices.resize(indexBase + visibleFaceIds.size() * 12);
+    parallelFor(visibleFaceIds.size(), [&](size_t i) {
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(visibleFaceIds[i]);
+        static const uint32_t quadTriangleCorners[12] = { 2, 1, 0, 3, 2, 0, 0, 1, 2, 0, 2, 3 };
+        for (size_t j = 0; j < 12; j++) {
+            triangleIndices[indexBase + i * 12 + j] = faceVertexIds[quadTriangleCorners[j]];
+        }
+    });
 }
 
 void HexMesh::getVolumeData_VolumeShared(
         std::vector<uint32_t>& triangleIndices,
         std::vector<glm::vec3>& vertexPositions,
         std::vector<float>& vertexAttributes) {
+    OutputBuffer<uint32_t> triangleIndexBuffer(triangleIndices);
+    OutputBuffer<glm::vec3> vertexPositionBuffer(vertexPositions);
+    OutputBuffer<float> vertexAttributeBuffer(vertexAttributes);
+    getVolumeData_VolumeShared(triangleIndexBuffer, vertexPositionBuffer, vertexAttributeBuffer);
+}
+
+void HexMesh::getVolumeData_VolumeShared(
+        OutputBuffer<uint32_t>& triangleIndices,
+        OutputBuffer<glm::vec3>& vertexPositions,
+        OutputBuffer<float>& vertexAttributes) {
     rebuildInternalRepresentationIfNecessary();
 
     // Compute all cell volumes.
@@ -1322,44 +1874,38 @@ void HexMesh::getVolumeData_VolumeShared(
     }
 
     // Add all hexahedral mesh vertices to the triangle mesh vertex data.
-    for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
+    size_t vertexBase = vertexPositions.size();
+    size_t attributeBase = vertexAttributes.size();
+    vertexPositions.resize(vertexBase + mesh->Vs.size());
+    vertexAttributes.resize(attributeBase + mesh->Vs.size());
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
         float vertexAttribute;
         if (!useManualVertexAttribute) {
-            vertexAttribute = interpolateCellAttributePerVertex(v_id, cellVolumes);
+            vertexAttribute = interpolateCellAttributePerVertex(uint32_t(v_id), cellVolumes);
         } else {
             vertexAttribute = this->manualVertexAttributes->at(v_id);
         }
-        vertexAttributes.push_back(vertexAttribute);
-        glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-        vertexPositions.push_back(vertexPosition);
-    }
-
-    // Add all triangle indices.
-    triangleIndices.reserve(mesh->Fs.size() * 12);
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        assert(f.vs.size() == 4);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[1]);
-        triangleIndices.push_back(f.vs[0]);
-        triangleIndices.push_back(f.vs[3]);
-        triangleIndices.push_back(f.vs[2]);
-        triangleIndices.push_back(f.vs[0]);
-
-        if (!f.boundary) {
-            triangleIndices.push_back(f.vs[0]);
-            triangleIndices.push_back(f.vs[1]);
-            triangleIndices.push_back(f.vs[2]);
-            triangleIndices.push_back(f.vs[0]);
-            triangleIndices.push_back(f.vs[2]);
-            triangleIndices.push_back(f.vs[3]);
-        }
-    }
+        vertexAttributes[attributeBase + v_id] = vertexAttribute;
+        vertexPositions[vertexBase + v_id] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+    });
+
+    // Add all triangle indices. Boundary faces are only seen from the inside.
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    parallelCountScanFill<size_t>(visibleFaceIds.size(), [&](size_t i) -> size_t {
+        return stream.getIsFaceBoundary(visibleFaceIds[i]) ? 6 : 12;
+    }, [&](size_t numIndices) {
+        triangleIndices.resize(indexBase + numIndices);
+    }, [&](size_t i, size_t indexOffset) {
+        uint32_t f_id = visibleFaceIds[i];
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
+        static const uint32_t quadTriangleCorners[12] = { 2, 1, 0, 3, 2, 0, 0, 1, 2, 0, 2, 3 };
+        size_t numIndices = stream.getIsFaceBoundary(f_id) ? 6 : 12;
+        for (size_t j = 0; j < numIndices; j++) {
+            triangleIndices[indexBase + indexOffset + j] = faceVertexIds[quadTriangleCorners[j]];
+        }
+    });
 }
 
 void HexMesh::getSingularityData(
@@ -2322,8 +2868,8 @@ void HexMesh::getCompleteWireframeTubeData(
         if (se.es_link.size() == 1) {
             v_id = se.es_link.at(0);
         } else {
-            std::vector<uint32_t>& verticesEdge0 = mesh->Es.at(se.es_link.at(0)).vs;
-            std::vector<uint32_t>& verticesEdge1 = mesh->Es.at(se.es_link.at(1)).vs;
+            Fixed_List<2>& verticesEdge0 = mesh->Es.at(se.es_link.at(0)).vs;
+            Fixed_List<2>& verticesEdge1 = mesh->Es.at(se.es_link.at(1)).vs;
             std::vector<uint32_t> sharedVertices;
             std::sort(verticesEdge0.begin(), verticesEdge0.end());
             std::sort(verticesEdge1.begin(), verticesEdge1.end());
@@ -2494,50 +3040,37 @@ void HexMesh::getSurfaceDataBarycentric(
     const glm::vec4 regularColor = useGlowColors ? glowColorRegular : outlineColorRegular;
     const glm::vec4 singularColor = useGlowColors ? glowColorSingular : outlineColorSingular;
 
-    size_t indexOffset = 0;
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t numFaces = visibleFaceIds.size();
+    size_t indexBase = triangleIndices.size();
+    size_t vertexBase = vertexPositions.size();
+    size_t colorBase = vertexColors.size();
+    size_t barycentricBase = barycentricCoordinates.size();
+    triangleIndices.resize(indexBase + numFaces * 6);
+    vertexPositions.resize(vertexBase + numFaces * 4);
+    vertexColors.resize(colorBase + numFaces * 4);
+    barycentricCoordinates.resize(barycentricBase + numFaces * 4);
+    parallelFor(numFaces, [&](size_t faceOffset) {
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(visibleFaceIds[faceOffset]);
+        for (size_t j = 0; j < 4; j++) {
+            uint32_t v_id = faceVertexIds[j];
+            vertexPositions[vertexBase + faceOffset * 4 + j] = glm::vec3(
+                    mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
         }
 
-        for (uint32_t v_id : f.vs) {
-            glm::vec3 vertexPosition(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-            vertexPositions.push_back(vertexPosition);
-        }
-
-        /**
-         * 1             2
-         *  | - - - - - |
-         *  | \         |
-         *  |   \       |
-         *  |     \     |
-         *  |       \   |
-         *  |         \ |
-         *  | - - - - - |
-         * 0             3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
+        writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4));
 
         glm::vec4 vertexColor(regularColor);
-        vertexColors.push_back(vertexColor);
-        vertexColors.push_back(vertexColor);
-        vertexColors.push_back(vertexColor);
-        vertexColors.push_back(vertexColor);
-
-        barycentricCoordinates.push_back(glm::vec3(1,0,0));
-        barycentricCoordinates.push_back(glm::vec3(0,1,0));
-        barycentricCoordinates.push_back(glm::vec3(1,0,0));
-        barycentricCoordinates.push_back(glm::vec3(0,0,1));
+        for (size_t j = 0; j < 4; j++) {
+            vertexColors[colorBase + faceOffset * 4 + j] = vertexColor;
+        }
 
-        indexOffset += 4;
-    }
+        barycentricCoordinates[barycentricBase + faceOffset * 4 + 0] = glm::vec3(1,0,0);
+        barycentricCoordinates[barycentricBase + faceOffset * 4 + 1] = glm::vec3(0,1,0);
+        barycentricCoordinates[barycentricBase + faceOffset * 4 + 2] = glm::vec3(1,0,0);
+        barycentricCoordinates[barycentricBase + faceOffset * 4 + 3] = glm::vec3(0,0,1);
+    });
 }
 
 
@@ -2546,65 +3079,41 @@ void HexMesh::getSurfaceDataWireframeFaces(
         std::vector<HexahedralCellFace>& hexahedralCellFaces,
         bool onlyBoundary,
         bool useGlowColors) {
-    rebuildInternalRepresentationIfNecessary();
-
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Fs.size(); i++) {
-        Hybrid_F& f = mesh->Fs.at(i);
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        if (onlyBoundary) {
-            if (!f.boundary && !std::any_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-                return isCellMarked(h_id);
-            })) {
-                continue;
-            }
-        }
-
-        hexahedralCellFaces.push_back(HexahedralCellFace());
-        HexahedralCellFace& hexahedralCellFace = hexahedralCellFaces.back();
-
-        assert(f.vs.size() == 4);
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    parallelCountScanFill<size_t>(visibleFaceIds.size(), [&](size_t i) -> size_t {
+        if (onlyBoundary && !stream.getIsFaceOnFilteredSurface(visibleFaceIds[i])) {
+            return 0;
+        }
+        return 1;
+    }, [&](size_t numFaces) {
+        triangleIndices.resize(indexBase + numFaces * 6);
+        hexahedralCellFaces.resize(faceBase + numFaces);
+    }, [&](size_t i, size_t faceOffset) {
+        uint32_t f_id = visibleFaceIds[i];
+        HexahedralCellFace& hexahedralCellFace = hexahedralCellFaces[faceBase + faceOffset];
+
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t v_id = f.vs.at(j);
+            uint32_t v_id = faceVertexIds[j];
             glm::vec4 vertexPosition(
                     mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
             hexahedralCellFace.vertexPositions[j] = vertexPosition;
         }
 
-        /**
-         * vertex 1     edge 1    vertex 2
-         *          | - - - - - |
-         *          | \         |
-         *          |   \       |
-         *   edge 0 |     \     | edge 2
-         *          |       \   |
-         *          |         \ |
-         *          | - - - - - |
-         * vertex 0     edge 3    vertex 3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
-
-        assert(f.es.size() == 4);
+        writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4));
+
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t e_id = f.es.at(j);
-            Hybrid_E& e = mesh->Es.at(e_id);
-            int edgeValence = int(e.neighbor_hs.size());
-            glm::vec4 vertexColor = edgeColorMap(singularEdgeIds.find(e_id) != singularEdgeIds.end(), e.boundary, edgeValence);
+            uint32_t e_id = faceEdgeIds[j];
+            glm::vec4 vertexColor = edgeColorMap(
+                    stream.getIsEdgeSingular(e_id), stream.getIsEdgeBoundary(e_id), stream.getEdgeValence(e_id));
             hexahedralCellFace.lineColors[j] = vertexColor;
         }
-
-        indexOffset += 4;
-    }
+    });
 }
 
 void HexMesh::getSurfaceDataWireframeFaces(
@@ -2612,60 +3121,40 @@ void HexMesh::getSurfaceDataWireframeFaces(
         std::vector<HexahedralCellFace>& hexahedralCellFaces,
         const std::vector<uint32_t>& faceIds,
         bool useSingularEdgeColorMap) {
-    rebuildInternalRepresentationIfNecessary();
-
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < faceIds.size(); i++) {
-        Hybrid_F& f = mesh->Fs.at(faceIds.at(i));
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        hexahedralCellFaces.push_back(HexahedralCellFace());
-        HexahedralCellFace& hexahedralCellFace = hexahedralCellFaces.back();
-
-        assert(f.vs.size() == 4);
+    const FaceStream& stream = getFaceStream();
+
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    parallelCountScanFill<size_t>(faceIds.size(), [&](size_t i) -> size_t {
+        return stream.getIsFaceVisible(faceIds.at(i)) ? 1 : 0;
+    }, [&](size_t numFaces) {
+        triangleIndices.resize(indexBase + numFaces * 6);
+        hexahedralCellFaces.resize(faceBase + numFaces);
+    }, [&](size_t i, size_t faceOffset) {
+        uint32_t f_id = faceIds.at(i);
+        HexahedralCellFace& hexahedralCellFace = hexahedralCellFaces[faceBase + faceOffset];
+
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t v_id = f.vs.at(j);
+            uint32_t v_id = faceVertexIds[j];
             glm::vec4 vertexPosition(
                     mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
             hexahedralCellFace.vertexPositions[j] = vertexPosition;
         }
 
-        /**
-         * vertex 1     edge 1    vertex 2
-         *          | - - - - - |
-         *          | \         |
-         *          |   \       |
-         *   edge 0 |     \     | edge 2
-         *          |       \   |
-         *          |         \ |
-         *          | - - - - - |
-         * vertex 0     edge 3    vertex 3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
-
-        assert(f.es.size() == 4);
+        writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4));
+
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t e_id = f.es.at(j);
-            Hybrid_E& e = mesh->Es.at(e_id);
+            uint32_t e_id = faceEdgeIds[j];
             glm::vec4 vertexColor(0.0f, 0.0f, 0.0f, 1.0f);
             if (useSingularEdgeColorMap) {
-                int edgeValence = int(e.neighbor_hs.size());
-                vertexColor = edgeColorMap(singularEdgeIds.find(e_id) != singularEdgeIds.end(), e.boundary, edgeValence);
+                vertexColor = edgeColorMap(
+                        stream.getIsEdgeSingular(e_id), stream.getIsEdgeBoundary(e_id), stream.getEdgeValence(e_id));
             }
             hexahedralCellFace.lineColors[j] = vertexColor;
         }
-
-        indexOffset += 4;
-    }
+    });
 }
 
 
@@ -2795,129 +3284,85 @@ void HexMesh::getSurfaceDataWireframeFacesUnified_AttributePerVertex(
     }
 
 
-    // 1. Get vertex data (first: position).
-    hexahedralCellVertices.reserve(mesh->Vs.size());
-    for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-        hexahedralCellVertices.push_back(HexahedralCellVertexUnified());
-        HexahedralCellVertexUnified& hexahedralCellVertex = hexahedralCellVertices.back();
+    // 1. Get vertex data (position and attribute).
+    size_t vertexBase = hexahedralCellVertices.size();
+    hexahedralCellVertices.resize(vertexBase + mesh->Vs.size());
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
+        HexahedralCellVertexUnified& hexahedralCellVertex = hexahedralCellVertices[vertexBase + v_id];
         hexahedralCellVertex.vertexPosition = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
-    }
-
-    // 1.2 Get vertex attributes.
-    if (!useManualVertexAttribute) {
-        if (useVolumeWeighting) {
-            for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-                HexahedralCellVertexUnified& hexahedralCellVertex = hexahedralCellVertices.at(v_id);
-                hexahedralCellVertex.vertexAttribute = interpolateCellAttributePerVertex(v_id, cellVolumes);
-            }
-        } else {
-            for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-                HexahedralCellVertexUnified& hexahedralCellVertex = hexahedralCellVertices.at(v_id);
-                hexahedralCellVertex.vertexAttribute = maximumCellAttributePerVertex(v_id);
-            }
-        }
-    } else {
-        // Use manually specified attributes.
-        for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-            HexahedralCellVertexUnified& hexahedralCellVertex = hexahedralCellVertices.at(v_id);
+        if (useManualVertexAttribute) {
+            // Use manually specified attributes.
             hexahedralCellVertex.vertexAttribute = this->manualVertexAttributes->at(v_id);
+        } else if (useVolumeWeighting) {
+            hexahedralCellVertex.vertexAttribute = interpolateCellAttributePerVertex(uint32_t(v_id), cellVolumes);
+        } else {
+            hexahedralCellVertex.vertexAttribute = maximumCellAttributePerVertex(uint32_t(v_id));
         }
-    }
+    });
 
 
     // 2. Edge data.
-    hexahedralCellEdges.reserve(mesh->Es.size());
-    if (!useManualVertexAttribute) {
-        // Compute all edge attributes.
-        for (uint32_t e_id = 0; e_id < mesh->Es.size(); e_id++) {
-            hexahedralCellEdges.push_back(HexahedralCellEdgeUnified());
-            HexahedralCellEdgeUnified& hexahedralCellEdge = hexahedralCellEdges.back();
-            hexahedralCellEdge.edgeAttribute = maximumCellAttributePerEdge(e_id);
-            hexahedralCellEdge.edgeLodValue = edgeLodValues.at(e_id);
-        }
-    } else {
-        // Use manually specified attributes.
-        for (uint32_t e_id = 0; e_id < mesh->Es.size(); e_id++) {
+    size_t edgeBase = hexahedralCellEdges.size();
+    hexahedralCellEdges.resize(edgeBase + mesh->Es.size());
+    parallelFor(mesh->Es.size(), [&](size_t e_id) {
+        HexahedralCellEdgeUnified& hexahedralCellEdge = hexahedralCellEdges[edgeBase + e_id];
+        if (!useManualVertexAttribute) {
+            hexahedralCellEdge.edgeAttribute = maximumCellAttributePerEdge(uint32_t(e_id));
+        } else {
+            // Use manually specified attributes.
             Hybrid_E& e = mesh->Es.at(e_id);
-            hexahedralCellEdges.push_back(HexahedralCellEdgeUnified());
-            HexahedralCellEdgeUnified& hexahedralCellEdge = hexahedralCellEdges.back();
             hexahedralCellEdge.edgeAttribute =
                     (this->manualVertexAttributes->at(e.vs.at(0))
                      + this->manualVertexAttributes->at(e.vs.at(1))) * 0.5f;
-            hexahedralCellEdge.edgeLodValue = edgeLodValues.at(e_id);
-            //hexahedralCellEdge.edgeSingularityInformation = packEdgeSingularityInformation(e_id);
         }
-    }
+        hexahedralCellEdge.edgeLodValue = edgeLodValues.at(e_id);
+    });
 
 
     // 3. Cell data.
     if (showFocusFaces) {
-        hexahedralCells.reserve(mesh->Hs.size());
-        for (uint32_t h_id = 0; h_id < mesh->Hs.size(); h_id++) {
-            hexahedralCells.push_back(getCellAttribute(h_id));
-        }
+        size_t cellBase = hexahedralCells.size();
+        hexahedralCells.resize(cellBase + mesh->Hs.size());
+        parallelFor(mesh->Hs.size(), [&](size_t h_id) {
+            hexahedralCells[cellBase + h_id] = getCellAttribute(uint32_t(h_id));
+        });
     }
 
 
     // 4. Face data.
-    size_t indexOffset = 0;
-    hexahedralCellFaces.reserve(mesh->Fs.size());
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t numFaces = visibleFaceIds.size();
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    size_t cellLinkBase = hexahedralCellFacesCellLinks.size();
+    triangleIndices.resize(indexBase + numFaces * 6);
+    hexahedralCellFaces.resize(faceBase + numFaces);
     if (showFocusFaces) {
-        hexahedralCellFacesCellLinks.reserve(mesh->Fs.size());
+        hexahedralCellFacesCellLinks.resize(cellLinkBase + numFaces);
     }
-    for (size_t f_id = 0; f_id < mesh->Fs.size(); f_id++) {
-        Hybrid_F& f = mesh->Fs.at(f_id);
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        hexahedralCellFaces.push_back(HexahedralCellFaceUnified());
-        HexahedralCellFaceUnified& hexahedralCellFace = hexahedralCellFaces.back();
-        hexahedralCellFace.vertexIdx[0];
-        hexahedralCellFace.edgeIdx[0];
+    parallelFor(numFaces, [&](size_t faceOffset) {
+        uint32_t f_id = visibleFaceIds[faceOffset];
+        HexahedralCellFaceUnified& hexahedralCellFace = hexahedralCellFaces[faceBase + faceOffset];
 
         if (showFocusFaces) {
-            glm::uvec2 cellLinks = glm::uvec2(0xFFFFFFFF, 0xFFFFFFFF);
-            assert(f.neighbor_hs.size() == 1 || f.neighbor_hs.size() == 2);
-            for (size_t i = 0; i < f.neighbor_hs.size(); i++) {
-                cellLinks[i] = f.neighbor_hs.at(i);
-            }
-            hexahedralCellFacesCellLinks.push_back(cellLinks);
-
+            // The outer side of boundary faces is linked to FaceStream::INVALID_CELL (i.e., 0xFFFFFFFF).
+            hexahedralCellFacesCellLinks[cellLinkBase + faceOffset] = glm::uvec2(
+                    stream.getFaceCellId(f_id, 0), stream.getFaceCellId(f_id, 1));
         }
 
-        assert(f.vs.size() == 4);
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
         for (size_t i = 0; i < 4; i++) {
-            hexahedralCellFace.vertexIdx[i] = f.vs.at(i);
+            hexahedralCellFace.vertexIdx[i] = faceVertexIds[i];
         }
 
-        assert(f.es.size() == 4);
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            hexahedralCellFace.edgeIdx[j] = f.es.at(j);
-        }
-
-        /**
-         * vertex 1     edge 1    vertex 2
-         *          | - - - - - |
-         *          | \         |
-         *          |   \       |
-         *   edge 0 |     \     | edge 2
-         *          |       \   |
-         *          |         \ |
-         *          | - - - - - |
-         * vertex 0     edge 3    vertex 3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
+            hexahedralCellFace.edgeIdx[j] = faceEdgeIds[j];
+        }
 
-        indexOffset += 4;
-    }
+        writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4));
+    });
 }
 
 void HexMesh::getSurfaceDataWireframeFacesUnified_AttributePerCell_Volume2(
@@ -2942,107 +3387,71 @@ void HexMesh::getSurfaceDataWireframeFacesUnified_AttributePerCell_Volume2(
 
     // Compute all edge attributes.
     std::vector<float> edgeAttributes(mesh->Es.size());
-    for (uint32_t e_id = 0; e_id < mesh->Es.size(); e_id++) {
-        float edgeAttribute = maximumCellAttributePerEdge(e_id);
-        edgeAttributes.at(e_id) = edgeAttribute;
-    }
-
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Hs.size(); i++) {
-        Hybrid& h = mesh->Hs.at(i);
-        for (size_t j = 0; j < h.fs.size(); j++) {
-            Hybrid_F& f = mesh->Fs.at(h.fs.at(j));
-            if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-                return isCellMarked(h_id);
-            })) {
-                continue;
-            }
+    parallelFor(mesh->Es.size(), [&](size_t e_id) {
+        edgeAttributes[e_id] = maximumCellAttributePerEdge(uint32_t(e_id));
+    });
 
-            assert(f.neighbor_hs.size() >= 1 && f.neighbor_hs.size() <= 2);
-            bool invertWinding = f.neighbor_hs.at(0) != h.id;
+    const FaceStream& stream = getFaceStream();
 
-            hexahedralCellFaces.push_back(HexahedralCellFaceUnified_Volume2());
-            HexahedralCellFaceUnified_Volume2& hexahedralCellFace = hexahedralCellFaces.back();
-            hexahedralCellFace.bitfield[0] = hexahedralCellFace.bitfield[1] = hexahedralCellFace.bitfield[2]
-                    = hexahedralCellFace.bitfield[3] = 0u;
+    auto fillFace = [&](uint32_t f_id, size_t side, uint32_t bitfield, HexahedralCellFaceUnified_Volume2& cellFace) {
+        cellFace.bitfield[0] = cellFace.bitfield[1] = cellFace.bitfield[2] = cellFace.bitfield[3] = bitfield;
 
-            assert(f.vs.size() == 4);
-            for (size_t j = 0; j < 4; j++) {
-                uint32_t v_id = f.vs.at(j);
-                glm::vec4 vertexPosition(
-                        mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
-                hexahedralCellFace.vertexPositions[j] = vertexPosition;
-                hexahedralCellFace.vertexAttributes[j] = getCellAttribute(h.id);
-            }
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
+        float cellAttribute = stream.getFaceCellAttribute(f_id, side);
+        for (size_t j = 0; j < 4; j++) {
+            uint32_t v_id = faceVertexIds[j];
+            glm::vec4 vertexPosition(
+                    mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
+            cellFace.vertexPositions[j] = vertexPosition;
+            cellFace.vertexAttributes[j] = cellAttribute;
+        }
 
-            if (!invertWinding) {
-                /**
-                 * vertex 1     edge 1    vertex 2
-                 *          | - - - - - |
-                 *          | \         |
-                 *          |   \       |
-                 *   edge 0 |     \     | edge 2
-                 *          |       \   |
-                 *          |         \ |
-                 *          | - - - - - |
-                 * vertex 0     edge 3    vertex 3
-                 */
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
-            }
-            if (invertWinding || f.boundary) {
-                if (f.boundary) {
-                    indexOffset += 4;
-                }
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 0);
-                triangleIndices.push_back(indexOffset + 3);
-                triangleIndices.push_back(indexOffset + 1);
-                triangleIndices.push_back(indexOffset + 2);
-            }
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
+        for (size_t j = 0; j < 4; j++) {
+            uint32_t e_id = faceEdgeIds[j];
+            cellFace.edgeAttributes[j] = edgeAttributes.at(e_id);
+            cellFace.edgeLodValues[j] = edgeLodValues.at(e_id);
+            cellFace.edgeSingularityInformationList[j] = stream.getEdgeSingularityInformation(e_id);
+        }
+    };
 
-            assert(f.es.size() == 4);
-            for (size_t j = 0; j < 4; j++) {
-                uint32_t e_id = f.es.at(j);
-                Hybrid_E& e = mesh->Es.at(e_id);
-                hexahedralCellFace.edgeAttributes[j] = edgeAttributes.at(e_id);
-                hexahedralCellFace.edgeLodValues[j] = edgeLodValues.at(e_id);
-                hexahedralCellFace.edgeSingularityInformationList[j] = packEdgeSingularityInformation(e_id);
+    // Every unfiltered face of a cell adds one face entry with one triangle pair. Boundary faces add a second entry
+    // for their backface.
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    parallelCountScanFill<size_t>(mesh->Hs.size(), [&](size_t cellIdx) -> size_t {
+        size_t numFaces = 0;
+        for (uint32_t f_id : mesh->Hs.at(cellIdx).fs) {
+            if (stream.getIsFaceVisible(f_id)) {
+                numFaces += stream.getIsFaceBoundary(f_id) ? 2 : 1;
+            }
+        }
+        return numFaces;
+    }, [&](size_t numFaces) {
+        triangleIndices.resize(indexBase + numFaces * 6);
+        hexahedralCellFaces.resize(faceBase + numFaces);
+    }, [&](size_t cellIdx, size_t faceOffset) {
+        Hybrid& h = mesh->Hs.at(cellIdx);
+        for (uint32_t f_id : h.fs) {
+            if (!stream.getIsFaceVisible(f_id)) {
+                continue;
             }
 
-            indexOffset += 4;
+            bool invertWinding = stream.getFaceCellId(f_id, 0) != h.id;
+            size_t side = invertWinding ? 1 : 0;
 
-            if (f.boundary) {
-                hexahedralCellFaces.push_back(HexahedralCellFaceUnified_Volume2());
-                HexahedralCellFaceUnified_Volume2& hexahedralCellBackface = hexahedralCellFaces.back();
-                hexahedralCellBackface.bitfield[0] = hexahedralCellBackface.bitfield[1] = hexahedralCellBackface.bitfield[2]
-                        = hexahedralCellBackface.bitfield[3] = 1u;
-
-                assert(f.vs.size() == 4);
-                for (size_t j = 0; j < 4; j++) {
-                    uint32_t v_id = f.vs.at(j);
-                    glm::vec4 vertexPosition(
-                            mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
-                    hexahedralCellBackface.vertexPositions[j] = vertexPosition;
-                    hexahedralCellBackface.vertexAttributes[j] = getCellAttribute(h.id);
-                }
+            fillFace(f_id, side, 0u, hexahedralCellFaces[faceBase + faceOffset]);
+            writeQuadTriangleIndices(
+                    &triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4), invertWinding);
+            faceOffset++;
 
-                assert(f.es.size() == 4);
-                for (size_t j = 0; j < 4; j++) {
-                    uint32_t e_id = f.es.at(j);
-                    Hybrid_E& e = mesh->Es.at(e_id);
-                    hexahedralCellBackface.edgeAttributes[j] = edgeAttributes.at(e_id);
-                    hexahedralCellBackface.edgeLodValues[j] = edgeLodValues.at(e_id);
-                    hexahedralCellBackface.edgeSingularityInformationList[j] = packEdgeSingularityInformation(e_id);
-                }
+            if (stream.getIsFaceBoundary(f_id)) {
+                fillFace(f_id, side, 1u, hexahedralCellFaces[faceBase + faceOffset]);
+                writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4), true);
+                faceOffset++;
             }
         }
-    }
+    });
 }
 
 void HexMesh::getSurfaceDataWireframeFacesUnified_AttributePerVertex_Volume2(
@@ -3067,106 +3476,65 @@ void HexMesh::getSurfaceDataWireframeFacesUnified_AttributePerVertex_Volume2(
 
     // Compute all vertex attributes.
     std::vector<float> vertexAttributes(mesh->Vs.size());
-    for (uint32_t v_id = 0; v_id < mesh->Vs.size(); v_id++) {
-        float vertexAttribute = interpolateCellAttributePerVertex(v_id, cellVolumes);
-        vertexAttributes.at(v_id) = vertexAttribute;
-    }
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
+        vertexAttributes[v_id] = interpolateCellAttributePerVertex(uint32_t(v_id), cellVolumes);
+    });
 
     // Compute all edge attributes.
     std::vector<float> edgeAttributes(mesh->Es.size());
-    for (uint32_t e_id = 0; e_id < mesh->Es.size(); e_id++) {
-        float edgeAttribute = maximumCellAttributePerEdge(e_id);
-        edgeAttributes.at(e_id) = edgeAttribute;
-    }
+    parallelFor(mesh->Es.size(), [&](size_t e_id) {
+        edgeAttributes[e_id] = maximumCellAttributePerEdge(uint32_t(e_id));
+    });
 
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Fs.size(); i++) {
-        Hybrid_F& f = mesh->Fs.at(i);
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
 
-        hexahedralCellFaces.push_back(HexahedralCellFaceUnified_Volume2());
-        HexahedralCellFaceUnified_Volume2& hexahedralCellFace = hexahedralCellFaces.back();
-        hexahedralCellFace.bitfield[0] = hexahedralCellFace.bitfield[1] = hexahedralCellFace.bitfield[2]
-                = hexahedralCellFace.bitfield[3] = 0u;
+    auto fillFace = [&](uint32_t f_id, uint32_t bitfield, HexahedralCellFaceUnified_Volume2& cellFace) {
+        cellFace.bitfield[0] = cellFace.bitfield[1] = cellFace.bitfield[2] = cellFace.bitfield[3] = bitfield;
 
-        assert(f.vs.size() == 4);
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t v_id = f.vs.at(j);
+            uint32_t v_id = faceVertexIds[j];
             glm::vec4 vertexPosition(
                     mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
-            hexahedralCellFace.vertexPositions[j] = vertexPosition;
-            hexahedralCellFace.vertexAttributes[j] = vertexAttributes.at(v_id);
-        }
-
-        /**
-         * vertex 1     edge 1    vertex 2
-         *          | - - - - - |
-         *          | \         |
-         *          |   \       |
-         *   edge 0 |     \     | edge 2
-         *          |       \   |
-         *          |         \ |
-         *          | - - - - - |
-         * vertex 0     edge 3    vertex 3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
-
-        // Backface
-        if (f.boundary) {
-            indexOffset += 4;
+            cellFace.vertexPositions[j] = vertexPosition;
+            cellFace.vertexAttributes[j] = vertexAttributes.at(v_id);
         }
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-
-        indexOffset += 4;
 
-        assert(f.es.size() == 4);
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t e_id = f.es.at(j);
-            Hybrid_E& e = mesh->Es.at(e_id);
-            hexahedralCellFace.edgeAttributes[j] = edgeAttributes.at(e_id);
-            hexahedralCellFace.edgeLodValues[j] = edgeLodValues.at(e_id);
-            hexahedralCellFace.edgeSingularityInformationList[j] = packEdgeSingularityInformation(e_id);
+            uint32_t e_id = faceEdgeIds[j];
+            cellFace.edgeAttributes[j] = edgeAttributes.at(e_id);
+            cellFace.edgeLodValues[j] = edgeLodValues.at(e_id);
+            cellFace.edgeSingularityInformationList[j] = stream.getEdgeSingularityInformation(e_id);
         }
+    };
 
-        if (f.boundary) {
-            hexahedralCellFaces.push_back(HexahedralCellFaceUnified_Volume2());
-            HexahedralCellFaceUnified_Volume2& hexahedralCellBackface = hexahedralCellFaces.back();
-            hexahedralCellBackface.bitfield[0] = hexahedralCellBackface.bitfield[1] = hexahedralCellBackface.bitfield[2]
-                    = hexahedralCellBackface.bitfield[3] = 1u;
-
-            assert(f.vs.size() == 4);
-            for (size_t j = 0; j < 4; j++) {
-                uint32_t v_id = f.vs.at(j);
-                glm::vec4 vertexPosition(
-                        mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
-                hexahedralCellBackface.vertexPositions[j] = vertexPosition;
-                hexahedralCellBackface.vertexAttributes[j] = vertexAttributes.at(v_id);
-            }
-
-            assert(f.es.size() == 4);
-            for (size_t j = 0; j < 4; j++) {
-                uint32_t e_id = f.es.at(j);
-                Hybrid_E& e = mesh->Es.at(e_id);
-                hexahedralCellBackface.edgeAttributes[j] = edgeAttributes.at(e_id);
-                hexahedralCellBackface.edgeLodValues[j] = edgeLodValues.at(e_id);
-                hexahedralCellBackface.edgeSingularityInformationList[j] = packEdgeSingularityInformation(e_id);
-            }
-        }
-    }
+    // Every unfiltered face adds a front and a back triangle pair. Boundary faces store their backface in a separate
+    // face entry, while inner faces reuse the vertices of the front face for it.
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    parallelCountScanFill<FaceIndexCount>(visibleFaceIds.size(), [&](size_t i) -> FaceIndexCount {
+        FaceIndexCount count;
+        count.numFaces = stream.getIsFaceBoundary(visibleFaceIds[i]) ? 2 : 1;
+        count.numIndices = 12;
+        return count;
+    }, [&](const FaceIndexCount& totalCount) {
+        triangleIndices.resize(indexBase + totalCount.numIndices);
+        hexahedralCellFaces.resize(faceBase + totalCount.numFaces);
+    }, [&](size_t i, const FaceIndexCount& offset) {
+        uint32_t f_id = visibleFaceIds[i];
+        bool isBoundary = stream.getIsFaceBoundary(f_id);
+        size_t backfaceOffset = offset.numFaces + (isBoundary ? 1 : 0);
+
+        fillFace(f_id, 0u, hexahedralCellFaces[faceBase + offset.numFaces]);
+        writeQuadTriangleIndices(&triangleIndices[indexBase + offset.numIndices], uint32_t(offset.numFaces * 4));
+        writeQuadTriangleIndices(
+                &triangleIndices[indexBase + offset.numIndices + 6], uint32_t(backfaceOffset * 4), true);
+        if (isBoundary) {
+            fillFace(f_id, 1u, hexahedralCellFaces[faceBase + backfaceOffset]);
+        }
+    });
 }
 
 void HexMesh::getVolumeData_DepthComplexity(
@@ -3174,34 +3542,23 @@ void HexMesh::getVolumeData_DepthComplexity(
         std::vector<glm::vec3>& vertexPositions) {
     rebuildInternalRepresentationIfNecessary();
 
-    for (Hybrid_V& v : mesh->Vs) {
-        glm::vec3 vertexPosition(mesh->V(0, v.id), mesh->V(1, v.id), mesh->V(2, v.id));
-        vertexPositions.push_back(vertexPosition);
-    }
-
-    size_t indexOffset = 0;
-    for (Hybrid_F& f : mesh->Fs) {
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
+    size_t vertexBase = vertexPositions.size();
+    vertexPositions.resize(vertexBase + mesh->Vs.size());
+    parallelFor(mesh->Vs.size(), [&](size_t v_id) {
+        vertexPositions[vertexBase + v_id] = glm::vec3(mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id));
+    });
 
-        assert(f.vs.size() == 4);
-        uint32_t v_ids[4];
-        for (size_t j = 0; j < 4; j++) {
-            v_ids[j] = f.vs.at(j);
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    triangleIndices.resize(indexBase + visibleFaceIds.size() * 6);
+    parallelFor(visibleFaceIds.size(), [&](size_t faceOffset) {
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(visibleFaceIds[faceOffset]);
+        static const uint32_t quadTriangleCorners[6] = { 0, 3, 1, 2, 1, 3 };
+        for (size_t j = 0; j < 6; j++) {
+            triangleIndices[indexBase + faceOffset * 6 + j] = faceVertexIds[quadTriangleCorners[j]];
         }
-
-        triangleIndices.push_back(v_ids[0]);
-        triangleIndices.push_back(v_ids[3]);
-        triangleIndices.push_back(v_ids[1]);
-        triangleIndices.push_back(v_ids[2]);
-        triangleIndices.push_back(v_ids[1]);
-        triangleIndices.push_back(v_ids[3]);
-
-        indexOffset += 4;
-    }
+    });
 }
 
 void HexMesh::getSurfaceDataWireframeFacesLineDensityControl(
@@ -3226,58 +3583,36 @@ void HexMesh::getSurfaceDataWireframeFacesLineDensityControl(
 
     // Compute all edge attributes.
     std::vector<float> edgeAttributes(mesh->Es.size());
-    for (uint32_t e_id = 0; e_id < mesh->Es.size(); e_id++) {
-        float edgeAttribute = interpolateCellAttributePerEdge(e_id, cellVolumes);
-        edgeAttributes.at(e_id) = edgeAttribute;
-    }
-
-    size_t indexOffset = 0;
-    for (size_t i = 0; i < mesh->Fs.size(); i++) {
-        Hybrid_F& f = mesh->Fs.at(i);
-        if (std::all_of(f.neighbor_hs.begin(), f.neighbor_hs.end(), [this](uint32_t h_id) {
-            return isCellMarked(h_id);
-        })) {
-            continue;
-        }
-
-        hexahedralCellFaces.push_back(HexahedralCellFaceLineDensityControl());
-        HexahedralCellFaceLineDensityControl& hexahedralCellFace = hexahedralCellFaces.back();
-
-        assert(f.vs.size() == 4);
+    parallelFor(mesh->Es.size(), [&](size_t e_id) {
+        edgeAttributes[e_id] = interpolateCellAttributePerEdge(uint32_t(e_id), cellVolumes);
+    });
+
+    const FaceStream& stream = getFaceStream();
+    const std::vector<uint32_t>& visibleFaceIds = stream.getVisibleFaceIds();
+    size_t indexBase = triangleIndices.size();
+    size_t faceBase = hexahedralCellFaces.size();
+    triangleIndices.resize(indexBase + visibleFaceIds.size() * 6);
+    hexahedralCellFaces.resize(faceBase + visibleFaceIds.size());
+    parallelFor(visibleFaceIds.size(), [&](size_t faceOffset) {
+        uint32_t f_id = visibleFaceIds[faceOffset];
+        HexahedralCellFaceLineDensityControl& hexahedralCellFace = hexahedralCellFaces[faceBase + faceOffset];
+
+        const uint32_t* faceVertexIds = stream.getFaceVertexIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t v_id = f.vs.at(j);
+            uint32_t v_id = faceVertexIds[j];
             glm::vec4 vertexPosition(
                     mesh->V(0, v_id), mesh->V(1, v_id), mesh->V(2, v_id), 1.0f);
             hexahedralCellFace.vertexPositions[j] = vertexPosition;
         }
 
-        /**
-         * vertex 1     edge 1    vertex 2
-         *          | - - - - - |
-         *          | \         |
-         *          |   \       |
-         *   edge 0 |     \     | edge 2
-         *          |       \   |
-         *          |         \ |
-         *          | - - - - - |
-         * vertex 0     edge 3    vertex 3
-         */
-        triangleIndices.push_back(indexOffset + 0);
-        triangleIndices.push_back(indexOffset + 3);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 2);
-        triangleIndices.push_back(indexOffset + 1);
-        triangleIndices.push_back(indexOffset + 3);
-
-        assert(f.es.size() == 4);
+        writeQuadTriangleIndices(&triangleIndices[indexBase + faceOffset * 6], uint32_t(faceOffset * 4));
+
+        const uint32_t* faceEdgeIds = stream.getFaceEdgeIds(f_id);
         for (size_t j = 0; j < 4; j++) {
-            uint32_t e_id = f.es.at(j);
-            Hybrid_E& e = mesh->Es.at(e_id);
+            uint32_t e_id = faceEdgeIds[j];
             hexahedralCellFace.edgeAttributes[j] = edgeAttributes.at(e_id);
             hexahedralCellFace.edgeLodValues[j] = edgeLodValues.at(e_id);
-            hexahedralCellFace.edgeSingularityInformationList[j] = packEdgeSingularityInformation(e_id);
+            hexahedralCellFace.edgeSingularityInformationList[j] = stream.getEdgeSingularityInformation(e_id);
         }
-
-        indexOffset += 4;
-    }
+    });
 }
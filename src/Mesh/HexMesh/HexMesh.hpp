@@ -71,11 +71,17 @@
 #include "QualityMeasure/QualityMeasure.hpp"
 #include "Renderers/Intersection/RayMeshIntersection.hpp"
 #include "Renderers/LOD/LodSheetGeneration.hpp"
+#include "Utils/OutputBuffer.hpp"
+#include "CellMask.hpp"
+#include "FilteredSurfaceData.hpp"
+#include "FaceStream.hpp"
 
 class Mesh;
 class Singularity;
 class Hybrid_E;
+class Hybrid_F;
 class Frame;
+class BinaryMeshCache;
 
 /**
  * Slim data representation for very large meshes.
@@ -99,6 +105,20 @@ class OctreeNode;
 class HexMesh;
 typedef std::shared_ptr<HexMesh> HexMeshPtr;
 
+/**
+ * Wall time (in milliseconds) of the stages of the base-complex frame extraction.
+ * @see HexMesh::getBaseComplexMeshFrameTimings.
+ */
+struct BaseComplexFrameTimings {
+    double nodeEdgeExtractionMs = 0.0;
+    double faceExtractionMs = 0.0;
+    double cuboidExtractionMs = 0.0;
+    double singularityAndColorMs = 0.0;
+    double totalMs = 0.0;
+    /// Whether the frame was loaded from the base-complex cache (only totalMs is set in this case).
+    bool isLoadedFromCache = false;
+};
+
 // For @see HexMesh::getSurfaceDataWireframeFaces.
 struct HexahedralCellFace {
     glm::vec4 vertexPositions[4];
@@ -166,6 +186,11 @@ struct HexahedralCellFaceLineDensityControl {
 class HexMesh {
 public:
     HexMesh(sgl::TransferFunctionWindow &transferFunctionWindow, RayMeshIntersection& rayMeshIntersection);
+    /**
+     * Creates a mesh without a transfer function window and ray-mesh intersection data structure. This is used for
+     * headless processing (e.g., benchmarking of the CPU stages), where neither histograms nor picking are needed.
+     */
+    HexMesh();
     ~HexMesh();
     /**
      *
@@ -173,24 +198,46 @@ public:
      * @param cellIndices The hex-mesh cell vertex indices.
      * @param loadMeshRepresentation Whether to load the (relatively large) mesh representation right away.
      * There are some rendering modes that can cope with smaller representations, so that might not always be necessary.
+     * @param meshCache An optional opened binary mesh cache. If it contains the mesh connectivity, the connectivity and
+     * singularity structure are restored from the cache instead of being recomputed.
      */
     void setHexMeshData(
             const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices,
-            bool loadMeshRepresentation = true);
+            bool loadMeshRepresentation = true, const BinaryMeshCache* meshCache = nullptr);
     void addManualVertexAttribute(const std::vector<float>& vertexAttributes, const std::string& attributeName);
     void addManualCellAttribute(const std::vector<float>& cellAttributes, const std::string& attributeName);
     void setQualityMeasure(QualityMeasure qualityMeasure);
+    /**
+     * If enabled, all quality measures are computed in one fused pass the next time a quality measure is set. The
+     * normalized qualities of all measures are stored as half floats, such that switching the quality measure
+     * afterwards only decodes the stored values instead of recomputing them.
+     * NOTE: The half floats have a precision of about 5e-4 close to 1. Thus, the cell attributes (and, e.g., the cells
+     * kept by the quality filter at a given threshold) may differ slightly from the ones without precomputation.
+     */
+    void setPrecomputeAllQualityMeasures(bool precompute);
     void onTransferFunctionMapRebuilt();
     inline bool isDirty() const { return dirty; }
+    /// Changes whenever the vertex positions or attributes change. The value is unique over all meshes.
+    inline uint64_t getMeshDataGeneration() const { return meshDataGeneration; }
 
     // Get mesh information.
     inline size_t getNumCells() const { return meshNumCells; }
     inline size_t getNumVertices() const { return meshNumVertices; }
 
     // Cell filtering.
-    void markCell(uint32_t h_id);
-    bool isCellMarked(uint32_t h_id);
+    inline void markCell(uint32_t h_id) { cellFilteringMask.set(h_id); }
+    inline bool isCellMarked(uint32_t h_id) const { return cellFilteringMask.test(h_id); }
     void unmark();
+    /**
+     * Returns the mask of filtered cells. Its per-block counts allow skipping fully filtered blocks of cells, and its
+     * change tracking allows updating render data only for the blocks changed since the last synchronization.
+     */
+    inline const CellMask& getCellFilteringMask() const { return cellFilteringMask; }
+    /**
+     * Marks exactly the cells marked in any of the passed masks (e.g., the cached masks of the enabled filters).
+     * @param filterMasks The masks to combine. Masks not matching the number of cells of this mesh are ignored.
+     */
+    void setCellFilteringMasks(const std::vector<const CellMask*>& filterMasks);
 
     /**
      * Updates the vertex positions of a deformable mesh. Thus, also the quality measure is recomputed for all cells.
@@ -208,6 +255,16 @@ public:
     Mesh& getBaseComplexMesh();
     Singularity& getBaseComplexMeshSingularity();
     Frame& getBaseComplexMeshFrame();
+    /// The stage timings of the last computation of the base-complex frame (zero if it wasn't computed yet).
+    inline const BaseComplexFrameTimings& getBaseComplexMeshFrameTimings() const { return baseComplexFrameTimings; }
+    /**
+     * Sets the directory of the base-complex cache. If set, the singularity structure and frame are loaded from a file
+     * in this directory keyed by the mesh topology when available, and are written to it after they were extracted.
+     * @param cacheDirectory The cache directory (with a trailing slash). An empty string disables the cache.
+     */
+    inline void setBaseComplexCacheDirectory(const std::string& cacheDirectory) {
+        baseComplexCacheDirectory = cacheDirectory;
+    }
 
     /**
      * @return The number of singular edges in the hexahedral mesh.
@@ -315,6 +372,32 @@ public:
             std::vector<uint32_t>& triangleIndices,
             std::vector<glm::vec3>& vertexPositions,
             bool removeFilteredCells = true);
+    /**
+     * Overloads of the extractors writing into output buffers. These can keep their capacity between regenerations
+     * or write directly into memory provided by the renderer (@see OutputBuffer).
+     */
+    void getSurfaceData(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            OutputBuffer<glm::vec3>& vertexNormals,
+            OutputBuffer<float>& vertexAttributes,
+            bool removeFilteredCells = true);
+    void getSurfaceData(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            bool removeFilteredCells = true);
+    /**
+     * Updates the triangle data of the boundary surface of the filtered hexahedral mesh. If the data was generated for
+     * this mesh before, only the faces adjacent to the cells whose filtering state changed since then are updated.
+     * Otherwise (or if the mesh data changed), all data is regenerated.
+     */
+    void updateFilteredSurfaceData(FilteredSurfaceData& surfaceData);
+    /**
+     * Returns the face stream of the mesh, i.e., the per-face and per-edge data all face-based extractors derive their
+     * output from. The static data is only regenerated if the mesh data changed, and the visibility data only if the
+     * cell filtering mask changed since the last call.
+     */
+    const FaceStream& getFaceStream();
     void getSurfaceData_Slim(
             std::vector<uint32_t>& triangleIndices,
             std::vector<glm::vec3>& vertexPositions,
@@ -370,6 +453,27 @@ public:
             std::vector<uint32_t>& triangleIndices,
             std::vector<glm::vec3>& vertexPositions,
             std::vector<float>& vertexAttributes);
+    /**
+     * Overloads of the volume extractors above writing into output buffers (@see OutputBuffer).
+     */
+    void getVolumeData_Faces(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            OutputBuffer<glm::vec3>& vertexNormals,
+            OutputBuffer<float>& vertexAttributes);
+    void getVolumeData_Volume(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            OutputBuffer<float>& vertexAttributes);
+    void getVolumeData_FacesShared(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            OutputBuffer<float>& vertexAttributes,
+            bool useVolumeWeighting = false);
+    void getVolumeData_VolumeShared(
+            OutputBuffer<uint32_t>& triangleIndices,
+            OutputBuffer<glm::vec3>& vertexPositions,
+            OutputBuffer<float>& vertexAttributes);
     /**
      * Get the singular edges and points of the hexahedral mesh.
      */
@@ -669,10 +773,14 @@ private:
      * base-complex representation. The data is stored in mesh, si and frame, respectively.
      * @param vertices The hexahedral mesh vertices
      * @param cellIndices Cell vertex indices (8*num_cells).
+     * @param meshCache An optional binary mesh cache the connectivity and singularity structure are read from.
      */
     void computeBaseComplexMesh(
-            const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices);
+            const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices,
+            const BinaryMeshCache* meshCache = nullptr);
     void computeBaseComplexMeshFrame();
+    /// Tries to restore the singularity structure and frame from the base-complex cache (if a directory is set).
+    bool loadBaseComplexMeshFrameFromCache();
     /**
      * A helper function for computeBaseComplexParametrizedGrid.
      * It infers the vertex belonging to the parameters encoded in idxShared by using the vertices parametrized by
@@ -735,15 +843,47 @@ private:
     // Cell deformation data.
     void recomputeHistogram();
     QualityMeasure qualityMeasure = QUALITY_MEASURE_SCALED_JACOBIAN;
-    sgl::TransferFunctionWindow &transferFunctionWindow;
+    sgl::TransferFunctionWindow* transferFunctionWindow = nullptr;
     std::vector<float> cellQualityMeasureList;
     float qualityMin = FLT_MAX;
     float qualityMax = -FLT_MAX;
     float qualityMinNormalized = FLT_MAX;
     float qualityMaxNormalized = -FLT_MAX;
 
-    RayMeshIntersection& rayMeshIntersection;
+    // The normalized qualities of all measures (see setPrecomputeAllQualityMeasures).
+    struct PrecomputedQualityMeasure {
+        std::vector<uint16_t> normalizedQualities;
+        float qualityMin, qualityMax;
+        float qualityMinNormalized, qualityMaxNormalized;
+    };
+    void precomputeQualityMeasures();
+    bool precomputeAllQualityMeasures = false;
+    std::vector<PrecomputedQualityMeasure> precomputedQualityMeasures; ///< Empty if not computed (yet).
+
+    RayMeshIntersection* rayMeshIntersection = nullptr;
     bool dirty = false;
+    // Changes whenever the vertex positions or attributes change (unique over all meshes).
+    void onMeshDataChanged();
+    uint64_t meshDataGeneration = 0;
+
+    /**
+     * Writes the four vertices and two triangles of a face of the surface of the filtered mesh (cf. getSurfaceData).
+     * The output pointers point to the data of the face, and indexOffset is the index of its first vertex.
+     */
+    void writeSurfaceQuad(
+            Hybrid_F& f, bool invertWinding, float cellAttribute, uint32_t indexOffset, uint32_t* triangleIndices,
+            glm::vec3* vertexPositions, glm::vec3* vertexNormals, float* vertexAttributes);
+
+    // Helpers for getFaceStream.
+    void updateFaceStreamStaticData();
+    void updateFaceStreamVisibility();
+    FaceStream faceStream;
+
+    // Helpers for updateFilteredSurfaceData.
+    bool getIsFaceSideVisible(uint32_t faceSide);
+    void writeFilteredSurfaceSlot(FilteredSurfaceData& surfaceData, uint32_t slot);
+    void addFilteredSurfaceFaceSide(FilteredSurfaceData& surfaceData, uint32_t faceSide);
+    void removeFilteredSurfaceFaceSide(FilteredSurfaceData& surfaceData, uint32_t faceSide);
 
     // Mesh data.
     size_t meshNumCells = 0;
@@ -755,6 +895,8 @@ private:
     Mesh* mesh = nullptr;
     Singularity* si = nullptr;
     Frame* frame = nullptr;
+    BaseComplexFrameTimings baseComplexFrameTimings;
+    std::string baseComplexCacheDirectory;
 
     // LoD edge data.
     LodSettings lodSettings;
@@ -762,7 +904,7 @@ private:
     int maxLodValue = 0;
 
     // Cell filtering.
-    std::vector<bool> cellFilteringList;
+    CellMask cellFilteringMask;
 
     // Additonal mesh data.
     std::unordered_set<uint32_t> singularEdgeIds;
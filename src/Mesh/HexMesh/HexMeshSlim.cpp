@@ -166,6 +166,10 @@ void HexMesh::rebuildInternalRepresentationIfNecessary_Slim() {
 }
 
 void HexMesh::updateMeshTriangleIntersectionDataStructure_Slim() {
+    if (!rayMeshIntersection) {
+        return;
+    }
+
     std::vector<uint32_t> triangleIndices;
     std::vector<glm::vec3> vertices;
 
@@ -193,7 +197,7 @@ void HexMesh::updateMeshTriangleIntersectionDataStructure_Slim() {
         triangleIndices.push_back(f.vs[3]);
     }
 
-    rayMeshIntersection.setMeshTriangleData(vertices, triangleIndices);
+    rayMeshIntersection->setMeshTriangleData(vertices, triangleIndices);
 }
 
 void HexMesh::getSurfaceData_Slim(
@@ -0,0 +1,139 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdlib>
+
+#include "AsciiScanner.hpp"
+
+static const double exactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool AsciiScanner::parseFloat(const char* begin, const char* end, float& value) {
+    const char* ptr = begin;
+    bool isNegative = false;
+    if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+        isNegative = *ptr == '-';
+        ptr++;
+    }
+
+    uint64_t mantissa = 0;
+    int numSignificantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; ptr < end; ptr++) {
+        unsigned digit = unsigned(*ptr) - unsigned('0');
+        if (digit > 9u) {
+            break;
+        }
+        hasDigits = true;
+        if (mantissa != 0 || digit != 0) {
+            numSignificantDigits++;
+        }
+        mantissa = mantissa * 10u + digit;
+    }
+    if (ptr < end && *ptr == '.') {
+        ptr++;
+        for (; ptr < end; ptr++) {
+            unsigned digit = unsigned(*ptr) - unsigned('0');
+            if (digit > 9u) {
+                break;
+            }
+            hasDigits = true;
+            if (mantissa != 0 || digit != 0) {
+                numSignificantDigits++;
+            }
+            mantissa = mantissa * 10u + digit;
+            exponent--;
+        }
+    }
+    if (!hasDigits || numSignificantDigits > 19) {
+        return parseFloatFallback(begin, end, value);
+    }
+
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+        ptr++;
+        bool isExponentNegative = false;
+        if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+            isExponentNegative = *ptr == '-';
+            ptr++;
+        }
+        int exponentPart = 0;
+        bool hasExponentDigits = false;
+        for (; ptr < end; ptr++) {
+            unsigned digit = unsigned(*ptr) - unsigned('0');
+            if (digit > 9u) {
+                break;
+            }
+            hasExponentDigits = true;
+            if (exponentPart < 10000) {
+                exponentPart = exponentPart * 10 + int(digit);
+            }
+        }
+        if (!hasExponentDigits) {
+            return false;
+        }
+        exponent += isExponentNegative ? -exponentPart : exponentPart;
+    }
+    if (ptr != end) {
+        // E.g., Fortran-style exponents ("1.0d0") or trailing garbage.
+        return parseFloatFallback(begin, end, value);
+    }
+
+    // The result is exact if both the mantissa and the power of ten are exactly representable as a double.
+    if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) {
+        return parseFloatFallback(begin, end, value);
+    }
+    double result = double(mantissa);
+    if (exponent < 0) {
+        result /= exactPowersOfTen[-exponent];
+    } else {
+        result *= exactPowersOfTen[exponent];
+    }
+    value = float(isNegative ? -result : result);
+    return true;
+}
+
+bool AsciiScanner::parseFloatFallback(const char* begin, const char* end, float& value) {
+    // The input is not null-terminated, so the token needs to be copied for strtod.
+    char tokenBuffer[128];
+    size_t length = size_t(end - begin);
+    if (length == 0 || length >= sizeof(tokenBuffer)) {
+        return false;
+    }
+    memcpy(tokenBuffer, begin, length);
+    tokenBuffer[length] = '\0';
+    char* parseEnd = nullptr;
+    double result = strtod(tokenBuffer, &parseEnd);
+    if (parseEnd != tokenBuffer + length) {
+        return false;
+    }
+    value = float(result);
+    return true;
+}
@@ -0,0 +1,364 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOADERS_ASCIISCANNER_HPP
+#define LOADERS_ASCIISCANNER_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * A tokenizer for line-based ASCII mesh files operating in place on a memory range (e.g., a memory-mapped file).
+ * In contrast to @see readFileLineByLine, no memory is allocated per line or token. Tokens are stored as pointers into
+ * the input, and numbers are parsed directly from the input characters.
+ */
+class AsciiScanner {
+public:
+    /// Only the first MAX_TOKENS tokens of a line can be accessed. getNumTokens still returns the total count.
+    static const size_t MAX_TOKENS = 16;
+
+    AsciiScanner(const char* begin, const char* end, size_t lineNumber = 0)
+            : position(begin), end(end), lineNumber(lineNumber) {}
+
+    /**
+     * Advances to the next non-empty line and splits it into tokens separated by whitespace characters (space, tab).
+     * @return False if the end of the input was reached.
+     */
+    inline bool nextLine() {
+        while (position < end) {
+            lineBegin = position;
+            lineNumber++;
+            numTokens = 0;
+            const char* ptr = position;
+            while (ptr < end) {
+                char c = *ptr;
+                if (c == '\n' || c == '\r') {
+                    break;
+                }
+                if (c == ' ' || c == '\t') {
+                    ptr++;
+                    continue;
+                }
+                const char* tokenBegin = ptr;
+                do {
+                    ptr++;
+                } while (ptr < end && *ptr != ' ' && *ptr != '\t' && *ptr != '\n' && *ptr != '\r');
+                if (numTokens < MAX_TOKENS) {
+                    tokenBegins[numTokens] = tokenBegin;
+                    tokenEnds[numTokens] = ptr;
+                }
+                numTokens++;
+            }
+            lineEnd = ptr;
+            // Like readFileLineByLine, '\r' and '\n' are both treated as line breaks (empty lines are skipped).
+            position = ptr < end ? ptr + 1 : end;
+            if (numTokens > 0) {
+                return true;
+            }
+        }
+        numTokens = 0;
+        return false;
+    }
+
+    inline size_t getNumTokens() const { return numTokens; }
+    inline size_t getLineNumber() const { return lineNumber; }
+    inline const char* getPosition() const { return position; }
+    inline const char* getEnd() const { return end; }
+    /// Continues scanning at the passed position (which must lie directly after a line break).
+    inline void setPosition(const char* newPosition, size_t newLineNumber) {
+        position = newPosition;
+        lineNumber = newLineNumber;
+        numTokens = 0;
+    }
+
+    /// Checks whether the token at the passed index exists and is equal to the passed string.
+    inline bool tokenEquals(size_t idx, const char* str) const {
+        if (idx >= numTokens || idx >= MAX_TOKENS) {
+            return false;
+        }
+        size_t length = strlen(str);
+        return size_t(tokenEnds[idx] - tokenBegins[idx]) == length && memcmp(tokenBegins[idx], str, length) == 0;
+    }
+    /// Checks whether the token at the passed index exists and starts with the passed string.
+    inline bool tokenStartsWith(size_t idx, const char* str) const {
+        if (idx >= numTokens || idx >= MAX_TOKENS) {
+            return false;
+        }
+        size_t length = strlen(str);
+        return size_t(tokenEnds[idx] - tokenBegins[idx]) >= length && memcmp(tokenBegins[idx], str, length) == 0;
+    }
+    /// Checks whether the line (including leading whitespace) starts with the passed string.
+    inline bool lineStartsWith(const char* str) const {
+        size_t length = strlen(str);
+        return size_t(lineEnd - lineBegin) >= length && memcmp(lineBegin, str, length) == 0;
+    }
+
+    /**
+     * Parses the token at the passed index as a number.
+     * @return False if the token doesn't exist or is not a valid number of the requested type.
+     */
+    inline bool parseToken(size_t idx, float& value) const {
+        return idx < numTokens && idx < MAX_TOKENS && parseFloat(tokenBegins[idx], tokenEnds[idx], value);
+    }
+    inline bool parseToken(size_t idx, uint32_t& value) const {
+        uint64_t value64 = 0;
+        if (!parseToken(idx, value64) || value64 > 0xFFFFFFFFull) {
+            return false;
+        }
+        value = uint32_t(value64);
+        return true;
+    }
+    inline bool parseToken(size_t idx, uint64_t& value) const {
+        return idx < numTokens && idx < MAX_TOKENS && parseUnsigned(tokenBegins[idx], tokenEnds[idx], value);
+    }
+
+    /// Returns the content of the current line (only meant for error messages).
+    inline std::string getLineString() const { return std::string(lineBegin, lineEnd); }
+
+    /**
+     * Parses an unsigned decimal integer spanning the range [begin, end).
+     * @return False if the range contains anything else than the decimal digits of a number fitting into 64 bits.
+     */
+    static inline bool parseUnsigned(const char* begin, const char* end, uint64_t& value) {
+        if (begin == end || end - begin > 20) {
+            return false;
+        }
+        uint64_t result = 0;
+        for (const char* ptr = begin; ptr < end; ptr++) {
+            unsigned digit = unsigned(*ptr) - unsigned('0');
+            if (digit > 9u) {
+                return false;
+            }
+            uint64_t resultNew = result * 10u + digit;
+            if (resultNew < result) {
+                return false;
+            }
+            result = resultNew;
+        }
+        value = result;
+        return true;
+    }
+
+    /**
+     * Parses a floating point number in decimal notation (e.g., "-1.5e-3") spanning the range [begin, end).
+     * Uncommon notations (e.g., "nan", "inf" or mantissas with more than 19 significant digits) are passed to strtod.
+     * @return False if the range doesn't contain a valid number.
+     */
+    static bool parseFloat(const char* begin, const char* end, float& value);
+
+private:
+    static bool parseFloatFallback(const char* begin, const char* end, float& value);
+
+    const char* position;
+    const char* end;
+    const char* lineBegin = nullptr;
+    const char* lineEnd = nullptr;
+    size_t lineNumber = 0;
+    size_t numTokens = 0;
+    const char* tokenBegins[MAX_TOKENS];
+    const char* tokenEnds[MAX_TOKENS];
+};
+
+/**
+ * Parses the next numLines non-empty lines of the input of the scanner and appends the results to output.
+ * For large sections, the lines are split into newline-aligned chunks that are parsed by multiple threads. The output
+ * location of each chunk is determined by an exclusive prefix sum over the number of lines per chunk.
+ * @param scanner The scanner. On success, it is advanced behind the last parsed line. On failure, it holds the line
+ * that couldn't be parsed (if any) so that it can be reported to the user.
+ * @param numLines The number of lines to parse.
+ * @param valuesPerLine The number of values of type T each line is converted to.
+ * @param output The output vector the values are appended to. It is left unchanged on failure.
+ * @param parseLine A thread-safe functor of the form bool(const AsciiScanner& line, T* lineOutput) writing the
+ * valuesPerLine values of the passed line to lineOutput. It is expected to return false if the line is invalid.
+ * @return Whether all lines could be parsed.
+ */
+template<class T, class LineParser>
+bool parseLinesParallel(
+        AsciiScanner& scanner, size_t numLines, size_t valuesPerLine, std::vector<T>& output, LineParser parseLine) {
+    const size_t outputOffset = output.size();
+    output.resize(outputOffset + numLines * valuesPerLine);
+    T* outputData = output.data() + outputOffset;
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+
+    // Lines are reported relative to the line the scanner currently points to.
+    const size_t baseLineNumber = scanner.getLineNumber();
+    const char* rangeBegin = scanner.getPosition();
+    const char* inputEnd = scanner.getEnd();
+    const size_t PARALLEL_MIN_LINES = 1 << 14;
+
+    // Determine the chunk boundaries and the number of (non-empty) lines in each chunk.
+    size_t numChunks = 0;
+    std::vector<const char*> chunkBegins;
+    std::vector<size_t> chunkNumLines, chunkNumLineBreaks;
+    if (numThreads > 1 && numLines >= PARALLEL_MIN_LINES) {
+        // Only search a window slightly larger than the estimated section size to not count the remaining file.
+        size_t numSampleLines = 0;
+        AsciiScanner sampleScanner(rangeBegin, inputEnd);
+        while (numSampleLines < 256 && sampleScanner.nextLine()) {
+            numSampleLines++;
+        }
+        size_t numSampleBytes = size_t(sampleScanner.getPosition() - rangeBegin);
+        size_t windowSize = size_t(inputEnd - rangeBegin);
+        if (numSampleLines > 0) {
+            windowSize = std::min(windowSize, numSampleBytes / numSampleLines * numLines * 5 / 4 + (1 << 16));
+        }
+
+        for (;;) {
+            const char* windowEnd = rangeBegin + windowSize;
+            while (windowEnd < inputEnd && windowEnd[-1] != '\n' && windowEnd[-1] != '\r') {
+                windowEnd++;
+            }
+            numChunks = size_t(numThreads) * 8;
+            chunkBegins.resize(numChunks + 1);
+            for (size_t i = 0; i < numChunks; i++) {
+                const char* chunkBegin = rangeBegin + (windowEnd - rangeBegin) * i / numChunks;
+                while (chunkBegin > rangeBegin && chunkBegin < windowEnd
+                        && chunkBegin[-1] != '\n' && chunkBegin[-1] != '\r') {
+                    chunkBegin++;
+                }
+                chunkBegins.at(i) = chunkBegin;
+            }
+            chunkBegins.at(numChunks) = windowEnd;
+            chunkNumLines.assign(numChunks, 0);
+            chunkNumLineBreaks.assign(numChunks, 0);
+
+#if _OPENMP >= 201107
+            #pragma omp parallel for default(none) shared(chunkBegins, chunkNumLines, chunkNumLineBreaks, numChunks) \
+            schedule(dynamic)
+#endif
+            for (size_t i = 0; i < numChunks; i++) {
+                size_t numChunkLines = 0, numChunkLineBreaks = 0;
+                bool lineHasContent = false;
+                for (const char* ptr = chunkBegins[i]; ptr < chunkBegins[i + 1]; ptr++) {
+                    char c = *ptr;
+                    if (c == '\n' || c == '\r') {
+                        numChunkLines += lineHasContent ? 1 : 0;
+                        numChunkLineBreaks++;
+                        lineHasContent = false;
+                    } else if (c != ' ' && c != '\t') {
+                        lineHasContent = true;
+                    }
+                }
+                chunkNumLines[i] = numChunkLines + (lineHasContent ? 1 : 0);
+                chunkNumLineBreaks[i] = numChunkLineBreaks;
+            }
+
+            size_t numLinesTotal = 0;
+            for (size_t i = 0; i < numChunks; i++) {
+                numLinesTotal += chunkNumLines[i];
+            }
+            if (numLinesTotal >= numLines || windowEnd == inputEnd) {
+                if (numLinesTotal < numLines) {
+                    // Not enough lines; the serial code path below reports the error.
+                    numChunks = 0;
+                }
+                break;
+            }
+            windowSize = size_t(inputEnd - rangeBegin);
+        }
+    }
+
+    if (numChunks == 0) {
+        for (size_t i = 0; i < numLines; i++) {
+            if (!scanner.nextLine() || !parseLine(scanner, outputData + i * valuesPerLine)) {
+                output.resize(outputOffset);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Exclusive prefix sums give the first output line and the first line number of each chunk.
+    std::vector<size_t> chunkFirstLine(numChunks), chunkFirstLineNumber(numChunks);
+    size_t lineCounter = 0, lineNumberCounter = baseLineNumber;
+    for (size_t i = 0; i < numChunks; i++) {
+        chunkFirstLine[i] = lineCounter;
+        chunkFirstLineNumber[i] = lineNumberCounter;
+        lineCounter += chunkNumLines[i];
+        lineNumberCounter += chunkNumLineBreaks[i];
+    }
+
+    const size_t INVALID_LINE = ~size_t(0);
+    std::vector<size_t> chunkErrorLine(numChunks, INVALID_LINE);
+    const char* endPosition = nullptr;
+    size_t endLineNumber = 0;
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) schedule(dynamic) \
+    shared(chunkBegins, chunkNumLines, chunkFirstLine, chunkFirstLineNumber, chunkErrorLine, numChunks, numLines) \
+    shared(outputData, valuesPerLine, parseLine, endPosition, endLineNumber)
+#endif
+    for (size_t i = 0; i < numChunks; i++) {
+        if (chunkFirstLine[i] >= numLines) {
+            continue;
+        }
+        size_t numLinesToParse = std::min(chunkNumLines[i], numLines - chunkFirstLine[i]);
+        AsciiScanner chunkScanner(chunkBegins[i], chunkBegins[i + 1], chunkFirstLineNumber[i]);
+        for (size_t lineIdx = 0; lineIdx < numLinesToParse; lineIdx++) {
+            chunkScanner.nextLine();
+            T* lineOutput = outputData + (chunkFirstLine[i] + lineIdx) * valuesPerLine;
+            if (!parseLine(chunkScanner, lineOutput)) {
+                chunkErrorLine[i] = lineIdx;
+                break;
+            }
+        }
+        if (chunkFirstLine[i] + chunkNumLines[i] >= numLines) {
+            // Only one chunk contains the last line.
+            endPosition = chunkScanner.getPosition();
+            endLineNumber = chunkScanner.getLineNumber();
+        }
+    }
+
+    for (size_t i = 0; i < numChunks; i++) {
+        if (chunkErrorLine[i] != INVALID_LINE) {
+            AsciiScanner errorScanner(chunkBegins[i], chunkBegins[i + 1], chunkFirstLineNumber[i]);
+            for (size_t lineIdx = 0; lineIdx <= chunkErrorLine[i]; lineIdx++) {
+                errorScanner.nextLine();
+            }
+            scanner = errorScanner;
+            output.resize(outputOffset);
+            return false;
+        }
+    }
+
+    scanner.setPosition(endPosition, endLineNumber);
+    return true;
+}
+
+#endif // LOADERS_ASCIISCANNER_HPP
@@ -0,0 +1,973 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+
+#include <Utils/File/Logfile.hpp>
+
+#include "Mesh/BaseComplex/global_types.h"
+#include "BinaryMeshCache.hpp"
+
+static const char HEXBIN_MAGIC[8] = { 'H', 'E', 'X', 'B', 'I', 'N', '\0', '\0' };
+static const uint32_t HEXBIN_BYTE_ORDER_MARK = 0x01020304u;
+
+struct HexBinSingularVertex {
+    uint32_t id, hid, boundary, fake, which_singularity, which_singularity_type;
+};
+
+struct HexBinSingularEdge {
+    uint32_t id, boundary, circle;
+};
+
+struct HexBinFrameVertex {
+    uint32_t id, hid, svid, singular, boundary;
+};
+
+struct HexBinFrameEdge {
+    uint32_t id, singular, boundary;
+};
+
+struct HexBinFrameFace {
+    uint32_t id, boundary;
+};
+
+struct HexBinFrameCell {
+    uint32_t id, colorId;
+};
+
+namespace {
+
+/**
+ * Collects the sections of a cache file. The data of a section is only generated when the file is written, i.e., no
+ * copy of the (potentially very large) mesh data is made.
+ */
+class HexBinWriter {
+public:
+    typedef std::function<void(std::ostream&)> DataWriter;
+
+    void addSection(uint32_t type, uint32_t elementSize, uint64_t numElements, DataWriter dataWriter) {
+        HexBinSection section;
+        section.type = type;
+        section.elementSize = elementSize;
+        section.numElements = numElements;
+        section.offset = 0;
+        sections.push_back(section);
+        dataWriters.push_back(dataWriter);
+    }
+
+    template<class T>
+    void addArray(uint32_t type, const T* data, size_t numElements) {
+        addSection(type, sizeof(T), numElements, [data, numElements](std::ostream& stream) {
+            stream.write(reinterpret_cast<const char*>(data), std::streamsize(numElements * sizeof(T)));
+        });
+    }
+
+    /// Adds a section with one value of type T per element, which is computed by the passed function.
+    template<class T, class E>
+    void addPerElement(uint32_t type, const std::vector<E>& elements, std::function<T(const E&)> getValue) {
+        addSection(type, sizeof(T), elements.size(), [&elements, getValue](std::ostream& stream) {
+            std::vector<T> buffer;
+            buffer.reserve(WRITE_BUFFER_SIZE);
+            for (const E& element : elements) {
+                buffer.push_back(getValue(element));
+                if (buffer.size() == WRITE_BUFFER_SIZE) {
+                    writeBuffer(stream, buffer);
+                }
+            }
+            writeBuffer(stream, buffer);
+        });
+    }
+
+    /// Adds a section storing a list of exactly listSize indices per element.
+    template<class E, class L>
+    void addFixedSizeLists(uint32_t type, const std::vector<E>& elements, L E::*member, size_t listSize) {
+        addSection(type, sizeof(uint32_t), elements.size() * listSize,
+                [&elements, member, listSize](std::ostream& stream) {
+            std::vector<uint32_t> buffer;
+            buffer.reserve(WRITE_BUFFER_SIZE + listSize);
+            for (const E& element : elements) {
+                const L& list = element.*member;
+                for (size_t i = 0; i < listSize; i++) {
+                    buffer.push_back(i < list.size() ? list[i] : uint32_t(-1));
+                }
+                if (buffer.size() >= WRITE_BUFFER_SIZE) {
+                    writeBuffer(stream, buffer);
+                }
+            }
+            writeBuffer(stream, buffer);
+        });
+    }
+
+    /// Adds an offset and an index section storing a variable-length list of indices per element.
+    template<class E, class L>
+    void addLists(uint32_t offsetsType, uint32_t indicesType, const std::vector<E>& elements, L E::*member) {
+        uint64_t numIndices = 0;
+        for (const E& element : elements) {
+            numIndices += (element.*member).size();
+        }
+
+        addSection(offsetsType, sizeof(uint64_t), elements.size() + 1,
+                [&elements, member](std::ostream& stream) {
+            std::vector<uint64_t> buffer;
+            buffer.reserve(WRITE_BUFFER_SIZE);
+            uint64_t offset = 0;
+            buffer.push_back(offset);
+            for (const E& element : elements) {
+                offset += (element.*member).size();
+                buffer.push_back(offset);
+                if (buffer.size() == WRITE_BUFFER_SIZE) {
+                    writeBuffer(stream, buffer);
+                }
+            }
+            writeBuffer(stream, buffer);
+        });
+        addSection(indicesType, sizeof(uint32_t), numIndices, [&elements, member](std::ostream& stream) {
+            for (const E& element : elements) {
+                const L& list = element.*member;
+                if (!list.empty()) {
+                    stream.write(
+                            reinterpret_cast<const char*>(list.data()),
+                            std::streamsize(list.size() * sizeof(uint32_t)));
+                }
+            }
+        });
+    }
+
+    bool write(const std::string& filename, HexBinHeader& header) {
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        header.numSections = uint32_t(sections.size());
+        uint64_t offset = sizeof(HexBinHeader) + sections.size() * sizeof(HexBinSection);
+        for (HexBinSection& section : sections) {
+            offset = alignOffset(offset);
+            section.offset = offset;
+            offset += section.numElements * section.elementSize;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(HexBinHeader));
+        file.write(reinterpret_cast<const char*>(sections.data()),
+                std::streamsize(sections.size() * sizeof(HexBinSection)));
+        uint64_t filePosition = sizeof(HexBinHeader) + sections.size() * sizeof(HexBinSection);
+        const char padding[HEXBIN_SECTION_ALIGNMENT] = {};
+        for (size_t i = 0; i < sections.size(); i++) {
+            file.write(padding, std::streamsize(sections.at(i).offset - filePosition));
+            dataWriters.at(i)(file);
+            filePosition = sections.at(i).offset + sections.at(i).numElements * sections.at(i).elementSize;
+        }
+
+        return file.good();
+    }
+
+private:
+    static const size_t WRITE_BUFFER_SIZE = 1 << 16;
+
+    static inline uint64_t alignOffset(uint64_t offset) {
+        return (offset + HEXBIN_SECTION_ALIGNMENT - 1) / HEXBIN_SECTION_ALIGNMENT * HEXBIN_SECTION_ALIGNMENT;
+    }
+
+    template<class T>
+    static void writeBuffer(std::ostream& stream, std::vector<T>& buffer) {
+        if (!buffer.empty()) {
+            stream.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size() * sizeof(T)));
+            buffer.clear();
+        }
+    }
+
+    std::vector<HexBinSection> sections;
+    std::vector<DataWriter> dataWriters;
+};
+
+void initHeader(HexBinHeader& header, const HexBinSourceKey& sourceKey, uint32_t flags) {
+    memcpy(header.magic, HEXBIN_MAGIC, sizeof(HEXBIN_MAGIC));
+    header.formatVersion = HEXBIN_FORMAT_VERSION;
+    header.byteOrderMark = HEXBIN_BYTE_ORDER_MARK;
+    header.flags = flags;
+    header.numSections = 0;
+    header.sourceDataSize = sourceKey.dataSize;
+    header.sourceDataHash = sourceKey.dataHash;
+}
+
+void addSingularitySections(HexBinWriter& writer, const Singularity& si) {
+    writer.addPerElement<HexBinSingularVertex, Singular_V>(HEXBIN_SV_DATA, si.SVs, [](const Singular_V& sv) {
+        HexBinSingularVertex svData;
+        svData.id = sv.id;
+        svData.hid = sv.hid;
+        svData.boundary = sv.boundary;
+        svData.fake = sv.fake;
+        svData.which_singularity = sv.which_singularity;
+        svData.which_singularity_type = sv.which_singularity_type;
+        return svData;
+    });
+    writer.addLists(HEXBIN_SV_NEIGHBOR_SVS_OFFSETS, HEXBIN_SV_NEIGHBOR_SVS, si.SVs, &Singular_V::neighbor_svs);
+    writer.addLists(HEXBIN_SV_NEIGHBOR_SES_OFFSETS, HEXBIN_SV_NEIGHBOR_SES, si.SVs, &Singular_V::neighbor_ses);
+
+    writer.addPerElement<HexBinSingularEdge, Singular_E>(HEXBIN_SE_DATA, si.SEs, [](const Singular_E& se) {
+        HexBinSingularEdge seData;
+        seData.id = se.id;
+        seData.boundary = se.boundary;
+        seData.circle = se.circle;
+        return seData;
+    });
+    writer.addLists(HEXBIN_SE_VS_OFFSETS, HEXBIN_SE_VS, si.SEs, &Singular_E::vs);
+    writer.addLists(HEXBIN_SE_ES_LINK_OFFSETS, HEXBIN_SE_ES_LINK, si.SEs, &Singular_E::es_link);
+    writer.addLists(HEXBIN_SE_VS_LINK_OFFSETS, HEXBIN_SE_VS_LINK, si.SEs, &Singular_E::vs_link);
+    writer.addLists(HEXBIN_SE_NEIGHBOR_SES_OFFSETS, HEXBIN_SE_NEIGHBOR_SES, si.SEs, &Singular_E::neighbor_ses);
+}
+
+/// Writes the file to a temporary file first, which is then moved to the final location.
+bool writeCacheFile(HexBinWriter& writer, HexBinHeader& header, const std::string& cacheFilename,
+        const std::string& functionName) {
+    std::string temporaryFilename = cacheFilename + ".tmp";
+    if (!writer.write(temporaryFilename, header)) {
+        sgl::Logfile::get()->writeError(
+                "Error in " + functionName + ": Couldn't write file \"" + temporaryFilename + "\".");
+        remove(temporaryFilename.c_str());
+        return false;
+    }
+    remove(cacheFilename.c_str());
+    if (rename(temporaryFilename.c_str(), cacheFilename.c_str()) != 0) {
+        sgl::Logfile::get()->writeError(
+                "Error in " + functionName + ": Couldn't move file to \"" + cacheFilename + "\".");
+        remove(temporaryFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+template<class E, class L>
+void assignLists(std::vector<E>& elements, L E::*member, const uint64_t* offsets, const uint32_t* indices) {
+    size_t numElements = elements.size();
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(elements, member, offsets, indices, numElements)
+#endif
+    for (size_t i = 0; i < numElements; i++) {
+        (elements[i].*member).assign(indices + offsets[i], indices + offsets[i + 1]);
+    }
+}
+
+/// Whether all indices are smaller than numElements, i.e., valid IDs of the referenced elements.
+bool areIndicesInRange(const uint32_t* indices, size_t numIndices, size_t numElements) {
+    bool inRange = true;
+#if _OPENMP >= 201107
+    #pragma omp parallel for reduction(&&: inRange) default(none) shared(indices, numIndices, numElements)
+#endif
+    for (size_t i = 0; i < numIndices; i++) {
+        inRange = inRange && indices[i] < numElements;
+    }
+    return inRange;
+}
+
+/// Whether all indices of a list section (see BinaryMeshCache::readListSection) are smaller than numElements.
+bool areListIndicesInRange(const uint64_t* offsets, const uint32_t* indices, size_t numLists, size_t numElements) {
+    return areIndicesInRange(indices, size_t(offsets[numLists]), numElements);
+}
+
+/// Copies a list section into the CSR adjacency arrays of the mesh.
+void assignAdjacency(Mesh& mesh, Adjacency_Type type, size_t numElements,
+        const uint64_t* offsets, const uint32_t* indices) {
+    std::vector<uint32_t> adjacencyOffsets(offsets, offsets + numElements + 1);
+    std::vector<uint32_t> adjacencyIndices(indices, indices + offsets[numElements]);
+    mesh.set_adjacency(type, adjacencyOffsets, adjacencyIndices);
+}
+
+}
+
+bool BinaryMeshCache::computeSourceKey(const std::string& sourceFilename, HexBinSourceKey& sourceKey) {
+    MappedFile sourceFile;
+    if (!sourceFile.open(sourceFilename)) {
+        return false;
+    }
+    sourceKey.dataSize = sourceFile.getSize();
+    sourceKey.dataHash = computeDataHash64(sourceFile.getData(), sourceFile.getSize());
+    return true;
+}
+
+std::string BinaryMeshCache::getCacheFilename(const std::string& meshFilename, const std::string& cacheDirectory) {
+    // Files with the same name in different directories shouldn't evict each other.
+    size_t separatorPos = meshFilename.find_last_of("/\\");
+    std::string baseName = separatorPos == std::string::npos ? meshFilename : meshFilename.substr(separatorPos + 1);
+    uint64_t pathHash = computeDataHash64(meshFilename.data(), meshFilename.size());
+    char pathHashString[17];
+    snprintf(pathHashString, sizeof(pathHashString), "%016llx", (unsigned long long)pathHash);
+    return cacheDirectory + baseName + "." + pathHashString + ".hexbin";
+}
+
+HexBinSourceKey BinaryMeshCache::computeContentKey(size_t numVertices, const std::vector<uint32_t>& cellIndices) {
+    HexBinSourceKey contentKey;
+    contentKey.dataSize = cellIndices.size() * sizeof(uint32_t);
+    uint64_t keyData[2];
+    keyData[0] = computeDataHash64(
+            reinterpret_cast<const char*>(cellIndices.data()), cellIndices.size() * sizeof(uint32_t));
+    keyData[1] = uint64_t(numVertices);
+    contentKey.dataHash = computeDataHash64(reinterpret_cast<const char*>(keyData), sizeof(keyData));
+    return contentKey;
+}
+
+std::string BinaryMeshCache::getFrameCacheFilename(
+        const HexBinSourceKey& contentKey, const std::string& cacheDirectory) {
+    char contentHashString[17];
+    snprintf(contentHashString, sizeof(contentHashString), "%016llx", (unsigned long long)contentKey.dataHash);
+    return cacheDirectory + contentHashString + ".hexframe";
+}
+
+bool BinaryMeshCache::save(
+        const std::string& cacheFilename, const HexBinSourceKey& sourceKey,
+        const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices,
+        const std::vector<glm::vec3>& deformations, const std::vector<float>& attributeList,
+        bool isPerVertexData, const Mesh* mesh, const Singularity* si) {
+    uint32_t flags = 0;
+    if (isPerVertexData) {
+        flags |= HEXBIN_FLAG_PER_VERTEX_DATA;
+    }
+    if (mesh != nullptr && si != nullptr) {
+        flags |= HEXBIN_FLAG_HAS_CONNECTIVITY;
+    }
+    HexBinHeader header;
+    initHeader(header, sourceKey, flags);
+
+    HexBinWriter writer;
+    writer.addArray(HEXBIN_VERTICES, vertices.data(), vertices.size());
+    writer.addArray(HEXBIN_CELL_INDICES, cellIndices.data(), cellIndices.size());
+    writer.addArray(HEXBIN_DEFORMATIONS, deformations.data(), deformations.size());
+    writer.addArray(HEXBIN_ATTRIBUTES, attributeList.data(), attributeList.size());
+
+    if (mesh != nullptr && si != nullptr) {
+        writer.addPerElement<uint8_t, Hybrid_V>(HEXBIN_V_BOUNDARY, mesh->Vs, [](const Hybrid_V& v) {
+            return uint8_t(v.boundary);
+        });
+        writer.addPerElement<uint32_t, Hybrid_V>(HEXBIN_V_SVID, mesh->Vs, [](const Hybrid_V& v) {
+            return v.svid;
+        });
+        writer.addLists(HEXBIN_V_NEIGHBOR_VS_OFFSETS, HEXBIN_V_NEIGHBOR_VS, mesh->Vs, &Hybrid_V::neighbor_vs);
+        writer.addLists(HEXBIN_V_NEIGHBOR_ES_OFFSETS, HEXBIN_V_NEIGHBOR_ES, mesh->Vs, &Hybrid_V::neighbor_es);
+        writer.addLists(HEXBIN_V_NEIGHBOR_FS_OFFSETS, HEXBIN_V_NEIGHBOR_FS, mesh->Vs, &Hybrid_V::neighbor_fs);
+        writer.addLists(HEXBIN_V_NEIGHBOR_HS_OFFSETS, HEXBIN_V_NEIGHBOR_HS, mesh->Vs, &Hybrid_V::neighbor_hs);
+
+        writer.addFixedSizeLists(HEXBIN_E_VS, mesh->Es, &Hybrid_E::vs, 2);
+        writer.addPerElement<uint8_t, Hybrid_E>(HEXBIN_E_FLAGS, mesh->Es, [](const Hybrid_E& e) {
+            return uint8_t((e.boundary ? 1u : 0u) | (e.hex_edge ? 2u : 0u));
+        });
+        writer.addLists(HEXBIN_E_NEIGHBOR_FS_OFFSETS, HEXBIN_E_NEIGHBOR_FS, mesh->Es, &Hybrid_E::neighbor_fs);
+        writer.addLists(HEXBIN_E_NEIGHBOR_HS_OFFSETS, HEXBIN_E_NEIGHBOR_HS, mesh->Es, &Hybrid_E::neighbor_hs);
+
+        writer.addFixedSizeLists(HEXBIN_F_VS, mesh->Fs, &Hybrid_F::vs, 4);
+        writer.addFixedSizeLists(HEXBIN_F_ES, mesh->Fs, &Hybrid_F::es, 4);
+        writer.addPerElement<uint8_t, Hybrid_F>(HEXBIN_F_BOUNDARY, mesh->Fs, [](const Hybrid_F& f) {
+            return uint8_t(f.boundary);
+        });
+        writer.addLists(HEXBIN_F_NEIGHBOR_HS_OFFSETS, HEXBIN_F_NEIGHBOR_HS, mesh->Fs, &Hybrid_F::neighbor_hs);
+
+        writer.addFixedSizeLists(HEXBIN_H_ES, mesh->Hs, &Hybrid::es, 12);
+        writer.addFixedSizeLists(HEXBIN_H_FS, mesh->Hs, &Hybrid::fs, 6);
+
+        addSingularitySections(writer, *si);
+    }
+
+    return writeCacheFile(writer, header, cacheFilename, "BinaryMeshCache::save");
+}
+
+bool BinaryMeshCache::saveFrame(
+        const std::string& cacheFilename, const HexBinSourceKey& contentKey,
+        const Singularity& si, const Frame& frame) {
+    HexBinHeader header;
+    initHeader(header, contentKey, HEXBIN_FLAG_HAS_FRAME);
+
+    HexBinWriter writer;
+    addSingularitySections(writer, si);
+
+    writer.addPerElement<HexBinFrameVertex, Frame_V>(HEXBIN_FV_DATA, frame.FVs, [](const Frame_V& fv) {
+        HexBinFrameVertex fvData;
+        fvData.id = fv.id;
+        fvData.hid = fv.hid;
+        fvData.svid = fv.svid;
+        fvData.singular = fv.singular;
+        fvData.boundary = fv.boundary;
+        return fvData;
+    });
+    writer.addLists(HEXBIN_FV_NEIGHBOR_FVS_OFFSETS, HEXBIN_FV_NEIGHBOR_FVS, frame.FVs, &Frame_V::neighbor_fvs);
+    writer.addLists(HEXBIN_FV_NEIGHBOR_FES_OFFSETS, HEXBIN_FV_NEIGHBOR_FES, frame.FVs, &Frame_V::neighbor_fes);
+    writer.addLists(HEXBIN_FV_NEIGHBOR_FFS_OFFSETS, HEXBIN_FV_NEIGHBOR_FFS, frame.FVs, &Frame_V::neighbor_ffs);
+    writer.addLists(HEXBIN_FV_NEIGHBOR_FHS_OFFSETS, HEXBIN_FV_NEIGHBOR_FHS, frame.FVs, &Frame_V::neighbor_fhs);
+
+    writer.addPerElement<HexBinFrameEdge, Frame_E>(HEXBIN_FE_DATA, frame.FEs, [](const Frame_E& fe) {
+        HexBinFrameEdge feData;
+        feData.id = fe.id;
+        feData.singular = fe.singular;
+        feData.boundary = fe.boundary;
+        return feData;
+    });
+    writer.addLists(HEXBIN_FE_VS_OFFSETS, HEXBIN_FE_VS, frame.FEs, &Frame_E::vs);
+    writer.addLists(HEXBIN_FE_VS_LINK_OFFSETS, HEXBIN_FE_VS_LINK, frame.FEs, &Frame_E::vs_link);
+    writer.addLists(HEXBIN_FE_ES_LINK_OFFSETS, HEXBIN_FE_ES_LINK, frame.FEs, &Frame_E::es_link);
+    writer.addLists(HEXBIN_FE_NEIGHBOR_FFS_OFFSETS, HEXBIN_FE_NEIGHBOR_FFS, frame.FEs, &Frame_E::neighbor_ffs);
+    writer.addLists(HEXBIN_FE_NEIGHBOR_FHS_OFFSETS, HEXBIN_FE_NEIGHBOR_FHS, frame.FEs, &Frame_E::neighbor_fhs);
+
+    writer.addPerElement<HexBinFrameFace, Frame_F>(HEXBIN_FF_DATA, frame.FFs, [](const Frame_F& ff) {
+        HexBinFrameFace ffData;
+        ffData.id = ff.id;
+        ffData.boundary = ff.boundary;
+        return ffData;
+    });
+    writer.addLists(HEXBIN_FF_VS_OFFSETS, HEXBIN_FF_VS, frame.FFs, &Frame_F::vs);
+    writer.addLists(HEXBIN_FF_ES_OFFSETS, HEXBIN_FF_ES, frame.FFs, &Frame_F::es);
+    writer.addLists(HEXBIN_FF_FFS_NET_OFFSETS, HEXBIN_FF_FFS_NET, frame.FFs, &Frame_F::ffs_net);
+    writer.addLists(HEXBIN_FF_NEIGHBOR_FHS_OFFSETS, HEXBIN_FF_NEIGHBOR_FHS, frame.FFs, &Frame_F::neighbor_fhs);
+
+    writer.addPerElement<HexBinFrameCell, Frame_H>(HEXBIN_FH_DATA, frame.FHs, [](const Frame_H& fh) {
+        HexBinFrameCell fhData;
+        fhData.id = fh.id;
+        fhData.colorId = fh.Color_ID;
+        return fhData;
+    });
+    writer.addLists(HEXBIN_FH_VS_OFFSETS, HEXBIN_FH_VS, frame.FHs, &Frame_H::vs);
+    writer.addLists(HEXBIN_FH_ES_OFFSETS, HEXBIN_FH_ES, frame.FHs, &Frame_H::es);
+    writer.addLists(HEXBIN_FH_FS_OFFSETS, HEXBIN_FH_FS, frame.FHs, &Frame_H::fs);
+    writer.addLists(HEXBIN_FH_HS_NET_OFFSETS, HEXBIN_FH_HS_NET, frame.FHs, &Frame_H::hs_net);
+
+    return writeCacheFile(writer, header, cacheFilename, "BinaryMeshCache::saveFrame");
+}
+
+bool BinaryMeshCache::open(const std::string& cacheFilename, const HexBinSourceKey& sourceKey) {
+    close();
+    if (!file.open(cacheFilename)) {
+        return false;
+    }
+
+    if (file.getSize() < sizeof(HexBinHeader)) {
+        close();
+        return false;
+    }
+    memcpy(&header, file.getData(), sizeof(HexBinHeader));
+    if (memcmp(header.magic, HEXBIN_MAGIC, sizeof(HEXBIN_MAGIC)) != 0
+            || header.formatVersion != HEXBIN_FORMAT_VERSION
+            || header.byteOrderMark != HEXBIN_BYTE_ORDER_MARK
+            || header.sourceDataSize != sourceKey.dataSize
+            || header.sourceDataHash != sourceKey.dataHash) {
+        close();
+        return false;
+    }
+
+    // Check that all sections lie within the file so that accessing them later can't fail.
+    const uint64_t fileSize = file.getSize();
+    const uint64_t sectionTableEnd = sizeof(HexBinHeader) + uint64_t(header.numSections) * sizeof(HexBinSection);
+    if (header.numSections > HEXBIN_NUM_SECTION_TYPES || sectionTableEnd > fileSize) {
+        close();
+        return false;
+    }
+    sections = reinterpret_cast<const HexBinSection*>(file.getData() + sizeof(HexBinHeader));
+    for (uint32_t i = 0; i < header.numSections; i++) {
+        const HexBinSection& section = sections[i];
+        if (section.offset % HEXBIN_SECTION_ALIGNMENT != 0 || section.offset < sectionTableEnd
+                || section.offset > fileSize || section.elementSize == 0
+                || section.numElements > (fileSize - section.offset) / section.elementSize) {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BinaryMeshCache::close() {
+    file.close();
+    sections = nullptr;
+}
+
+const HexBinSection* BinaryMeshCache::findSection(uint32_t type, uint32_t elementSize) const {
+    for (uint32_t i = 0; i < header.numSections; i++) {
+        if (sections[i].type == type) {
+            return sections[i].elementSize == elementSize ? &sections[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+template<class T>
+bool BinaryMeshCache::readSection(uint32_t type, std::vector<T>& data) const {
+    const HexBinSection* section = findSection(type, sizeof(T));
+    if (section == nullptr) {
+        return false;
+    }
+    const T* sectionData = reinterpret_cast<const T*>(file.getData() + section->offset);
+    data.assign(sectionData, sectionData + section->numElements);
+    return true;
+}
+
+template<class T>
+const T* BinaryMeshCache::getSectionData(uint32_t type, size_t numElementsExpected) const {
+    const HexBinSection* section = findSection(type, sizeof(T));
+    if (section == nullptr || section->numElements != numElementsExpected) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(file.getData() + section->offset);
+}
+
+bool BinaryMeshCache::readListSection(
+        uint32_t offsetsType, uint32_t indicesType, size_t numLists,
+        const uint64_t*& offsets, const uint32_t*& indices) const {
+    offsets = getSectionData<uint64_t>(offsetsType, numLists + 1);
+    const HexBinSection* indicesSection = findSection(indicesType, sizeof(uint32_t));
+    if (offsets == nullptr || indicesSection == nullptr || offsets[0] != 0
+            || offsets[numLists] != indicesSection->numElements
+            || offsets[numLists] > uint64_t(std::numeric_limits<uint32_t>::max())) {
+        return false;
+    }
+    for (size_t i = 0; i < numLists; i++) {
+        if (offsets[i] > offsets[i + 1]) {
+            return false;
+        }
+    }
+    indices = reinterpret_cast<const uint32_t*>(file.getData() + indicesSection->offset);
+    return true;
+}
+
+bool BinaryMeshCache::readMeshData(
+        std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+        std::vector<glm::vec3>& deformations, std::vector<float>& attributeList,
+        bool& isPerVertexData) const {
+    if (!isOpen()) {
+        return false;
+    }
+    if (!readSection(HEXBIN_VERTICES, vertices) || !readSection(HEXBIN_CELL_INDICES, cellIndices)
+            || !readSection(HEXBIN_DEFORMATIONS, deformations) || !readSection(HEXBIN_ATTRIBUTES, attributeList)) {
+        sgl::Logfile::get()->writeError("Error in BinaryMeshCache::readMeshData: Missing mesh data sections.");
+        return false;
+    }
+    if (cellIndices.size() % 8 != 0 || !areIndicesInRange(cellIndices.data(), cellIndices.size(), vertices.size())) {
+        sgl::Logfile::get()->writeError("Error in BinaryMeshCache::readMeshData: Invalid cell indices.");
+        vertices.clear();
+        cellIndices.clear();
+        deformations.clear();
+        attributeList.clear();
+        return false;
+    }
+    isPerVertexData = (header.flags & HEXBIN_FLAG_PER_VERTEX_DATA) != 0;
+    return true;
+}
+
+bool BinaryMeshCache::readConnectivity(Mesh& mesh, Singularity& si) const {
+    if (!isOpen() || !getHasConnectivity()) {
+        return false;
+    }
+
+    const HexBinSection* verticesSection = findSection(HEXBIN_VERTICES, sizeof(glm::vec3));
+    const HexBinSection* cellIndicesSection = findSection(HEXBIN_CELL_INDICES, sizeof(uint32_t));
+    const HexBinSection* edgesSection = findSection(HEXBIN_E_VS, sizeof(uint32_t));
+    const HexBinSection* facesSection = findSection(HEXBIN_F_VS, sizeof(uint32_t));
+    if (verticesSection == nullptr || cellIndicesSection == nullptr || edgesSection == nullptr
+            || facesSection == nullptr) {
+        return false;
+    }
+    if (cellIndicesSection->numElements % 8 != 0 || edgesSection->numElements % 2 != 0
+            || facesSection->numElements % 4 != 0) {
+        return false;
+    }
+    size_t numVertices = verticesSection->numElements;
+    size_t numCells = cellIndicesSection->numElements / 8;
+    size_t numEdges = edgesSection->numElements / 2;
+    size_t numFaces = facesSection->numElements / 4;
+
+    const uint32_t* cellIndices = reinterpret_cast<const uint32_t*>(file.getData() + cellIndicesSection->offset);
+    const uint32_t* edgeVertices = reinterpret_cast<const uint32_t*>(file.getData() + edgesSection->offset);
+    const uint32_t* faceVertices = reinterpret_cast<const uint32_t*>(file.getData() + facesSection->offset);
+
+    const uint8_t* vertexBoundary = getSectionData<uint8_t>(HEXBIN_V_BOUNDARY, numVertices);
+    const uint32_t* vertexSingularIds = getSectionData<uint32_t>(HEXBIN_V_SVID, numVertices);
+    const uint8_t* edgeFlags = getSectionData<uint8_t>(HEXBIN_E_FLAGS, numEdges);
+    const uint32_t* faceEdges = getSectionData<uint32_t>(HEXBIN_F_ES, numFaces * 4);
+    const uint8_t* faceBoundary = getSectionData<uint8_t>(HEXBIN_F_BOUNDARY, numFaces);
+    const uint32_t* cellEdges = getSectionData<uint32_t>(HEXBIN_H_ES, numCells * 12);
+    const uint32_t* cellFaces = getSectionData<uint32_t>(HEXBIN_H_FS, numCells * 6);
+
+    const uint64_t* vnvOffsets, * vneOffsets, * vnfOffsets, * vnhOffsets;
+    const uint32_t* vnvIndices, * vneIndices, * vnfIndices, * vnhIndices;
+    const uint64_t* enfOffsets, * enhOffsets, * fnhOffsets;
+    const uint32_t* enfIndices, * enhIndices, * fnhIndices;
+    bool dataValid =
+            vertexBoundary && vertexSingularIds && edgeFlags && faceEdges && faceBoundary && cellEdges && cellFaces
+            && readListSection(HEXBIN_V_NEIGHBOR_VS_OFFSETS, HEXBIN_V_NEIGHBOR_VS, numVertices, vnvOffsets, vnvIndices)
+            && readListSection(HEXBIN_V_NEIGHBOR_ES_OFFSETS, HEXBIN_V_NEIGHBOR_ES, numVertices, vneOffsets, vneIndices)
+            && readListSection(HEXBIN_V_NEIGHBOR_FS_OFFSETS, HEXBIN_V_NEIGHBOR_FS, numVertices, vnfOffsets, vnfIndices)
+            && readListSection(HEXBIN_V_NEIGHBOR_HS_OFFSETS, HEXBIN_V_NEIGHBOR_HS, numVertices, vnhOffsets, vnhIndices)
+            && readListSection(HEXBIN_E_NEIGHBOR_FS_OFFSETS, HEXBIN_E_NEIGHBOR_FS, numEdges, enfOffsets, enfIndices)
+            && readListSection(HEXBIN_E_NEIGHBOR_HS_OFFSETS, HEXBIN_E_NEIGHBOR_HS, numEdges, enhOffsets, enhIndices)
+            && readListSection(HEXBIN_F_NEIGHBOR_HS_OFFSETS, HEXBIN_F_NEIGHBOR_HS, numFaces, fnhOffsets, fnhIndices);
+    // A truncated or corrupted file must not lead to out-of-bounds accesses when the connectivity is used.
+    dataValid =
+            dataValid
+            && areIndicesInRange(cellIndices, numCells * 8, numVertices)
+            && areIndicesInRange(edgeVertices, numEdges * 2, numVertices)
+            && areIndicesInRange(faceVertices, numFaces * 4, numVertices)
+            && areIndicesInRange(faceEdges, numFaces * 4, numEdges)
+            && areIndicesInRange(cellEdges, numCells * 12, numEdges)
+            && areIndicesInRange(cellFaces, numCells * 6, numFaces)
+            && areListIndicesInRange(vnvOffsets, vnvIndices, numVertices, numVertices)
+            && areListIndicesInRange(vneOffsets, vneIndices, numVertices, numEdges)
+            && areListIndicesInRange(vnfOffsets, vnfIndices, numVertices, numFaces)
+            && areListIndicesInRange(vnhOffsets, vnhIndices, numVertices, numCells)
+            && areListIndicesInRange(enfOffsets, enfIndices, numEdges, numFaces)
+            && areListIndicesInRange(enhOffsets, enhIndices, numEdges, numCells)
+            && areListIndicesInRange(fnhOffsets, fnhIndices, numFaces, numCells);
+    Singularity siLoaded;
+    dataValid = dataValid && readSingularity(numVertices, numEdges, siLoaded);
+    for (size_t i = 0; dataValid && i < numVertices; i++) {
+        dataValid = vertexSingularIds[i] == uint32_t(-1) || vertexSingularIds[i] < siLoaded.SVs.size();
+    }
+    if (!dataValid) {
+        sgl::Logfile::get()->writeError(
+                "Error in BinaryMeshCache::readConnectivity: Missing or inconsistent connectivity sections.");
+        return false;
+    }
+
+    mesh.Vs.clear();
+    mesh.Es.clear();
+    mesh.Fs.clear();
+    mesh.Hs.clear();
+    mesh.Vs.resize(numVertices);
+    mesh.Es.resize(numEdges);
+    mesh.Fs.resize(numFaces);
+    mesh.Hs.resize(numCells);
+
+#if _OPENMP >= 201107
+    #pragma omp parallel default(none) shared(mesh, vertexBoundary, vertexSingularIds, edgeVertices, edgeFlags) \
+    shared(faceVertices, faceEdges, faceBoundary, cellIndices, cellEdges, cellFaces) \
+    shared(numVertices, numEdges, numFaces, numCells)
+#endif
+    {
+#if _OPENMP >= 201107
+        #pragma omp for nowait
+#endif
+        for (size_t i = 0; i < numVertices; i++) {
+            Hybrid_V& v = mesh.Vs[i];
+            v.id = uint32_t(i);
+            v.svid = vertexSingularIds[i];
+            v.fvid = uint32_t(-1);
+            v.boundary = vertexBoundary[i] != 0;
+        }
+#if _OPENMP >= 201107
+        #pragma omp for nowait
+#endif
+        for (size_t i = 0; i < numEdges; i++) {
+            Hybrid_E& e = mesh.Es[i];
+            e.id = uint32_t(i);
+            e.vs.assign(edgeVertices + i * 2, edgeVertices + (i + 1) * 2);
+            e.boundary = (edgeFlags[i] & 1u) != 0;
+            e.hex_edge = (edgeFlags[i] & 2u) != 0;
+        }
+#if _OPENMP >= 201107
+        #pragma omp for nowait
+#endif
+        for (size_t i = 0; i < numFaces; i++) {
+            Hybrid_F& f = mesh.Fs[i];
+            f.id = uint32_t(i);
+            f.vs.assign(faceVertices + i * 4, faceVertices + (i + 1) * 4);
+            f.es.assign(faceEdges + i * 4, faceEdges + (i + 1) * 4);
+            f.boundary = faceBoundary[i] != 0;
+        }
+#if _OPENMP >= 201107
+        #pragma omp for nowait
+#endif
+        for (size_t i = 0; i < numCells; i++) {
+            Hybrid& h = mesh.Hs[i];
+            h.id = uint32_t(i);
+            h.vs.assign(cellIndices + i * 8, cellIndices + (i + 1) * 8);
+            h.es.assign(cellEdges + i * 12, cellEdges + (i + 1) * 12);
+            h.fs.assign(cellFaces + i * 6, cellFaces + (i + 1) * 6);
+            h.boundary = false;
+        }
+    }
+
+    assignAdjacency(mesh, V_NVS, numVertices, vnvOffsets, vnvIndices);
+    assignAdjacency(mesh, V_NES, numVertices, vneOffsets, vneIndices);
+    assignAdjacency(mesh, V_NFS, numVertices, vnfOffsets, vnfIndices);
+    assignAdjacency(mesh, V_NHS, numVertices, vnhOffsets, vnhIndices);
+    assignAdjacency(mesh, E_NFS, numEdges, enfOffsets, enfIndices);
+    assignAdjacency(mesh, E_NHS, numEdges, enhOffsets, enhIndices);
+    assignAdjacency(mesh, F_NHS, numFaces, fnhOffsets, fnhIndices);
+
+    si = std::move(siLoaded);
+
+    return true;
+}
+
+bool BinaryMeshCache::readSingularity(size_t numVertices, size_t numEdges, Singularity& si) const {
+    const HexBinSection* singularVerticesSection = findSection(HEXBIN_SV_DATA, sizeof(HexBinSingularVertex));
+    const HexBinSection* singularEdgesSection = findSection(HEXBIN_SE_DATA, sizeof(HexBinSingularEdge));
+    if (singularVerticesSection == nullptr || singularEdgesSection == nullptr) {
+        return false;
+    }
+    size_t numSingularVertices = singularVerticesSection->numElements;
+    size_t numSingularEdges = singularEdgesSection->numElements;
+    const HexBinSingularVertex* singularVertices = reinterpret_cast<const HexBinSingularVertex*>(
+            file.getData() + singularVerticesSection->offset);
+    const HexBinSingularEdge* singularEdges = reinterpret_cast<const HexBinSingularEdge*>(
+            file.getData() + singularEdgesSection->offset);
+
+    const uint64_t* svnsvOffsets, * svnseOffsets, * sevOffsets, * seelOffsets, * sevlOffsets, * senseOffsets;
+    const uint32_t* svnsvIndices, * svnseIndices, * sevIndices, * seelIndices, * sevlIndices, * senseIndices;
+    bool dataValid =
+            readListSection(
+                    HEXBIN_SV_NEIGHBOR_SVS_OFFSETS, HEXBIN_SV_NEIGHBOR_SVS, numSingularVertices,
+                    svnsvOffsets, svnsvIndices)
+            && readListSection(
+                    HEXBIN_SV_NEIGHBOR_SES_OFFSETS, HEXBIN_SV_NEIGHBOR_SES, numSingularVertices,
+                    svnseOffsets, svnseIndices)
+            && readListSection(HEXBIN_SE_VS_OFFSETS, HEXBIN_SE_VS, numSingularEdges, sevOffsets, sevIndices)
+            && readListSection(
+                    HEXBIN_SE_ES_LINK_OFFSETS, HEXBIN_SE_ES_LINK, numSingularEdges, seelOffsets, seelIndices)
+            && readListSection(
+                    HEXBIN_SE_VS_LINK_OFFSETS, HEXBIN_SE_VS_LINK, numSingularEdges, sevlOffsets, sevlIndices)
+            && readListSection(
+                    HEXBIN_SE_NEIGHBOR_SES_OFFSETS, HEXBIN_SE_NEIGHBOR_SES, numSingularEdges,
+                    senseOffsets, senseIndices);
+    for (size_t i = 0; dataValid && i < numSingularVertices; i++) {
+        dataValid = singularVertices[i].id < numSingularVertices && singularVertices[i].hid < numVertices;
+    }
+    for (size_t i = 0; dataValid && i < numSingularEdges; i++) {
+        dataValid = singularEdges[i].id < numSingularEdges;
+    }
+    dataValid =
+            dataValid
+            && areListIndicesInRange(svnsvOffsets, svnsvIndices, numSingularVertices, numSingularVertices)
+            && areListIndicesInRange(svnseOffsets, svnseIndices, numSingularVertices, numSingularEdges)
+            && areListIndicesInRange(sevOffsets, sevIndices, numSingularEdges, numSingularVertices)
+            && areListIndicesInRange(seelOffsets, seelIndices, numSingularEdges, numEdges)
+            && areListIndicesInRange(sevlOffsets, sevlIndices, numSingularEdges, numVertices)
+            && areListIndicesInRange(senseOffsets, senseIndices, numSingularEdges, numSingularEdges);
+    if (!dataValid) {
+        return false;
+    }
+
+    si.SVs.clear();
+    si.SEs.clear();
+    si.SVs.resize(numSingularVertices);
+    si.SEs.resize(numSingularEdges);
+    for (size_t i = 0; i < numSingularVertices; i++) {
+        Singular_V& sv = si.SVs[i];
+        const HexBinSingularVertex& svData = singularVertices[i];
+        sv.id = svData.id;
+        sv.hid = svData.hid;
+        sv.boundary = svData.boundary != 0;
+        sv.fake = svData.fake != 0;
+        sv.which_singularity = svData.which_singularity;
+        sv.which_singularity_type = svData.which_singularity_type;
+    }
+    for (size_t i = 0; i < numSingularEdges; i++) {
+        Singular_E& se = si.SEs[i];
+        const HexBinSingularEdge& seData = singularEdges[i];
+        se.id = seData.id;
+        se.boundary = seData.boundary != 0;
+        se.circle = seData.circle != 0;
+    }
+    assignLists(si.SVs, &Singular_V::neighbor_svs, svnsvOffsets, svnsvIndices);
+    assignLists(si.SVs, &Singular_V::neighbor_ses, svnseOffsets, svnseIndices);
+    assignLists(si.SEs, &Singular_E::vs, sevOffsets, sevIndices);
+    assignLists(si.SEs, &Singular_E::es_link, seelOffsets, seelIndices);
+    assignLists(si.SEs, &Singular_E::vs_link, sevlOffsets, sevlIndices);
+    assignLists(si.SEs, &Singular_E::neighbor_ses, senseOffsets, senseIndices);
+
+    return true;
+}
+
+bool BinaryMeshCache::readFrame(Mesh& mesh, Singularity& si, Frame& frame) const {
+    if (!isOpen() || !getHasFrame()) {
+        return false;
+    }
+
+    const HexBinSection* frameVerticesSection = findSection(HEXBIN_FV_DATA, sizeof(HexBinFrameVertex));
+    const HexBinSection* frameEdgesSection = findSection(HEXBIN_FE_DATA, sizeof(HexBinFrameEdge));
+    const HexBinSection* frameFacesSection = findSection(HEXBIN_FF_DATA, sizeof(HexBinFrameFace));
+    const HexBinSection* frameCellsSection = findSection(HEXBIN_FH_DATA, sizeof(HexBinFrameCell));
+    if (frameVerticesSection == nullptr || frameEdgesSection == nullptr || frameFacesSection == nullptr
+            || frameCellsSection == nullptr) {
+        sgl::Logfile::get()->writeError("Error in BinaryMeshCache::readFrame: Missing frame sections.");
+        return false;
+    }
+    size_t numFrameVertices = frameVerticesSection->numElements;
+    size_t numFrameEdges = frameEdgesSection->numElements;
+    size_t numFrameFaces = frameFacesSection->numElements;
+    size_t numFrameCells = frameCellsSection->numElements;
+    const HexBinFrameVertex* frameVertices = reinterpret_cast<const HexBinFrameVertex*>(
+            file.getData() + frameVerticesSection->offset);
+    const HexBinFrameEdge* frameEdges = reinterpret_cast<const HexBinFrameEdge*>(
+            file.getData() + frameEdgesSection->offset);
+    const HexBinFrameFace* frameFaces = reinterpret_cast<const HexBinFrameFace*>(
+            file.getData() + frameFacesSection->offset);
+    const HexBinFrameCell* frameCells = reinterpret_cast<const HexBinFrameCell*>(
+            file.getData() + frameCellsSection->offset);
+
+    const uint64_t* fvnfvOffsets, * fvnfeOffsets, * fvnffOffsets, * fvnfhOffsets;
+    const uint32_t* fvnfvIndices, * fvnfeIndices, * fvnffIndices, * fvnfhIndices;
+    const uint64_t* fevOffsets, * fevlOffsets, * feelOffsets, * fenffOffsets, * fenfhOffsets;
+    const uint32_t* fevIndices, * fevlIndices, * feelIndices, * fenffIndices, * fenfhIndices;
+    const uint64_t* ffvOffsets, * ffeOffsets, * fffnOffsets, * ffnfhOffsets;
+    const uint32_t* ffvIndices, * ffeIndices, * fffnIndices, * ffnfhIndices;
+    const uint64_t* fhvOffsets, * fheOffsets, * fhfOffsets, * fhhnOffsets;
+    const uint32_t* fhvIndices, * fheIndices, * fhfIndices, * fhhnIndices;
+    bool dataValid =
+            readListSection(
+                    HEXBIN_FV_NEIGHBOR_FVS_OFFSETS, HEXBIN_FV_NEIGHBOR_FVS, numFrameVertices,
+                    fvnfvOffsets, fvnfvIndices)
+            && readListSection(
+                    HEXBIN_FV_NEIGHBOR_FES_OFFSETS, HEXBIN_FV_NEIGHBOR_FES, numFrameVertices,
+                    fvnfeOffsets, fvnfeIndices)
+            && readListSection(
+                    HEXBIN_FV_NEIGHBOR_FFS_OFFSETS, HEXBIN_FV_NEIGHBOR_FFS, numFrameVertices,
+                    fvnffOffsets, fvnffIndices)
+            && readListSection(
+                    HEXBIN_FV_NEIGHBOR_FHS_OFFSETS, HEXBIN_FV_NEIGHBOR_FHS, numFrameVertices,
+                    fvnfhOffsets, fvnfhIndices)
+            && readListSection(HEXBIN_FE_VS_OFFSETS, HEXBIN_FE_VS, numFrameEdges, fevOffsets, fevIndices)
+            && readListSection(HEXBIN_FE_VS_LINK_OFFSETS, HEXBIN_FE_VS_LINK, numFrameEdges, fevlOffsets, fevlIndices)
+            && readListSection(HEXBIN_FE_ES_LINK_OFFSETS, HEXBIN_FE_ES_LINK, numFrameEdges, feelOffsets, feelIndices)
+            && readListSection(
+                    HEXBIN_FE_NEIGHBOR_FFS_OFFSETS, HEXBIN_FE_NEIGHBOR_FFS, numFrameEdges,
+                    fenffOffsets, fenffIndices)
+            && readListSection(
+                    HEXBIN_FE_NEIGHBOR_FHS_OFFSETS, HEXBIN_FE_NEIGHBOR_FHS, numFrameEdges,
+                    fenfhOffsets, fenfhIndices)
+            && readListSection(HEXBIN_FF_VS_OFFSETS, HEXBIN_FF_VS, numFrameFaces, ffvOffsets, ffvIndices)
+            && readListSection(HEXBIN_FF_ES_OFFSETS, HEXBIN_FF_ES, numFrameFaces, ffeOffsets, ffeIndices)
+            && readListSection(HEXBIN_FF_FFS_NET_OFFSETS, HEXBIN_FF_FFS_NET, numFrameFaces, fffnOffsets, fffnIndices)
+            && readListSection(
+                    HEXBIN_FF_NEIGHBOR_FHS_OFFSETS, HEXBIN_FF_NEIGHBOR_FHS, numFrameFaces,
+                    ffnfhOffsets, ffnfhIndices)
+            && readListSection(HEXBIN_FH_VS_OFFSETS, HEXBIN_FH_VS, numFrameCells, fhvOffsets, fhvIndices)
+            && readListSection(HEXBIN_FH_ES_OFFSETS, HEXBIN_FH_ES, numFrameCells, fheOffsets, fheIndices)
+            && readListSection(HEXBIN_FH_FS_OFFSETS, HEXBIN_FH_FS, numFrameCells, fhfOffsets, fhfIndices)
+            && readListSection(HEXBIN_FH_HS_NET_OFFSETS, HEXBIN_FH_HS_NET, numFrameCells, fhhnOffsets, fhhnIndices);
+    Singularity siLoaded;
+    dataValid = dataValid && readSingularity(mesh.Vs.size(), mesh.Es.size(), siLoaded);
+
+    // Frame element ids index the frame lists, and mesh element ids index the lists of the already loaded mesh.
+    for (size_t i = 0; dataValid && i < numFrameVertices; i++) {
+        const HexBinFrameVertex& fvData = frameVertices[i];
+        dataValid =
+                fvData.id < numFrameVertices && fvData.hid < mesh.Vs.size()
+                && (fvData.svid == uint32_t(-1) || fvData.svid < siLoaded.SVs.size());
+    }
+    for (size_t i = 0; dataValid && i < numFrameEdges; i++) {
+        dataValid = frameEdges[i].id < numFrameEdges;
+    }
+    for (size_t i = 0; dataValid && i < numFrameFaces; i++) {
+        dataValid = frameFaces[i].id < numFrameFaces;
+    }
+    for (size_t i = 0; dataValid && i < numFrameCells; i++) {
+        dataValid = frameCells[i].id < numFrameCells;
+    }
+    dataValid =
+            dataValid
+            && areListIndicesInRange(fvnfvOffsets, fvnfvIndices, numFrameVertices, numFrameVertices)
+            && areListIndicesInRange(fvnfeOffsets, fvnfeIndices, numFrameVertices, numFrameEdges)
+            && areListIndicesInRange(fvnffOffsets, fvnffIndices, numFrameVertices, numFrameFaces)
+            && areListIndicesInRange(fvnfhOffsets, fvnfhIndices, numFrameVertices, numFrameCells)
+            && areListIndicesInRange(fevOffsets, fevIndices, numFrameEdges, numFrameVertices)
+            && areListIndicesInRange(fevlOffsets, fevlIndices, numFrameEdges, mesh.Vs.size())
+            && areListIndicesInRange(feelOffsets, feelIndices, numFrameEdges, mesh.Es.size())
+            && areListIndicesInRange(fenffOffsets, fenffIndices, numFrameEdges, numFrameFaces)
+            && areListIndicesInRange(fenfhOffsets, fenfhIndices, numFrameEdges, numFrameCells)
+            && areListIndicesInRange(ffvOffsets, ffvIndices, numFrameFaces, numFrameVertices)
+            && areListIndicesInRange(ffeOffsets, ffeIndices, numFrameFaces, numFrameEdges)
+            && areListIndicesInRange(fffnOffsets, fffnIndices, numFrameFaces, mesh.Fs.size())
+            && areListIndicesInRange(ffnfhOffsets, ffnfhIndices, numFrameFaces, numFrameCells)
+            && areListIndicesInRange(fhvOffsets, fhvIndices, numFrameCells, numFrameVertices)
+            && areListIndicesInRange(fheOffsets, fheIndices, numFrameCells, numFrameEdges)
+            && areListIndicesInRange(fhfOffsets, fhfIndices, numFrameCells, numFrameFaces)
+            && areListIndicesInRange(fhhnOffsets, fhhnIndices, numFrameCells, mesh.Hs.size());
+    if (!dataValid) {
+        sgl::Logfile::get()->writeError(
+                "Error in BinaryMeshCache::readFrame: Missing or inconsistent frame sections.");
+        return false;
+    }
+    si = std::move(siLoaded);
+
+    frame.FVs.clear();
+    frame.FEs.clear();
+    frame.FFs.clear();
+    frame.FHs.clear();
+    frame.FVs.resize(numFrameVertices);
+    frame.FEs.resize(numFrameEdges);
+    frame.FFs.resize(numFrameFaces);
+    frame.FHs.resize(numFrameCells);
+    for (Hybrid_V& v : mesh.Vs) {
+        v.fvid = uint32_t(-1);
+    }
+    for (size_t i = 0; i < numFrameVertices; i++) {
+        Frame_V& fv = frame.FVs[i];
+        const HexBinFrameVertex& fvData = frameVertices[i];
+        fv.id = fvData.id;
+        fv.hid = fvData.hid;
+        fv.svid = fvData.svid;
+        fv.singular = fvData.singular != 0;
+        fv.boundary = fvData.boundary != 0;
+        mesh.Vs[fv.hid].fvid = fv.id;
+    }
+    for (size_t i = 0; i < numFrameEdges; i++) {
+        Frame_E& fe = frame.FEs[i];
+        const HexBinFrameEdge& feData = frameEdges[i];
+        fe.id = feData.id;
+        fe.singular = feData.singular != 0;
+        fe.boundary = feData.boundary != 0;
+    }
+    for (size_t i = 0; i < numFrameFaces; i++) {
+        Frame_F& ff = frame.FFs[i];
+        ff.id = frameFaces[i].id;
+        ff.boundary = frameFaces[i].boundary != 0;
+    }
+    for (size_t i = 0; i < numFrameCells; i++) {
+        Frame_H& fh = frame.FHs[i];
+        fh.id = frameCells[i].id;
+        fh.Color_ID = frameCells[i].colorId;
+    }
+    assignLists(frame.FVs, &Frame_V::neighbor_fvs, fvnfvOffsets, fvnfvIndices);
+    assignLists(frame.FVs, &Frame_V::neighbor_fes, fvnfeOffsets, fvnfeIndices);
+    assignLists(frame.FVs, &Frame_V::neighbor_ffs, fvnffOffsets, fvnffIndices);
+    assignLists(frame.FVs, &Frame_V::neighbor_fhs, fvnfhOffsets, fvnfhIndices);
+    assignLists(frame.FEs, &Frame_E::vs, fevOffsets, fevIndices);
+    assignLists(frame.FEs, &Frame_E::vs_link, fevlOffsets, fevlIndices);
+    assignLists(frame.FEs, &Frame_E::es_link, feelOffsets, feelIndices);
+    assignLists(frame.FEs, &Frame_E::neighbor_ffs, fenffOffsets, fenffIndices);
+    assignLists(frame.FEs, &Frame_E::neighbor_fhs, fenfhOffsets, fenfhIndices);
+    assignLists(frame.FFs, &Frame_F::vs, ffvOffsets, ffvIndices);
+    assignLists(frame.FFs, &Frame_F::es, ffeOffsets, ffeIndices);
+    assignLists(frame.FFs, &Frame_F::ffs_net, fffnOffsets, fffnIndices);
+    assignLists(frame.FFs, &Frame_F::neighbor_fhs, ffnfhOffsets, ffnfhIndices);
+    assignLists(frame.FHs, &Frame_H::vs, fhvOffsets, fhvIndices);
+    assignLists(frame.FHs, &Frame_H::es, fheOffsets, fheIndices);
+    assignLists(frame.FHs, &Frame_H::fs, fhfOffsets, fhfIndices);
+    assignLists(frame.FHs, &Frame_H::hs_net, fhhnOffsets, fhhnIndices);
+
+    return true;
+}
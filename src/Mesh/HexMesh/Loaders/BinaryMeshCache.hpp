@@ -0,0 +1,253 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOADERS_BINARYMESHCACHE_HPP
+#define LOADERS_BINARYMESHCACHE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+#include "Utils/MappedFile.hpp"
+
+struct Mesh;
+struct Singularity;
+struct Frame;
+
+/**
+ * Binary mesh cache files (.hexbin) store the data returned by a HexahedralMeshLoader together with the connectivity
+ * of the base-complex mesh (faces, edges, boundary flags, adjacency lists) and its singularity structure. Reloading a
+ * file thus skips both parsing and the connectivity computation.
+ *
+ * Layout (little-endian): A header, followed by a table of sections, followed by the section data. Each section
+ * stores a flat array of elements and starts at an offset aligned to HEXBIN_SECTION_ALIGNMENT bytes, i.e., the file
+ * can be memory-mapped and the arrays can be accessed in place. Variable-length adjacency lists are stored as
+ * offset arrays (uint64_t, size n + 1) plus index arrays (uint32_t).
+ *
+ * The cache is validated against the size and a 64-bit content hash of the source file (see computeFileHash64).
+ *
+ * Base-complex frame caches (.hexframe) use the same layout, but only store the singularity structure and the frame
+ * (Frame_V/E/F/H) extracted by base_complex::base_complex_extraction. As the frame only depends on the topology of the
+ * mesh, they are keyed by the content of the cell index array and the number of vertices (see computeContentKey), i.e.,
+ * they are independent of the source file and of the vertex deformation.
+ */
+/// Version 2: Added the singularity and base-complex frame sections (.hexframe files).
+const uint32_t HEXBIN_FORMAT_VERSION = 2;
+const size_t HEXBIN_SECTION_ALIGNMENT = 64;
+
+enum HexBinSectionType : uint32_t {
+    // Loader data.
+    HEXBIN_VERTICES = 0, HEXBIN_CELL_INDICES, HEXBIN_DEFORMATIONS, HEXBIN_ATTRIBUTES,
+    // Hybrid_V.
+    HEXBIN_V_BOUNDARY, HEXBIN_V_SVID,
+    HEXBIN_V_NEIGHBOR_VS_OFFSETS, HEXBIN_V_NEIGHBOR_VS,
+    HEXBIN_V_NEIGHBOR_ES_OFFSETS, HEXBIN_V_NEIGHBOR_ES,
+    HEXBIN_V_NEIGHBOR_FS_OFFSETS, HEXBIN_V_NEIGHBOR_FS,
+    HEXBIN_V_NEIGHBOR_HS_OFFSETS, HEXBIN_V_NEIGHBOR_HS,
+    // Hybrid_E.
+    HEXBIN_E_VS, HEXBIN_E_FLAGS,
+    HEXBIN_E_NEIGHBOR_FS_OFFSETS, HEXBIN_E_NEIGHBOR_FS,
+    HEXBIN_E_NEIGHBOR_HS_OFFSETS, HEXBIN_E_NEIGHBOR_HS,
+    // Hybrid_F.
+    HEXBIN_F_VS, HEXBIN_F_ES, HEXBIN_F_BOUNDARY,
+    HEXBIN_F_NEIGHBOR_HS_OFFSETS, HEXBIN_F_NEIGHBOR_HS,
+    // Hybrid (the vertices of the cells are stored in HEXBIN_CELL_INDICES).
+    HEXBIN_H_ES, HEXBIN_H_FS,
+    // Singular_V.
+    HEXBIN_SV_DATA,
+    HEXBIN_SV_NEIGHBOR_SVS_OFFSETS, HEXBIN_SV_NEIGHBOR_SVS,
+    HEXBIN_SV_NEIGHBOR_SES_OFFSETS, HEXBIN_SV_NEIGHBOR_SES,
+    // Singular_E.
+    HEXBIN_SE_DATA,
+    HEXBIN_SE_VS_OFFSETS, HEXBIN_SE_VS,
+    HEXBIN_SE_ES_LINK_OFFSETS, HEXBIN_SE_ES_LINK,
+    HEXBIN_SE_VS_LINK_OFFSETS, HEXBIN_SE_VS_LINK,
+    HEXBIN_SE_NEIGHBOR_SES_OFFSETS, HEXBIN_SE_NEIGHBOR_SES,
+    // Frame_V.
+    HEXBIN_FV_DATA,
+    HEXBIN_FV_NEIGHBOR_FVS_OFFSETS, HEXBIN_FV_NEIGHBOR_FVS,
+    HEXBIN_FV_NEIGHBOR_FES_OFFSETS, HEXBIN_FV_NEIGHBOR_FES,
+    HEXBIN_FV_NEIGHBOR_FFS_OFFSETS, HEXBIN_FV_NEIGHBOR_FFS,
+    HEXBIN_FV_NEIGHBOR_FHS_OFFSETS, HEXBIN_FV_NEIGHBOR_FHS,
+    // Frame_E.
+    HEXBIN_FE_DATA,
+    HEXBIN_FE_VS_OFFSETS, HEXBIN_FE_VS,
+    HEXBIN_FE_VS_LINK_OFFSETS, HEXBIN_FE_VS_LINK,
+    HEXBIN_FE_ES_LINK_OFFSETS, HEXBIN_FE_ES_LINK,
+    HEXBIN_FE_NEIGHBOR_FFS_OFFSETS, HEXBIN_FE_NEIGHBOR_FFS,
+    HEXBIN_FE_NEIGHBOR_FHS_OFFSETS, HEXBIN_FE_NEIGHBOR_FHS,
+    // Frame_F.
+    HEXBIN_FF_DATA,
+    HEXBIN_FF_VS_OFFSETS, HEXBIN_FF_VS,
+    HEXBIN_FF_ES_OFFSETS, HEXBIN_FF_ES,
+    HEXBIN_FF_FFS_NET_OFFSETS, HEXBIN_FF_FFS_NET,
+    HEXBIN_FF_NEIGHBOR_FHS_OFFSETS, HEXBIN_FF_NEIGHBOR_FHS,
+    // Frame_H.
+    HEXBIN_FH_DATA,
+    HEXBIN_FH_VS_OFFSETS, HEXBIN_FH_VS,
+    HEXBIN_FH_ES_OFFSETS, HEXBIN_FH_ES,
+    HEXBIN_FH_FS_OFFSETS, HEXBIN_FH_FS,
+    HEXBIN_FH_HS_NET_OFFSETS, HEXBIN_FH_HS_NET,
+    HEXBIN_NUM_SECTION_TYPES
+};
+
+enum HexBinFlags : uint32_t {
+    HEXBIN_FLAG_PER_VERTEX_DATA = 1, ///< The attribute list contains per-vertex (not per-cell) data.
+    HEXBIN_FLAG_HAS_CONNECTIVITY = 2, ///< The file contains the base-complex mesh connectivity and singularities.
+    HEXBIN_FLAG_HAS_FRAME = 4 ///< The file contains the singularities and the base-complex frame.
+};
+
+struct HexBinHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t byteOrderMark;
+    uint32_t flags;
+    uint32_t numSections;
+    uint64_t sourceDataSize; ///< See HexBinSourceKey.
+    uint64_t sourceDataHash;
+};
+
+struct HexBinSection {
+    uint32_t type;
+    uint32_t elementSize;
+    uint64_t numElements;
+    uint64_t offset;
+};
+
+/**
+ * Identifies the data a cache file was created from. For mesh caches (see computeSourceKey), this is the mesh source
+ * file. For base-complex frame caches (see computeContentKey), this is the cell index array of the loaded mesh.
+ */
+struct HexBinSourceKey {
+    uint64_t dataSize = 0; ///< The size of the data in bytes.
+    uint64_t dataHash = 0;
+};
+
+class BinaryMeshCache {
+public:
+    /**
+     * Computes the key a cache file must match to be a valid cache of the passed source file.
+     * @return False if the source file couldn't be read.
+     */
+    static bool computeSourceKey(const std::string& sourceFilename, HexBinSourceKey& sourceKey);
+
+    /**
+     * Returns the name of the cache file belonging to the passed mesh file.
+     * @param meshFilename The name of the source mesh file.
+     * @param cacheDirectory The directory the cache files are stored in (ends with a slash).
+     */
+    static std::string getCacheFilename(const std::string& meshFilename, const std::string& cacheDirectory);
+
+    /**
+     * Computes the key of the base-complex frame cache of a mesh from the content of its cell index array and its
+     * number of vertices. The vertex positions are not part of the key, as the frame doesn't depend on them.
+     */
+    static HexBinSourceKey computeContentKey(size_t numVertices, const std::vector<uint32_t>& cellIndices);
+
+    /**
+     * Returns the name of the base-complex frame cache file belonging to the passed content key.
+     * @param cacheDirectory The directory the cache files are stored in (ends with a slash).
+     */
+    static std::string getFrameCacheFilename(const HexBinSourceKey& contentKey, const std::string& cacheDirectory);
+
+    /**
+     * Writes a cache file. The file is first written to a temporary file that is then moved to the final location,
+     * i.e., a crash during writing doesn't leave a truncated cache behind.
+     * @param mesh The base-complex mesh, or nullptr if only the loader data should be stored.
+     * @param si The singularity structure belonging to mesh (ignored if mesh is nullptr).
+     * @return Whether the file could be written.
+     */
+    static bool save(
+            const std::string& cacheFilename, const HexBinSourceKey& sourceKey,
+            const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& cellIndices,
+            const std::vector<glm::vec3>& deformations, const std::vector<float>& attributeList,
+            bool isPerVertexData, const Mesh* mesh, const Singularity* si);
+
+    /**
+     * Writes a base-complex frame cache file (see @see save for how the file is written).
+     * @param contentKey The key computed by @see computeContentKey.
+     * @param si The singularity structure the frame was extracted from.
+     * @param frame The base-complex frame.
+     * @return Whether the file could be written.
+     */
+    static bool saveFrame(
+            const std::string& cacheFilename, const HexBinSourceKey& contentKey,
+            const Singularity& si, const Frame& frame);
+
+    /**
+     * Maps the cache file into memory and checks whether it is a valid cache of the source file with the passed key.
+     * @return False if the file doesn't exist, is corrupt, uses an outdated format or belongs to a different source.
+     */
+    bool open(const std::string& cacheFilename, const HexBinSourceKey& sourceKey);
+    void close();
+    inline bool isOpen() const { return file.isOpen(); }
+    inline bool getHasConnectivity() const { return (header.flags & HEXBIN_FLAG_HAS_CONNECTIVITY) != 0; }
+    inline bool getHasFrame() const { return (header.flags & HEXBIN_FLAG_HAS_FRAME) != 0; }
+
+    /// Reads the data also returned by HexahedralMeshLoader::loadHexahedralMeshFromFile.
+    bool readMeshData(
+            std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+            std::vector<glm::vec3>& deformations, std::vector<float>& attributeList,
+            bool& isPerVertexData) const;
+
+    /**
+     * Restores the base-complex mesh connectivity as computed by build_connectivity and the
+     * singularity structure as computed by base_complex::singularity_structure. The vertex position matrix mesh.V is
+     * not touched, as it depends on the vertex deformation and normalization applied after loading.
+     * @return False if the file contains no (or inconsistent) connectivity data. In this case, mesh and si are left
+     * unchanged.
+     */
+    bool readConnectivity(Mesh& mesh, Singularity& si) const;
+
+    /**
+     * Restores the singularity structure and the base-complex frame as computed by
+     * base_complex::base_complex_extraction, and sets the frame vertex ids (fvid) of the mesh vertices.
+     * @return False if the file contains no (or inconsistent) frame data. In this case, mesh, si and frame are left
+     * unchanged.
+     */
+    bool readFrame(Mesh& mesh, Singularity& si, Frame& frame) const;
+
+private:
+    const HexBinSection* findSection(uint32_t type, uint32_t elementSize) const;
+    template<class T>
+    bool readSection(uint32_t type, std::vector<T>& data) const;
+    template<class T>
+    const T* getSectionData(uint32_t type, size_t numElementsExpected) const;
+    bool readListSection(
+            uint32_t offsetsType, uint32_t indicesType, size_t numLists,
+            const uint64_t*& offsets, const uint32_t*& indices) const;
+    /// Reads the singularity sections and checks all ids against the singularity and mesh element counts.
+    bool readSingularity(size_t numVertices, size_t numEdges, Singularity& si) const;
+
+    MappedFile file;
+    HexBinHeader header;
+    const HexBinSection* sections = nullptr;
+};
+
+#endif // LOADERS_BINARYMESHCACHE_HPP
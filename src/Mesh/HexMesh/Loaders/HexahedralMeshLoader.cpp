@@ -26,6 +26,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "Utils/MappedFile.hpp"
+#include "AsciiScanner.hpp"
 #include "HexahedralMeshLoader.hpp"
 
 #include <Utils/File/Logfile.hpp>
@@ -120,3 +122,26 @@ bool readFileLineByLine(
 
     return true;
 }
+
+bool readMappedFileLineByLine(
+        const std::string& filename, std::function<bool(AsciiScanner&)> readLineCallback) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        sgl::Logfile::get()->writeError(
+                "Error in readMappedFileLineByLine: Couldn't open file \"" + filename + "\".");
+        return false;
+    }
+
+    AsciiScanner scanner(file.begin(), file.end());
+    while (scanner.nextLine()) {
+        if (!readLineCallback(scanner)) {
+            sgl::Logfile::get()->writeError(
+                    std::string() + "Error in readMappedFileLineByLine: An error occured at line "
+                    + sgl::toString(scanner.getLineNumber()) + ". Content of the line:");
+            sgl::Logfile::get()->writeError(scanner.getLineString());
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -37,6 +37,8 @@
 
 #include "Mesh/HexMesh/HexMesh.hpp"
 
+class AsciiScanner;
+
 class HexahedralMeshLoader {
 public:
     virtual ~HexahedralMeshLoader() {}
@@ -71,4 +73,15 @@ bool readFileLineByLine(
         const std::string& filename,
         std::function<bool(const std::string&, const std::vector<std::string>&)> readLineCallback);
 
+/**
+ * Reads a memory-mapped text file line by line without allocating memory per line (see @see AsciiScanner).
+ * @param filename The name of the text file.
+ * @param readLineCallback A function that is called when a new (non-empty) line was read. It is passed the scanner
+ * holding the tokens of the current line and is expected to return false if an error occurred while reading the line
+ * and true otherwise. The callback may also advance the scanner itself to consume multiple lines at once.
+ * @return Whether loading has succeeded.
+ */
+bool readMappedFileLineByLine(
+        const std::string& filename, std::function<bool(AsciiScanner&)> readLineCallback);
+
 #endif // LOADERS_HEXAHEDRALMESHLOADER_HPP
\ No newline at end of file
@@ -33,9 +33,9 @@
 #include <glm/vec3.hpp>
 
 #include <Utils/File/Logfile.hpp>
-#include <Utils/Convert.hpp>
 
 #include "Mesh/HexMesh/HexMesh.hpp"
+#include "AsciiScanner.hpp"
 #include "MeshLoader.hpp"
 
 bool MeshLoader::loadHexahedralMeshFromFile(
@@ -49,60 +49,61 @@ bool MeshLoader::loadHexahedralMeshFromFile(
     bool lastLineWasDimensionHeader = false;
     bool foundVerticesHeader = false;
     bool lastLineWasVerticesHeader = false;
-    bool isVerticesReadMode = false;
-    int numVerticesLeft = 0;
+    uint64_t numVertices = 0;
     bool foundHexahedraHeader = false;
     bool lastLineWasHexahedraHeader = false;
-    bool isHexahedraReadMode = false;
-    int numHexahedraLeft = 0;
+    uint64_t numHexahedra = 0;
     bool foundQuadrilateralsHeader = false;
     bool lastLineWasQuadrilateralsHeader = false;
     bool isQuadrilateralsReadMode = false;
-    int numQuadrilateralsLeft = 0;
+    uint64_t numQuadrilateralsLeft = 0;
     bool endReached = false;
 
-    bool loadingSuccessful = readFileLineByLine(
-            filename, [&](const std::string& lineString, const std::vector<std::string>& tokens) {
-        if (endReached) {
-            sgl::Logfile::get()->writeError("Error in MeshLoader: End was reached, but it was not the last token!");
-            return false;
+    // The vertex and cell sections make up almost all of the file and are parsed in parallel.
+    auto readVertices = [&](AsciiScanner& line) {
+        bool success = parseLinesParallel(
+                line, size_t(numVertices), 1, vertices,
+                [](const AsciiScanner& vertexLine, glm::vec3* vertexPosition) {
+            return vertexLine.getNumTokens() == 4 && vertexLine.parseToken(0, vertexPosition->x)
+                    && vertexLine.parseToken(1, vertexPosition->y) && vertexLine.parseToken(2, vertexPosition->z);
+        });
+        if (!success) {
+            sgl::Logfile::get()->writeError("Error in MeshLoader: Invalid vertex coordinates!");
         }
-
-        if (isVerticesReadMode) {
-            if (tokens.size() != 4) {
-                sgl::Logfile::get()->writeError("Error in MeshLoader: Invalid number of vertex coordinates!");
+        return success;
+    };
+    auto readHexahedra = [&](AsciiScanner& line) {
+        bool success = parseLinesParallel(
+                line, size_t(numHexahedra), 8, cellIndices,
+                [](const AsciiScanner& cellLine, uint32_t* hexahedronIndices) {
+            if (cellLine.getNumTokens() != 9) {
                 return false;
             }
-            vertices.push_back(glm::vec3(
-                    sgl::fromString<float>(tokens.at(0)),
-                    sgl::fromString<float>(tokens.at(1)),
-                    sgl::fromString<float>(tokens.at(2))));
-            numVerticesLeft--;
-            if (numVerticesLeft <= 0) {
-                isVerticesReadMode = false;
+            for (int i = 0; i < 8; i++) {
+                uint32_t vertexIndex = 0;
+                if (!cellLine.parseToken(i, vertexIndex) || vertexIndex == 0) {
+                    return false;
+                }
+                hexahedronIndices[i] = vertexIndex - 1;
             }
             return true;
+        });
+        if (!success) {
+            sgl::Logfile::get()->writeError("Error in MeshLoader: Invalid hexahedral cell indices!");
         }
+        return success;
+    };
 
-        if (isHexahedraReadMode) {
-            if (tokens.size() != 9) {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid number of hexahedral cell indices!");
-                return false;
-            }
-            for (int i = 0; i < 8; i++) {
-                cellIndices.push_back(sgl::fromString<uint32_t>(tokens.at(i)) - 1);
-            }
-            numHexahedraLeft--;
-            if (numHexahedraLeft <= 0) {
-                isHexahedraReadMode = false;
-            }
-            return true;
+    bool loadingSuccessful = readMappedFileLineByLine(filename, [&](AsciiScanner& line) {
+        if (endReached) {
+            sgl::Logfile::get()->writeError("Error in MeshLoader: End was reached, but it was not the last token!");
+            return false;
         }
 
         // Quadrilateral data is not used.
         if (isQuadrilateralsReadMode) {
             numQuadrilateralsLeft--;
-            if (numQuadrilateralsLeft <= 0) {
+            if (numQuadrilateralsLeft == 0) {
                 isQuadrilateralsReadMode = false;
             }
             return true;
@@ -110,7 +111,7 @@ bool MeshLoader::loadHexahedralMeshFromFile(
 
         // The version header must the first non-empty line!
         if (!foundVersionHeader) {
-            if (sgl::startsWith(tokens.at(0), "MeshVersionFormatted")) {
+            if (line.tokenStartsWith(0, "MeshVersionFormatted")) {
                 foundVersionHeader = true;
                 return true;
             } else {
@@ -120,12 +121,12 @@ bool MeshLoader::loadHexahedralMeshFromFile(
             }
         }
 
-        if (!foundDimensionHeader && tokens.at(0) == "Dimension") {
+        if (!foundDimensionHeader && line.tokenEquals(0, "Dimension")) {
             foundDimensionHeader = true;
-            if (tokens.size() == 1) {
+            if (line.getNumTokens() == 1) {
                 lastLineWasDimensionHeader = true;
             } else {
-                if (tokens.at(1) != "3") {
+                if (!line.tokenEquals(1, "3")) {
                     sgl::Logfile::get()->writeError("Error in MeshLoader: Invalid dimension number!");
                     return false;
                 }
@@ -134,7 +135,7 @@ bool MeshLoader::loadHexahedralMeshFromFile(
         }
 
         if (lastLineWasDimensionHeader) {
-            if (tokens.at(0) != "3") {
+            if (!line.tokenEquals(0, "3")) {
                 sgl::Logfile::get()->writeError("Error in MeshLoader: Invalid dimension number!");
                 return false;
             } else {
@@ -143,61 +144,71 @@ bool MeshLoader::loadHexahedralMeshFromFile(
             }
         }
 
-        if (!foundVerticesHeader && tokens.at(0) == "Vertices") {
+        if (!foundVerticesHeader && line.tokenEquals(0, "Vertices")) {
             foundVerticesHeader = true;
-            if (tokens.size() == 1) {
+            if (line.getNumTokens() == 1) {
                 lastLineWasVerticesHeader = true;
             } else {
-                numVerticesLeft = sgl::fromString<size_t>(tokens.at(1));
-                isVerticesReadMode = numVerticesLeft > 0;
+                if (!line.parseToken(1, numVertices)) {
+                    return false;
+                }
+                return readVertices(line);
             }
             return true;
         }
 
         if (lastLineWasVerticesHeader) {
-            numVerticesLeft = sgl::fromString<size_t>(tokens.at(0));
+            if (!line.parseToken(0, numVertices)) {
+                return false;
+            }
             lastLineWasVerticesHeader = false;
-            isVerticesReadMode = numVerticesLeft > 0;
-            return true;
+            return readVertices(line);
         }
 
-        if (!foundHexahedraHeader && tokens.at(0) == "Hexahedra") {
+        if (!foundHexahedraHeader && line.tokenEquals(0, "Hexahedra")) {
             foundHexahedraHeader = true;
-            if (tokens.size() == 1) {
+            if (line.getNumTokens() == 1) {
                 lastLineWasHexahedraHeader = true;
             } else {
-                numHexahedraLeft = sgl::fromString<size_t>(tokens.at(1));
-                isHexahedraReadMode = numHexahedraLeft > 0;
+                if (!line.parseToken(1, numHexahedra)) {
+                    return false;
+                }
+                return readHexahedra(line);
             }
             return true;
         }
 
         if (lastLineWasHexahedraHeader) {
-            numHexahedraLeft = sgl::fromString<size_t>(tokens.at(0));
+            if (!line.parseToken(0, numHexahedra)) {
+                return false;
+            }
             lastLineWasHexahedraHeader = false;
-            isHexahedraReadMode = numHexahedraLeft > 0;
-            return true;
+            return readHexahedra(line);
         }
 
-        if (!foundQuadrilateralsHeader && (tokens.at(0) == "Quadrilaterals" || tokens.at(0) == "Quads")) {
+        if (!foundQuadrilateralsHeader && (line.tokenEquals(0, "Quadrilaterals") || line.tokenEquals(0, "Quads"))) {
             foundQuadrilateralsHeader = true;
-            if (tokens.size() == 1) {
+            if (line.getNumTokens() == 1) {
                 lastLineWasQuadrilateralsHeader = true;
             } else {
-                numQuadrilateralsLeft = sgl::fromString<size_t>(tokens.at(0));
+                if (!line.parseToken(1, numQuadrilateralsLeft)) {
+                    return false;
+                }
                 isQuadrilateralsReadMode = numQuadrilateralsLeft > 0;
             }
             return true;
         }
 
         if (lastLineWasQuadrilateralsHeader) {
-            numQuadrilateralsLeft = sgl::fromString<size_t>(tokens.at(0));
+            if (!line.parseToken(0, numQuadrilateralsLeft)) {
+                return false;
+            }
             lastLineWasQuadrilateralsHeader = false;
             isQuadrilateralsReadMode = numQuadrilateralsLeft > 0;
             return true;
         }
 
-        if (!endReached && tokens.at(0) == "End") {
+        if (!endReached && line.tokenEquals(0, "End")) {
             endReached = true;
             return true;
         }
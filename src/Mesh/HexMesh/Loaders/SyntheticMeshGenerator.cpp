@@ -0,0 +1,407 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+
+#include <glm/glm.hpp>
+
+#include <Utils/File/Logfile.hpp>
+
+#include "SyntheticMeshGenerator.hpp"
+
+namespace {
+
+/// SplitMix64 hash; used to derive reproducible random numbers independently of the thread count.
+inline uint64_t hashIndex(uint64_t seed, uint64_t idx) {
+    uint64_t z = seed * 0x9E3779B97F4A7C15ull + idx + 0x632BE59BD9B4E019ull;
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/// Maps 21 bits of the hash value starting at bit 'shift' to [0, 1].
+inline float hashToUnitFloat(uint64_t hash, uint32_t shift) {
+    return float((hash >> shift) & 0x1FFFFFull) / float(0x1FFFFF);
+}
+
+/// Maps 21 bits of the hash value starting at bit 'shift' to [-1, 1].
+inline float hashToSignedFloat(uint64_t hash, uint32_t shift) {
+    return hashToUnitFloat(hash, shift) * 2.0f - 1.0f;
+}
+
+/**
+ * Computes the n + 1 coordinates of the sheet boundaries along one axis. The thicknesses of successive sheets grow by
+ * the factor 'grading'. The local spacing (i.e., the minimum thickness of the adjacent sheets) is used for the jitter.
+ */
+void computeAxisCoordinates(
+        uint32_t n, float grading, float extent, std::vector<float>& coordinates, std::vector<float>& localSpacings) {
+    coordinates.resize(n + 1);
+    localSpacings.resize(n + 1);
+    double thickness = 1.0;
+    double position = 0.0;
+    for (uint32_t i = 0; i <= n; i++) {
+        coordinates.at(i) = float(position);
+        position += thickness;
+        thickness *= double(grading);
+    }
+    float scale = extent / coordinates.at(n);
+    for (uint32_t i = 0; i <= n; i++) {
+        coordinates.at(i) *= scale;
+    }
+    for (uint32_t i = 0; i <= n; i++) {
+        float spacingPrev = i > 0 ? coordinates.at(i) - coordinates.at(i - 1) : std::numeric_limits<float>::max();
+        float spacingNext = i < n ? coordinates.at(i + 1) - coordinates.at(i) : std::numeric_limits<float>::max();
+        localSpacings.at(i) = std::min(spacingPrev, spacingNext);
+    }
+}
+
+float evaluateAttributeField(SyntheticAttributeField attributeField, const glm::vec3& p, uint64_t hash) {
+    if (attributeField == SyntheticAttributeField::RADIAL) {
+        return glm::length(p - glm::vec3(0.5f));
+    } else if (attributeField == SyntheticAttributeField::WAVE) {
+        const float TWO_PI = 6.28318530718f;
+        return 0.5f + 0.5f * std::sin(TWO_PI * (2.0f * p.x + p.y)) * std::cos(TWO_PI * 3.0f * p.z);
+    } else {
+        return hashToUnitFloat(hash, 0);
+    }
+}
+
+/// The 2D vertices of the extruded quad grid.
+struct SyntheticVertex2D {
+    glm::vec2 position;
+    /// The maximum displacement in x and y direction (zero in the direction orthogonal to a boundary).
+    glm::vec2 jitterScale;
+};
+
+}
+
+void SyntheticMeshSettings::setApproximateNumCells(size_t numCells) {
+    uint32_t resolution = uint32_t(std::max(std::round(std::cbrt(double(numCells))), 1.0));
+    resolutionX = resolution;
+    resolutionY = resolution;
+    resolutionZ = resolution;
+}
+
+bool parseSyntheticMeshSpecification(const std::string& specification, SyntheticMeshSettings& settings) {
+    const std::string prefix = "synthetic:";
+    if (specification.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+
+    size_t position = prefix.size();
+    while (position < specification.size()) {
+        size_t end = specification.find(',', position);
+        if (end == std::string::npos) {
+            end = specification.size();
+        }
+        std::string entry = specification.substr(position, end - position);
+        position = end + 1;
+        if (entry.empty()) {
+            continue;
+        }
+
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) {
+            sgl::Logfile::get()->writeError(
+                    "Error in parseSyntheticMeshSpecification: Expected key=value, got \"" + entry + "\".");
+            return false;
+        }
+        std::string key = entry.substr(0, separator);
+        std::string value = entry.substr(separator + 1);
+        bool valid = true;
+        unsigned long long integerValue = 0;
+        unsigned int x = 0, y = 0, z = 0;
+        if (key == "cells") {
+            valid = std::sscanf(value.c_str(), "%llu", &integerValue) == 1 && integerValue > 0;
+            settings.setApproximateNumCells(size_t(integerValue));
+        } else if (key == "resolution") {
+            if (std::sscanf(value.c_str(), "%ux%ux%u", &x, &y, &z) == 3) {
+                settings.resolutionX = x;
+                settings.resolutionY = y;
+                settings.resolutionZ = z;
+            } else if (std::sscanf(value.c_str(), "%u", &x) == 1) {
+                settings.resolutionX = settings.resolutionY = settings.resolutionZ = x;
+            } else {
+                valid = false;
+            }
+            valid = valid && settings.resolutionX > 0 && settings.resolutionY > 0 && settings.resolutionZ > 0;
+        } else if (key == "templates") {
+            valid = std::sscanf(value.c_str(), "%u", &x) == 1;
+            settings.numSingularityTemplates = x;
+        } else if (key == "jitter") {
+            valid = std::sscanf(value.c_str(), "%f", &settings.vertexJitter) == 1;
+        } else if (key == "grading") {
+            valid = std::sscanf(value.c_str(), "%f", &settings.sheetGrading) == 1 && settings.sheetGrading > 0.0f;
+        } else if (key == "attribute") {
+            if (value == "none") {
+                settings.attributeField = SyntheticAttributeField::NONE;
+            } else if (value == "radial") {
+                settings.attributeField = SyntheticAttributeField::RADIAL;
+            } else if (value == "wave") {
+                settings.attributeField = SyntheticAttributeField::WAVE;
+            } else if (value == "noise") {
+                settings.attributeField = SyntheticAttributeField::NOISE;
+            } else {
+                valid = false;
+            }
+        } else if (key == "per_cell") {
+            settings.attributePerVertex = !(value == "1" || value == "true");
+        } else if (key == "seed") {
+            valid = std::sscanf(value.c_str(), "%u", &x) == 1;
+            settings.seed = x;
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            sgl::Logfile::get()->writeError(
+                    "Error in parseSyntheticMeshSpecification: Invalid entry \"" + entry + "\".");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the number of possible template positions. Templates are placed on cells with odd x and y indices that
+ * don't touch the boundary, so no two templates share a vertex.
+ */
+static void getSingularityTemplateCandidates(
+        const SyntheticMeshSettings& settings, uint32_t& numCandidatesX, uint32_t& numCandidatesY) {
+    // Cells x = 1, 3, 5, ... with x + 1 <= resolution - 1.
+    numCandidatesX = settings.resolutionX >= 3 ? (settings.resolutionX - 1) / 2 : 0;
+    numCandidatesY = settings.resolutionY >= 3 ? (settings.resolutionY - 1) / 2 : 0;
+}
+
+static uint32_t getNumSingularityTemplates(const SyntheticMeshSettings& settings) {
+    uint32_t numCandidatesX, numCandidatesY;
+    getSingularityTemplateCandidates(settings, numCandidatesX, numCandidatesY);
+    return uint32_t(std::min(uint64_t(settings.numSingularityTemplates), uint64_t(numCandidatesX) * numCandidatesY));
+}
+
+size_t getSyntheticMeshNumCells(const SyntheticMeshSettings& settings) {
+    size_t numQuads2D = size_t(settings.resolutionX) * size_t(settings.resolutionY)
+            + 4 * size_t(getNumSingularityTemplates(settings));
+    return numQuads2D * size_t(settings.resolutionZ);
+}
+
+bool generateSyntheticHexMesh(
+        const SyntheticMeshSettings& settings,
+        std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+        std::vector<float>& attributeList, bool& isPerVertexData) {
+    const uint32_t nx = std::max(settings.resolutionX, 1u);
+    const uint32_t ny = std::max(settings.resolutionY, 1u);
+    const uint32_t nz = std::max(settings.resolutionZ, 1u);
+    const uint32_t numTemplates = getNumSingularityTemplates(settings);
+    const float vertexJitter = std::max(std::min(settings.vertexJitter, 0.45f), 0.0f);
+    const float sheetGrading = settings.sheetGrading > 0.0f ? settings.sheetGrading : 1.0f;
+
+    const size_t numVertices2D = size_t(nx + 1) * size_t(ny + 1) + 4 * size_t(numTemplates);
+    const size_t numQuads2D = size_t(nx) * size_t(ny) + 4 * size_t(numTemplates);
+    const size_t numVertices = numVertices2D * size_t(nz + 1);
+    const size_t numCells = numQuads2D * size_t(nz);
+    if (numVertices > size_t(std::numeric_limits<uint32_t>::max())) {
+        sgl::Logfile::get()->writeError(
+                "Error in generateSyntheticHexMesh: The number of vertices exceeds the 32-bit index range.");
+        return false;
+    }
+
+    // The mesh is scaled such that its largest side has length 1.
+    const float maxResolution = float(std::max(nx, std::max(ny, nz)));
+    const glm::vec3 extent = glm::vec3(float(nx), float(ny), float(nz)) / maxResolution;
+    std::vector<float> coordinatesX, coordinatesY, coordinatesZ;
+    std::vector<float> spacingsX, spacingsY, spacingsZ;
+    computeAxisCoordinates(nx, sheetGrading, extent.x, coordinatesX, spacingsX);
+    computeAxisCoordinates(ny, sheetGrading, extent.y, coordinatesY, spacingsY);
+    computeAxisCoordinates(nz, sheetGrading, extent.z, coordinatesZ, spacingsZ);
+
+    // Place the singularity templates at distinct random candidate positions.
+    uint32_t numCandidatesX, numCandidatesY;
+    getSingularityTemplateCandidates(settings, numCandidatesX, numCandidatesY);
+    std::vector<uint32_t> templateCells;
+    if (numTemplates > 0) {
+        std::vector<uint32_t> candidates(size_t(numCandidatesX) * size_t(numCandidatesY));
+        for (size_t i = 0; i < candidates.size(); i++) {
+            candidates.at(i) = uint32_t(i);
+        }
+        std::mt19937 generator(settings.seed);
+        for (uint32_t i = 0; i < numTemplates; i++) {
+            std::uniform_int_distribution<size_t> distribution(i, candidates.size() - 1);
+            std::swap(candidates.at(i), candidates.at(distribution(generator)));
+        }
+        templateCells.reserve(numTemplates);
+        for (uint32_t i = 0; i < numTemplates; i++) {
+            uint32_t candidateX = candidates.at(i) % numCandidatesX;
+            uint32_t candidateY = candidates.at(i) / numCandidatesX;
+            templateCells.push_back((2 * candidateX + 1) + (2 * candidateY + 1) * nx);
+        }
+        std::sort(templateCells.begin(), templateCells.end());
+    }
+
+    // Build the 2D quad grid including the templates.
+    auto gridVertexIndex = [nx](uint32_t x, uint32_t y) { return x + y * (nx + 1); };
+    std::vector<SyntheticVertex2D> vertices2D(numVertices2D);
+    for (uint32_t y = 0; y <= ny; y++) {
+        for (uint32_t x = 0; x <= nx; x++) {
+            SyntheticVertex2D& vertex = vertices2D.at(gridVertexIndex(x, y));
+            vertex.position = glm::vec2(coordinatesX.at(x), coordinatesY.at(y));
+            vertex.jitterScale = glm::vec2(
+                    x == 0 || x == nx ? 0.0f : vertexJitter * spacingsX.at(x),
+                    y == 0 || y == ny ? 0.0f : vertexJitter * spacingsY.at(y));
+        }
+    }
+    std::vector<uint32_t> quads2D;
+    quads2D.reserve(numQuads2D * 4);
+    size_t templateIdx = 0;
+    uint32_t innerVertexIdx = uint32_t(size_t(nx + 1) * size_t(ny + 1));
+    for (uint32_t y = 0; y < ny; y++) {
+        for (uint32_t x = 0; x < nx; x++) {
+            uint32_t corners[4] = {
+                    gridVertexIndex(x, y), gridVertexIndex(x + 1, y),
+                    gridVertexIndex(x + 1, y + 1), gridVertexIndex(x, y + 1) };
+            if (templateIdx >= templateCells.size() || templateCells.at(templateIdx) != x + y * nx) {
+                quads2D.insert(quads2D.end(), corners, corners + 4);
+                continue;
+            }
+            templateIdx++;
+
+            // Inner quad corners at 1/4 and 3/4 of the cell. The jitter of the template vertices is reduced so that
+            // the trapezoids can't be inverted.
+            const glm::vec2 fractions[4] = {
+                    glm::vec2(0.25f, 0.25f), glm::vec2(0.75f, 0.25f), glm::vec2(0.75f, 0.75f), glm::vec2(0.25f, 0.75f)
+            };
+            glm::vec2 cellMin = vertices2D.at(corners[0]).position;
+            glm::vec2 cellSize = vertices2D.at(corners[2]).position - cellMin;
+            uint32_t inner[4];
+            for (int i = 0; i < 4; i++) {
+                vertices2D.at(corners[i]).jitterScale = glm::min(
+                        vertices2D.at(corners[i]).jitterScale, vertexJitter * 0.25f * cellSize);
+                inner[i] = innerVertexIdx++;
+                SyntheticVertex2D& vertex = vertices2D.at(inner[i]);
+                vertex.position = cellMin + fractions[i] * cellSize;
+                vertex.jitterScale = vertexJitter * 0.25f * cellSize;
+            }
+            const uint32_t templateQuads[5][4] = {
+                    { inner[0], inner[1], inner[2], inner[3] },
+                    { corners[0], corners[1], inner[1], inner[0] },
+                    { corners[1], corners[2], inner[2], inner[1] },
+                    { corners[2], corners[3], inner[3], inner[2] },
+                    { corners[3], corners[0], inner[0], inner[3] },
+            };
+            for (int i = 0; i < 5; i++) {
+                quads2D.insert(quads2D.end(), templateQuads[i], templateQuads[i] + 4);
+            }
+        }
+    }
+
+    // Extrude the 2D grid along the z axis. The output arrays are filled in parallel.
+    const uint64_t seed = settings.seed;
+    vertices.resize(numVertices);
+#if _OPENMP >= 200805
+    #pragma omp parallel for default(none) \
+    shared(vertices, vertices2D, coordinatesZ, spacingsZ, numVertices, numVertices2D, nz, vertexJitter, seed)
+#endif
+    for (size_t vertexIdx = 0; vertexIdx < numVertices; vertexIdx++) {
+        size_t layer = vertexIdx / numVertices2D;
+        const SyntheticVertex2D& vertex2D = vertices2D.at(vertexIdx % numVertices2D);
+        glm::vec3 position(vertex2D.position.x, vertex2D.position.y, coordinatesZ.at(layer));
+        if (vertexJitter > 0.0f) {
+            uint64_t hash = hashIndex(seed, vertexIdx);
+            float jitterScaleZ = layer == 0 || layer == nz ? 0.0f : vertexJitter * spacingsZ.at(layer);
+            position += glm::vec3(
+                    vertex2D.jitterScale.x * hashToSignedFloat(hash, 0),
+                    vertex2D.jitterScale.y * hashToSignedFloat(hash, 21),
+                    jitterScaleZ * hashToSignedFloat(hash, 42));
+        }
+        vertices.at(vertexIdx) = position;
+    }
+
+    cellIndices.resize(numCells * 8);
+#if _OPENMP >= 200805
+    #pragma omp parallel for default(none) shared(cellIndices, quads2D, numCells, numQuads2D, numVertices2D)
+#endif
+    for (size_t cellIdx = 0; cellIdx < numCells; cellIdx++) {
+        size_t layer = cellIdx / numQuads2D;
+        size_t quadIdx = cellIdx % numQuads2D;
+        uint32_t offsetBottom = uint32_t(layer * numVertices2D);
+        uint32_t offsetTop = uint32_t((layer + 1) * numVertices2D);
+        for (int i = 0; i < 4; i++) {
+            uint32_t vertexIdx2D = quads2D.at(quadIdx * 4 + i);
+            cellIndices.at(cellIdx * 8 + i) = offsetBottom + vertexIdx2D;
+            cellIndices.at(cellIdx * 8 + 4 + i) = offsetTop + vertexIdx2D;
+        }
+    }
+
+    // Evaluate the attribute field on the unperturbed normalized positions.
+    isPerVertexData = settings.attributePerVertex;
+    attributeList.clear();
+    SyntheticAttributeField attributeField = settings.attributeField;
+    if (attributeField == SyntheticAttributeField::NONE) {
+        return true;
+    }
+    const uint64_t attributeSeed = hashIndex(seed, std::numeric_limits<uint64_t>::max());
+    if (isPerVertexData) {
+        attributeList.resize(numVertices);
+#if _OPENMP >= 200805
+        #pragma omp parallel for default(none) shared(attributeList, vertices2D, coordinatesZ, extent) \
+        shared(numVertices, numVertices2D, attributeField, attributeSeed)
+#endif
+        for (size_t vertexIdx = 0; vertexIdx < numVertices; vertexIdx++) {
+            const SyntheticVertex2D& vertex2D = vertices2D.at(vertexIdx % numVertices2D);
+            glm::vec3 position(
+                    vertex2D.position.x, vertex2D.position.y, coordinatesZ.at(vertexIdx / numVertices2D));
+            attributeList.at(vertexIdx) = evaluateAttributeField(
+                    attributeField, position / extent, hashIndex(attributeSeed, vertexIdx));
+        }
+    } else {
+        attributeList.resize(numCells);
+#if _OPENMP >= 200805
+        #pragma omp parallel for default(none) shared(attributeList, vertices2D, quads2D, coordinatesZ, extent) \
+        shared(numCells, numQuads2D, attributeField, attributeSeed)
+#endif
+        for (size_t cellIdx = 0; cellIdx < numCells; cellIdx++) {
+            size_t layer = cellIdx / numQuads2D;
+            size_t quadIdx = cellIdx % numQuads2D;
+            glm::vec2 center2D(0.0f);
+            for (int i = 0; i < 4; i++) {
+                center2D += vertices2D.at(quads2D.at(quadIdx * 4 + i)).position;
+            }
+            center2D *= 0.25f;
+            glm::vec3 center(
+                    center2D.x, center2D.y, 0.5f * (coordinatesZ.at(layer) + coordinatesZ.at(layer + 1)));
+            attributeList.at(cellIdx) = evaluateAttributeField(
+                    attributeField, center / extent, hashIndex(attributeSeed, cellIdx));
+        }
+    }
+
+    return true;
+}
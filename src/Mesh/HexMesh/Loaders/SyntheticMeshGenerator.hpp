@@ -0,0 +1,115 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_SYNTHETICMESHGENERATOR_HPP
+#define HEXVOLUMERENDERER_SYNTHETICMESHGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+enum class SyntheticAttributeField {
+    NONE, ///< No attribute data is generated.
+    RADIAL, ///< The distance to the center of the mesh.
+    WAVE, ///< A smooth periodic field.
+    NOISE ///< Uniformly distributed random values in [0, 1].
+};
+
+/**
+ * Settings for @see generateSyntheticHexMesh.
+ *
+ * The mesh is a box made of resolutionX * resolutionY * resolutionZ cells. It consists of resolutionZ layers of an
+ * extruded quad grid. The mesh has one sheet per layer of cells in each direction, i.e.,
+ * resolutionX + resolutionY + resolutionZ sheets in total.
+ *
+ * Singular edges are introduced by singularity templates. A template replaces an interior quad of the 2D grid by an
+ * inner quad surrounded by four trapezoids, which keeps the mesh conforming. Extruded along the z axis, each template
+ * adds four singular lines of valence 3 (at the inner quad corners) and four singular lines of valence 5 (at the
+ * corners of the replaced quad), i.e., 8 * resolutionZ singular edges, and one additional ring-shaped sheet. Templates
+ * are placed at random, but never share vertices with each other or the boundary.
+ */
+struct SyntheticMeshSettings {
+    uint32_t resolutionX = 32;
+    uint32_t resolutionY = 32;
+    uint32_t resolutionZ = 32;
+    /// The number of singularity templates (clamped to the number of available template positions).
+    uint32_t numSingularityTemplates = 0;
+    /**
+     * The maximum random displacement of the vertices relative to the local cell size (clamped to [0, 0.45]).
+     * Values up to about 1/6 keep all cells valid; larger values may produce inverted cells.
+     */
+    float vertexJitter = 0.0f;
+    /// The ratio of the thicknesses of successive sheets in each direction (1 means uniform sheet thickness).
+    float sheetGrading = 1.0f;
+    SyntheticAttributeField attributeField = SyntheticAttributeField::NONE;
+    /// Whether the attribute is generated per vertex or per cell.
+    bool attributePerVertex = true;
+    /// The seed of the random template placement, vertex jitter and noise. The same seed gives the same mesh.
+    uint32_t seed = 0;
+
+    /**
+     * Sets a cube-shaped resolution such that the mesh has approximately the passed number of cells (not counting the
+     * cells added by the singularity templates).
+     */
+    void setApproximateNumCells(size_t numCells);
+};
+
+/**
+ * Parses a synthetic mesh specification of the form "synthetic:key=value,key=value,...". Supported keys are
+ * "cells" (approximate number of cells), "resolution" (NXxNYxNZ or N), "templates", "jitter", "grading",
+ * "attribute" (none, radial, wave or noise), "per_cell" (0 or 1) and "seed".
+ * @param specification The specification string.
+ * @param settings The parsed settings. Keys not specified keep their current value.
+ * @return Whether the string is a valid synthetic mesh specification.
+ */
+bool parseSyntheticMeshSpecification(const std::string& specification, SyntheticMeshSettings& settings);
+
+/**
+ * @return The number of cells of the mesh generated for the passed settings.
+ */
+size_t getSyntheticMeshNumCells(const SyntheticMeshSettings& settings);
+
+/**
+ * Generates a synthetic hexahedral mesh. The output arrays are allocated once with their final size and filled in
+ * parallel, so they can be passed to @see HexMesh::setHexMeshData without any intermediate representation.
+ * @param settings The generator settings.
+ * @param vertices The mesh vertices.
+ * @param cellIndices The indices of vertices forming hexahedral cells. Eight consecutive indices build one cell.
+ * @param attributeList The generated attribute field (empty for SyntheticAttributeField::NONE).
+ * @param isPerVertexData Whether the data stored in attributeList is per-vertex or per-cell.
+ * @return False if the mesh would exceed the 32-bit vertex index range, and true otherwise.
+ */
+bool generateSyntheticHexMesh(
+        const SyntheticMeshSettings& settings,
+        std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+        std::vector<float>& attributeList, bool& isPerVertexData);
+
+#endif //HEXVOLUMERENDERER_SYNTHETICMESHGENERATOR_HPP
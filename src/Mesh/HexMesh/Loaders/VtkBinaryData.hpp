@@ -0,0 +1,150 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOADERS_VTKBINARYDATA_HPP
+#define LOADERS_VTKBINARYDATA_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/// Scalar types of binary VTK data arrays (legacy BINARY sections and XML data arrays).
+enum VtkDataType {
+    VTK_DATA_TYPE_INVALID,
+    VTK_DATA_TYPE_INT8, VTK_DATA_TYPE_UINT8,
+    VTK_DATA_TYPE_INT16, VTK_DATA_TYPE_UINT16,
+    VTK_DATA_TYPE_INT32, VTK_DATA_TYPE_UINT32,
+    VTK_DATA_TYPE_INT64, VTK_DATA_TYPE_UINT64,
+    VTK_DATA_TYPE_FLOAT32, VTK_DATA_TYPE_FLOAT64
+};
+
+/// @return The size of one value of the passed type in bytes (or 0 for VTK_DATA_TYPE_INVALID).
+inline size_t getVtkDataTypeSize(VtkDataType dataType) {
+    switch (dataType) {
+        case VTK_DATA_TYPE_INT8:
+        case VTK_DATA_TYPE_UINT8:
+            return 1;
+        case VTK_DATA_TYPE_INT16:
+        case VTK_DATA_TYPE_UINT16:
+            return 2;
+        case VTK_DATA_TYPE_INT32:
+        case VTK_DATA_TYPE_UINT32:
+        case VTK_DATA_TYPE_FLOAT32:
+            return 4;
+        case VTK_DATA_TYPE_INT64:
+        case VTK_DATA_TYPE_UINT64:
+        case VTK_DATA_TYPE_FLOAT64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+/// @return Whether the machine this program runs on stores multi-byte values in big-endian byte order.
+inline bool getIsHostBigEndian() {
+    const uint16_t testValue = 1;
+    uint8_t firstByte = 0;
+    memcpy(&firstByte, &testValue, 1);
+    return firstByte == 0;
+}
+
+/// Reads one value of type S from possibly unaligned memory, optionally reversing its byte order.
+template<class S>
+inline S readVtkValue(const char* data, bool swapBytes) {
+    S value;
+    if (swapBytes) {
+        char bytes[sizeof(S)];
+        for (size_t i = 0; i < sizeof(S); i++) {
+            bytes[i] = data[sizeof(S) - i - 1];
+        }
+        memcpy(&value, bytes, sizeof(S));
+    } else {
+        memcpy(&value, data, sizeof(S));
+    }
+    return value;
+}
+
+template<class S, class T>
+void convertVtkDataArrayTyped(const char* data, bool swapBytes, size_t numValues, T* output) {
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(data, swapBytes, numValues, output) if(numValues >= (1 << 16))
+#endif
+    for (size_t i = 0; i < numValues; i++) {
+        output[i] = T(readVtkValue<S>(data + i * sizeof(S), swapBytes));
+    }
+}
+
+/**
+ * Converts a binary VTK data array to the passed output type.
+ * @param data The binary data (numValues * getVtkDataTypeSize(dataType) bytes, no alignment requirements).
+ * @param dataType The type of the values stored in data.
+ * @param isBigEndian Whether the data is stored in big-endian byte order (as in legacy VTK BINARY files).
+ * @param numValues The number of values to convert.
+ * @param output The output array (with space for numValues values).
+ * @return False if the data type is invalid.
+ */
+template<class T>
+bool convertVtkDataArray(const char* data, VtkDataType dataType, bool isBigEndian, size_t numValues, T* output) {
+    bool swapBytes = isBigEndian != getIsHostBigEndian();
+    switch (dataType) {
+        case VTK_DATA_TYPE_INT8:
+            convertVtkDataArrayTyped<int8_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_UINT8:
+            convertVtkDataArrayTyped<uint8_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_INT16:
+            convertVtkDataArrayTyped<int16_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_UINT16:
+            convertVtkDataArrayTyped<uint16_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_INT32:
+            convertVtkDataArrayTyped<int32_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_UINT32:
+            convertVtkDataArrayTyped<uint32_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_INT64:
+            convertVtkDataArrayTyped<int64_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_UINT64:
+            convertVtkDataArrayTyped<uint64_t>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_FLOAT32:
+            convertVtkDataArrayTyped<float>(data, swapBytes, numValues, output);
+            return true;
+        case VTK_DATA_TYPE_FLOAT64:
+            convertVtkDataArrayTyped<double>(data, swapBytes, numValues, output);
+            return true;
+        default:
+            return false;
+    }
+}
+
+#endif // LOADERS_VTKBINARYDATA_HPP
@@ -33,11 +33,67 @@
 #include <glm/vec3.hpp>
 
 #include <Utils/File/Logfile.hpp>
-#include <Utils/Convert.hpp>
 
 #include "Mesh/HexMesh/HexMesh.hpp"
+#include "AsciiScanner.hpp"
+#include "VtkBinaryData.hpp"
 #include "VtkLoader.hpp"
 
+/// Maps the data type names used in legacy VTK files (e.g., "float" or "vtktypeint64") to VtkDataType.
+static VtkDataType parseLegacyVtkDataType(const AsciiScanner& line, size_t idx) {
+    if (line.tokenEquals(idx, "float")) {
+        return VTK_DATA_TYPE_FLOAT32;
+    } else if (line.tokenEquals(idx, "double")) {
+        return VTK_DATA_TYPE_FLOAT64;
+    } else if (line.tokenEquals(idx, "int") || line.tokenEquals(idx, "vtktypeint32")) {
+        return VTK_DATA_TYPE_INT32;
+    } else if (line.tokenEquals(idx, "unsigned_int") || line.tokenEquals(idx, "vtktypeuint32")) {
+        return VTK_DATA_TYPE_UINT32;
+    } else if (line.tokenEquals(idx, "long") || line.tokenEquals(idx, "vtktypeint64")
+            || line.tokenEquals(idx, "vtkIdType")) {
+        return VTK_DATA_TYPE_INT64;
+    } else if (line.tokenEquals(idx, "unsigned_long") || line.tokenEquals(idx, "vtktypeuint64")) {
+        return VTK_DATA_TYPE_UINT64;
+    } else if (line.tokenEquals(idx, "short")) {
+        return VTK_DATA_TYPE_INT16;
+    } else if (line.tokenEquals(idx, "unsigned_short")) {
+        return VTK_DATA_TYPE_UINT16;
+    } else if (line.tokenEquals(idx, "char")) {
+        return VTK_DATA_TYPE_INT8;
+    } else if (line.tokenEquals(idx, "unsigned_char")) {
+        return VTK_DATA_TYPE_UINT8;
+    }
+    return VTK_DATA_TYPE_INVALID;
+}
+
+/**
+ * In legacy BINARY files, the (big-endian) binary data directly follows the line break of the line declaring it.
+ * Reads numValues values of the passed type and advances the scanner behind the binary data.
+ * @param output The output array (may be nullptr for skipping the data).
+ * @return False if the data type is invalid or the file is too short.
+ */
+template<class T>
+static bool readLegacyBinaryArray(AsciiScanner& line, VtkDataType dataType, size_t numValues, T* output) {
+    const char* dataBegin = line.getPosition();
+    // Declarations in files written on Windows may end with "\r\n".
+    if (dataBegin < line.getEnd() && dataBegin[-1] == '\r' && *dataBegin == '\n') {
+        dataBegin++;
+    }
+    size_t numBytes = numValues * getVtkDataTypeSize(dataType);
+    if (dataType == VTK_DATA_TYPE_INVALID || size_t(line.getEnd() - dataBegin) < numBytes) {
+        return false;
+    }
+    if (output) {
+        convertVtkDataArray(dataBegin, dataType, true, numValues, output);
+    }
+    line.setPosition(dataBegin + numBytes, line.getLineNumber());
+    return true;
+}
+
+static bool skipLegacyBinaryArray(AsciiScanner& line, VtkDataType dataType, size_t numValues) {
+    return readLegacyBinaryArray(line, dataType, numValues, static_cast<float*>(nullptr));
+}
+
 bool VtkLoader::loadHexahedralMeshFromFile(
         const std::string& filename,
         std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
@@ -46,66 +102,59 @@ bool VtkLoader::loadHexahedralMeshFromFile(
     bool foundVersionHeader = false;
     bool foundTitle = false;
     bool foundType = false;
+    bool isBinary = false;
     bool foundDatasetType = false;
     bool foundPoints = false;
     bool foundCells = false;
     bool foundCellTypes = false;
-    bool isPointsReadMode = false;
-    int numPointsLeft = 0;
-    bool isCellsReadMode = false;
-    int numCellsLeft = 0;
+    uint64_t numPoints = 0;
+    uint64_t numCells = 0;
     bool isCellTypesReadMode = false;
-    int numCellTypesLeft = 0;
+    uint64_t numCellTypesLeft = 0;
     bool isCellDataReadMode = false;
-    int numCellDataLinesLeft = 0;
+    uint64_t numCellDataLinesLeft = 0;
     bool isPointDataReadMode = false;
-    int numPointDataLinesLeft = 0;
-    bool isDeformationDataReadMode = false;
-    int numDeformationDataLinesLeft = 0;
-    bool isAnisotropyMetricReadMode = false;
-    int numAnisotropyMetricLinesLeft = 0;
-
-    bool loadingSuccessful = readFileLineByLine(
-            filename, [&](const std::string& lineString, const std::vector<std::string>& tokens) {
-        if (isPointsReadMode) {
-            if (tokens.size() != 3) {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid number of point coordinates!");
-                return false;
-            }
-            vertices.push_back(glm::vec3(
-                    sgl::fromString<float>(tokens.at(0)),
-                    sgl::fromString<float>(tokens.at(1)),
-                    sgl::fromString<float>(tokens.at(2))));
-            numPointsLeft--;
-            if (numPointsLeft <= 0) {
-                isPointsReadMode = false;
-            }
-            return true;
-        }
+    uint64_t numPointDataLinesLeft = 0;
+    uint64_t numDeformationDataLines = 0;
+    uint64_t numAnisotropyMetricLines = 0;
 
-        if (isCellsReadMode) {
-            if (tokens.size() != 9 || tokens.at(0) != "8") {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid number of cell indices!");
-                return false;
-            }
-            for (int i = 0; i < 8; i++) {
-                cellIndices.push_back(sgl::fromString<uint32_t>(tokens.at(i + 1)));
-            }
-            numCellsLeft--;
-            if (numCellsLeft <= 0) {
-                isCellsReadMode = false;
-            }
-            return true;
+    // Point and cell data of binary files can't be skipped line by line and is thus parsed.
+    bool isAttributeSectionPerVertex = false;
+    uint64_t attributeSectionSize = 0;
+    bool isScalarsLookupTableExpected = false;
+    VtkDataType scalarsDataType = VTK_DATA_TYPE_INVALID;
+    uint64_t scalarsNumComponents = 1;
+    uint64_t numFieldArraysLeft = 0;
+
+    // The first scalar point or cell data array of a binary file is used as the attribute data.
+    auto readBinaryAttributeArray = [&](
+            AsciiScanner& line, VtkDataType dataType, uint64_t numComponents, uint64_t numTuples) {
+        if (numComponents == 1 && numTuples == attributeSectionSize && attributeList.empty()) {
+            attributeList.resize(size_t(numTuples));
+            isPerVertexData = isAttributeSectionPerVertex;
+            return readLegacyBinaryArray(line, dataType, size_t(numTuples), attributeList.data());
         }
+        return skipLegacyBinaryArray(line, dataType, size_t(numComponents * numTuples));
+    };
+
+    // Parses a section of numLines lines with three float values each (i.e., points or deformation vectors).
+    auto readVectors = [](AsciiScanner& line, uint64_t numLines, std::vector<glm::vec3>& output) {
+        return parseLinesParallel(
+                line, size_t(numLines), 1, output, [](const AsciiScanner& vectorLine, glm::vec3* vector) {
+            return vectorLine.getNumTokens() == 3 && vectorLine.parseToken(0, vector->x)
+                    && vectorLine.parseToken(1, vector->y) && vectorLine.parseToken(2, vector->z);
+        });
+    };
 
+    bool loadingSuccessful = readMappedFileLineByLine(filename, [&](AsciiScanner& line) {
         if (isCellTypesReadMode) {
             // Somehow, data sets from "2019 - Symmetric Moving Frames" have 10 / tetrahedron as cell type...
-            //if (tokens.size() != 1 || tokens.at(0) != "12") {
+            //if (line.getNumTokens() != 1 || !line.tokenEquals(0, "12")) {
             //    sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid cell type!");
             //    return false;
             //}
             numCellTypesLeft--;
-            if (numCellTypesLeft <= 0) {
+            if (numCellTypesLeft == 0) {
                 isCellTypesReadMode = false;
             }
             return true;
@@ -113,7 +162,7 @@ bool VtkLoader::loadHexahedralMeshFromFile(
 
         if (isCellDataReadMode) {
             numCellDataLinesLeft--;
-            if (numCellDataLinesLeft <= 0) {
+            if (numCellDataLinesLeft == 0) {
                 isCellDataReadMode = false;
             }
             return true;
@@ -121,44 +170,38 @@ bool VtkLoader::loadHexahedralMeshFromFile(
 
         if (isPointDataReadMode) {
             numPointDataLinesLeft--;
-            if (numPointDataLinesLeft <= 0) {
+            if (numPointDataLinesLeft == 0) {
                 isPointDataReadMode = false;
             }
             return true;
         }
 
-        if (isDeformationDataReadMode) {
-            if (tokens.size() != 3) {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid number of point coordinates!");
+        // Expecting: <array_name> <num_components> <num_tuples> <data_type>
+        if (numFieldArraysLeft > 0) {
+            uint64_t numComponents = 0, numTuples = 0;
+            if (line.getNumTokens() != 4 || !line.parseToken(1, numComponents) || !line.parseToken(2, numTuples)
+                    || !readBinaryAttributeArray(line, parseLegacyVtkDataType(line, 3), numComponents, numTuples)) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid field data array!");
                 return false;
             }
-            deformations.push_back(glm::vec3(
-                    sgl::fromString<float>(tokens.at(0)),
-                    sgl::fromString<float>(tokens.at(1)),
-                    sgl::fromString<float>(tokens.at(2))));
-            numDeformationDataLinesLeft--;
-            if (numDeformationDataLinesLeft <= 0) {
-                isDeformationDataReadMode = false;
-            }
+            numFieldArraysLeft--;
             return true;
         }
 
-        if (isAnisotropyMetricReadMode) {
-            if (tokens.size() != 1) {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Data is not scalar!");
+        // Expecting: LOOKUP_TABLE <table_name> (after SCALARS).
+        if (isScalarsLookupTableExpected) {
+            isScalarsLookupTableExpected = false;
+            if (!line.tokenEquals(0, "LOOKUP_TABLE")
+                    || !readBinaryAttributeArray(line, scalarsDataType, scalarsNumComponents, attributeSectionSize)) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid scalar data array!");
                 return false;
             }
-            attributeList.push_back(sgl::fromString<float>(tokens.at(0)));
-            numAnisotropyMetricLinesLeft--;
-            if (numAnisotropyMetricLinesLeft <= 0) {
-                isAnisotropyMetricReadMode = false;
-            }
             return true;
         }
 
-                // The version header must the first non-empty line!
+        // The version header must the first non-empty line!
         if (!foundVersionHeader) {
-            if (sgl::startsWith(lineString, "# vtk DataFile Version")) {
+            if (line.lineStartsWith("# vtk DataFile Version")) {
                 foundVersionHeader = true;
                 return true;
             } else {
@@ -177,8 +220,9 @@ bool VtkLoader::loadHexahedralMeshFromFile(
 
         // Next line is the type of data (ASCII vs BINARY).
         if (!foundType) {
-            if (tokens.at(0) == "ASCII") {
+            if (line.tokenEquals(0, "ASCII") || line.tokenEquals(0, "BINARY")) {
                 foundType = true;
+                isBinary = line.tokenEquals(0, "BINARY");
                 return true;
             } else {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid or unsupported type!");
@@ -187,8 +231,8 @@ bool VtkLoader::loadHexahedralMeshFromFile(
         }
 
         // Expecting: DATASET UNSTRUCTURED_GRID
-        if (!foundDatasetType && tokens.at(0) == "DATASET") {
-            if (tokens.size() != 2 || tokens.at(1) != "UNSTRUCTURED_GRID") {
+        if (!foundDatasetType && line.tokenEquals(0, "DATASET")) {
+            if (line.getNumTokens() != 2 || !line.tokenEquals(1, "UNSTRUCTURED_GRID")) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid or unsupported dataset type!");
                 return false;
             }
@@ -197,90 +241,220 @@ bool VtkLoader::loadHexahedralMeshFromFile(
         }
 
         // Expecting: POINTS <num_points> <data_type>
-        if (!foundPoints && tokens.at(0) == "POINTS") {
-            if (tokens.size() != 3) {
+        if (!foundPoints && line.tokenEquals(0, "POINTS")) {
+            if (line.getNumTokens() != 3 || !line.parseToken(1, numPoints)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed POINTS declaration!");
                 return false;
             }
-            numPointsLeft = sgl::fromString<size_t>(tokens.at(1));
             foundPoints = true;
-            isPointsReadMode = numPointsLeft > 0;
+            bool pointsValid;
+            if (isBinary) {
+                size_t offset = vertices.size();
+                vertices.resize(offset + size_t(numPoints));
+                pointsValid = readLegacyBinaryArray(
+                        line, parseLegacyVtkDataType(line, 2), size_t(numPoints) * 3,
+                        reinterpret_cast<float*>(vertices.data() + offset));
+            } else {
+                pointsValid = readVectors(line, numPoints, vertices);
+            }
+            if (!pointsValid) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid point coordinates!");
+                return false;
+            }
             return true;
         }
 
         // Expecting: CELLS <num_cells> <num_entries>
-        if (!foundCells && tokens.at(0) == "CELLS") {
-            if (tokens.size() != 3) {
-                sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed POINTS declaration!");
+        if (!foundCells && line.tokenEquals(0, "CELLS")) {
+            uint64_t numEntries = 0;
+            if (line.getNumTokens() != 3 || !line.parseToken(1, numCells) || !line.parseToken(2, numEntries)) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed CELLS declaration!");
                 return false;
             }
-            numCellsLeft = sgl::fromString<size_t>(tokens.at(1));
-            int numEntries = sgl::fromString<size_t>(tokens.at(2));
-            if (numEntries != numCellsLeft * 9) {
+            if (numEntries != numCells * 9) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid number of cell entries!");
                 return false;
             }
             foundCells = true;
-            isCellsReadMode = numCellsLeft > 0;
+            bool cellsValid;
+            if (isBinary) {
+                // Each cell is stored as the number of vertices (which needs to be 8) followed by the vertex indices.
+                std::vector<uint32_t> cellData(static_cast<size_t>(numEntries));
+                cellsValid = readLegacyBinaryArray(line, VTK_DATA_TYPE_INT32, cellData.size(), cellData.data());
+                size_t offset = cellIndices.size();
+                cellIndices.resize(offset + size_t(numCells) * 8);
+                // Negative indices are converted to values >= numPoints and are thus rejected, too.
+                for (size_t cellIdx = 0; cellsValid && cellIdx < size_t(numCells); cellIdx++) {
+                    cellsValid = cellData[cellIdx * 9] == 8;
+                    for (size_t i = 0; i < 8; i++) {
+                        uint32_t vertexIdx = cellData[cellIdx * 9 + i + 1];
+                        cellsValid = cellsValid && vertexIdx < numPoints;
+                        cellIndices[offset + cellIdx * 8 + i] = vertexIdx;
+                    }
+                }
+            } else {
+                cellsValid = parseLinesParallel(
+                        line, size_t(numCells), 8, cellIndices,
+                        [numPoints](const AsciiScanner& cellLine, uint32_t* cellVertices) {
+                    if (cellLine.getNumTokens() != 9 || !cellLine.tokenEquals(0, "8")) {
+                        return false;
+                    }
+                    for (int i = 0; i < 8; i++) {
+                        if (!cellLine.parseToken(i + 1, cellVertices[i]) || cellVertices[i] >= numPoints) {
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+            }
+            if (!cellsValid) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid hexahedral cell indices!");
+                return false;
+            }
             return true;
         }
 
         // Expecting: CELL_TYPES <num_cells>
-        if (!foundCellTypes && tokens.at(0) == "CELL_TYPES") {
-            if (tokens.size() != 2) {
+        if (!foundCellTypes && line.tokenEquals(0, "CELL_TYPES")) {
+            if (line.getNumTokens() != 2 || !line.parseToken(1, numCellTypesLeft)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed CELL_TYPES declaration!");
                 return false;
             }
-            numCellTypesLeft = sgl::fromString<size_t>(tokens.at(1));
             foundCellTypes = true;
+            if (isBinary) {
+                if (!skipLegacyBinaryArray(line, VTK_DATA_TYPE_INT32, size_t(numCellTypesLeft))) {
+                    sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid cell types!");
+                    return false;
+                }
+                return true;
+            }
             isCellTypesReadMode = numCellTypesLeft > 0;
             return true;
         }
 
-        // Ignore cell data
-        if (tokens.at(0) == "CELL_DATA") {
-            if (tokens.size() != 2) {
+        // Ignore cell data (or parse it in binary files)
+        if (line.tokenEquals(0, "CELL_DATA")) {
+            if (line.getNumTokens() != 2 || !line.parseToken(1, numCellDataLinesLeft)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed CELL_DATA declaration!");
                 return false;
             }
+            if (isBinary) {
+                isAttributeSectionPerVertex = false;
+                attributeSectionSize = numCellDataLinesLeft;
+                return true;
+            }
             // Number of entries + SCALARS + LOOKUP_TABLE information
-            numCellDataLinesLeft = sgl::fromString<size_t>(tokens.at(1)) + 2;
+            numCellDataLinesLeft += 2;
             isCellDataReadMode = true;
             return true;
         }
 
-        // Ignore point data
-        if (tokens.at(0) == "POINT_DATA") {
-            if (tokens.size() != 2) {
+        // Ignore point data (or parse it in binary files)
+        if (line.tokenEquals(0, "POINT_DATA")) {
+            if (line.getNumTokens() != 2 || !line.parseToken(1, numPointDataLinesLeft)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed POINT_DATA declaration!");
                 return false;
             }
+            if (isBinary) {
+                isAttributeSectionPerVertex = true;
+                attributeSectionSize = numPointDataLinesLeft;
+                return true;
+            }
             // Number of entries + SCALARS + LOOKUP_TABLE information
-            numPointDataLinesLeft = sgl::fromString<size_t>(tokens.at(1)) + 2;
+            numPointDataLinesLeft += 2;
             isPointDataReadMode = true;
             return true;
         }
 
+        if (isBinary && line.tokenEquals(0, "SCALARS")) {
+            // Expecting: SCALARS <data_name> <data_type> [<num_components>]
+            scalarsDataType = parseLegacyVtkDataType(line, 2);
+            scalarsNumComponents = 1;
+            if ((line.getNumTokens() != 3 && line.getNumTokens() != 4) || scalarsDataType == VTK_DATA_TYPE_INVALID
+                    || (line.getNumTokens() == 4 && !line.parseToken(3, scalarsNumComponents))) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed SCALARS declaration!");
+                return false;
+            }
+            isScalarsLookupTableExpected = true;
+            return true;
+        }
+
+        if (isBinary && line.tokenEquals(0, "FIELD")) {
+            // Expecting: FIELD <field_name> <num_arrays>
+            if (line.getNumTokens() != 3 || !line.parseToken(2, numFieldArraysLeft)) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed FIELD declaration!");
+                return false;
+            }
+            return true;
+        }
+
+        // Other attributes of binary files are skipped.
+        if (isBinary && (line.tokenEquals(0, "VECTORS") || line.tokenEquals(0, "NORMALS")
+                || line.tokenEquals(0, "TENSORS") || line.tokenEquals(0, "LOOKUP_TABLE"))) {
+            // Expecting: <attribute_type> <data_name> <data_type> (or LOOKUP_TABLE <table_name> <num_colors>)
+            uint64_t numValues = 0;
+            VtkDataType dataType = parseLegacyVtkDataType(line, 2);
+            if (line.tokenEquals(0, "LOOKUP_TABLE")) {
+                dataType = VTK_DATA_TYPE_UINT8;
+                line.parseToken(2, numValues);
+                numValues *= 4;
+            } else {
+                numValues = attributeSectionSize * (line.tokenEquals(0, "TENSORS") ? 9 : 3);
+            }
+            if (line.getNumTokens() != 3 || !skipLegacyBinaryArray(line, dataType, size_t(numValues))) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid attribute data!");
+                return false;
+            }
+            return true;
+        }
+
         // Read deformation data
-        if (tokens.at(0) == "Deformation") {
-            if (tokens.size() != 2) {
+        if (line.tokenEquals(0, "Deformation")) {
+            if (line.getNumTokens() != 2 || !line.parseToken(1, numDeformationDataLines)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed Deformation declaration!");
                 return false;
             }
-            numDeformationDataLinesLeft = sgl::fromString<size_t>(tokens.at(1));
-            isDeformationDataReadMode = true;
+            bool deformationsValid;
+            if (isBinary) {
+                size_t offset = deformations.size();
+                deformations.resize(offset + size_t(numDeformationDataLines));
+                deformationsValid = readLegacyBinaryArray(
+                        line, VTK_DATA_TYPE_FLOAT32, size_t(numDeformationDataLines) * 3,
+                        reinterpret_cast<float*>(deformations.data() + offset));
+            } else {
+                deformationsValid = readVectors(line, numDeformationDataLines, deformations);
+            }
+            if (!deformationsValid) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid deformation vectors!");
+                return false;
+            }
             return true;
         }
 
         // Read anisotropy metric data
-        if (tokens.at(0) == "AnisotropyMetric") {
-            if (tokens.size() != 2) {
+        if (line.tokenEquals(0, "AnisotropyMetric")) {
+            if (line.getNumTokens() != 2 || !line.parseToken(1, numAnisotropyMetricLines)) {
                 sgl::Logfile::get()->writeError("Error in VtkLoader: Malformed AnisotropyMetric declaration!");
                 return false;
             }
-            numAnisotropyMetricLinesLeft = sgl::fromString<size_t>(tokens.at(1));
-            isAnisotropyMetricReadMode = true;
             isPerVertexData = true;
+            bool attributesValid;
+            if (isBinary) {
+                size_t offset = attributeList.size();
+                attributeList.resize(offset + size_t(numAnisotropyMetricLines));
+                attributesValid = readLegacyBinaryArray(
+                        line, VTK_DATA_TYPE_FLOAT32, size_t(numAnisotropyMetricLines), attributeList.data() + offset);
+            } else {
+                attributesValid = parseLinesParallel(
+                        line, size_t(numAnisotropyMetricLines), 1, attributeList,
+                        [](const AsciiScanner& attributeLine, float* attributeValue) {
+                    return attributeLine.getNumTokens() == 1 && attributeLine.parseToken(0, *attributeValue);
+                });
+            }
+            if (!attributesValid) {
+                sgl::Logfile::get()->writeError("Error in VtkLoader: Invalid scalar anisotropy metric values!");
+                return false;
+            }
             return true;
         }
 
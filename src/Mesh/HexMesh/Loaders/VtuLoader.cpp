@@ -0,0 +1,382 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <zlib.h>
+#include <tinyxml2.h>
+#include <glm/vec3.hpp>
+
+#include <Utils/File/Logfile.hpp>
+
+#include "Utils/MappedFile.hpp"
+#include "VtkBinaryData.hpp"
+#include "VtuLoader.hpp"
+
+/// Information necessary for decoding the data arrays stored in the appended data section of a .vtu file.
+struct VtuAppendedData {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    bool isBigEndian = false;
+    bool isCompressed = false;
+    size_t headerSize = 4; ///< The size of the block headers (header_type UInt32 or UInt64).
+};
+
+static VtkDataType parseXmlVtkDataType(const char* typeName) {
+    if (typeName == nullptr) {
+        return VTK_DATA_TYPE_INVALID;
+    }
+    const char* typeNames[] = {
+            "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32", "Int64", "UInt64", "Float32", "Float64"
+    };
+    const VtkDataType dataTypes[] = {
+            VTK_DATA_TYPE_INT8, VTK_DATA_TYPE_UINT8, VTK_DATA_TYPE_INT16, VTK_DATA_TYPE_UINT16,
+            VTK_DATA_TYPE_INT32, VTK_DATA_TYPE_UINT32, VTK_DATA_TYPE_INT64, VTK_DATA_TYPE_UINT64,
+            VTK_DATA_TYPE_FLOAT32, VTK_DATA_TYPE_FLOAT64
+    };
+    for (size_t i = 0; i < sizeof(dataTypes) / sizeof(*dataTypes); i++) {
+        if (strcmp(typeName, typeNames[i]) == 0) {
+            return dataTypes[i];
+        }
+    }
+    return VTK_DATA_TYPE_INVALID;
+}
+
+static const tinyxml2::XMLElement* findDataArray(const tinyxml2::XMLElement* parentElement, const char* name) {
+    if (parentElement == nullptr) {
+        return nullptr;
+    }
+    for (const tinyxml2::XMLElement* dataArrayElement = parentElement->FirstChildElement("DataArray");
+            dataArrayElement != nullptr; dataArrayElement = dataArrayElement->NextSiblingElement("DataArray")) {
+        if (dataArrayElement->Attribute("Name", name)) {
+            return dataArrayElement;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the active scalar data array of a PointData or CellData element (or the first array with one component).
+ */
+static const tinyxml2::XMLElement* findScalarDataArray(const tinyxml2::XMLElement* dataElement) {
+    if (dataElement == nullptr) {
+        return nullptr;
+    }
+    const char* activeScalarsName = dataElement->Attribute("Scalars");
+    if (activeScalarsName != nullptr) {
+        const tinyxml2::XMLElement* dataArrayElement = findDataArray(dataElement, activeScalarsName);
+        if (dataArrayElement != nullptr && dataArrayElement->IntAttribute("NumberOfComponents", 1) == 1) {
+            return dataArrayElement;
+        }
+    }
+    for (const tinyxml2::XMLElement* dataArrayElement = dataElement->FirstChildElement("DataArray");
+            dataArrayElement != nullptr; dataArrayElement = dataArrayElement->NextSiblingElement("DataArray")) {
+        if (dataArrayElement->IntAttribute("NumberOfComponents", 1) == 1) {
+            return dataArrayElement;
+        }
+    }
+    return nullptr;
+}
+
+static bool readHeaderValue(const VtuAppendedData& appendedData, const char*& ptr, uint64_t& value) {
+    if (size_t(appendedData.end - ptr) < appendedData.headerSize) {
+        return false;
+    }
+    bool swapBytes = appendedData.isBigEndian != getIsHostBigEndian();
+    if (appendedData.headerSize == 8) {
+        value = readVtkValue<uint64_t>(ptr, swapBytes);
+    } else {
+        value = readVtkValue<uint32_t>(ptr, swapBytes);
+    }
+    ptr += appendedData.headerSize;
+    return true;
+}
+
+/**
+ * Reads a data array from the appended data section and converts it to the output type.
+ * Compressed data is stored in blocks (header: number of blocks, block size, size of the last block, compressed size
+ * of each block), which are decompressed in parallel.
+ * @param appendedData The appended data section of the file.
+ * @param dataArrayElement The DataArray element.
+ * @param numValues The number of values to read (i.e., number of tuples times number of components).
+ * @param output The output array (with space for numValues values).
+ * @return Whether the data array could be read.
+ */
+template<class T>
+static bool readVtuDataArray(
+        const VtuAppendedData& appendedData, const tinyxml2::XMLElement* dataArrayElement,
+        size_t numValues, T* output) {
+    const char* dataArrayName = dataArrayElement->Attribute("Name");
+    std::string errorPrefix =
+            std::string() + "Error in VtuLoader: Data array \"" + (dataArrayName ? dataArrayName : "") + "\": ";
+    if (appendedData.begin == nullptr || !dataArrayElement->Attribute("format", "appended")) {
+        sgl::Logfile::get()->writeError(errorPrefix + "Only data arrays stored as raw appended data are supported.");
+        return false;
+    }
+    VtkDataType dataType = parseXmlVtkDataType(dataArrayElement->Attribute("type"));
+    int64_t offset = 0;
+    if (dataType == VTK_DATA_TYPE_INVALID
+            || dataArrayElement->QueryInt64Attribute("offset", &offset) != tinyxml2::XML_SUCCESS
+            || offset < 0 || uint64_t(offset) >= uint64_t(appendedData.end - appendedData.begin)) {
+        sgl::Logfile::get()->writeError(errorPrefix + "Invalid type or offset.");
+        return false;
+    }
+    size_t numBytes = numValues * getVtkDataTypeSize(dataType);
+
+    const char* ptr = appendedData.begin + offset;
+    const char* data = nullptr;
+    std::vector<char> decompressedData;
+    if (!appendedData.isCompressed) {
+        uint64_t dataSize = 0;
+        if (!readHeaderValue(appendedData, ptr, dataSize) || dataSize < numBytes
+                || uint64_t(appendedData.end - ptr) < dataSize) {
+            sgl::Logfile::get()->writeError(errorPrefix + "Invalid data size.");
+            return false;
+        }
+        data = ptr;
+    } else {
+        uint64_t numBlocks = 0, blockSize = 0, lastBlockSize = 0;
+        if (!readHeaderValue(appendedData, ptr, numBlocks) || !readHeaderValue(appendedData, ptr, blockSize)
+                || !readHeaderValue(appendedData, ptr, lastBlockSize)
+                || numBlocks > uint64_t(appendedData.end - ptr) / appendedData.headerSize) {
+            sgl::Logfile::get()->writeError(errorPrefix + "Invalid compression header.");
+            return false;
+        }
+
+        // The last block is only smaller than the other blocks if lastBlockSize is not zero.
+        std::vector<uint64_t> compressedBlockOffsets(size_t(numBlocks) + 1, 0);
+        for (size_t blockIdx = 0; blockIdx < size_t(numBlocks); blockIdx++) {
+            uint64_t compressedBlockSize = 0;
+            readHeaderValue(appendedData, ptr, compressedBlockSize);
+            compressedBlockOffsets[blockIdx + 1] = compressedBlockOffsets[blockIdx] + compressedBlockSize;
+        }
+        uint64_t uncompressedSize = 0;
+        if (numBlocks > 0) {
+            uncompressedSize = (numBlocks - 1) * blockSize + (lastBlockSize == 0 ? blockSize : lastBlockSize);
+        }
+        if (uncompressedSize < numBytes || compressedBlockOffsets.back() > uint64_t(appendedData.end - ptr)) {
+            sgl::Logfile::get()->writeError(errorPrefix + "Invalid compressed data size.");
+            return false;
+        }
+
+        decompressedData.resize(size_t(uncompressedSize));
+        bool decompressionFailed = false;
+        const char* compressedData = ptr;
+        size_t numBlocksSizeT = size_t(numBlocks);
+        size_t blockSizeSizeT = size_t(blockSize);
+        size_t uncompressedSizeSizeT = size_t(uncompressedSize);
+#if _OPENMP >= 201107
+        #pragma omp parallel for default(none) schedule(dynamic) shared(decompressedData, decompressionFailed) \
+        shared(compressedData, compressedBlockOffsets, numBlocksSizeT, blockSizeSizeT, uncompressedSizeSizeT)
+#endif
+        for (size_t blockIdx = 0; blockIdx < numBlocksSizeT; blockIdx++) {
+            size_t blockStart = blockIdx * blockSizeSizeT;
+            size_t blockEnd = std::min(blockStart + blockSizeSizeT, uncompressedSizeSizeT);
+            uLongf decompressedBlockSize = uLongf(blockEnd - blockStart);
+            int errorCode = uncompress(
+                    reinterpret_cast<Bytef*>(decompressedData.data() + blockStart), &decompressedBlockSize,
+                    reinterpret_cast<const Bytef*>(compressedData + compressedBlockOffsets[blockIdx]),
+                    uLong(compressedBlockOffsets[blockIdx + 1] - compressedBlockOffsets[blockIdx]));
+            if (errorCode != Z_OK || decompressedBlockSize != uLongf(blockEnd - blockStart)) {
+                decompressionFailed = true;
+            }
+        }
+        if (decompressionFailed) {
+            sgl::Logfile::get()->writeError(errorPrefix + "Decompression failed.");
+            return false;
+        }
+        data = decompressedData.data();
+    }
+
+    return convertVtkDataArray(data, dataType, appendedData.isBigEndian, numValues, output);
+}
+
+bool VtuLoader::loadHexahedralMeshFromFile(
+        const std::string& filename,
+        std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+        std::vector<glm::vec3>& deformations, std::vector<float>& attributeList,
+        bool& isPerVertexData) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        sgl::Logfile::get()->writeError("Error in VtuLoader: Couldn't open file \"" + filename + "\".");
+        return false;
+    }
+
+    // The appended data may contain arbitrary bytes and is thus excluded from XML parsing.
+    VtuAppendedData appendedData;
+    const char* xmlEnd = file.end();
+    const char appendedDataTagName[] = "<AppendedData";
+    const char* appendedDataTag = std::search(
+            file.begin(), file.end(), appendedDataTagName, appendedDataTagName + strlen(appendedDataTagName));
+    if (appendedDataTag != file.end()) {
+        const char* appendedDataTagEnd = std::find(appendedDataTag, file.end(), '>');
+        const char* appendedDataMarker = std::find(appendedDataTagEnd, file.end(), '_');
+        if (appendedDataMarker == file.end()
+                || std::string(appendedDataTag, appendedDataTagEnd).find("raw") == std::string::npos) {
+            sgl::Logfile::get()->writeError(
+                    "Error in VtuLoader: Only raw appended data is supported (no base64 encoding).");
+            return false;
+        }
+        appendedData.begin = appendedDataMarker + 1;
+        appendedData.end = file.end();
+        xmlEnd = appendedDataTag;
+    }
+    std::string xmlString(file.begin(), xmlEnd);
+    if (appendedData.begin != nullptr) {
+        xmlString += "</VTKFile>";
+    }
+
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(xmlString.c_str(), xmlString.size()) != tinyxml2::XML_SUCCESS) {
+        sgl::Logfile::get()->writeError("Error in VtuLoader: Couldn't parse the XML data of \"" + filename + "\".");
+        return false;
+    }
+    const tinyxml2::XMLElement* vtkFileElement = doc.FirstChildElement("VTKFile");
+    const tinyxml2::XMLElement* gridElement =
+            vtkFileElement ? vtkFileElement->FirstChildElement("UnstructuredGrid") : nullptr;
+    if (gridElement == nullptr || !vtkFileElement->Attribute("type", "UnstructuredGrid")) {
+        sgl::Logfile::get()->writeError("Error in VtuLoader: The file is no VTK UnstructuredGrid file.");
+        return false;
+    }
+    appendedData.isBigEndian = vtkFileElement->Attribute("byte_order", "BigEndian") != nullptr;
+    appendedData.headerSize = vtkFileElement->Attribute("header_type", "UInt64") != nullptr ? 8 : 4;
+    const char* compressor = vtkFileElement->Attribute("compressor");
+    if (compressor != nullptr) {
+        if (strcmp(compressor, "vtkZLibDataCompressor") != 0) {
+            sgl::Logfile::get()->writeError(
+                    std::string() + "Error in VtuLoader: Unsupported compressor \"" + compressor + "\".");
+            return false;
+        }
+        appendedData.isCompressed = true;
+    }
+
+    // Pieces are merged into one mesh. Attributes are only used if all pieces store the same kind of data.
+    bool useAttributes = true;
+    bool isFirstPiece = true;
+    for (const tinyxml2::XMLElement* pieceElement = gridElement->FirstChildElement("Piece");
+            pieceElement != nullptr; pieceElement = pieceElement->NextSiblingElement("Piece")) {
+        int64_t numPoints = 0, numCells = 0;
+        if (pieceElement->QueryInt64Attribute("NumberOfPoints", &numPoints) != tinyxml2::XML_SUCCESS
+                || pieceElement->QueryInt64Attribute("NumberOfCells", &numCells) != tinyxml2::XML_SUCCESS
+                || numPoints < 0 || numCells < 0) {
+            sgl::Logfile::get()->writeError("Error in VtuLoader: Malformed Piece element.");
+            return false;
+        }
+
+        const tinyxml2::XMLElement* pointsElement = pieceElement->FirstChildElement("Points");
+        const tinyxml2::XMLElement* pointsArrayElement =
+                pointsElement ? pointsElement->FirstChildElement("DataArray") : nullptr;
+        if (pointsArrayElement == nullptr || pointsArrayElement->IntAttribute("NumberOfComponents", 1) != 3) {
+            sgl::Logfile::get()->writeError("Error in VtuLoader: Missing or malformed point data array.");
+            return false;
+        }
+        size_t vertexOffset = vertices.size();
+        vertices.resize(vertexOffset + size_t(numPoints));
+        if (!readVtuDataArray(
+                appendedData, pointsArrayElement, size_t(numPoints) * 3,
+                reinterpret_cast<float*>(vertices.data() + vertexOffset))) {
+            return false;
+        }
+
+        // Only hexahedral cells are supported, i.e., each cell needs to be of type VTK_HEXAHEDRON with eight vertices.
+        // VTK_VOXEL cells also have eight vertices, but a different vertex order, and are thus rejected, too.
+        const tinyxml2::XMLElement* cellsElement = pieceElement->FirstChildElement("Cells");
+        const tinyxml2::XMLElement* connectivityArrayElement = findDataArray(cellsElement, "connectivity");
+        const tinyxml2::XMLElement* offsetsArrayElement = findDataArray(cellsElement, "offsets");
+        const tinyxml2::XMLElement* typesArrayElement = findDataArray(cellsElement, "types");
+        if (connectivityArrayElement == nullptr || offsetsArrayElement == nullptr || typesArrayElement == nullptr) {
+            sgl::Logfile::get()->writeError(
+                    "Error in VtuLoader: Missing cell connectivity, offsets or types data array.");
+            return false;
+        }
+        std::vector<uint64_t> cellOffsets(static_cast<size_t>(numCells));
+        if (!readVtuDataArray(appendedData, offsetsArrayElement, cellOffsets.size(), cellOffsets.data())) {
+            return false;
+        }
+        std::vector<int64_t> cellTypes(static_cast<size_t>(numCells));
+        if (!readVtuDataArray(appendedData, typesArrayElement, cellTypes.size(), cellTypes.data())) {
+            return false;
+        }
+        const int64_t VTK_HEXAHEDRON = 12;
+        for (size_t cellIdx = 0; cellIdx < cellOffsets.size(); cellIdx++) {
+            if (cellTypes.at(cellIdx) != VTK_HEXAHEDRON || cellOffsets.at(cellIdx) != (cellIdx + 1) * 8) {
+                sgl::Logfile::get()->writeError("Error in VtuLoader: Only hexahedral cells are supported.");
+                return false;
+            }
+        }
+        size_t cellIndexOffset = cellIndices.size();
+        cellIndices.resize(cellIndexOffset + size_t(numCells) * 8);
+        if (!readVtuDataArray(
+                appendedData, connectivityArrayElement, size_t(numCells) * 8, cellIndices.data() + cellIndexOffset)) {
+            return false;
+        }
+        // The indices are local to the piece. Negative indices are converted to values >= numPoints and are thus
+        // rejected, too.
+        for (size_t i = cellIndexOffset; i < cellIndices.size(); i++) {
+            if (cellIndices.at(i) >= uint64_t(numPoints)) {
+                sgl::Logfile::get()->writeError("Error in VtuLoader: Invalid vertex index in the cell connectivity.");
+                return false;
+            }
+            cellIndices.at(i) += uint32_t(vertexOffset);
+        }
+
+        // Use the active scalar point data array (or cell data array if no point data exists) as attribute data.
+        if (useAttributes) {
+            bool isPieceDataPerVertex = true;
+            const tinyxml2::XMLElement* scalarArrayElement =
+                    findScalarDataArray(pieceElement->FirstChildElement("PointData"));
+            if (scalarArrayElement == nullptr) {
+                isPieceDataPerVertex = false;
+                scalarArrayElement = findScalarDataArray(pieceElement->FirstChildElement("CellData"));
+            }
+            if (scalarArrayElement == nullptr || (!isFirstPiece && isPieceDataPerVertex != isPerVertexData)) {
+                useAttributes = false;
+                attributeList.clear();
+            } else {
+                isPerVertexData = isPieceDataPerVertex;
+                size_t numAttributes = size_t(isPieceDataPerVertex ? numPoints : numCells);
+                size_t attributeOffset = attributeList.size();
+                attributeList.resize(attributeOffset + numAttributes);
+                if (!readVtuDataArray(
+                        appendedData, scalarArrayElement, numAttributes, attributeList.data() + attributeOffset)) {
+                    return false;
+                }
+            }
+        }
+        isFirstPiece = false;
+    }
+
+    if (isFirstPiece) {
+        sgl::Logfile::get()->writeError("Error in VtuLoader: The file contains no Piece element.");
+        return false;
+    }
+    return true;
+}
@@ -26,39 +26,22 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef HEXVOLUMERENDERER_EDGEKEY_HPP
-#define HEXVOLUMERENDERER_EDGEKEY_HPP
+#ifndef LOADERS_VTULOADER_HPP
+#define LOADERS_VTULOADER_HPP
 
-#include <algorithm>
-#include <unordered_set>
+#include "HexahedralMeshLoader.hpp"
 
-struct EdgeKey {
-    EdgeKey(uint32_t id0, uint32_t id1) {
-        edgeIds[0] = id0;
-        edgeIds[1] = id1;
-        std::sort(std::begin(edgeIds), std::end(edgeIds));
-    }
-
-    bool operator==(const EdgeKey& rhs) const {
-        for (int i = 0; i < 2; i++) {
-            if (edgeIds[i] != rhs.edgeIds[i]) {
-                return false;
-            }
-        }
-        return true;
-    }
-
-    uint32_t edgeIds[2];
-};
-
-// Hash Function: H(i,j) = (i0*p_1 xor i1*jp_2) mod n
-struct EdgeKeyHasher {
-    std::size_t operator()(const EdgeKey& key) const {
-        const size_t PRIME_NUMBERS[] = { 12582917, 3145739 };
-        return (key.edgeIds[0] * PRIME_NUMBERS[0]) ^ (key.edgeIds[1] * PRIME_NUMBERS[1]);
-    }
+/**
+ * For XML .vtu files (VTK UnstructuredGrid). The data arrays need to be stored in raw appended data, which may be
+ * compressed using zlib. The first scalar point or cell data array is loaded as the attribute data.
+ */
+class VtuLoader : public HexahedralMeshLoader {
+public:
+    virtual bool loadHexahedralMeshFromFile(
+            const std::string& filename,
+            std::vector<glm::vec3>& vertices, std::vector<uint32_t>& cellIndices,
+            std::vector<glm::vec3>& deformations, std::vector<float>& attributeList,
+            bool& isPerVertexData);
 };
 
-typedef std::unordered_map<EdgeKey, uint32_t, EdgeKeyHasher> EdgeMap;
-
-#endif //HEXVOLUMERENDERER_EDGEKEY_HPP
+#endif // LOADERS_VTULOADER_HPP
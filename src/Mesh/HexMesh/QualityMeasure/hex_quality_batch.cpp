@@ -0,0 +1,747 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HEX_QUALITY_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEX_QUALITY_BATCH_SSE2
+#endif
+
+#include "hex_quality_batch.h"
+
+namespace HexaLab {
+
+namespace {
+
+/*
+ * Lanes holds one float per cell of a (partial) batch, and Mask holds the result of a lane-wise comparison.
+ * min and max have the semantics of std::min(a, b) and std::max(a, b) (also with regard to NaN), such that folding
+ * them over an array gives the same result as std::min_element and std::max_element in hex_quality.h.
+ */
+#if defined(HEX_QUALITY_BATCH_AVX2)
+
+struct Lanes {
+    static const size_t width = 8;
+    Lanes() {}
+    Lanes(__m256 v) : v(v) {}
+    Lanes(float f) : v(_mm256_set1_ps(f)) {}
+    static inline Lanes load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+    inline void store(float* ptr) const { _mm256_storeu_ps(ptr, v); }
+    __m256 v;
+};
+
+struct Mask {
+    Mask(__m256 v) : v(v) {}
+    explicit Mask(bool b) : v(_mm256_castsi256_ps(_mm256_set1_epi32(b ? -1 : 0))) {}
+    __m256 v;
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return _mm256_add_ps(a.v, b.v); }
+inline Lanes operator-(Lanes a, Lanes b) { return _mm256_sub_ps(a.v, b.v); }
+inline Lanes operator*(Lanes a, Lanes b) { return _mm256_mul_ps(a.v, b.v); }
+inline Lanes operator/(Lanes a, Lanes b) { return _mm256_div_ps(a.v, b.v); }
+inline Lanes operator-(Lanes a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+inline Mask operator<(Lanes a, Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline Mask operator<=(Lanes a, Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+inline Mask operator>(Lanes a, Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+inline Mask operator==(Lanes a, Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+inline Mask operator|(Mask a, Mask b) { return _mm256_or_ps(a.v, b.v); }
+inline Mask operator!(Mask a) { return _mm256_xor_ps(a.v, Mask(true).v); }
+/// Lane-wise mask ? a : b.
+inline Lanes select(Mask mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+inline Lanes sqrt(Lanes a) { return _mm256_sqrt_ps(a.v); }
+inline Lanes abs(Lanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline Lanes min(Lanes a, Lanes b) { return _mm256_min_ps(b.v, a.v); }
+inline Lanes max(Lanes a, Lanes b) { return _mm256_max_ps(b.v, a.v); }
+/// Approximates the cube root of positive values by dividing the exponent (and mantissa) bits by three.
+inline Lanes cbrtEstimate(Lanes a) {
+    __m256i bits = _mm256_castps_si256(a.v);
+    bits = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(bits), _mm256_set1_ps(1.0f / 3.0f)));
+    return _mm256_castsi256_ps(_mm256_add_epi32(bits, _mm256_set1_epi32(709921077)));
+}
+
+#elif defined(HEX_QUALITY_BATCH_SSE2)
+
+struct Lanes {
+    static const size_t width = 4;
+    Lanes() {}
+    Lanes(__m128 v) : v(v) {}
+    Lanes(float f) : v(_mm_set1_ps(f)) {}
+    static inline Lanes load(const float* ptr) { return _mm_loadu_ps(ptr); }
+    inline void store(float* ptr) const { _mm_storeu_ps(ptr, v); }
+    __m128 v;
+};
+
+struct Mask {
+    Mask(__m128 v) : v(v) {}
+    explicit Mask(bool b) : v(_mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0))) {}
+    __m128 v;
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return _mm_add_ps(a.v, b.v); }
+inline Lanes operator-(Lanes a, Lanes b) { return _mm_sub_ps(a.v, b.v); }
+inline Lanes operator*(Lanes a, Lanes b) { return _mm_mul_ps(a.v, b.v); }
+inline Lanes operator/(Lanes a, Lanes b) { return _mm_div_ps(a.v, b.v); }
+inline Lanes operator-(Lanes a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+inline Mask operator<(Lanes a, Lanes b) { return _mm_cmplt_ps(a.v, b.v); }
+inline Mask operator<=(Lanes a, Lanes b) { return _mm_cmple_ps(a.v, b.v); }
+inline Mask operator>(Lanes a, Lanes b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline Mask operator==(Lanes a, Lanes b) { return _mm_cmpeq_ps(a.v, b.v); }
+inline Mask operator|(Mask a, Mask b) { return _mm_or_ps(a.v, b.v); }
+inline Mask operator!(Mask a) { return _mm_xor_ps(a.v, Mask(true).v); }
+/// Lane-wise mask ? a : b.
+inline Lanes select(Mask mask, Lanes a, Lanes b) {
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+inline Lanes sqrt(Lanes a) { return _mm_sqrt_ps(a.v); }
+inline Lanes abs(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline Lanes min(Lanes a, Lanes b) { return _mm_min_ps(b.v, a.v); }
+inline Lanes max(Lanes a, Lanes b) { return _mm_max_ps(b.v, a.v); }
+/// Approximates the cube root of positive values by dividing the exponent (and mantissa) bits by three.
+inline Lanes cbrtEstimate(Lanes a) {
+    __m128i bits = _mm_castps_si128(a.v);
+    bits = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(1.0f / 3.0f)));
+    return _mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(709921077)));
+}
+
+#else
+
+struct Lanes {
+    static const size_t width = 1;
+    Lanes() {}
+    Lanes(float f) : v(f) {}
+    static inline Lanes load(const float* ptr) { return *ptr; }
+    inline void store(float* ptr) const { *ptr = v; }
+    float v;
+};
+
+struct Mask {
+    explicit Mask(bool b) : v(b) {}
+    bool v;
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return a.v + b.v; }
+inline Lanes operator-(Lanes a, Lanes b) { return a.v - b.v; }
+inline Lanes operator*(Lanes a, Lanes b) { return a.v * b.v; }
+inline Lanes operator/(Lanes a, Lanes b) { return a.v / b.v; }
+inline Lanes operator-(Lanes a) { return -a.v; }
+inline Mask operator<(Lanes a, Lanes b) { return Mask(a.v < b.v); }
+inline Mask operator<=(Lanes a, Lanes b) { return Mask(a.v <= b.v); }
+inline Mask operator>(Lanes a, Lanes b) { return Mask(a.v > b.v); }
+inline Mask operator==(Lanes a, Lanes b) { return Mask(a.v == b.v); }
+inline Mask operator|(Mask a, Mask b) { return Mask(a.v || b.v); }
+inline Mask operator!(Mask a) { return Mask(!a.v); }
+/// Lane-wise mask ? a : b.
+inline Lanes select(Mask mask, Lanes a, Lanes b) { return mask.v ? a : b; }
+inline Lanes sqrt(Lanes a) { return std::sqrt(a.v); }
+inline Lanes abs(Lanes a) { return std::fabs(a.v); }
+inline Lanes min(Lanes a, Lanes b) { return (b.v < a.v) ? b : a; }
+inline Lanes max(Lanes a, Lanes b) { return (a.v < b.v) ? b : a; }
+/// Approximates the cube root of positive values by dividing the exponent (and mantissa) bits by three.
+inline Lanes cbrtEstimate(Lanes a) {
+    int32_t bits;
+    memcpy(&bits, &a.v, sizeof(float));
+    bits = bits / 3 + 709921077;
+    float estimate;
+    memcpy(&estimate, &bits, sizeof(float));
+    return estimate;
+}
+
+#endif
+
+const float FLOAT_MIN = std::numeric_limits<float>::min();
+const float FLOAT_MAX = std::numeric_limits<float>::max();
+
+/// Cube root of positive values. Three Newton steps bring the estimate to full float precision.
+inline Lanes cbrt(Lanes a) {
+    Lanes y = cbrtEstimate(a);
+    for (int i = 0; i < 3; i++) {
+        y = (y + y + a / (y * y)) * Lanes(1.0f / 3.0f);
+    }
+    return y;
+}
+
+inline Lanes minElement(const Lanes* values, int size) {
+    Lanes smallest = values[0];
+    for (int i = 1; i < size; i++) {
+        smallest = min(smallest, values[i]);
+    }
+    return smallest;
+}
+
+inline Lanes maxElement(const Lanes* values, int size) {
+    Lanes largest = values[0];
+    for (int i = 1; i < size; i++) {
+        largest = max(largest, values[i]);
+    }
+    return largest;
+}
+
+struct Vec3 {
+    Lanes x, y, z;
+};
+
+inline Vec3 operator+(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline Vec3 operator-(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline Vec3 operator-(const Vec3& a) { return { -a.x, -a.y, -a.z }; }
+inline Lanes dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y };
+}
+inline Lanes length(const Vec3& a) { return sqrt(dot(a, a)); }
+inline Vec3 normalize(const Vec3& a) {
+    Lanes invLength = Lanes(1.0f) / sqrt(dot(a, a));
+    return { a.x * invLength, a.y * invLength, a.z * invLength };
+}
+
+/*
+ * The helpers and measures below mirror the scalar versions in hex_quality.h (see there for the corner order).
+ * Early returns for degenerate cells are replaced by masks selecting the corresponding result per lane.
+ */
+
+inline void norms(const Vec3 vec[], const int size, Lanes norms[]) {
+    for (int i = 0; i < size; i++) {
+        norms[i] = length(vec[i]);
+    }
+}
+
+inline void hexEdges(const Vec3 p[8], Vec3 L[12], const bool normalized) {
+    L[0] = p[1] - p[0];    L[4] = p[4] - p[0];    L[8]  = p[5] - p[4];
+    L[1] = p[2] - p[1];    L[5] = p[5] - p[1];    L[9]  = p[6] - p[5];
+    L[2] = p[3] - p[2];    L[6] = p[6] - p[2];    L[10] = p[7] - p[6];
+    L[3] = p[3] - p[0];    L[7] = p[7] - p[3];    L[11] = p[7] - p[4];
+
+    if (normalized) for (int i = 0; i < 12; i++) L[i] = normalize(L[i]);
+}
+
+inline void hexPrincipalAxes(const Vec3 p[8], Vec3 X[3], const bool normalized) {
+    X[0] = (p[1] - p[0]) + (p[2] - p[3]) + (p[5] - p[4]) + (p[6] - p[7]);
+    X[1] = (p[3] - p[0]) + (p[2] - p[1]) + (p[7] - p[4]) + (p[6] - p[5]);
+    X[2] = (p[4] - p[0]) + (p[5] - p[1]) + (p[6] - p[2]) + (p[7] - p[3]);
+
+    if (normalized) for (int i = 0; i < 3; i++) X[i] = normalize(X[i]);
+}
+
+inline void hexCrossDerivatives(const Vec3 p[8], Vec3 XX[3]) {
+    XX[0] = (p[2] - p[3]) - (p[1] - p[0]) + (p[6] - p[7]) - (p[5] - p[4]);
+    XX[1] = (p[5] - p[1]) - (p[4] - p[0]) + (p[6] - p[2]) - (p[7] - p[3]);
+    XX[2] = (p[7] - p[4]) - (p[3] - p[0]) + (p[6] - p[5]) - (p[2] - p[1]);
+}
+
+inline void hexDiagonals(const Vec3 p[8], Vec3 D[4]) {
+    D[0] = p[6] - p[0];
+    D[1] = p[7] - p[1];
+    D[2] = p[4] - p[2];
+    D[3] = p[5] - p[3];
+}
+
+inline void hexSubtets(const Vec3 L[], const Vec3 X[], const int id, Vec3 tet[]) {
+    switch (id) {
+        case 0: tet[0] = L[0];   tet[1] = L[3];   tet[2] = L[4];  break;
+        case 1: tet[0] = L[1];   tet[1] = -L[0];  tet[2] = L[5];  break;
+        case 2: tet[0] = L[2];   tet[1] = -L[1];  tet[2] = L[6];  break;
+        case 3: tet[0] = -L[3];  tet[1] = -L[2];  tet[2] = L[7];  break;
+        case 4: tet[0] = L[11];  tet[1] = L[8];   tet[2] = -L[4]; break;
+        case 5: tet[0] = -L[8];  tet[1] = L[9];   tet[2] = -L[5]; break;
+        case 6: tet[0] = -L[9];  tet[1] = L[10];  tet[2] = -L[6]; break;
+        case 7: tet[0] = -L[10]; tet[1] = -L[11]; tet[2] = -L[7]; break;
+        case 8: tet[0] = X[0];   tet[1] = X[1];   tet[2] = X[2];  break;
+    }
+}
+
+inline Lanes determinant(const Vec3& col0, const Vec3& col1, const Vec3& col2) {
+    return dot(col0, cross(col1, col2));
+}
+
+inline Lanes frobenius(const Vec3& col0, const Vec3& col1, const Vec3& col2) {
+    Lanes det = determinant(col0, col1, col2);
+    Lanes term1 = dot(col0, col0) + dot(col1, col1) + dot(col2, col2);
+    Vec3 cross01 = cross(col0, col1);
+    Vec3 cross12 = cross(col1, col2);
+    Vec3 cross20 = cross(col2, col0);
+    Lanes term2 = dot(cross01, cross01) + dot(cross12, cross12) + dot(cross20, cross20);
+    Lanes frob = sqrt(term1 * term2) / det;
+    return select(det <= Lanes(FLOAT_MIN), Lanes(FLOAT_MAX), frob / Lanes(3.0f));
+}
+
+Lanes diagonal(const Vec3 p[8], const void* arg) {
+    Vec3 D[4];
+    Lanes D_norms[4];
+    hexDiagonals(p, D);
+    norms(D, 4, D_norms);
+    return minElement(D_norms, 4) / maxElement(D_norms, 4);
+}
+
+Lanes dimension(const Vec3 p[8], const void* arg) {
+    return Lanes(-1.0f);
+}
+
+Lanes distortion(const Vec3 p[8], const void* arg) {
+    return Lanes(-1.0f);
+}
+
+Lanes edgeRatio(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Lanes L_norms[12];
+    hexEdges(p, L, false);
+    norms(L, 12, L_norms);
+    return maxElement(L_norms, 12) / minElement(L_norms, 12);
+}
+
+Lanes jacobian(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+
+    Lanes sj[9];
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        sj[i] = determinant(tet[0], tet[1], tet[2]);
+    }
+    sj[8] = sj[8] / Lanes(64.0f);
+    return minElement(sj, 9);
+}
+
+Lanes maximumEdgeRatio(const Vec3 p[8], const void* arg) {
+    Vec3 X[3];
+    Lanes X_norms[3];
+    hexPrincipalAxes(p, X, false);
+    norms(X, 3, X_norms);
+
+    Mask degenerate =
+            (X_norms[0] < Lanes(FLOAT_MIN)) | (X_norms[1] < Lanes(FLOAT_MIN)) | (X_norms[2] < Lanes(FLOAT_MIN));
+    Lanes maxRatios[3] = {
+            max(X_norms[0] / X_norms[1], X_norms[1] / X_norms[0]),
+            max(X_norms[0] / X_norms[2], X_norms[2] / X_norms[0]),
+            max(X_norms[1] / X_norms[2], X_norms[2] / X_norms[1]),
+    };
+    return select(degenerate, Lanes(FLOAT_MAX), maxElement(maxRatios, 3));
+}
+
+Lanes maximumAspectFrobenius(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+
+    Lanes frob[8];
+    Mask degenerate(false);
+    for (int i = 0; i < 8; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        frob[i] = frobenius(tet[0], tet[1], tet[2]);
+        degenerate = degenerate | (frob[i] == Lanes(FLOAT_MAX));
+    }
+    return select(degenerate, Lanes(FLOAT_MAX), maxElement(frob, 8));
+}
+
+Lanes meanAspectFrobenius(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+
+    Lanes frob(0.0f);
+    for (int i = 0; i < 8; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        frob = frob + frobenius(tet[0], tet[1], tet[2]);
+    }
+    return frob / Lanes(8.0f);
+}
+
+Lanes oddy(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+
+    Lanes oddy[9];
+    Mask degenerate(false);
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        Lanes det = determinant(tet[0], tet[1], tet[2]);
+        Mask isDetValid = det > Lanes(FLOAT_MIN);
+        degenerate = degenerate | !isDetValid;
+        det = select(isDetValid, det, Lanes(1.0f));
+
+        Lanes a11 = dot(tet[0], tet[0]);
+        Lanes a12 = dot(tet[0], tet[1]);
+        Lanes a13 = dot(tet[0], tet[2]);
+        Lanes a22 = dot(tet[1], tet[1]);
+        Lanes a23 = dot(tet[1], tet[2]);
+        Lanes a33 = dot(tet[2], tet[2]);
+
+        Lanes two(2.0f);
+        Lanes AtA_sqrd = a11 * a11 + two * a12 * a12 + two * a13 * a13 + a22 * a22 + two * a23 * a23 + a33 * a33;
+        Lanes A_sqrd = a11 + a22 + a33;
+
+        // pow(det, 4/3) = det * cbrt(det).
+        oddy[i] = (AtA_sqrd - A_sqrd * A_sqrd / Lanes(3.0f)) / (det * cbrt(det));
+    }
+    return select(degenerate, Lanes(FLOAT_MAX), maxElement(oddy, 9));
+}
+
+Lanes relativeSizeSquared(const Vec3 p[8], const void* arg) {
+    float avgV = *(const float*)arg;
+
+    Vec3 X[3];
+    hexPrincipalAxes(p, X, false);
+    Lanes D = determinant(X[0], X[1], X[2]) / Lanes(64.0f * avgV);
+
+    Mask degenerate = Mask(avgV <= FLOAT_MIN) | (D <= Lanes(FLOAT_MIN));
+    Lanes minRatio = min(D, Lanes(1.0f) / D);
+    return select(degenerate, Lanes(0.0f), minRatio * minRatio);
+}
+
+Lanes scaledJacobian(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, true);
+    hexPrincipalAxes(p, X, true);
+
+    Lanes sj[9];
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        sj[i] = determinant(tet[0], tet[1], tet[2]);
+    }
+    Lanes msj = minElement(sj, 9);
+    return select(msj > Lanes(1.0001f), Lanes(-1.0f), msj);
+}
+
+Lanes shape(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+
+    Lanes shape[9];
+    Mask degenerate(false);
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        Lanes det = determinant(tet[0], tet[1], tet[2]);
+        Mask isDetDegenerate = det <= Lanes(FLOAT_MIN);
+        det = select(isDetDegenerate, Lanes(1.0f), det);
+        // pow(det, 2/3) = cbrt(det)^2.
+        Lanes detCbrt = cbrt(det);
+        Lanes num = detCbrt * detCbrt;
+        Lanes den = dot(tet[0], tet[0]) + dot(tet[1], tet[1]) + dot(tet[2], tet[2]);
+        degenerate = degenerate | isDetDegenerate | (den <= Lanes(FLOAT_MIN));
+        shape[i] = Lanes(3.0f) * num / den;
+    }
+    return select(degenerate, Lanes(0.0f), minElement(shape, 9));
+}
+
+Lanes shapeAndSize(const Vec3 p[8], const void* arg) {
+    return relativeSizeSquared(p, arg) * shape(p, nullptr);
+}
+
+Lanes shear(const Vec3 p[8], const void* arg) {
+    Vec3 L[12];
+    Vec3 X[3];
+    hexEdges(p, L, true);
+    hexPrincipalAxes(p, X, true);
+
+    Lanes shear[9];
+    Mask degenerate(false);
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        shear[i] = determinant(tet[0], tet[1], tet[2]);
+        degenerate = degenerate | (shear[i] <= Lanes(FLOAT_MIN));
+    }
+    return select(degenerate, Lanes(0.0f), minElement(shear, 9));
+}
+
+Lanes shearAndSize(const Vec3 p[8], const void* arg) {
+    return relativeSizeSquared(p, arg) * shear(p, nullptr);
+}
+
+Lanes skew(const Vec3 p[8], const void* arg) {
+    Vec3 X[3];
+    hexPrincipalAxes(p, X, true);
+
+    Mask degenerate =
+            (length(X[0]) <= Lanes(FLOAT_MIN)) | (length(X[1]) <= Lanes(FLOAT_MIN))
+            | (length(X[2]) <= Lanes(FLOAT_MIN));
+    Lanes skew[3] = {
+            abs(dot(X[0], X[1])),
+            abs(dot(X[0], X[2])),
+            abs(dot(X[1], X[2]))
+    };
+    return select(degenerate, Lanes(0.0f), maxElement(skew, 3));
+}
+
+Lanes stretch(const Vec3 p[8], const void* arg) {
+    const float sqrt3 = 1.732050807568877f;
+
+    Vec3 L[12];
+    Lanes L_norms[12];
+    hexEdges(p, L, false);
+    norms(L, 12, L_norms);
+
+    Vec3 D[4];
+    Lanes D_norms[4];
+    hexDiagonals(p, D);
+    norms(D, 4, D_norms);
+
+    return Lanes(sqrt3) * minElement(L_norms, 12) / maxElement(D_norms, 4);
+}
+
+Lanes taper(const Vec3 p[8], const void* arg) {
+    Vec3 X[3];
+    Vec3 XX[3];
+    Lanes X_norms[3];
+    Lanes XX_norms[3];
+    hexPrincipalAxes(p, X, false);
+    hexCrossDerivatives(p, XX);
+    norms(X, 3, X_norms);
+    norms(XX, 3, XX_norms);
+
+    Mask degenerate =
+            (X_norms[0] <= Lanes(FLOAT_MIN)) | (X_norms[1] <= Lanes(FLOAT_MIN)) | (X_norms[2] <= Lanes(FLOAT_MIN));
+    Lanes taper[3] = {
+            XX_norms[0] / min(X_norms[0], X_norms[1]),
+            XX_norms[1] / min(X_norms[0], X_norms[2]),
+            XX_norms[2] / min(X_norms[1], X_norms[2]),
+    };
+    return select(degenerate, Lanes(FLOAT_MAX), maxElement(taper, 3));
+}
+
+Lanes volume(const Vec3 p[8], const void* arg) {
+    Vec3 X[3];
+    hexPrincipalAxes(p, X, false);
+    return determinant(X[0], X[1], X[2]) / Lanes(64.0f);
+}
+
+/**
+ * Computes all measures at once. The edge vectors, principal axes, diagonals, sub-tetrahedra determinants and cube
+ * roots are computed only once and shared by the measures. The results are the same as the ones of the single measures.
+ */
+void allMeasures(const Vec3 p[8], const void* arg, Lanes qualities[NUM_QUALITY_MEASURES]) {
+    const float sqrt3 = 1.732050807568877f;
+    float avgV = *(const float*)arg;
+
+    Vec3 L[12], X[3], XX[3], D[4];
+    Lanes L_norms[12], X_norms[3], XX_norms[3], D_norms[4];
+    hexEdges(p, L, false);
+    hexPrincipalAxes(p, X, false);
+    hexCrossDerivatives(p, XX);
+    hexDiagonals(p, D);
+    norms(L, 12, L_norms);
+    norms(X, 3, X_norms);
+    norms(XX, 3, XX_norms);
+    norms(D, 4, D_norms);
+    Vec3 L_normalized[12], X_normalized[3];
+    for (int i = 0; i < 12; i++) L_normalized[i] = normalize(L[i]);
+    for (int i = 0; i < 3; i++) X_normalized[i] = normalize(X[i]);
+
+    Lanes det[9], sj[9], oddy[9], shape[9], frob[8];
+    Mask oddyDegenerate(false), shapeDegenerate(false), shearDegenerate(false), frobDegenerate(false);
+    Lanes frobSum(0.0f);
+    for (int i = 0; i < 9; i++) {
+        Vec3 tet[3];
+        hexSubtets(L, X, i, tet);
+        det[i] = determinant(tet[0], tet[1], tet[2]);
+
+        Lanes a11 = dot(tet[0], tet[0]);
+        Lanes a12 = dot(tet[0], tet[1]);
+        Lanes a13 = dot(tet[0], tet[2]);
+        Lanes a22 = dot(tet[1], tet[1]);
+        Lanes a23 = dot(tet[1], tet[2]);
+        Lanes a33 = dot(tet[2], tet[2]);
+        Lanes two(2.0f);
+        Lanes AtA_sqrd = a11 * a11 + two * a12 * a12 + two * a13 * a13 + a22 * a22 + two * a23 * a23 + a33 * a33;
+        Lanes A_sqrd = a11 + a22 + a33;
+
+        Mask isDetDegenerate = det[i] <= Lanes(FLOAT_MIN);
+        Lanes detSafe = select(isDetDegenerate, Lanes(1.0f), det[i]);
+        Lanes detCbrt = cbrt(detSafe);
+        oddyDegenerate = oddyDegenerate | !(det[i] > Lanes(FLOAT_MIN));
+        oddy[i] = (AtA_sqrd - A_sqrd * A_sqrd / Lanes(3.0f)) / (detSafe * detCbrt);
+        shapeDegenerate = shapeDegenerate | isDetDegenerate | (A_sqrd <= Lanes(FLOAT_MIN));
+        shape[i] = Lanes(3.0f) * (detCbrt * detCbrt) / A_sqrd;
+
+        if (i < 8) {
+            frob[i] = frobenius(tet[0], tet[1], tet[2]);
+            frobDegenerate = frobDegenerate | (frob[i] == Lanes(FLOAT_MAX));
+            frobSum = frobSum + frob[i];
+        }
+
+        Vec3 tetNormalized[3];
+        hexSubtets(L_normalized, X_normalized, i, tetNormalized);
+        sj[i] = determinant(tetNormalized[0], tetNormalized[1], tetNormalized[2]);
+        shearDegenerate = shearDegenerate | (sj[i] <= Lanes(FLOAT_MIN));
+    }
+
+    Lanes volume = det[8] / Lanes(64.0f);
+    Lanes jacobian[9];
+    for (int i = 0; i < 8; i++) jacobian[i] = det[i];
+    jacobian[8] = volume;
+
+    Lanes relativeSize = det[8] / Lanes(64.0f * avgV);
+    Lanes minRatio = min(relativeSize, Lanes(1.0f) / relativeSize);
+    Lanes relativeSizeSquared = select(
+            Mask(avgV <= FLOAT_MIN) | (relativeSize <= Lanes(FLOAT_MIN)), Lanes(0.0f), minRatio * minRatio);
+
+    Mask isMaxEdgeRatioDegenerate =
+            (X_norms[0] < Lanes(FLOAT_MIN)) | (X_norms[1] < Lanes(FLOAT_MIN)) | (X_norms[2] < Lanes(FLOAT_MIN));
+    Lanes maxRatios[3] = {
+            max(X_norms[0] / X_norms[1], X_norms[1] / X_norms[0]),
+            max(X_norms[0] / X_norms[2], X_norms[2] / X_norms[0]),
+            max(X_norms[1] / X_norms[2], X_norms[2] / X_norms[1]),
+    };
+
+    Mask isSkewDegenerate =
+            (length(X_normalized[0]) <= Lanes(FLOAT_MIN)) | (length(X_normalized[1]) <= Lanes(FLOAT_MIN))
+            | (length(X_normalized[2]) <= Lanes(FLOAT_MIN));
+    Lanes skew[3] = {
+            abs(dot(X_normalized[0], X_normalized[1])),
+            abs(dot(X_normalized[0], X_normalized[2])),
+            abs(dot(X_normalized[1], X_normalized[2]))
+    };
+
+    Mask isTaperDegenerate =
+            (X_norms[0] <= Lanes(FLOAT_MIN)) | (X_norms[1] <= Lanes(FLOAT_MIN)) | (X_norms[2] <= Lanes(FLOAT_MIN));
+    Lanes taper[3] = {
+            XX_norms[0] / min(X_norms[0], X_norms[1]),
+            XX_norms[1] / min(X_norms[0], X_norms[2]),
+            XX_norms[2] / min(X_norms[1], X_norms[2]),
+    };
+
+    Lanes msj = minElement(sj, 9);
+    Lanes shapeValue = select(shapeDegenerate, Lanes(0.0f), minElement(shape, 9));
+    Lanes shearValue = select(shearDegenerate, Lanes(0.0f), msj);
+
+    qualities[int(QualityMeasureEnum::DIA)] = minElement(D_norms, 4) / maxElement(D_norms, 4);
+    qualities[int(QualityMeasureEnum::DIM)] = Lanes(-1.0f);
+    qualities[int(QualityMeasureEnum::DIS)] = Lanes(-1.0f);
+    qualities[int(QualityMeasureEnum::ER)] = maxElement(L_norms, 12) / minElement(L_norms, 12);
+    qualities[int(QualityMeasureEnum::J)] = minElement(jacobian, 9);
+    qualities[int(QualityMeasureEnum::MER)] =
+            select(isMaxEdgeRatioDegenerate, Lanes(FLOAT_MAX), maxElement(maxRatios, 3));
+    qualities[int(QualityMeasureEnum::MAAF)] = select(frobDegenerate, Lanes(FLOAT_MAX), maxElement(frob, 8));
+    qualities[int(QualityMeasureEnum::MEAF)] = frobSum / Lanes(8.0f);
+    qualities[int(QualityMeasureEnum::ODD)] = select(oddyDegenerate, Lanes(FLOAT_MAX), maxElement(oddy, 9));
+    qualities[int(QualityMeasureEnum::RSS)] = relativeSizeSquared;
+    qualities[int(QualityMeasureEnum::SJ)] = select(msj > Lanes(1.0001f), Lanes(-1.0f), msj);
+    qualities[int(QualityMeasureEnum::SHA)] = shapeValue;
+    qualities[int(QualityMeasureEnum::SHAS)] = relativeSizeSquared * shapeValue;
+    qualities[int(QualityMeasureEnum::SHE)] = shearValue;
+    qualities[int(QualityMeasureEnum::SHES)] = relativeSizeSquared * shearValue;
+    qualities[int(QualityMeasureEnum::SKE)] = select(isSkewDegenerate, Lanes(0.0f), maxElement(skew, 3));
+    qualities[int(QualityMeasureEnum::STR)] = Lanes(sqrt3) * minElement(L_norms, 12) / maxElement(D_norms, 4);
+    qualities[int(QualityMeasureEnum::TAP)] = select(isTaperDegenerate, Lanes(FLOAT_MAX), maxElement(taper, 3));
+    qualities[int(QualityMeasureEnum::VOL)] = volume;
+}
+
+typedef Lanes (lanes_quality_measure_fun) (const Vec3 p[8], const void* arg);
+
+/// Loads the corners of Lanes::width cells of the batch at a time and evaluates the measure for them.
+template<lanes_quality_measure_fun* measure>
+void evaluateBatch(const HexCellBatch& cells, const void* arg, float* qualities) {
+    for (size_t laneOffset = 0; laneOffset < QUALITY_MEASURE_BATCH_SIZE; laneOffset += Lanes::width) {
+        Vec3 p[8];
+        for (int j = 0; j < 8; j++) {
+            p[j].x = Lanes::load(cells.x[j] + laneOffset);
+            p[j].y = Lanes::load(cells.y[j] + laneOffset);
+            p[j].z = Lanes::load(cells.z[j] + laneOffset);
+        }
+        measure(p, arg).store(qualities + laneOffset);
+    }
+}
+
+}
+
+quality_measure_batch_fun* get_quality_measure_batch_fun(QualityMeasureEnum measure) {
+    quality_measure_batch_fun* fun = nullptr;
+    switch (measure) {
+        case QualityMeasureEnum::SJ:   fun = &evaluateBatch<scaledJacobian>;         break;
+        case QualityMeasureEnum::DIA:  fun = &evaluateBatch<diagonal>;               break;
+        case QualityMeasureEnum::ER:   fun = &evaluateBatch<edgeRatio>;              break;
+        case QualityMeasureEnum::DIM:  fun = &evaluateBatch<dimension>;              break;
+        case QualityMeasureEnum::DIS:  fun = &evaluateBatch<distortion>;             break;
+        case QualityMeasureEnum::J:    fun = &evaluateBatch<jacobian>;               break;
+        case QualityMeasureEnum::MER:  fun = &evaluateBatch<maximumEdgeRatio>;       break;
+        case QualityMeasureEnum::MAAF: fun = &evaluateBatch<maximumAspectFrobenius>; break;
+        case QualityMeasureEnum::MEAF: fun = &evaluateBatch<meanAspectFrobenius>;    break;
+        case QualityMeasureEnum::ODD:  fun = &evaluateBatch<oddy>;                   break;
+        case QualityMeasureEnum::RSS:  fun = &evaluateBatch<relativeSizeSquared>;    break;
+        case QualityMeasureEnum::SHA:  fun = &evaluateBatch<shape>;                  break;
+        case QualityMeasureEnum::SHAS: fun = &evaluateBatch<shapeAndSize>;           break;
+        case QualityMeasureEnum::SHE:  fun = &evaluateBatch<shear>;                  break;
+        case QualityMeasureEnum::SHES: fun = &evaluateBatch<shearAndSize>;           break;
+        case QualityMeasureEnum::SKE:  fun = &evaluateBatch<skew>;                   break;
+        case QualityMeasureEnum::STR:  fun = &evaluateBatch<stretch>;                break;
+        case QualityMeasureEnum::TAP:  fun = &evaluateBatch<taper>;                  break;
+        case QualityMeasureEnum::VOL:  fun = &evaluateBatch<volume>;                 break;
+        default: std::cerr << "Invalid QualityMeasureEnum value: " << static_cast<int>(measure) << std::endl; break;
+    }
+    return fun;
+}
+
+void compute_all_quality_measures_batch(
+        const HexCellBatch& cells, const void* arg, float qualities[][QUALITY_MEASURE_BATCH_SIZE]) {
+    for (size_t laneOffset = 0; laneOffset < QUALITY_MEASURE_BATCH_SIZE; laneOffset += Lanes::width) {
+        Vec3 p[8];
+        for (int j = 0; j < 8; j++) {
+            p[j].x = Lanes::load(cells.x[j] + laneOffset);
+            p[j].y = Lanes::load(cells.y[j] + laneOffset);
+            p[j].z = Lanes::load(cells.z[j] + laneOffset);
+        }
+        Lanes measureQualities[NUM_QUALITY_MEASURES];
+        allMeasures(p, arg, measureQualities);
+        for (size_t measureIdx = 0; measureIdx < NUM_QUALITY_MEASURES; measureIdx++) {
+            measureQualities[measureIdx].store(qualities[measureIdx] + laneOffset);
+        }
+    }
+}
+
+const char* get_quality_measure_batch_isa_name() {
+#if defined(HEX_QUALITY_BATCH_AVX2)
+    return "AVX2";
+#elif defined(HEX_QUALITY_BATCH_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_HEX_QUALITY_BATCH_H
+#define HEXVOLUMERENDERER_HEX_QUALITY_BATCH_H
+
+#include <cstddef>
+#include <limits>
+
+#include "hex_quality_color_maps.h"
+
+/**
+ * Batched versions of the quality measures in hex_quality.h. Each call evaluates a measure for
+ * QUALITY_MEASURE_BATCH_SIZE cells at once on lane-packed corner positions. Depending on the target instruction set,
+ * the kernels use AVX2 (8 lanes), SSE2 (4 lanes) or plain scalar code. The results match the scalar versions up to
+ * floating point rounding.
+ */
+namespace HexaLab {
+
+/// The number of cells processed by one call of a batched quality measure function.
+const size_t QUALITY_MEASURE_BATCH_SIZE = 8;
+
+/**
+ * The corner positions of QUALITY_MEASURE_BATCH_SIZE cells in structure-of-arrays layout, i.e., x[j][k] is the
+ * x coordinate of the corner j (in the corner order of hex_quality.h) of the k-th cell in the batch.
+ */
+struct alignas(32) HexCellBatch {
+    float x[8][QUALITY_MEASURE_BATCH_SIZE];
+    float y[8][QUALITY_MEASURE_BATCH_SIZE];
+    float z[8][QUALITY_MEASURE_BATCH_SIZE];
+};
+
+/**
+ * Computes the quality of all cells in the batch.
+ * @param cells The corner positions of the cells.
+ * @param arg The measure argument (see quality_measure_fun, e.g., a pointer to the average cell volume).
+ * @param qualities The output array of size QUALITY_MEASURE_BATCH_SIZE.
+ */
+typedef void (quality_measure_batch_fun) (const HexCellBatch& cells, const void* arg, float* qualities);
+
+quality_measure_batch_fun* get_quality_measure_batch_fun(QualityMeasureEnum measure);
+
+/// The number of quality measures, i.e., the number of values of QualityMeasureEnum.
+const size_t NUM_QUALITY_MEASURES = size_t(QualityMeasureEnum::VOL) + 1;
+
+/**
+ * Computes all quality measures for all cells in the batch in one fused pass. The setup shared by the measures (e.g.,
+ * the edge vectors and the Jacobian determinants of the sub-tetrahedra) is computed only once per cell.
+ * @param cells The corner positions of the cells.
+ * @param arg A pointer to the average cell volume (used by the size-dependent measures).
+ * @param qualities The output array. qualities[int(measure)][k] is the quality of the k-th cell for the passed measure.
+ */
+void compute_all_quality_measures_batch(
+        const HexCellBatch& cells, const void* arg, float qualities[][QUALITY_MEASURE_BATCH_SIZE]);
+
+/// @return The name of the instruction set the batched kernels were compiled for ("AVX2", "SSE2" or "scalar").
+const char* get_quality_measure_batch_isa_name();
+
+}
+
+#endif //HEXVOLUMERENDERER_HEX_QUALITY_BATCH_H
@@ -39,8 +39,14 @@
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Utils/AutomaticPerformanceMeasurer.hpp"
+#include "Helpers/VisualizationMappingCache.hpp"
 #include "DepthComplexityRenderer.hpp"
 
+struct DepthComplexityMapping : public VisualizationMapping {
+    sgl::GeometryBufferPtr indexBuffer;
+    sgl::GeometryBufferPtr positionBuffer;
+};
+
 DepthComplexityRenderer::DepthComplexityRenderer(SceneData &sceneData, sgl::TransferFunctionWindow &transferFunctionWindow)
         : HexahedralMeshRenderer(sceneData, transferFunctionWindow) {
     sgl::ShaderManager->invalidateShaderCache();
@@ -72,23 +78,34 @@ DepthComplexityRenderer::DepthComplexityRenderer(SceneData &sceneData, sgl::Tran
 void DepthComplexityRenderer::uploadVisualizationMapping(HexMeshPtr meshIn, bool isNewMesh) {
     hexMesh = meshIn;
 
-    std::vector<uint32_t> triangleIndices;
-    std::vector<glm::vec3> vertexPositions;
-    meshIn->getVolumeData_DepthComplexity_Slim(triangleIndices, vertexPositions);
+    // Reuse the cached mapping if neither the mesh nor the filters changed since it was generated.
+    VisualizationMappingKey mappingKey(getWindowName(), *meshIn);
+    std::shared_ptr<DepthComplexityMapping> mapping =
+            sceneData.visualizationMappingCache.get<DepthComplexityMapping>(mappingKey);
+    if (!mapping) {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<glm::vec3> vertexPositions;
+        meshIn->getVolumeData_DepthComplexity_Slim(triangleIndices, vertexPositions);
+
+        mapping = std::make_shared<DepthComplexityMapping>();
+        mapping->indexBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER),
+                sizeof(uint32_t)*triangleIndices.size());
+        mapping->positionBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER),
+                vertexPositions.size()*sizeof(glm::vec3));
+        sceneData.visualizationMappingCache.put(mappingKey, mapping);
+    }
 
     shaderAttributes = sgl::ShaderManager->createShaderAttributes(gatherShader);
     shaderAttributes->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER);
-    shaderAttributes->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    shaderAttributes->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER);
     shaderAttributes->addGeometryBuffer(
-            positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
+            mapping->positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     firstFrame = true;
     totalNumFragments = 0;
@@ -0,0 +1,106 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_GEOMETRYBUFFEROUTPUT_HPP
+#define HEXVOLUMERENDERER_GEOMETRYBUFFEROUTPUT_HPP
+
+#include <Graphics/Renderer.hpp>
+#include <Graphics/Buffers/GeometryBuffer.hpp>
+
+#include "Utils/OutputBuffer.hpp"
+
+/**
+ * Output buffer for the mesh data extractors of HexMesh that writes directly into a newly created, mapped geometry
+ * buffer instead of into a temporary vector, which saves one full copy of the data.
+ * Must only be used in the thread of the OpenGL context (i.e., in uploadVisualizationMapping).
+ *
+ * Usage: Create a GeometryBufferOutput, pass getOutputBuffer() to the extractor and then call finish() to get the
+ * geometry buffer holding the data.
+ */
+template<class T>
+class GeometryBufferOutput {
+public:
+    explicit GeometryBufferOutput(sgl::BufferType bufferType)
+            : bufferType(bufferType), outputBuffer(
+                    [this](size_t numElements) { return allocate(numElements); },
+                    [this](T* output, size_t numElements) { readback(output, numElements); }) {}
+
+    inline OutputBuffer<T>& getOutputBuffer() { return outputBuffer; }
+    /// The size of the written data in bytes.
+    inline size_t getSizeInBytes() const { return outputBuffer.size() * sizeof(T); }
+
+    /// Unmaps the geometry buffer. If no mapped memory was used, the buffer is created from the output data.
+    sgl::GeometryBufferPtr finish() {
+        if (isMapped) {
+            geometryBuffer->unmapBuffer();
+            isMapped = false;
+        }
+        if (!outputBuffer.getIsExternalMemoryUsed()) {
+            geometryBuffer = sgl::Renderer->createGeometryBuffer(
+                    outputBuffer.size() * sizeof(T), outputBuffer.data(), bufferType);
+        }
+        return geometryBuffer;
+    }
+
+private:
+    T* allocate(size_t numElements) {
+        geometryBuffer = sgl::Renderer->createGeometryBuffer(numElements * sizeof(T), NULL, bufferType);
+        T* mappedMemory = static_cast<T*>(geometryBuffer->mapBuffer(sgl::BUFFER_MAP_WRITE_ONLY));
+        isMapped = mappedMemory != nullptr;
+        return mappedMemory;
+    }
+
+    /**
+     * Copies the data written so far to the staging vector of the output buffer. The buffer is mapped write-only for
+     * writing, so it needs to be mapped again with read access.
+     */
+    void readback(T* output, size_t numElements) {
+        if (isMapped) {
+            geometryBuffer->unmapBuffer();
+            isMapped = false;
+        }
+        if (numElements > 0) {
+            const T* mappedMemory = static_cast<const T*>(geometryBuffer->mapBuffer(sgl::BUFFER_MAP_READ_ONLY));
+            if (mappedMemory) {
+                std::copy(mappedMemory, mappedMemory + numElements, output);
+            } else {
+                sgl::Logfile::get()->writeError(
+                        "Error in GeometryBufferOutput::readback: Couldn't map the geometry buffer for reading.");
+            }
+            geometryBuffer->unmapBuffer();
+        }
+        geometryBuffer = sgl::GeometryBufferPtr();
+    }
+
+    sgl::BufferType bufferType;
+    sgl::GeometryBufferPtr geometryBuffer;
+    bool isMapped = false;
+    OutputBuffer<T> outputBuffer;
+};
+
+#endif //HEXVOLUMERENDERER_GEOMETRYBUFFEROUTPUT_HPP
@@ -0,0 +1,81 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Mesh/HexMesh/HexMesh.hpp"
+#include "VisualizationMappingCache.hpp"
+
+VisualizationMappingKey::VisualizationMappingKey(
+        const std::string& rendererName, const HexMesh& hexMesh, const std::string& settings)
+        : rendererName(rendererName), settings(settings), meshDataGeneration(hexMesh.getMeshDataGeneration()),
+          cellMaskVersion(hexMesh.getCellFilteringMask().getVersion()) {}
+
+VisualizationMappingPtr VisualizationMappingCache::find(const VisualizationMappingKey& key) {
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+        if (it->key == key) {
+            // Mark the entry as the most recently used one.
+            entries.splice(entries.end(), entries, it);
+            return entries.back().mapping;
+        }
+    }
+    return VisualizationMappingPtr();
+}
+
+void VisualizationMappingCache::put(const VisualizationMappingKey& key, const VisualizationMappingPtr& mapping) {
+    // Each renderer (and settings string) only keeps its last mapping.
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+        if (it->key.rendererName == key.rendererName && it->key.settings == key.settings) {
+            memoryUsed -= it->mapping->sizeInBytes;
+            entries.erase(it);
+            break;
+        }
+    }
+
+    if (!mapping || mapping->sizeInBytes > memoryBudget) {
+        return;
+    }
+    entries.push_back(Entry{key, mapping});
+    memoryUsed += mapping->sizeInBytes;
+    evict();
+}
+
+void VisualizationMappingCache::clear() {
+    entries.clear();
+    memoryUsed = 0;
+}
+
+void VisualizationMappingCache::setMemoryBudget(size_t memoryBudgetBytes) {
+    memoryBudget = memoryBudgetBytes;
+    evict();
+}
+
+void VisualizationMappingCache::evict() {
+    while (memoryUsed > memoryBudget && !entries.empty()) {
+        memoryUsed -= entries.front().mapping->sizeInBytes;
+        entries.pop_front();
+    }
+}
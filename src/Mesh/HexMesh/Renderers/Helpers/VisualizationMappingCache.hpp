@@ -0,0 +1,131 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_VISUALIZATIONMAPPINGCACHE_HPP
+#define HEXVOLUMERENDERER_VISUALIZATIONMAPPINGCACHE_HPP
+
+#include <string>
+#include <list>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include <Graphics/Buffers/GeometryBuffer.hpp>
+
+class HexMesh;
+
+/**
+ * The state a visualization mapping was generated for. Two mappings with the same key are identical, so a renderer
+ * can reuse a cached mapping instead of regenerating it (e.g., when switching back to a previously used renderer).
+ */
+struct VisualizationMappingKey {
+    VisualizationMappingKey() {}
+    /**
+     * @param rendererName The name of the renderer (e.g., its window name).
+     * @param hexMesh The mesh the mapping is generated for.
+     * @param settings A string encoding all renderer settings the mapping depends on (or an empty string).
+     */
+    VisualizationMappingKey(const std::string& rendererName, const HexMesh& hexMesh, const std::string& settings = "");
+
+    bool operator==(const VisualizationMappingKey& other) const {
+        return meshDataGeneration == other.meshDataGeneration && cellMaskVersion == other.cellMaskVersion
+                && rendererName == other.rendererName && settings == other.settings;
+    }
+    bool operator!=(const VisualizationMappingKey& other) const { return !(*this == other); }
+
+    std::string rendererName;
+    std::string settings;
+    uint64_t meshDataGeneration = 0; ///< @see HexMesh::getMeshDataGeneration (unique over all meshes).
+    uint64_t cellMaskVersion = 0; ///< @see CellMask::getVersion of the cell filtering mask of the mesh.
+};
+
+/**
+ * The cached data of a visualization mapping. Renderers derive from this class to store their GPU buffers and any
+ * other data generated together with them (e.g., the maximum LOD value).
+ */
+struct VisualizationMapping {
+    virtual ~VisualizationMapping() {}
+    /// Adds the size of the passed buffer to the memory usage of the mapping and returns the buffer.
+    inline sgl::GeometryBufferPtr addBuffer(const sgl::GeometryBufferPtr& buffer, size_t bufferSizeInBytes) {
+        sizeInBytes += bufferSizeInBytes;
+        return buffer;
+    }
+    /// The memory used by the mapping (mostly on the GPU), which is counted against the budget of the cache.
+    size_t sizeInBytes = 0;
+};
+typedef std::shared_ptr<VisualizationMapping> VisualizationMappingPtr;
+
+/**
+ * Stores the last generated visualization mapping per renderer (and renderer settings string), so that switching
+ * between renderers doesn't regenerate the mappings if neither the mesh, the filters nor the settings changed.
+ * If the mappings exceed the memory budget, the least recently used ones are evicted.
+ */
+class VisualizationMappingCache {
+public:
+    static const size_t DEFAULT_MEMORY_BUDGET = size_t(512) << 20u;
+
+    explicit VisualizationMappingCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET) : memoryBudget(memoryBudget) {}
+
+    /**
+     * Returns the cached mapping for the passed key, or a null pointer if the renderer has no mapping for this state.
+     * @tparam T The type of the mapping as passed to @see put.
+     */
+    template<class T>
+    std::shared_ptr<T> get(const VisualizationMappingKey& key) {
+        return std::dynamic_pointer_cast<T>(find(key));
+    }
+    /**
+     * Stores the passed mapping. It replaces the previous mapping of the same renderer and settings. Mappings larger
+     * than the memory budget are not stored.
+     */
+    void put(const VisualizationMappingKey& key, const VisualizationMappingPtr& mapping);
+
+    /// Removes all mappings (e.g., when a new mesh is loaded).
+    void clear();
+
+    void setMemoryBudget(size_t memoryBudgetBytes);
+    inline size_t getMemoryBudget() const { return memoryBudget; }
+    inline size_t getMemoryUsed() const { return memoryUsed; }
+
+private:
+    struct Entry {
+        VisualizationMappingKey key;
+        VisualizationMappingPtr mapping;
+    };
+
+    VisualizationMappingPtr find(const VisualizationMappingKey& key);
+    /// Evicts the least recently used mappings until the memory used fits into the budget.
+    void evict();
+
+    // Ordered from the least to the most recently used entry.
+    std::list<Entry> entries;
+    size_t memoryBudget;
+    size_t memoryUsed = 0;
+};
+
+#endif //HEXVOLUMERENDERER_VISUALIZATIONMAPPINGCACHE_HPP
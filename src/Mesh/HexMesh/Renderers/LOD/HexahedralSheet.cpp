@@ -27,6 +27,7 @@
  */
 
 #include <unordered_set>
+#include <algorithm>
 #include <limits>
 #include <queue>
 #include "Mesh/BaseComplex/global_types.h"
@@ -42,7 +43,7 @@ void getParallelEdgesInCell(Hybrid& h, uint32_t e_id, uint32_t parallelEdgeIds[3
         }
     }
 
-    // Add all parallel edges (this works thanks to @see buildCellEdgeList in HexMesh.cpp).
+    // Add all parallel edges (this works thanks to the edge order of @see hex_edge_table in global_types.h).
     size_t baseEdgeIndex = (edgeCellIndex / 4) * 4;
     int insertionIndex = 0;
     for (int i = 0; i < 4; i++) {
@@ -142,10 +143,17 @@ void extractAllHexahedralSheets(HexMesh* hexMesh, std::vector<HexahedralSheet>&
     }
 }
 
-bool computeHexahedralSheetComponentNeighborship(
+/**
+ * The combinatorial part of @see computeHexahedralSheetComponentNeighborship. It only reads the mesh connectivity and
+ * can thus be called concurrently for different component pairs.
+ * @param isIntersecting Set to whether the two components share cells.
+ * @param boundaryFaceIdsNoLongerBoundaryAfterMerging Set to the shared boundary faces that are no longer boundary
+ * faces of the merged component.
+ * @return False if the two components consist of exactly the same cells. In this case, they are not neighbors.
+ */
+static bool computeBoundaryFacesNoLongerBoundaryAfterMerging(
         HexMesh* hexMesh, SheetComponent& component0, SheetComponent& component1,
-        bool useVolumeAndAreaMeasures, bool useNumCellsOrVolume,
-        float& matchingWeight, ComponentConnectionType& componentConnectionType) {
+        bool& isIntersecting, std::vector<uint32_t>& boundaryFaceIdsNoLongerBoundaryAfterMerging) {
     SheetComponent mergedComponent;
     std::set_intersection(
             component0.cellIds.begin(), component0.cellIds.end(),
@@ -153,7 +161,7 @@ bool computeHexahedralSheetComponentNeighborship(
             std::back_inserter(mergedComponent.cellIds));
 
     // Is intersecting (or hybrid), i.e. not parallel?
-    bool isIntersecting = !mergedComponent.cellIds.empty();
+    isIntersecting = !mergedComponent.cellIds.empty();
 
     // Is the merged component exactly the original components?
     if (mergedComponent.cellIds.size() == component0.cellIds.size()
@@ -170,12 +178,22 @@ bool computeHexahedralSheetComponentNeighborship(
             component1.boundaryFaceIds.begin(), component1.boundaryFaceIds.end(),
             std::back_inserter(boundaryFaceIdsIntersection));
 
-    std::vector<uint32_t> boundaryFaceIdsNoLongerBoundaryAfterMerging;
     std::set_difference(
             boundaryFaceIdsIntersection.begin(), boundaryFaceIdsIntersection.end(),
             mergedComponent.boundaryFaceIds.begin(), mergedComponent.boundaryFaceIds.end(),
             std::back_inserter(boundaryFaceIdsNoLongerBoundaryAfterMerging));
+    return true;
+}
 
+/**
+ * The weighting part of @see computeHexahedralSheetComponentNeighborship (see there for the parameters).
+ * It uses the lazily computed face areas and cell volumes of the mesh and must not be called concurrently.
+ */
+static bool computeComponentConnectionWeight(
+        HexMesh* hexMesh, SheetComponent& component0, SheetComponent& component1,
+        bool useVolumeAndAreaMeasures, bool useNumCellsOrVolume, bool isIntersecting,
+        const std::vector<uint32_t>& boundaryFaceIdsNoLongerBoundaryAfterMerging,
+        float& matchingWeight, ComponentConnectionType& componentConnectionType) {
     bool isHybrid = isIntersecting && !boundaryFaceIdsNoLongerBoundaryAfterMerging.empty();
 
     if (useVolumeAndAreaMeasures) {
@@ -220,32 +238,110 @@ bool computeHexahedralSheetComponentNeighborship(
     return !boundaryFaceIdsNoLongerBoundaryAfterMerging.empty(); // i.e., adjacent or hybrid
 }
 
+bool computeHexahedralSheetComponentNeighborship(
+        HexMesh* hexMesh, SheetComponent& component0, SheetComponent& component1,
+        bool useVolumeAndAreaMeasures, bool useNumCellsOrVolume,
+        float& matchingWeight, ComponentConnectionType& componentConnectionType) {
+    bool isIntersecting = false;
+    std::vector<uint32_t> boundaryFaceIdsNoLongerBoundaryAfterMerging;
+    if (!computeBoundaryFacesNoLongerBoundaryAfterMerging(
+            hexMesh, component0, component1, isIntersecting, boundaryFaceIdsNoLongerBoundaryAfterMerging)) {
+        return false;
+    }
+    return computeComponentConnectionWeight(
+            hexMesh, component0, component1, useVolumeAndAreaMeasures, useNumCellsOrVolume, isIntersecting,
+            boundaryFaceIdsNoLongerBoundaryAfterMerging, matchingWeight, componentConnectionType);
+}
+
 void computeHexahedralSheetComponentConnectionData(
         HexMesh* hexMesh, std::vector<SheetComponent*>& components,
         bool useVolumeAndAreaMeasures, bool useNumCellsOrVolume,
         std::vector<ComponentConnectionData>& connectionDataList) {
-    for (size_t i = 0; i < components.size(); i++) {
-        for (size_t j = i + 1; j < components.size(); j++) {
-            SheetComponent& component0 = *components.at(i);
-            SheetComponent& component1 = *components.at(j);
-            ComponentConnectionType componentConnectionType;
-            float edgeWeight = 1.0f;
-            bool componentsAreNeighbors = computeHexahedralSheetComponentNeighborship(
-                    hexMesh, component0, component1, useVolumeAndAreaMeasures, useNumCellsOrVolume,
-                    edgeWeight, componentConnectionType);
-            if (!componentsAreNeighbors) {
-                continue;
+    Mesh& mesh = hexMesh->getBaseComplexMesh();
+    size_t numComponents = components.size();
+
+    // Components can only be neighbors if they share at least one boundary face. Thus, we build an inverted index
+    // mapping each face to the components it is a boundary face of and only test the pairs found this way.
+    std::vector<uint32_t> faceComponentOffsets(mesh.Fs.size() + 1, 0);
+    for (SheetComponent* component : components) {
+        for (uint32_t f_id : component->boundaryFaceIds) {
+            faceComponentOffsets.at(f_id + 1)++;
+        }
+    }
+    for (size_t f_id = 0; f_id < mesh.Fs.size(); f_id++) {
+        faceComponentOffsets.at(f_id + 1) += faceComponentOffsets.at(f_id);
+    }
+    std::vector<uint32_t> faceComponentIndices(faceComponentOffsets.back());
+    std::vector<uint32_t> faceComponentWritePositions(faceComponentOffsets.begin(), faceComponentOffsets.end() - 1);
+    for (size_t i = 0; i < numComponents; i++) {
+        for (uint32_t f_id : components.at(i)->boundaryFaceIds) {
+            faceComponentIndices.at(faceComponentWritePositions.at(f_id)++) = uint32_t(i);
+        }
+    }
+
+    // Collect the candidate pairs (i, j), i < j, in lexicographic order.
+    std::vector<std::pair<uint32_t, uint32_t>> candidatePairs;
+    std::vector<uint32_t> candidateIndices;
+    for (size_t i = 0; i < numComponents; i++) {
+        candidateIndices.clear();
+        for (uint32_t f_id : components.at(i)->boundaryFaceIds) {
+            for (uint32_t k = faceComponentOffsets.at(f_id); k < faceComponentOffsets.at(f_id + 1); k++) {
+                if (faceComponentIndices.at(k) > i) {
+                    candidateIndices.push_back(faceComponentIndices.at(k));
+                }
             }
+        }
+        std::sort(candidateIndices.begin(), candidateIndices.end());
+        candidateIndices.erase(std::unique(candidateIndices.begin(), candidateIndices.end()), candidateIndices.end());
+        for (uint32_t j : candidateIndices) {
+            candidatePairs.push_back(std::make_pair(uint32_t(i), j));
+        }
+    }
 
-            component0.neighborIndices.insert(j);
-            component1.neighborIndices.insert(i);
+    // The set operations on the cells and faces of the candidate pairs are independent of each other.
+    size_t numCandidatePairs = candidatePairs.size();
+    std::vector<uint8_t> isCandidateValidList(numCandidatePairs, 0);
+    std::vector<uint8_t> isIntersectingList(numCandidatePairs, 0);
+    std::vector<std::vector<uint32_t>> boundaryFaceIdsNoLongerBoundaryList(numCandidatePairs);
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) schedule(dynamic) shared(hexMesh, components, candidatePairs) \
+    shared(isCandidateValidList, isIntersectingList, boundaryFaceIdsNoLongerBoundaryList, numCandidatePairs)
+#endif
+    for (size_t k = 0; k < numCandidatePairs; k++) {
+        bool isIntersecting = false;
+        isCandidateValidList.at(k) = computeBoundaryFacesNoLongerBoundaryAfterMerging(
+                hexMesh, *components.at(candidatePairs.at(k).first), *components.at(candidatePairs.at(k).second),
+                isIntersecting, boundaryFaceIdsNoLongerBoundaryList.at(k));
+        isIntersectingList.at(k) = isIntersecting;
+    }
 
-            ComponentConnectionData connectionData;
-            connectionData.firstIdx = i;
-            connectionData.secondIdx = j;
-            connectionData.componentConnectionType = componentConnectionType;
-            connectionData.weight = edgeWeight;
-            connectionDataList.push_back(connectionData);
+    // The weights and neighbor sets are computed in the same order as when testing all pairs.
+    for (size_t k = 0; k < numCandidatePairs; k++) {
+        if (!isCandidateValidList.at(k)) {
+            continue;
         }
+        uint32_t i = candidatePairs.at(k).first;
+        uint32_t j = candidatePairs.at(k).second;
+        SheetComponent& component0 = *components.at(i);
+        SheetComponent& component1 = *components.at(j);
+        ComponentConnectionType componentConnectionType;
+        float edgeWeight = 1.0f;
+        bool componentsAreNeighbors = computeComponentConnectionWeight(
+                hexMesh, component0, component1, useVolumeAndAreaMeasures, useNumCellsOrVolume,
+                isIntersectingList.at(k) != 0, boundaryFaceIdsNoLongerBoundaryList.at(k),
+                edgeWeight, componentConnectionType);
+        if (!componentsAreNeighbors) {
+            continue;
+        }
+
+        component0.neighborIndices.insert(j);
+        component1.neighborIndices.insert(i);
+
+        ComponentConnectionData connectionData;
+        connectionData.firstIdx = i;
+        connectionData.secondIdx = j;
+        connectionData.componentConnectionType = componentConnectionType;
+        connectionData.weight = edgeWeight;
+        connectionDataList.push_back(connectionData);
     }
 }
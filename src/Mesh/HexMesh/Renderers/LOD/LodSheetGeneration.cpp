@@ -27,6 +27,8 @@
  */
 
 #include <unordered_map>
+#include <queue>
+#include <algorithm>
 #include <chrono>
 
 #include <Utils/File/Logfile.hpp>
@@ -58,6 +60,81 @@ void set_union(const std::unordered_set<T>& set0, const std::unordered_set<T>& s
  */
 //#define LOD_USE_WEIGHTS_FOR_MERGING
 
+/**
+ * The sheet components of the merge loop in @see generateSheetLevelOfDetailEdgeStructure are kept at stable indices:
+ * The initial components keep their index, and the component created in merge iteration t (starting at 1) gets the
+ * index numInitialComponents + t - 1. A union-find forest over these indices tells which components are still alive
+ * (i.e., roots), so connections in the priority queue can be invalidated lazily instead of rebuilding the queue.
+ *
+ * Ties between connections of equal type and weight are broken in the order the components would have in an array
+ * where each newly merged component is put in front of all other (remaining) components. The order key of a component
+ * sorts like its position in this array.
+ */
+class SheetComponentForest {
+public:
+    explicit SheetComponentForest(size_t numInitialComponents) : numInitialComponents(numInitialComponents) {
+        parents.resize(numInitialComponents);
+        orderKeys.resize(numInitialComponents);
+        for (size_t i = 0; i < numInitialComponents; i++) {
+            parents.at(i) = uint32_t(i);
+            orderKeys.at(i) = uint32_t(numInitialComponents + i);
+        }
+    }
+
+    /// Merges the components with the passed indices and returns the index of the merged component.
+    uint32_t merge(uint32_t idx0, uint32_t idx1) {
+        uint32_t mergedIdx = uint32_t(parents.size());
+        parents.push_back(mergedIdx);
+        orderKeys.push_back(uint32_t(numInitialComponents - (parents.size() - numInitialComponents)));
+        parents.at(idx0) = mergedIdx;
+        parents.at(idx1) = mergedIdx;
+        return mergedIdx;
+    }
+
+    /// Returns the index of the (alive) component the passed component has been merged into.
+    uint32_t find(uint32_t idx) {
+        while (parents.at(idx) != idx) {
+            parents.at(idx) = parents.at(parents.at(idx));
+            idx = parents.at(idx);
+        }
+        return idx;
+    }
+
+    inline bool isAlive(uint32_t idx) const { return parents.at(idx) == idx; }
+    inline uint32_t getOrderKey(uint32_t idx) const { return orderKeys.at(idx); }
+
+private:
+    size_t numInitialComponents;
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> orderKeys;
+};
+
+/**
+ * An entry of the merge priority queue. The order keys of the components are stored in @see data, such that
+ * ComponentConnectionData::operator< yields the merge order.
+ */
+struct SheetComponentConnectionEntry {
+    ComponentConnectionData data;
+    uint32_t idx0, idx1; ///< The indices of the connected components.
+
+    SheetComponentConnectionEntry(
+            SheetComponentForest& forest, uint32_t idx0, uint32_t idx1,
+            ComponentConnectionType componentConnectionType, float weight) : idx0(idx0), idx1(idx1) {
+        if (forest.getOrderKey(this->idx0) > forest.getOrderKey(this->idx1)) {
+            std::swap(this->idx0, this->idx1);
+        }
+        data.firstIdx = forest.getOrderKey(this->idx0);
+        data.secondIdx = forest.getOrderKey(this->idx1);
+        data.componentConnectionType = componentConnectionType;
+        data.weight = weight;
+    }
+
+    /// std::priority_queue keeps the largest element on top, so the order needs to be inverted.
+    bool operator<(const SheetComponentConnectionEntry& rhs) const {
+        return rhs.data < data;
+    }
+};
+
 void generateSheetLevelOfDetailEdgeStructure(
         HexMesh* hexMesh,
         std::vector<float> &edgeLodValues,
@@ -100,10 +177,14 @@ void generateSheetLevelOfDetailEdgeStructure(
     std::vector<ComponentConnectionData> connectionDataList;
     computeHexahedralSheetComponentConnectionData(
             hexMesh, components, useVolumeAndAreaMeasures, useNumCellsOrVolume, connectionDataList);
-    std::set<ComponentConnectionData> connectionDataSet; // Use similarly to a priority queue
+    SheetComponentForest componentForest(components.size());
+    std::priority_queue<SheetComponentConnectionEntry> connectionQueue;
     for (ComponentConnectionData& componentConnectionData : connectionDataList) {
-        connectionDataSet.insert(componentConnectionData);
+        connectionQueue.push(SheetComponentConnectionEntry(
+                componentForest, componentConnectionData.firstIdx, componentConnectionData.secondIdx,
+                componentConnectionData.componentConnectionType, componentConnectionData.weight));
     }
+    components.reserve(components.size() * 2);
 
     // This array represents a map storing for each line the LOD level where it was marked as last visible.
     std::vector<int> lodEdgeVisibilityMap;
@@ -122,7 +203,12 @@ void generateSheetLevelOfDetailEdgeStructure(
 
     int iterationNumber = 1;
     while (true) {
-        if (connectionDataSet.size() == 0) {
+        // Connections to components that were merged in the meantime are outdated.
+        while (!connectionQueue.empty() && (!componentForest.isAlive(connectionQueue.top().idx0)
+                || !componentForest.isAlive(connectionQueue.top().idx1))) {
+            connectionQueue.pop();
+        }
+        if (connectionQueue.empty()) {
             sgl::Logfile::get()->writeInfo("Finished merging all mesh sheet components.");
             break;
         }
@@ -131,14 +217,11 @@ void generateSheetLevelOfDetailEdgeStructure(
                 std::string() + "Starting iteration number " + std::to_string(iterationNumber) + "...");
         auto startIteration = std::chrono::system_clock::now();
 
-        // An index map mapping the indices of the components to their indices after merging (in @see mergedComponents).
-        std::unordered_map<uint32_t, uint32_t> mergedComponentIndexMap;
-        std::vector<SheetComponent*> mergedComponents;
-        mergedComponents.reserve(components.size() - 1);
-
         // Find the LOD with the best merging weight.
-        ComponentConnectionData bestMatchingComponentConnectionData = *connectionDataSet.begin();
-        connectionDataSet.erase(connectionDataSet.begin());
+        uint32_t componentIdx0 = connectionQueue.top().idx0;
+        uint32_t componentIdx1 = connectionQueue.top().idx1;
+        ComponentConnectionData bestMatchingComponentConnectionData = connectionQueue.top().data;
+        connectionQueue.pop();
 
         // For creating a discrete LOD when switching from merging adjacent to hybrid or intersecting sheet components.
         if (bestMatchingComponentConnectionData.componentConnectionType == ComponentConnectionType::INTERSECTING
@@ -152,8 +235,8 @@ void generateSheetLevelOfDetailEdgeStructure(
         }
 
         // Mark all edges as invisible on this level shared by matched components.
-        SheetComponent* component0 = components.at(bestMatchingComponentConnectionData.firstIdx);
-        SheetComponent* component1 = components.at(bestMatchingComponentConnectionData.secondIdx);
+        SheetComponent* component0 = components.at(componentIdx0);
+        SheetComponent* component1 = components.at(componentIdx1);
         SheetComponent* mergedComponent = new SheetComponent;
         // Cells(c') = (Cells(c_0) UNION Cells(c_1))
         std::set_union(
@@ -244,88 +327,47 @@ void generateSheetLevelOfDetailEdgeStructure(
             }
         }
 
-        // Add the merged component to the index map and the merged component set.
-        mergedComponents.push_back(mergedComponent);
-        size_t mergedComponentIndex = 0;
-        mergedComponentIndexMap.insert(std::make_pair(
-                bestMatchingComponentConnectionData.firstIdx, uint32_t(mergedComponentIndex)));
-        mergedComponentIndexMap.insert(std::make_pair(
-                bestMatchingComponentConnectionData.secondIdx, uint32_t(mergedComponentIndex)));
-        mergedComponentIndex++;
-
-        // Add all unmatched (i.e., unchanged) components to the index map and the merged component set.
-        size_t oldComponentIndex = 0;
-        for (SheetComponent* component : components) {
-            mergedComponentIndexMap.insert(
-                    std::make_pair(uint32_t(oldComponentIndex), uint32_t(mergedComponentIndex)));
-            if (component != component0 && component != component1) {
-                mergedComponents.push_back(component);
-                mergedComponentIndex++;
-            }
-            oldComponentIndex++;
-        }
+        // Add the merged component. It takes over the neighbors of the two old components.
+        uint32_t mergedComponentIdx = componentForest.merge(componentIdx0, componentIdx1);
+        components.push_back(mergedComponent);
+        components.at(componentIdx0) = nullptr;
+        components.at(componentIdx1) = nullptr;
+        std::vector<uint32_t> neighborIndices;
+        neighborIndices.insert(
+                neighborIndices.end(), component0->neighborIndices.begin(), component0->neighborIndices.end());
+        neighborIndices.insert(
+                neighborIndices.end(), component1->neighborIndices.begin(), component1->neighborIndices.end());
+        std::sort(neighborIndices.begin(), neighborIndices.end());
+        neighborIndices.erase(std::unique(neighborIndices.begin(), neighborIndices.end()), neighborIndices.end());
 
         // Free the memory of the old components. They are no longer used afterwards.
         delete component0;
         delete component1;
 
-        // Fix the indices of the neighborship relation using the index map and recompute the merging weight between
-        // the neighbors of the merged component and the merged component itself.
-        for (int i = 1; i < mergedComponents.size(); i++) {
-            SheetComponent* component = mergedComponents.at(i);
-            std::unordered_set<uint32_t> newNeighborIndices;
-            for (uint32_t oldNeighborIndex : component->neighborIndices) {
-                uint32_t newNeighborIndex = mergedComponentIndexMap.find(oldNeighborIndex)->second;
-                if (newNeighborIndex != i) {
-                    newNeighborIndices.insert(newNeighborIndex);
-                }
-            }
-            component->neighborIndices = newNeighborIndices;
-        }
-        std::set<ComponentConnectionData> mergedConnectionDataSet;
-        std::unordered_set<ComponentConnectionData, ComponentConnectionDataHasher> mergedConnectionDataUnorderedSet;
-        for (const ComponentConnectionData& connectionData : connectionDataSet) {
-            ComponentConnectionData mergedConnectionData;
-            mergedConnectionData.firstIdx = mergedComponentIndexMap.find(connectionData.firstIdx)->second;
-            mergedConnectionData.secondIdx = mergedComponentIndexMap.find(connectionData.secondIdx)->second;
-            if (mergedConnectionData.firstIdx > mergedConnectionData.secondIdx) {
-                size_t tmp = mergedConnectionData.firstIdx;
-                mergedConnectionData.firstIdx = mergedConnectionData.secondIdx;
-                mergedConnectionData.secondIdx = tmp;
+        // Recompute the merging weight between the neighbors of the old components and the merged component. The
+        // connections of all other components are not affected by the merge.
+        for (uint32_t neighborIdx : neighborIndices) {
+            if (neighborIdx == componentIdx0 || neighborIdx == componentIdx1) {
+                continue;
             }
-
-            auto it = mergedConnectionDataUnorderedSet.find(mergedConnectionData);
-            if (it == mergedConnectionDataUnorderedSet.end()) {
-                if (mergedConnectionData.firstIdx == 0 || mergedConnectionData.secondIdx == 0) {
-                    float weight;
-                    ComponentConnectionType componentConnectionType;
-                    bool isNeighbor = computeHexahedralSheetComponentNeighborship(
-                            hexMesh,
-                            *mergedComponents.at(mergedConnectionData.firstIdx),
-                            *mergedComponents.at(mergedConnectionData.secondIdx),
-                            useVolumeAndAreaMeasures, useNumCellsOrVolume, weight, componentConnectionType);
-                    mergedConnectionData.weight = weight;
-                    mergedConnectionData.componentConnectionType = componentConnectionType;
-                    mergedComponents.at(mergedConnectionData.firstIdx)->neighborIndices.insert(
-                            mergedConnectionData.secondIdx);
-                    mergedComponents.at(mergedConnectionData.secondIdx)->neighborIndices.insert(
-                            mergedConnectionData.firstIdx);
-                    if (!isNeighbor) {
-                        continue;
-                    }
-                } else {
-                    mergedConnectionData.weight = connectionData.weight;
-                    mergedConnectionData.componentConnectionType = connectionData.componentConnectionType;
-                }
-                mergedConnectionDataUnorderedSet.insert(mergedConnectionData);
-                mergedConnectionDataSet.insert(mergedConnectionData);
+            SheetComponent* neighborComponent = components.at(neighborIdx);
+            neighborComponent->neighborIndices.erase(componentIdx0);
+            neighborComponent->neighborIndices.erase(componentIdx1);
+
+            float weight;
+            ComponentConnectionType componentConnectionType;
+            bool isNeighbor = computeHexahedralSheetComponentNeighborship(
+                    hexMesh, *mergedComponent, *neighborComponent,
+                    useVolumeAndAreaMeasures, useNumCellsOrVolume, weight, componentConnectionType);
+            if (!isNeighbor) {
+                continue;
             }
+            mergedComponent->neighborIndices.insert(neighborIdx);
+            neighborComponent->neighborIndices.insert(mergedComponentIdx);
+            connectionQueue.push(SheetComponentConnectionEntry(
+                    componentForest, mergedComponentIdx, neighborIdx, componentConnectionType, weight));
         }
 
-        // Set data to merged data for the next iteration.
-        components = mergedComponents;
-        connectionDataSet = mergedConnectionDataSet;
-
         auto endIteration = std::chrono::system_clock::now();
         auto elapsedIteration = std::chrono::duration_cast<std::chrono::milliseconds>(endIteration - startIteration);
         sgl::Logfile::get()->writeInfo(
@@ -40,8 +40,15 @@
 
 #include "Mesh/HexMesh/Renderers/Helpers/LineRenderingDefines.hpp"
 #include "Mesh/HexMesh/Renderers/LOD/LodSheetGeneration.hpp"
+#include "Mesh/HexMesh/Renderers/Helpers/VisualizationMappingCache.hpp"
 #include "LineDensityControlRenderer.hpp"
 
+struct LineDensityControlMapping : public VisualizationMapping {
+    sgl::GeometryBufferPtr indexBuffer;
+    sgl::GeometryBufferPtr hexahedralCellFacesBuffer;
+    int maxLodValue = 0;
+};
+
 /// Expected (average) depth complexity, i.e. width*height* this value = number of fragments that can be stored.
 static int EXPECTED_DEPTH_COMPLEXITY = 90;
 
@@ -171,10 +178,27 @@ void LineDensityControlRenderer::uploadVisualizationMapping(HexMeshPtr meshIn, b
             std::cbrt(meshIn->getAverageCellVolume()) * LINE_WIDTH_VOLUME_CBRT_FACTOR,
             MIN_LINE_WIDTH_AUTO, MAX_LINE_WIDTH_AUTO);
 
-    std::vector<uint32_t> triangleIndices;
-    std::vector<HexahedralCellFaceLineDensityControl> hexahedralCellFaces;
-    meshIn->getSurfaceDataWireframeFacesLineDensityControl(
-            triangleIndices, hexahedralCellFaces, maxLodValue);
+    // Reuse the cached mapping if neither the mesh nor the filters changed since it was generated.
+    VisualizationMappingKey mappingKey(getWindowName(), *meshIn);
+    std::shared_ptr<LineDensityControlMapping> mapping =
+            sceneData.visualizationMappingCache.get<LineDensityControlMapping>(mappingKey);
+    if (!mapping) {
+        std::vector<uint32_t> triangleIndices;
+        std::vector<HexahedralCellFaceLineDensityControl> hexahedralCellFaces;
+        mapping = std::make_shared<LineDensityControlMapping>();
+        meshIn->getSurfaceDataWireframeFacesLineDensityControl(
+                triangleIndices, hexahedralCellFaces, mapping->maxLodValue);
+
+        mapping->indexBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER),
+                sizeof(uint32_t)*triangleIndices.size());
+        mapping->hexahedralCellFacesBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                hexahedralCellFaces.size()*sizeof(HexahedralCellFaceLineDensityControl),
+                hexahedralCellFaces.data(), sgl::SHADER_STORAGE_BUFFER),
+                hexahedralCellFaces.size()*sizeof(HexahedralCellFaceLineDensityControl));
+        sceneData.visualizationMappingCache.put(mappingKey, mapping);
+    }
+    maxLodValue = mapping->maxLodValue;
 
     lineDensityControlRenderData = sgl::ShaderManager->createShaderAttributes(lineDensityControlShader);
     lineDensityControlRenderData->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
@@ -183,15 +207,11 @@ void LineDensityControlRenderer::uploadVisualizationMapping(HexMeshPtr meshIn, b
     createAttributeTextureGatherRenderData->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER);
-    lineDensityControlRenderData->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
-    createAttributeTextureGatherRenderData->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    lineDensityControlRenderData->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    createAttributeTextureGatherRenderData->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Create an SSBO for the hexahedral cell faces.
-    hexahedralCellFacesBuffer = sgl::Renderer->createGeometryBuffer(
-            hexahedralCellFaces.size()*sizeof(HexahedralCellFaceLineDensityControl),
-            hexahedralCellFaces.data(), sgl::SHADER_STORAGE_BUFFER);
+    hexahedralCellFacesBuffer = mapping->hexahedralCellFacesBuffer;
 
     singularEdgeColorMapWidget.generateSingularityStructureInformation(meshIn);
 
@@ -35,16 +35,19 @@
 #include "Mesh/HexMesh/Renderers/Intersection/RayMeshIntersection.hpp"
 
 class AutomaticPerformanceMeasurer;
+class VisualizationMappingCache;
 
 struct SceneData {
     SceneData(
             sgl::FramebufferObjectPtr* framebuffer, sgl::TexturePtr* sceneTexture,
             sgl::RenderbufferObjectPtr* sceneDepthRBO, sgl::CameraPtr& camera, sgl::Color& clearColor,
             AutomaticPerformanceMeasurer*& performanceMeasurer, bool& recordingMode,
-            bool& useCameraFlight, RayMeshIntersection& rayMeshIntersection)
+            bool& useCameraFlight, RayMeshIntersection& rayMeshIntersection,
+            VisualizationMappingCache& visualizationMappingCache)
         : framebuffer(framebuffer), sceneTexture(sceneTexture), sceneDepthRBO(sceneDepthRBO), camera(camera),
           clearColor(clearColor), performanceMeasurer(performanceMeasurer), recordingMode(recordingMode),
-          useCameraFlight(useCameraFlight), rayMeshIntersection(rayMeshIntersection) {}
+          useCameraFlight(useCameraFlight), rayMeshIntersection(rayMeshIntersection),
+          visualizationMappingCache(visualizationMappingCache) {}
     sgl::FramebufferObjectPtr* framebuffer;
     sgl::TexturePtr* sceneTexture;
     sgl::RenderbufferObjectPtr* sceneDepthRBO;
@@ -55,6 +58,8 @@ struct SceneData {
     bool& recordingMode;
     bool& useCameraFlight;
     RayMeshIntersection& rayMeshIntersection;
+    /// Lets renderers reuse their last visualization mapping if the mesh, filters and settings didn't change.
+    VisualizationMappingCache& visualizationMappingCache;
     int pickingOffsetX = 0, pickingOffsetY = 0;
 };
 
@@ -29,7 +29,9 @@
 #include <Graphics/Renderer.hpp>
 #include <Graphics/Shader/ShaderManager.hpp>
 #include <Graphics/OpenGL/RendererGL.hpp>
+#include <Graphics/OpenGL/GeometryBuffer.hpp>
 
+#include "Helpers/GeometryBufferOutput.hpp"
 #include "SurfaceRenderer.hpp"
 
 const glm::vec4 hullColor = glm::vec4(
@@ -47,73 +49,122 @@ SurfaceRenderer::SurfaceRenderer(SceneData &sceneData, sgl::TransferFunctionWind
     sgl::ShaderManager->removePreprocessorDefine("DIRECT_BLIT_GATHER");
 }
 
+/**
+ * Uploads the elements [begin, end) of the passed data to the same range of the geometry buffer.
+ */
+template<class T>
+static void uploadBufferRange(const sgl::GeometryBufferPtr& geometryBuffer, const std::vector<T>& data,
+        size_t begin, size_t end) {
+    if (end <= begin) {
+        return;
+    }
+    glNamedBufferSubData(
+            static_cast<sgl::GeometryBufferGL*>(geometryBuffer.get())->getBuffer(),
+            GLintptr(begin * sizeof(T)), GLsizeiptr((end - begin) * sizeof(T)), data.data() + begin);
+}
+
 void SurfaceRenderer::uploadVisualizationMapping(HexMeshPtr meshIn, bool isNewMesh) {
-    std::vector<uint32_t> triangleIndices;
-    std::vector<glm::vec3> vertexPositions;
-    std::vector<glm::vec3> vertexNormals;
-    std::vector<float> vertexAttributes;
-    meshIn->getSurfaceData(triangleIndices, vertexPositions, vertexNormals, vertexAttributes);
+    // After a filter change, only the faces next to cells with a changed filtering state are updated.
+    meshIn->updateFilteredSurfaceData(filteredSurfaceData);
+    if (filteredSurfaceData.getWasRebuilt() || !shaderAttributesSurface
+            || filteredSurfaceData.getNumFaces() > surfaceFaceCapacity) {
+        createSurfaceBuffers();
+    } else {
+        updateSurfaceBuffers(filteredSurfaceData.getFirstChangedFace());
+    }
+
+    // The hull doesn't depend on the filters, so it only needs to be regenerated if the mesh data changed.
+    if (!shaderAttributesHull || hullMeshDataGeneration != meshIn->getMeshDataGeneration()) {
+        createHullBuffers(meshIn);
+        hullMeshDataGeneration = meshIn->getMeshDataGeneration();
+    }
+
+    dirty = false;
+    reRender = true;
+}
+
+void SurfaceRenderer::createSurfaceBuffers() {
+    // Reserve some space for faces added by later filter changes, which can then be patched in place.
+    size_t numFaces = filteredSurfaceData.getNumFaces();
+    surfaceFaceCapacity = std::max(numFaces + numFaces / 4, size_t(64));
 
     shaderAttributesSurface = sgl::ShaderManager->createShaderAttributes(shaderProgramSurface);
     shaderAttributesSurface->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER);
-    shaderAttributesSurface->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    surfaceIndexBuffer = sgl::Renderer->createGeometryBuffer(
+            sizeof(uint32_t)*surfaceFaceCapacity*6, NULL, sgl::INDEX_BUFFER);
+    shaderAttributesSurface->setIndexGeometryBuffer(surfaceIndexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER);
+    surfacePositionBuffer = sgl::Renderer->createGeometryBuffer(
+            sizeof(glm::vec3)*surfaceFaceCapacity*4, NULL, sgl::VERTEX_BUFFER);
     shaderAttributesSurface->addGeometryBuffer(
-            positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
+            surfacePositionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     // Add the normal buffer.
-    sgl::GeometryBufferPtr normalBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexNormals.size()*sizeof(glm::vec3), vertexNormals.data(), sgl::VERTEX_BUFFER);
+    surfaceNormalBuffer = sgl::Renderer->createGeometryBuffer(
+            sizeof(glm::vec3)*surfaceFaceCapacity*4, NULL, sgl::VERTEX_BUFFER);
     shaderAttributesSurface->addGeometryBuffer(
-            normalBuffer, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
+            surfaceNormalBuffer, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
 
     // Add the color buffer.
-    sgl::GeometryBufferPtr attributeBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexAttributes.size()*sizeof(float), vertexAttributes.data(), sgl::VERTEX_BUFFER);
+    surfaceAttributeBuffer = sgl::Renderer->createGeometryBuffer(
+            sizeof(float)*surfaceFaceCapacity*4, NULL, sgl::VERTEX_BUFFER);
     shaderAttributesSurface->addGeometryBuffer(
-            attributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
+            surfaceAttributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
 
+    // The unused slots are drawn as degenerate triangles.
+    numUploadedSurfaceFaces = surfaceFaceCapacity;
+    updateSurfaceBuffers(0);
+}
 
+void SurfaceRenderer::updateSurfaceBuffers(size_t firstChangedFace) {
+    size_t numFaces = filteredSurfaceData.getNumFaces();
+    uploadBufferRange(surfaceIndexBuffer, filteredSurfaceData.triangleIndices, firstChangedFace * 6, numFaces * 6);
+    uploadBufferRange(surfacePositionBuffer, filteredSurfaceData.vertexPositions, firstChangedFace * 4, numFaces * 4);
+    uploadBufferRange(surfaceNormalBuffer, filteredSurfaceData.vertexNormals, firstChangedFace * 4, numFaces * 4);
+    uploadBufferRange(surfaceAttributeBuffer, filteredSurfaceData.vertexAttributes, firstChangedFace * 4, numFaces * 4);
+
+    // Slots freed by this update are turned into degenerate triangles by setting their indices to zero.
+    if (numUploadedSurfaceFaces > numFaces) {
+        GLuint zero = 0;
+        glClearNamedBufferSubData(
+                static_cast<sgl::GeometryBufferGL*>(surfaceIndexBuffer.get())->getBuffer(), GL_R32UI,
+                GLintptr(numFaces * 6 * sizeof(uint32_t)),
+                GLsizeiptr((numUploadedSurfaceFaces - numFaces) * 6 * sizeof(uint32_t)),
+                GL_RED_INTEGER, GL_UNSIGNED_INT, (const void*)&zero);
+    }
+    numUploadedSurfaceFaces = numFaces;
+}
 
-    // Get hull data.
-    std::vector<uint32_t> triangleIndicesHull;
-    std::vector<glm::vec3> vertexPositionsHull;
-    std::vector<glm::vec3> vertexNormalsHull;
-    std::vector<float> vertexAttributesHull;
+void SurfaceRenderer::createHullBuffers(HexMeshPtr meshIn) {
+    // Get hull data. It is written directly into the mapped GPU buffers.
+    GeometryBufferOutput<uint32_t> indexBufferHullOutput(sgl::INDEX_BUFFER);
+    GeometryBufferOutput<glm::vec3> positionBufferHullOutput(sgl::VERTEX_BUFFER);
+    GeometryBufferOutput<glm::vec3> normalBufferHullOutput(sgl::VERTEX_BUFFER);
+    vertexAttributesHull.clear();
     meshIn->getSurfaceData(
-            triangleIndicesHull, vertexPositionsHull,
-            vertexNormalsHull, vertexAttributesHull,
+            indexBufferHullOutput.getOutputBuffer(), positionBufferHullOutput.getOutputBuffer(),
+            normalBufferHullOutput.getOutputBuffer(), vertexAttributesHull,
             false);
 
     shaderAttributesHull = sgl::ShaderManager->createShaderAttributes(shaderProgramHull);
     shaderAttributesHull->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBufferHull = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndicesHull.size(), triangleIndicesHull.data(), sgl::INDEX_BUFFER);
+    sgl::GeometryBufferPtr indexBufferHull = indexBufferHullOutput.finish();
     shaderAttributesHull->setIndexGeometryBuffer(indexBufferHull, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBufferHull = sgl::Renderer->createGeometryBuffer(
-            vertexPositionsHull.size()*sizeof(glm::vec3), vertexPositionsHull.data(), sgl::VERTEX_BUFFER);
+    sgl::GeometryBufferPtr positionBufferHull = positionBufferHullOutput.finish();
     shaderAttributesHull->addGeometryBuffer(
             positionBufferHull, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     // Add the normal buffer.
-    sgl::GeometryBufferPtr normalBufferHull = sgl::Renderer->createGeometryBuffer(
-            vertexNormalsHull.size()*sizeof(glm::vec3), vertexNormalsHull.data(), sgl::VERTEX_BUFFER);
+    sgl::GeometryBufferPtr normalBufferHull = normalBufferHullOutput.finish();
     shaderAttributesHull->addGeometryBuffer(
             normalBufferHull, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
-
-    dirty = false;
-    reRender = true;
 }
 
 void SurfaceRenderer::render() {
@@ -56,10 +56,28 @@ public:
     virtual void renderGui();
 
 protected:
+    /// Recreates the surface buffers with some spare capacity and uploads all faces.
+    void createSurfaceBuffers();
+    /// Uploads the faces starting at firstChangedFace and turns the slots freed since the last upload degenerate.
+    void updateSurfaceBuffers(size_t firstChangedFace);
+    void createHullBuffers(HexMeshPtr meshIn);
+
     sgl::ShaderProgramPtr shaderProgramSurface;
     sgl::ShaderProgramPtr shaderProgramHull;
     sgl::ShaderAttributesPtr shaderAttributesSurface;
     sgl::ShaderAttributesPtr shaderAttributesHull;
+    FilteredSurfaceData filteredSurfaceData;
+    // The surface buffers are patched in place after filter changes (see FilteredSurfaceData::getFirstChangedFace).
+    sgl::GeometryBufferPtr surfaceIndexBuffer;
+    sgl::GeometryBufferPtr surfacePositionBuffer;
+    sgl::GeometryBufferPtr surfaceNormalBuffer;
+    sgl::GeometryBufferPtr surfaceAttributeBuffer;
+    size_t surfaceFaceCapacity = 0;
+    size_t numUploadedSurfaceFaces = 0;
+    // The mesh data generation the hull buffers were generated for.
+    uint64_t hullMeshDataGeneration = 0;
+    // The hull is rendered without attributes. The buffer keeps its capacity between regenerations.
+    OutputBuffer<float> vertexAttributesHull;
 
     // GUI data
     bool showRendererWindow = true;
@@ -38,8 +38,20 @@
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Helpers/SortingVendorFix.hpp"
+#include "Helpers/GeometryBufferOutput.hpp"
+#include "Helpers/VisualizationMappingCache.hpp"
 #include "VolumeRenderer_Faces.hpp"
 
+struct VolumeFacesMapping : public VisualizationMapping {
+    sgl::GeometryBufferPtr indexBuffer;
+    sgl::GeometryBufferPtr positionBuffer;
+    sgl::GeometryBufferPtr normalBuffer;
+    sgl::GeometryBufferPtr attributeBuffer;
+    sgl::GeometryBufferPtr indexBufferHull;
+    sgl::GeometryBufferPtr positionBufferHull;
+    sgl::GeometryBufferPtr normalBufferHull;
+};
+
 const char* const sortingModeStrings[] = {"Priority Queue", "Bubble Sort", "Insertion Sort", "Shell Sort", "Max Heap"};
 
 // Use stencil buffer to mask unused pixels
@@ -103,75 +115,93 @@ VolumeRenderer_Faces::VolumeRenderer_Faces(SceneData &sceneData, sgl::TransferFu
 
 void VolumeRenderer_Faces::uploadVisualizationMapping(HexMeshPtr meshIn, bool isNewMesh) {
     this->hexMesh = meshIn;
-    
-    std::vector<uint32_t> triangleIndices;
-    std::vector<glm::vec3> vertexPositions;
-    std::vector<glm::vec3> vertexNormals;
-    std::vector<float> vertexAttributes;
-    if (useWeightedVertexAttributes) {
-        meshIn->getVolumeData_FacesShared(triangleIndices, vertexPositions, vertexAttributes);
-        // Just fill with dummy data for now
-        vertexNormals.resize(vertexPositions.size(), glm::vec3(1.0f));
-    } else {
-        meshIn->getVolumeData_Faces(triangleIndices, vertexPositions, vertexNormals, vertexAttributes);
+
+    // Reuse the cached mapping if neither the mesh, the filters nor the settings changed since it was generated.
+    VisualizationMappingKey mappingKey(
+            getWindowName(), *meshIn, useWeightedVertexAttributes ? "weightedVertexAttributes" : "");
+    std::shared_ptr<VolumeFacesMapping> mapping =
+            sceneData.visualizationMappingCache.get<VolumeFacesMapping>(mappingKey);
+    if (!mapping) {
+        mapping = std::make_shared<VolumeFacesMapping>();
+
+        // The output buffers are members, so they keep their capacity when the mapping is regenerated.
+        triangleIndices.clear();
+        vertexPositions.clear();
+        vertexNormals.clear();
+        vertexAttributes.clear();
+        if (useWeightedVertexAttributes) {
+            meshIn->getVolumeData_FacesShared(triangleIndices, vertexPositions, vertexAttributes);
+            // Just fill with dummy data for now
+            vertexNormals.resize(vertexPositions.size());
+            std::fill(vertexNormals.data(), vertexNormals.data() + vertexNormals.size(), glm::vec3(1.0f));
+        } else {
+            meshIn->getVolumeData_Faces(triangleIndices, vertexPositions, vertexNormals, vertexAttributes);
+        }
+
+        mapping->indexBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER),
+                sizeof(uint32_t)*triangleIndices.size());
+        mapping->positionBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER),
+                vertexPositions.size()*sizeof(glm::vec3));
+        mapping->normalBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                vertexNormals.size()*sizeof(glm::vec3), vertexNormals.data(), sgl::VERTEX_BUFFER),
+                vertexNormals.size()*sizeof(glm::vec3));
+        mapping->attributeBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                vertexAttributes.size()*sizeof(float), vertexAttributes.data(), sgl::VERTEX_BUFFER),
+                vertexAttributes.size()*sizeof(float));
+
+        // Get hull data. It is written directly into the mapped GPU buffers.
+        GeometryBufferOutput<uint32_t> indexBufferHullOutput(sgl::INDEX_BUFFER);
+        GeometryBufferOutput<glm::vec3> positionBufferHullOutput(sgl::VERTEX_BUFFER);
+        GeometryBufferOutput<glm::vec3> normalBufferHullOutput(sgl::VERTEX_BUFFER);
+        vertexAttributesHull.clear();
+        meshIn->getSurfaceData(
+                indexBufferHullOutput.getOutputBuffer(), positionBufferHullOutput.getOutputBuffer(),
+                normalBufferHullOutput.getOutputBuffer(), vertexAttributesHull,
+                false);
+        mapping->indexBufferHull = mapping->addBuffer(
+                indexBufferHullOutput.finish(), indexBufferHullOutput.getSizeInBytes());
+        mapping->positionBufferHull = mapping->addBuffer(
+                positionBufferHullOutput.finish(), positionBufferHullOutput.getSizeInBytes());
+        mapping->normalBufferHull = mapping->addBuffer(
+                normalBufferHullOutput.finish(), normalBufferHullOutput.getSizeInBytes());
+
+        sceneData.visualizationMappingCache.put(mappingKey, mapping);
     }
 
     shaderAttributes = sgl::ShaderManager->createShaderAttributes(gatherShader);
     shaderAttributes->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER);
-    shaderAttributes->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    shaderAttributes->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER);
     shaderAttributes->addGeometryBuffer(
-            positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
+            mapping->positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     // Add the normal buffer.
-    sgl::GeometryBufferPtr normalBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexNormals.size()*sizeof(glm::vec3), vertexNormals.data(), sgl::VERTEX_BUFFER);
     shaderAttributes->addGeometryBuffer(
-            normalBuffer, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
+            mapping->normalBuffer, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
 
     // Add the color buffer.
-    sgl::GeometryBufferPtr attributeBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexAttributes.size()*sizeof(float), vertexAttributes.data(), sgl::VERTEX_BUFFER);
     shaderAttributes->addGeometryBuffer(
-            attributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
-
+            mapping->attributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
 
-    // Get hull data.
-    std::vector<uint32_t> triangleIndicesHull;
-    std::vector<glm::vec3> vertexPositionsHull;
-    std::vector<glm::vec3> vertexNormalsHull;
-    std::vector<float> vertexAttributesHull;
-    meshIn->getSurfaceData(
-            triangleIndicesHull, vertexPositionsHull,
-            vertexNormalsHull, vertexAttributesHull,
-            false);
 
     shaderAttributesHull = sgl::ShaderManager->createShaderAttributes(gatherShaderHull);
     shaderAttributesHull->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBufferHull = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndicesHull.size(), triangleIndicesHull.data(), sgl::INDEX_BUFFER);
-    shaderAttributesHull->setIndexGeometryBuffer(indexBufferHull, sgl::ATTRIB_UNSIGNED_INT);
+    shaderAttributesHull->setIndexGeometryBuffer(mapping->indexBufferHull, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBufferHull = sgl::Renderer->createGeometryBuffer(
-            vertexPositionsHull.size()*sizeof(glm::vec3), vertexPositionsHull.data(), sgl::VERTEX_BUFFER);
     shaderAttributesHull->addGeometryBuffer(
-            positionBufferHull, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
+            mapping->positionBufferHull, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     // Add the normal buffer.
-    sgl::GeometryBufferPtr normalBufferHull = sgl::Renderer->createGeometryBuffer(
-            vertexNormalsHull.size()*sizeof(glm::vec3), vertexNormalsHull.data(), sgl::VERTEX_BUFFER);
     shaderAttributesHull->addGeometryBuffer(
-            normalBufferHull, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
+            mapping->normalBufferHull, "vertexNormal", sgl::ATTRIB_FLOAT, 3);
 
     dirty = false;
     reRender = true;
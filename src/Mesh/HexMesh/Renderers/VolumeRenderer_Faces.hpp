@@ -77,6 +77,12 @@ protected:
     // The rendering data for the volume object.
     sgl::ShaderAttributesPtr shaderAttributes;
     sgl::ShaderAttributesPtr shaderAttributesHull;
+    // Output of the mesh data extractors. Kept between regenerations of the visualization mapping to reuse the memory.
+    OutputBuffer<uint32_t> triangleIndices;
+    OutputBuffer<glm::vec3> vertexPositions;
+    OutputBuffer<glm::vec3> vertexNormals;
+    OutputBuffer<float> vertexAttributes;
+    OutputBuffer<float> vertexAttributesHull;
 
     // Per-pixel linked list data.
     sgl::GeometryBufferPtr fragmentBuffer;
@@ -38,8 +38,16 @@
 #include <ImGui/ImGuiWrapper.hpp>
 
 #include "Helpers/SortingVendorFix.hpp"
+#include "Helpers/GeometryBufferOutput.hpp"
+#include "Helpers/VisualizationMappingCache.hpp"
 #include "VolumeRenderer_Volume.hpp"
 
+struct VolumeVolumeMapping : public VisualizationMapping {
+    sgl::GeometryBufferPtr indexBuffer;
+    sgl::GeometryBufferPtr positionBuffer;
+    sgl::GeometryBufferPtr attributeBuffer;
+};
+
 const char* const sortingModeStrings[] = {"Priority Queue", "Bubble Sort", "Insertion Sort", "Shell Sort", "Max Heap"};
 
 // Use stencil buffer to mask unused pixels
@@ -107,34 +115,49 @@ VolumeRenderer_Volume::VolumeRenderer_Volume(SceneData &sceneData, sgl::Transfer
 void VolumeRenderer_Volume::uploadVisualizationMapping(HexMeshPtr meshIn, bool isNewMesh) {
     this->hexMesh = meshIn;
 
-    std::vector<uint32_t> triangleIndices;
-    std::vector<glm::vec3> vertexPositions;
-    std::vector<float> vertexAttributes;
-    if (useWeightedVertexAttributes) {
-        meshIn->getVolumeData_VolumeShared(triangleIndices, vertexPositions, vertexAttributes);
-    } else {
-        meshIn->getVolumeData_Volume(triangleIndices, vertexPositions, vertexAttributes);
+    // Reuse the cached mapping if neither the mesh, the filters nor the settings changed since it was generated.
+    VisualizationMappingKey mappingKey(
+            getWindowName(), *meshIn, useWeightedVertexAttributes ? "weightedVertexAttributes" : "");
+    std::shared_ptr<VolumeVolumeMapping> mapping =
+            sceneData.visualizationMappingCache.get<VolumeVolumeMapping>(mappingKey);
+    if (!mapping) {
+        // The data is written directly into the mapped GPU buffers.
+        GeometryBufferOutput<uint32_t> indexBufferOutput(sgl::INDEX_BUFFER);
+        GeometryBufferOutput<glm::vec3> positionBufferOutput(sgl::VERTEX_BUFFER);
+        GeometryBufferOutput<float> attributeBufferOutput(sgl::VERTEX_BUFFER);
+        if (useWeightedVertexAttributes) {
+            meshIn->getVolumeData_VolumeShared(
+                    indexBufferOutput.getOutputBuffer(), positionBufferOutput.getOutputBuffer(),
+                    attributeBufferOutput.getOutputBuffer());
+        } else {
+            meshIn->getVolumeData_Volume(
+                    indexBufferOutput.getOutputBuffer(), positionBufferOutput.getOutputBuffer(),
+                    attributeBufferOutput.getOutputBuffer());
+        }
+
+        mapping = std::make_shared<VolumeVolumeMapping>();
+        mapping->indexBuffer = mapping->addBuffer(
+                indexBufferOutput.finish(), indexBufferOutput.getSizeInBytes());
+        mapping->positionBuffer = mapping->addBuffer(
+                positionBufferOutput.finish(), positionBufferOutput.getSizeInBytes());
+        mapping->attributeBuffer = mapping->addBuffer(
+                attributeBufferOutput.finish(), attributeBufferOutput.getSizeInBytes());
+        sceneData.visualizationMappingCache.put(mappingKey, mapping);
     }
 
     shaderAttributesVolumeFrontFaces = sgl::ShaderManager->createShaderAttributes(gatherShaderVolumeFrontFaces);
     shaderAttributesVolumeFrontFaces->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*triangleIndices.size(), triangleIndices.data(), sgl::INDEX_BUFFER);
-    shaderAttributesVolumeFrontFaces->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    shaderAttributesVolumeFrontFaces->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Add the position buffer.
-    sgl::GeometryBufferPtr positionBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexPositions.size()*sizeof(glm::vec3), vertexPositions.data(), sgl::VERTEX_BUFFER);
     shaderAttributesVolumeFrontFaces->addGeometryBuffer(
-            positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
+            mapping->positionBuffer, "vertexPosition", sgl::ATTRIB_FLOAT, 3);
 
     // Add the color buffer.
-    sgl::GeometryBufferPtr attributeBuffer = sgl::Renderer->createGeometryBuffer(
-            vertexAttributes.size()*sizeof(float), vertexAttributes.data(), sgl::VERTEX_BUFFER);
     shaderAttributesVolumeFrontFaces->addGeometryBuffer(
-            attributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
+            mapping->attributeBuffer, "vertexAttribute", sgl::ATTRIB_FLOAT, 1);
 
     // Use the same data for the back faces, but with a different shader.
     shaderAttributesVolumeBackFaces = shaderAttributesVolumeFrontFaces->copy(gatherShaderVolumeBackFaces);
@@ -31,8 +31,14 @@
 #include <Graphics/Shader/ShaderManager.hpp>
 
 #include "Mesh/HexMesh/Renderers/Helpers/LineRenderingDefines.hpp"
+#include "Mesh/HexMesh/Renderers/Helpers/VisualizationMappingCache.hpp"
 #include "WireframeRenderer_Faces.hpp"
 
+struct WireframeFacesMapping : public VisualizationMapping {
+    sgl::GeometryBufferPtr indexBuffer;
+    sgl::GeometryBufferPtr hexahedralCellFacesBuffer;
+};
+
 WireframeRenderer_Faces::WireframeRenderer_Faces(
         SceneData &sceneData, sgl::TransferFunctionWindow &transferFunctionWindow, bool useOutline, bool onlyBoundary)
         : HexahedralMeshRenderer(sceneData, transferFunctionWindow), onlyBoundary(onlyBoundary) {
@@ -55,22 +61,33 @@ void WireframeRenderer_Faces::uploadVisualizationMapping(HexMeshPtr meshIn, bool
             std::cbrt(meshIn->getAverageCellVolume()) * LINE_WIDTH_VOLUME_CBRT_FACTOR,
             MIN_LINE_WIDTH_AUTO, MAX_LINE_WIDTH_AUTO);
 
-    std::vector<uint32_t> indices;
-    std::vector<HexahedralCellFace> hexahedralCellFaces;
-    meshIn->getSurfaceDataWireframeFaces(indices, hexahedralCellFaces, onlyBoundary, false);
+    // Reuse the cached mapping if neither the mesh, the filters nor the settings changed since it was generated.
+    VisualizationMappingKey mappingKey(getWindowName(), *meshIn, onlyBoundary ? "onlyBoundary" : "");
+    std::shared_ptr<WireframeFacesMapping> mapping =
+            sceneData.visualizationMappingCache.get<WireframeFacesMapping>(mappingKey);
+    if (!mapping) {
+        std::vector<uint32_t> indices;
+        std::vector<HexahedralCellFace> hexahedralCellFaces;
+        meshIn->getSurfaceDataWireframeFaces(indices, hexahedralCellFaces, onlyBoundary, false);
+
+        mapping = std::make_shared<WireframeFacesMapping>();
+        mapping->indexBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                sizeof(uint32_t)*indices.size(), indices.data(), sgl::INDEX_BUFFER),
+                sizeof(uint32_t)*indices.size());
+        mapping->hexahedralCellFacesBuffer = mapping->addBuffer(sgl::Renderer->createGeometryBuffer(
+                hexahedralCellFaces.size()*sizeof(HexahedralCellFace), hexahedralCellFaces.data(),
+                sgl::SHADER_STORAGE_BUFFER), hexahedralCellFaces.size()*sizeof(HexahedralCellFace));
+        sceneData.visualizationMappingCache.put(mappingKey, mapping);
+    }
 
     shaderAttributes = sgl::ShaderManager->createShaderAttributes(shaderProgram);
     shaderAttributes->setVertexMode(sgl::VERTEX_MODE_TRIANGLES);
 
     // Add the index buffer.
-    sgl::GeometryBufferPtr indexBuffer = sgl::Renderer->createGeometryBuffer(
-            sizeof(uint32_t)*indices.size(), indices.data(), sgl::INDEX_BUFFER);
-    shaderAttributes->setIndexGeometryBuffer(indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
+    shaderAttributes->setIndexGeometryBuffer(mapping->indexBuffer, sgl::ATTRIB_UNSIGNED_INT);
 
     // Create an SSBO for the hexahedral cell faces.
-    hexahedralCellFacesBuffer = sgl::Renderer->createGeometryBuffer(
-            hexahedralCellFaces.size()*sizeof(HexahedralCellFace), hexahedralCellFaces.data(),
-            sgl::SHADER_STORAGE_BUFFER);
+    hexahedralCellFacesBuffer = mapping->hexahedralCellFacesBuffer;
 
     dirty = false;
     reRender = true;
@@ -0,0 +1,161 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hpp"
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef MAPPED_FILE_USE_MMAP
+    int fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        ::close(fileDescriptor);
+        return false;
+    }
+    size = size_t(fileStat.st_size);
+    if (size == 0) {
+        ::close(fileDescriptor);
+        opened = true;
+        return true;
+    }
+    void* mappedData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    ::close(fileDescriptor);
+    if (mappedData == MAP_FAILED) {
+        size = 0;
+        return false;
+    }
+    // The mesh loaders read the files front to back.
+    madvise(mappedData, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(mappedData);
+    isMemoryMapped = true;
+#else
+    std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    size = size_t(file.tellg());
+    file.seekg(0);
+    if (size > 0) {
+        char* fileData = new char[size];
+        if (!file.read(fileData, std::streamsize(size))) {
+            delete[] fileData;
+            size = 0;
+            return false;
+        }
+        data = fileData;
+    }
+    isMemoryMapped = false;
+#endif
+
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+#ifdef MAPPED_FILE_USE_MMAP
+        if (isMemoryMapped) {
+            munmap(const_cast<char*>(data), size);
+        } else {
+            delete[] data;
+        }
+#else
+        delete[] data;
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    opened = false;
+    isMemoryMapped = false;
+}
+
+
+static inline uint64_t hashMix64(uint64_t x) {
+    // Finalizer of MurmurHash3.
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline uint64_t readUint64Unaligned(const char* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(uint64_t));
+    return value;
+}
+
+uint64_t computeDataHash64(const char* data, size_t size) {
+    const uint64_t prime0 = 0x9e3779b185ebca87ull;
+    const uint64_t prime1 = 0xc2b2ae3d27d4eb4full;
+
+    // Four independent lanes so that the multiplications of consecutive words can be pipelined.
+    uint64_t lanes[4] = { prime0, prime1, prime0 ^ prime1, prime0 + prime1 };
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word = readUint64Unaligned(data + i + lane * 8);
+            lanes[lane] = (lanes[lane] ^ (word * prime1)) * prime0;
+            lanes[lane] = (lanes[lane] << 31) | (lanes[lane] >> 33);
+        }
+    }
+
+    uint64_t hash = uint64_t(size) * prime0;
+    for (int lane = 0; lane < 4; lane++) {
+        hash = (hash ^ hashMix64(lanes[lane])) * prime1;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ uint64_t(static_cast<unsigned char>(data[i]))) * prime0;
+    }
+    return hashMix64(hash);
+}
+
+bool computeFileHash64(const std::string& filename, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    hash = computeDataHash64(file.getData(), file.getSize());
+    return true;
+}
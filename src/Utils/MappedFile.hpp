@@ -0,0 +1,83 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_MAPPEDFILE_HPP
+#define HEXVOLUMERENDERER_MAPPEDFILE_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A read-only view of the full content of a file. On POSIX systems, the file is memory-mapped, i.e., pages are only
+ * read from disk when they are accessed. On other systems, the file is read into a heap buffer as a fallback.
+ */
+class MappedFile {
+public:
+    MappedFile() {}
+    explicit MappedFile(const std::string& filename) { open(filename); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps the passed file into memory.
+     * @param filename The name of the file to open.
+     * @return Whether the file could be opened successfully. An empty file counts as a success.
+     */
+    bool open(const std::string& filename);
+    void close();
+
+    inline bool isOpen() const { return opened; }
+    inline const char* getData() const { return data; }
+    inline size_t getSize() const { return size; }
+    inline const char* begin() const { return data; }
+    inline const char* end() const { return data + size; }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool opened = false;
+    bool isMemoryMapped = false;
+};
+
+/**
+ * Computes a 64-bit hash of the passed data. The hash is not cryptographically secure, but it is fast enough to be
+ * used for validating cached data derived from large files.
+ */
+uint64_t computeDataHash64(const char* data, size_t size);
+
+/**
+ * Computes a 64-bit hash of the content of the passed file (see @see computeDataHash64).
+ * @param filename The name of the file.
+ * @param hash The hash of the file content (only valid if true is returned).
+ * @return Whether the file could be read.
+ */
+bool computeFileHash64(const std::string& filename, uint64_t& hash);
+
+#endif //HEXVOLUMERENDERER_MAPPEDFILE_HPP
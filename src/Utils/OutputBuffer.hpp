@@ -0,0 +1,141 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_OUTPUTBUFFER_HPP
+#define HEXVOLUMERENDERER_OUTPUTBUFFER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+
+#include <Utils/File/Logfile.hpp>
+
+/**
+ * Output of a mesh data extractor (e.g., HexMesh::getSurfaceData). The extractors size the output exactly once per
+ * call and then write to data() in parallel, so the output can be stored either
+ * - in a vector that keeps its capacity between regenerations (no steady-state allocations), or
+ * - in memory provided by the caller as soon as the output size is known, e.g., a mapped GPU buffer. This saves the
+ *   copy from a temporary vector to the GPU.
+ *
+ * Like the extractors writing into std::vector, the output is appended to the current content of the buffer.
+ */
+template<class T>
+class OutputBuffer {
+public:
+    /**
+     * Called with the final number of elements. Returns memory for (at least) this many elements or nullptr.
+     */
+    typedef std::function<T*(size_t numElements)> AllocationFunction;
+    /**
+     * Called when falling back to the internal vector. Copies the first numElements elements of the external memory to
+     * output. After the call, the external memory is no longer accessed.
+     */
+    typedef std::function<void(T* output, size_t numElements)> ReadbackFunction;
+
+    /// Writes into an internal vector, which keeps its capacity between regenerations.
+    OutputBuffer() : outputVector(&ownedVector) {}
+    /// Writes into the passed vector.
+    explicit OutputBuffer(std::vector<T>& outputVector) : outputVector(&outputVector) {}
+    /**
+     * Writes into the memory returned by the passed function. If it returns nullptr, or if the buffer needs to grow
+     * a second time before clear() was called, the internal vector is used instead (@see getIsExternalMemoryUsed).
+     * The data written so far is then copied to the internal vector with the readback function. The external memory
+     * is read directly if no readback function is passed, i.e., it must not be write-only (like mapped GPU memory).
+     */
+    explicit OutputBuffer(
+            AllocationFunction allocationFunction, ReadbackFunction readbackFunction = ReadbackFunction())
+            : outputVector(nullptr), allocationFunction(allocationFunction), readbackFunction(readbackFunction) {}
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /// Sets the size to zero. The capacity of the internal vector is kept.
+    void clear() {
+        if (outputVector) {
+            outputVector->clear();
+        }
+        if (allocationFunction) {
+            outputVector = nullptr;
+            externalMemory = nullptr;
+        }
+        externalSize = 0;
+    }
+
+    /**
+     * Changes the number of elements. Existing elements are kept. The pointer returned by data() is only valid until
+     * the next call of this function.
+     */
+    void resize(size_t newSize) {
+        if (outputVector) {
+            outputVector->resize(newSize);
+            return;
+        }
+        if (externalSize == 0) {
+            externalMemory = newSize > 0 ? allocationFunction(newSize) : nullptr;
+            if (externalMemory || newSize == 0) {
+                externalSize = newSize;
+                return;
+            }
+            sgl::Logfile::get()->writeError(
+                    "Error in OutputBuffer::resize: Allocation of external memory failed. Using internal memory.");
+        }
+
+        // Fall back to the internal vector, e.g., if the output is appended to after it was written.
+        size_t numElementsKept = std::min(externalSize, newSize);
+        if (readbackFunction && externalMemory) {
+            ownedVector.resize(newSize);
+            readbackFunction(ownedVector.data(), numElementsKept);
+        } else {
+            ownedVector.assign(externalMemory, externalMemory + numElementsKept);
+            ownedVector.resize(newSize);
+        }
+        outputVector = &ownedVector;
+        externalMemory = nullptr;
+        externalSize = 0;
+    }
+
+    inline size_t size() const { return outputVector ? outputVector->size() : externalSize; }
+    inline bool empty() const { return size() == 0; }
+    inline T* data() { return outputVector ? outputVector->data() : externalMemory; }
+    inline const T* data() const { return outputVector ? outputVector->data() : externalMemory; }
+    inline T& operator[](size_t i) { return data()[i]; }
+    inline const T& operator[](size_t i) const { return data()[i]; }
+
+    /// Whether the data lies in the memory returned by the allocation function.
+    inline bool getIsExternalMemoryUsed() const { return !outputVector && externalMemory; }
+
+private:
+    std::vector<T>* outputVector;
+    std::vector<T> ownedVector;
+    AllocationFunction allocationFunction;
+    ReadbackFunction readbackFunction;
+    T* externalMemory = nullptr;
+    size_t externalSize = 0;
+};
+
+#endif //HEXVOLUMERENDERER_OUTPUTBUFFER_HPP
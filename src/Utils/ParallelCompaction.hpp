@@ -0,0 +1,125 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_PARALLELCOMPACTION_HPP
+#define HEXVOLUMERENDERER_PARALLELCOMPACTION_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Generates a variable amount of output per input item (e.g., per face or cell of a mesh) in parallel, with the output
+ * in the same order as a serial loop over the items would produce it. This is done in three passes:
+ * 1. The output count of every item is computed in parallel.
+ * 2. An exclusive prefix sum over the counts of contiguous blocks of items gives the output offset of each item.
+ * 3. After the output buffers were sized once, every item with a non-zero count writes its output in parallel.
+ *
+ * @param numItems The number of input items.
+ * @param countFunction A thread-safe functor (size_t itemIdx) -> Count returning the output count of an item.
+ * Count is either an unsigned integer type or a struct of counts for multiple output streams that provides
+ * operator+= and operator!=, and whose value-initialized state is zero.
+ * @param resizeFunction A functor (const Count& totalCount) -> void sizing the output buffers. It is called once.
+ * @param fillFunction A thread-safe functor (size_t itemIdx, const Count& offset) -> void writing the output of an
+ * item starting at the passed offset relative to the start of the output.
+ * @return The total count.
+ */
+template<class Count, class CountFunction, class ResizeFunction, class FillFunction>
+Count parallelCountScanFill(
+        size_t numItems, CountFunction countFunction, ResizeFunction resizeFunction, FillFunction fillFunction) {
+    int numBlocks = 1;
+#ifdef _OPENMP
+    if (numItems >= (size_t(1) << 14)) {
+        numBlocks = omp_get_max_threads() * 4;
+    }
+#endif
+
+    std::vector<Count> itemCounts(numItems);
+    std::vector<Count> blockOffsets(size_t(numBlocks) + 1);
+    Count* counts = itemCounts.data();
+    Count* offsets = blockOffsets.data();
+
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(counts, offsets, countFunction, numBlocks, numItems) \
+    schedule(dynamic)
+#endif
+    for (int block = 0; block < numBlocks; block++) {
+        size_t blockBegin = numItems * size_t(block) / size_t(numBlocks);
+        size_t blockEnd = numItems * size_t(block + 1) / size_t(numBlocks);
+        Count blockCount = Count();
+        for (size_t itemIdx = blockBegin; itemIdx < blockEnd; itemIdx++) {
+            counts[itemIdx] = countFunction(itemIdx);
+            blockCount += counts[itemIdx];
+        }
+        offsets[block + 1] = blockCount;
+    }
+
+    for (int block = 0; block < numBlocks; block++) {
+        offsets[block + 1] += offsets[block];
+    }
+    Count totalCount = offsets[numBlocks];
+    resizeFunction(totalCount);
+
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(counts, offsets, fillFunction, numBlocks, numItems) \
+    schedule(dynamic)
+#endif
+    for (int block = 0; block < numBlocks; block++) {
+        size_t blockBegin = numItems * size_t(block) / size_t(numBlocks);
+        size_t blockEnd = numItems * size_t(block + 1) / size_t(numBlocks);
+        Count offset = offsets[block];
+        for (size_t itemIdx = blockBegin; itemIdx < blockEnd; itemIdx++) {
+            if (counts[itemIdx] != Count()) {
+                fillFunction(itemIdx, offset);
+                offset += counts[itemIdx];
+            }
+        }
+    }
+
+    return totalCount;
+}
+
+/**
+ * Calls the passed thread-safe functor (size_t itemIdx) -> void for all items in parallel. Used for extractor outputs
+ * with exactly one entry per input item, which need no prefix sum.
+ */
+template<class Function>
+void parallelFor(size_t numItems, Function function) {
+#if _OPENMP >= 201107
+    #pragma omp parallel for default(none) shared(function, numItems)
+#endif
+    for (size_t itemIdx = 0; itemIdx < numItems; itemIdx++) {
+        function(itemIdx);
+    }
+}
+
+#endif //HEXVOLUMERENDERER_PARALLELCOMPACTION_HPP
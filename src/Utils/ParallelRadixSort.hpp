@@ -0,0 +1,132 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Christoph Neuhauser
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXVOLUMERENDERER_PARALLELRADIXSORT_HPP
+#define HEXVOLUMERENDERER_PARALLELRADIXSORT_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * Sorts records stably by an unsigned integer key using a least-significant-digit radix sort with 8-bit digits.
+ * In every pass, each thread counts the digits of one contiguous block of records. The threads then scatter their
+ * blocks to the exclusive prefix sums of the counts in (digit, block) order, which keeps the sort stable.
+ * Passes in which all records share the same digit are skipped.
+ * @param records The records to sort.
+ * @param numKeyBits The number of significant key bits. ceil(numKeyBits / 8) passes are made at most.
+ * @param getDigit A functor (const Record&, uint32_t pass) -> uint32_t returning the pass-th least significant byte
+ * of the key of the passed record.
+ */
+template<class Record, class DigitFunction>
+void parallelRadixSort(std::vector<Record>& records, uint32_t numKeyBits, DigitFunction getDigit) {
+    size_t numRecords = records.size();
+    if (numRecords < 2) {
+        return;
+    }
+
+    int numBlocks = 1;
+#ifdef _OPENMP
+    if (numRecords >= (size_t(1) << 16)) {
+        numBlocks = omp_get_max_threads();
+    }
+#endif
+
+    std::vector<Record> buffer(numRecords);
+    std::vector<size_t> counts(size_t(numBlocks) * 256);
+    std::vector<size_t> digitCounts(256);
+    Record* src = records.data();
+    Record* dst = buffer.data();
+    uint32_t numPasses = (numKeyBits + 7) / 8;
+
+    for (uint32_t pass = 0; pass < numPasses; pass++) {
+        std::fill(counts.begin(), counts.end(), 0);
+#if _OPENMP >= 201107
+        #pragma omp parallel for num_threads(numBlocks) default(none) \
+        shared(src, counts, getDigit, numBlocks, numRecords, pass)
+#endif
+        for (int block = 0; block < numBlocks; block++) {
+            size_t blockBegin = numRecords * size_t(block) / size_t(numBlocks);
+            size_t blockEnd = numRecords * size_t(block + 1) / size_t(numBlocks);
+            size_t* blockCounts = counts.data() + size_t(block) * 256;
+            for (size_t i = blockBegin; i < blockEnd; i++) {
+                blockCounts[getDigit(src[i], pass)]++;
+            }
+        }
+
+        bool isPassNeeded = true;
+        std::fill(digitCounts.begin(), digitCounts.end(), 0);
+        for (int block = 0; block < numBlocks; block++) {
+            for (size_t digit = 0; digit < 256; digit++) {
+                digitCounts[digit] += counts[size_t(block) * 256 + digit];
+            }
+        }
+        for (size_t digit = 0; digit < 256; digit++) {
+            if (digitCounts[digit] == numRecords) {
+                isPassNeeded = false;
+            }
+        }
+        if (!isPassNeeded) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; digit++) {
+            for (int block = 0; block < numBlocks; block++) {
+                size_t count = counts[size_t(block) * 256 + digit];
+                counts[size_t(block) * 256 + digit] = offset;
+                offset += count;
+            }
+        }
+
+#if _OPENMP >= 201107
+        #pragma omp parallel for num_threads(numBlocks) default(none) \
+        shared(src, dst, counts, getDigit, numBlocks, numRecords, pass)
+#endif
+        for (int block = 0; block < numBlocks; block++) {
+            size_t blockBegin = numRecords * size_t(block) / size_t(numBlocks);
+            size_t blockEnd = numRecords * size_t(block + 1) / size_t(numBlocks);
+            size_t* blockOffsets = counts.data() + size_t(block) * 256;
+            for (size_t i = blockBegin; i < blockEnd; i++) {
+                dst[blockOffsets[getDigit(src[i], pass)]++] = src[i];
+            }
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != records.data()) {
+        records.swap(buffer);
+    }
+}
+
+#endif //HEXVOLUMERENDERER_PARALLELRADIXSORT_HPP